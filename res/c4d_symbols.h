@@ -35,6 +35,16 @@ enum
   IDS_LUXC4D_EXPORTER_DESCR,
   IDS_OVERWRITE_FILE_QUERY,
   IDS_EXPORT_FILENAME_QUERY,
+  IDS_EXPORT_PROGRESS,
+  IDS_EXPORT_PROGRESS_ITEMS,
+  IDS_EXPORT_CANCELLED,
+  IDS_EXPORT_RUNNING,
+  IDS_EXPORT_PHASE_SETTINGS,
+  IDS_EXPORT_PHASE_COLLECT,
+  IDS_EXPORT_PHASE_LIGHTS,
+  IDS_EXPORT_PHASE_GEOMETRY,
+  IDS_EXPORT_PHASE_TEXTURES,
+  IDS_EXPORT_PHASE_FRAMES,
 
   // LuxC4DExporterRender IDs
   IDS_LUXC4D_EXPORTERRENDER = 1000,
@@ -69,9 +79,12 @@ enum
   IDB_LUXC4D_PREFS_LUX_PATH,
   IDB_LUXC4D_PREFS_OK,
   IDS_LUXC4D_PREFS_LUX_PATH_FS_TITLE,
+  IDS_LUXC4D_PREFS_PROFILE,
+  IDD_LUXC4D_PREFS_PROFILE,
 
   // container IDs of LuxC4DPreferences
   IDV_LUXC4D_PREFS_LUX_PATH = 0,
+  IDV_LUXC4D_PREFS_PROFILE,
 
   // error strings
   IDS_ERROR_INITIALISE_LUXAPIWRITER = 100000,
@@ -444,7 +444,23 @@ enum
     IDD_BUMP_SAMPLE_DISTANCE,
     IDD_TEXTURE_GAMMA_CORRECTION,
     IDD_USE_RELATIVE_PATHS,
-    IDD_DO_COLOUR_GAMMA_CORRECTION
+    IDD_DO_COLOUR_GAMMA_CORRECTION,
+
+    // ----------------------------------
+    // TEXTURE CACHE GROUP
+    IDG_TEXTURE_CACHE = 30300,
+    IDD_PREPROCESS_TEXTURES,
+    IDD_MAX_TEXTURE_RESOLUTION,
+    IDD_TEXTURE_MEMORY_BUDGET,
+    IDD_MAX_ENVIRONMENT_RESOLUTION,
+    IDD_BAKE_SHADERS,
+    IDD_SHADER_BAKE_RESOLUTION,
+
+    // ----------------------------------
+    // INCREMENTAL EXPORT GROUP
+    IDG_INCREMENTAL_EXPORT = 30400,
+    IDD_INCREMENTAL_EXPORT,
+    IDD_EXPORT_ANIMATION
 };
 
 
@@ -577,6 +577,15 @@ CONTAINER VPluxc4dsettings
     REAL IDD_TEXTURE_GAMMA_CORRECTION     { ANIM OFF;  MIN 1.0;  MAX 10.0;  STEP 0.1; }
     BOOL IDD_DO_COLOUR_GAMMA_CORRECTION   { ANIM OFF; }
     BOOL IDD_USE_RELATIVE_PATHS           { ANIM OFF; }
+    BOOL IDD_INCREMENTAL_EXPORT           { ANIM OFF; }
+    BOOL IDD_EXPORT_ANIMATION             { ANIM OFF; }
+    
+    BOOL IDD_PREPROCESS_TEXTURES          { ANIM OFF; }
+    LONG IDD_MAX_TEXTURE_RESOLUTION       { ANIM OFF;  MIN 16;  MAX 65536;  STEP 256; }
+    LONG IDD_TEXTURE_MEMORY_BUDGET        { ANIM OFF;  MIN 0;  MAX 65536;  STEP 64; }
+    LONG IDD_MAX_ENVIRONMENT_RESOLUTION   { ANIM OFF;  MIN 16;  MAX 65536;  STEP 256; }
+    BOOL IDD_BAKE_SHADERS                 { ANIM OFF; }
+    LONG IDD_SHADER_BAKE_RESOLUTION       { ANIM OFF;  MIN 16;  MAX 65536;  STEP 256; }
     
   } // GROUP IDG_EXPORT
 
@@ -41,6 +41,9 @@ DIALOG DLG_LUXC4D_PREFERENCES
       EDITTEXT IDD_LUXC4D_PREFS_LUX_PATH { SCALE_H; }
       BUTTON   IDB_LUXC4D_PREFS_LUX_PATH { NAME IDB_LUXC4D_PREFS_LUX_PATH; }
     }
+
+    STATICTEXT { NAME IDS_LUXC4D_PREFS_PROFILE; }
+    CHECKBOX IDD_LUXC4D_PREFS_PROFILE { }
   }
   
   GROUP {
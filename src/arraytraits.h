@@ -0,0 +1,296 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __ARRAYTRAITS_H__
+#define __ARRAYTRAITS_H__  1
+
+
+
+#include <cstddef>
+#include <cstring>
+
+#include <c4d.h>
+
+
+
+/// The alignment (in bytes) of the arrays of types that are declared with
+/// DECLARE_ALIGNED_ARRAY_TYPE(), i.e. the geometry buffers processed by SIMD
+/// kernels. 32 bytes are needed for aligned AVX loads, 64 would align the
+/// arrays to cache lines.
+#ifndef LUXC4D_SIMD_ALIGNMENT
+#define LUXC4D_SIMD_ALIGNMENT  32
+#endif
+
+
+
+/***************************************************************************//*!
+ This template tells the array containers (DynArray1D and FixArray1D) how
+ they can handle elements of type T. By default an element type is treated
+ as non-trivial, i.e. elements are default constructed on allocation, copied
+ one by one via the copy operator and destructed on deallocation.
+
+ Trivial types (cIsTrivial == 1) must be copyable with memcpy() and don't need
+ to be constructed or destructed. Their memory is allocated uninitialised with
+ the C4D memory functions (or cleared, if requested) and copied with memcpy().
+ This is true for all fundamental types and pointers. Other types can be
+ declared as trivial with DECLARE_TRIVIAL_ARRAY_TYPE(), if skipping their
+ default constructor doesn't change anything (e.g. vectors whose constructor
+ doesn't initialise the components).
+
+ cAlignment is the default alignment of FixArray1D arrays of this type. 0 means
+ that the arrays are aligned like any other allocated memory. Only trivial
+ types can have a different alignment, which is used for the geometry types
+ to allow aligned vector loads.
+*//****************************************************************************/
+template <class T>
+struct ArrayTraits
+{
+  enum { cIsTrivial = 0, cAlignment = 0 };
+};
+
+/// Pointers are always trivial.
+template <class T>
+struct ArrayTraits<T*>
+{
+  enum { cIsTrivial = 1, cAlignment = 0 };
+};
+
+/// Declares a type as trivial element type of arrays - see ArrayTraits. It has
+/// to be used in the global namespace.
+#define DECLARE_TRIVIAL_ARRAY_TYPE(T)                                         \
+  template <> struct ArrayTraits<T> { enum { cIsTrivial = 1, cAlignment = 0 }; };
+
+/// Declares a type as trivial element type of arrays, whose FixArray1D arrays
+/// are aligned to LUXC4D_SIMD_ALIGNMENT bytes by default - see ArrayTraits.
+/// It has to be used in the global namespace.
+#define DECLARE_ALIGNED_ARRAY_TYPE(T)                                         \
+  template <> struct ArrayTraits<T> { enum { cIsTrivial = 1,                  \
+                                             cAlignment = LUXC4D_SIMD_ALIGNMENT }; };
+
+DECLARE_TRIVIAL_ARRAY_TYPE(bool)
+DECLARE_TRIVIAL_ARRAY_TYPE(char)
+DECLARE_TRIVIAL_ARRAY_TYPE(signed char)
+DECLARE_TRIVIAL_ARRAY_TYPE(unsigned char)
+DECLARE_TRIVIAL_ARRAY_TYPE(short)
+DECLARE_TRIVIAL_ARRAY_TYPE(unsigned short)
+DECLARE_TRIVIAL_ARRAY_TYPE(int)
+DECLARE_TRIVIAL_ARRAY_TYPE(unsigned int)
+DECLARE_TRIVIAL_ARRAY_TYPE(long)
+DECLARE_TRIVIAL_ARRAY_TYPE(unsigned long)
+DECLARE_TRIVIAL_ARRAY_TYPE(long long)
+DECLARE_TRIVIAL_ARRAY_TYPE(unsigned long long)
+DECLARE_TRIVIAL_ARRAY_TYPE(float)
+DECLARE_TRIVIAL_ARRAY_TYPE(double)
+
+// the C4D vectors clear themselves in their constructor, but we only use
+// arrays of them for data that is filled completely by C4D (e.g. phong
+// normals) or by us
+#if _C4D_VERSION < 120
+DECLARE_TRIVIAL_ARRAY_TYPE(Vector)
+#else
+DECLARE_TRIVIAL_ARRAY_TYPE(SVector)
+#endif
+DECLARE_TRIVIAL_ARRAY_TYPE(LVector)
+DECLARE_TRIVIAL_ARRAY_TYPE(CPolygon)
+
+
+
+/***************************************************************************//*!
+ Implements the allocation, copying and deallocation of the element arrays of
+ DynArray1D and FixArray1D. There are specialisations for non-trivial types,
+ trivial types and trivial types with an alignment (in bytes) - see
+ ArrayTraits. Non-trivial types with an alignment are not supported, i.e. the
+ primary template is not defined.
+*//****************************************************************************/
+template <class T,
+          int IS_TRIVIAL=ArrayTraits<T>::cIsTrivial,
+          int ALIGNMENT=0>
+struct ArrayStorage;
+
+
+/// ArrayStorage for non-trivial types, which uses bNew/bDelete and copies
+/// element by element.
+template <class T>
+struct ArrayStorage<T, 0, 0>
+{
+  /// Allocates an array of SIZE default constructed elements or returns NULL
+  /// if we ran out of memory.
+  static inline T* allocate(VULONG size)
+  {
+    return bNew T[size];
+  }
+
+  /// Allocates an array of SIZE elements, whose bytes are all set to 0.
+  static inline T* allocateZeroed(VULONG size)
+  {
+    T* data = allocate(size);
+    if (data)  memset(data, 0, size*sizeof(T));
+    return data;
+  }
+
+  /// Deallocates an array (can be NULL) and sets the pointer to NULL.
+  static inline void deallocate(T*& data)
+  {
+    bDelete(data);
+  }
+
+  /// Copies SIZE elements from SOURCE to TARGET, which must not overlap.
+  static inline void copy(T*       target,
+                          const T* source,
+                          VULONG   size)
+  {
+    for (VULONG c=0; c<size; ++c)  target[c] = source[c];
+  }
+
+  /// Moves the first SIZE elements of an array into a newly allocated array
+  /// of CAPACITY elements and deallocates the old array. Returns the new
+  /// array or NULL if we ran out of memory, in which case the old array is
+  /// still valid.
+  static inline T* reallocate(T*     data,
+                              VULONG size,
+                              VULONG capacity)
+  {
+    T* newData = allocate(capacity);
+    if (!newData)  return 0;
+    copy(newData, data, size);
+    deallocate(data);
+    return newData;
+  }
+};
+
+
+/// ArrayStorage for trivial types, which uses the C4D memory functions and
+/// memcpy().
+template <class T>
+struct ArrayStorage<T, 1, 0>
+{
+  static inline T* allocate(VULONG size)
+  {
+    return (T*)GeAllocNC(size*sizeof(T));
+  }
+
+  static inline T* allocateZeroed(VULONG size)
+  {
+    return (T*)GeAlloc(size*sizeof(T));
+  }
+
+  static inline void deallocate(T*& data)
+  {
+    void* memory = data;
+    GeFree(memory);
+    data = 0;
+  }
+
+  static inline void copy(T*       target,
+                          const T* source,
+                          VULONG   size)
+  {
+    if (size)  memcpy(target, source, size*sizeof(T));
+  }
+
+  static inline T* reallocate(T*     data,
+                              VULONG size,
+                              VULONG capacity)
+  {
+    T* newData = allocate(capacity);
+    if (!newData)  return 0;
+    copy(newData, data, size);
+    deallocate(data);
+    return newData;
+  }
+};
+
+
+/// ArrayStorage for trivial types, whose arrays are aligned to ALIGNMENT bytes.
+/// ALIGNMENT must be a power of 2 and at least the size of a pointer. The
+/// memory is allocated with the C4D memory functions, but a bit larger, so the
+/// array can be shifted to the next aligned address. The address of the actual
+/// memory block is stored directly in front of the array, i.e. arrays can only
+/// be deallocated by the same ArrayStorage.
+template <class T, int ALIGNMENT>
+struct ArrayStorage<T, 1, ALIGNMENT>
+{
+  static inline T* allocate(VULONG size)
+  {
+    return align(GeAllocNC(blockSize(size)));
+  }
+
+  static inline T* allocateZeroed(VULONG size)
+  {
+    return align(GeAlloc(blockSize(size)));
+  }
+
+  static inline void deallocate(T*& data)
+  {
+    if (data) {
+      void* memory = ((void**)data)[-1];
+      GeFree(memory);
+      data = 0;
+    }
+  }
+
+  static inline void copy(T*       target,
+                          const T* source,
+                          VULONG   size)
+  {
+    if (size)  memcpy(target, source, size*sizeof(T));
+  }
+
+  static inline T* reallocate(T*     data,
+                              VULONG size,
+                              VULONG capacity)
+  {
+    T* newData = allocate(capacity);
+    if (!newData)  return 0;
+    copy(newData, data, size);
+    deallocate(data);
+    return newData;
+  }
+
+
+private:
+
+  /// Returns the number of bytes we have to allocate for an array of SIZE
+  /// elements.
+  static inline VULONG blockSize(VULONG size)
+  {
+    return size*sizeof(T) + sizeof(void*) + ALIGNMENT - 1;
+  }
+
+  /// Returns the first aligned address in a memory block, that leaves enough
+  /// space for storing the address of the block in front of it.
+  static inline T* align(void* memory)
+  {
+    if (!memory)  return 0;
+    size_t address = ((size_t)memory + sizeof(void*) + ALIGNMENT - 1) &
+                     ~(size_t)(ALIGNMENT-1);
+    ((void**)address)[-1] = memory;
+    return (T*)address;
+  }
+};
+
+
+
+#endif  // #ifndef __ARRAYTRAITS_H__
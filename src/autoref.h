@@ -28,10 +28,193 @@
 
 
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include "utilities.h"
 
 
 
+/// The type of the reference counters of AutoRef. It's a long, as the atomic
+/// intrinsics of MSVC work on longs.
+typedef long RefCountT;
+
+
+
+/***************************************************************************//*!
+  Base class for objects that are referenced by AutoRefs. The reference
+  counter is stored in the object itself, i.e. creating an AutoRef from such an
+  object doesn't allocate a separate counter, the counter lies on the same
+  cache line as the object and two AutoRefs created from the same raw pointer
+  share the counter.
+
+  The counter is not copied or assigned together with the object.
+
+  Such objects can also be constructed in a MemoryArena - see inArena().
+*//****************************************************************************/
+class RefCounted
+{
+  friend struct AutoRefCounter;
+
+
+protected:
+
+  inline RefCounted(void) : mRefCount(0), mInArena(FALSE) {}
+  inline RefCounted(const RefCounted& other) : mRefCount(0), mInArena(FALSE) {}
+  inline RefCounted& operator=(const RefCounted& other)  { return *this; }
+
+
+private:
+
+  RefCountT mRefCount;
+  Bool      mInArena;
+};
+
+
+
+/***************************************************************************//*!
+  Same as RefCounted, but the reference counter is updated atomically, i.e.
+  AutoRefs of the object can be copied and released in different threads
+  (e.g. when the conversion is done in parallel). Accessing the object itself
+  is not synchronised, of course.
+*//****************************************************************************/
+class AtomicRefCounted
+{
+  friend struct AutoRefCounter;
+
+
+protected:
+
+  inline AtomicRefCounted(void) : mRefCount(0), mInArena(FALSE) {}
+  inline AtomicRefCounted(const AtomicRefCounted& other) : mRefCount(0), mInArena(FALSE) {}
+  inline AtomicRefCounted& operator=(const AtomicRefCounted& other)  { return *this; }
+
+
+private:
+
+  volatile RefCountT mRefCount;
+  Bool               mInArena;
+};
+
+
+
+/***************************************************************************//*!
+  Helper functions of AutoRef, which update a reference counter. The overload
+  is selected by the static type of the referenced object, i.e. objects that
+  are derived from RefCounted or AtomicRefCounted use their embedded counter
+  and all other objects use a separately allocated counter.
+*//****************************************************************************/
+struct AutoRefCounter
+{
+  /// Returns NULL as non-intrusive objects have no embedded counter.
+  static inline RefCountT* embedded(const void*)
+  {
+    return 0;
+  }
+
+  /// Returns the counter embedded in an object derived from RefCounted.
+  static inline RefCountT* embedded(RefCounted* object)
+  {
+    return &object->mRefCount;
+  }
+
+  /// Returns the counter embedded in an object derived from AtomicRefCounted.
+  static inline RefCountT* embedded(AtomicRefCounted* object)
+  {
+    return (RefCountT*)&object->mRefCount;
+  }
+
+  /// Returns FALSE as non-intrusive objects are always allocated on the heap.
+  static inline Bool isInArena(const void*)
+  {
+    return FALSE;
+  }
+
+  /// Returns TRUE if an object derived from RefCounted lives in an arena.
+  static inline Bool isInArena(const RefCounted* object)
+  {
+    return object->mInArena;
+  }
+
+  /// Returns TRUE if an object derived from AtomicRefCounted lives in an arena.
+  static inline Bool isInArena(const AtomicRefCounted* object)
+  {
+    return object->mInArena;
+  }
+
+  /// Marks an object derived from RefCounted as living in an arena.
+  static inline void setInArena(RefCounted* object)
+  {
+    object->mInArena = TRUE;
+  }
+
+  /// Marks an object derived from AtomicRefCounted as living in an arena.
+  static inline void setInArena(AtomicRefCounted* object)
+  {
+    object->mInArena = TRUE;
+  }
+
+  /// Increments a plain reference counter and returns the new count.
+  static inline RefCountT increment(const void*,
+                                    RefCountT* count)
+  {
+    return ++(*count);
+  }
+
+  /// Increments the counter of an AtomicRefCounted object atomically and
+  /// returns the new count.
+  static inline RefCountT increment(const AtomicRefCounted*,
+                                    RefCountT* count)
+  {
+#if defined(_MSC_VER)
+    return _InterlockedIncrement(count);
+#else
+    return __sync_add_and_fetch(count, 1);
+#endif
+  }
+
+  /// Decrements a plain reference counter and returns the new count.
+  static inline RefCountT decrement(const void*,
+                                    RefCountT* count)
+  {
+    return --(*count);
+  }
+
+  /// Decrements the counter of an AtomicRefCounted object atomically and
+  /// returns the new count.
+  static inline RefCountT decrement(const AtomicRefCounted*,
+                                    RefCountT* count)
+  {
+#if defined(_MSC_VER)
+    return _InterlockedDecrement(count);
+#else
+    return __sync_sub_and_fetch(count, 1);
+#endif
+  }
+};
+
+
+
+/// Marks an object derived from RefCounted or AtomicRefCounted, which was
+/// constructed in a MemoryArena. When its last AutoRef is released, the object
+/// gets destroyed, but its memory is only given back with the arena, i.e. all
+/// AutoRefs of the object must be gone before the arena is released. Usage:
+///   LuxMatteDataH material = inArena(new (arena) LuxMatteData);
+///
+/// @param[in]  object
+///   The object that was constructed in an arena (can be NULL).
+/// @return
+///   The passed in pointer.
+template<class T>
+inline T* inArena(T* object)
+{
+  if (object) { AutoRefCounter::setInArena(object); }
+  return object;
+}
+
+
+
 /***************************************************************************//*!
   This class is to be used for reference counting and automatic deallocation.
   Such a handle object behaves like a normal reference plus assignment operator.
@@ -39,8 +222,14 @@
   counter and each AutoRef destruction decreases the internal counter. If the
   counter reaches zero the memory pointed by the internal pointer is deallocated.
 
+  If T is derived from RefCounted or AtomicRefCounted, the counter embedded in
+  the object is used, otherwise a counter gets allocated separately. Objects
+  in a MemoryArena (see inArena()) are only destroyed, not deallocated. Up-casts
+  must not leave the intrusive class hierarchy, i.e. the target type must be
+  derived from the same base as T.
+
   The array template parameter is needed to differ between object (de)allocation
-  and array (de)allocation.
+  and array (de)allocation. Arrays always use a separate counter.
 *//****************************************************************************/
 template<class T, Bool array=FALSE>
 class AutoRef
@@ -83,13 +272,16 @@ class AutoRef
     /// that different template classes are handled as different types that have
     /// no access to private/protected members of objects with other template
     /// parameters.
-    inline AutoRef(T* data, SizeT* count);
+    inline AutoRef(T* data, RefCountT* count);
 
 
   private :
 
-    T*     mData;
-    SizeT* mRefCount;
+    T*         mData;
+    RefCountT* mRefCount;
+
+    Bool attach(T* data);
+    inline static RefCountT* embeddedCounter(T* data);
 };
 
 
@@ -111,16 +303,10 @@ inline AutoRef<T,array>::AutoRef(void)
 ///   Pointer to the data the AutoRef should be the reference of.
 template<class T, Bool array>
 inline AutoRef<T,array>::AutoRef(T* data)
+: mData(0), mRefCount(0)
 {
-  if (data) {
-    mRefCount = gNew SizeT(1);
-    if (!mRefCount) {
-      ERRLOG_RETURN("AutoRef::AutoRef(): Could not allocate reference counter.");
-    }
-    mData = data;
-  } else {
-    mData = 0;
-    mRefCount = 0;
+  if (data && !attach(data)) {
+    ERRLOG("AutoRef::AutoRef(): Could not allocate reference counter.");
   }
 }
 
@@ -135,7 +321,7 @@ template<class T, Bool array>
 inline AutoRef<T,array>::AutoRef(const AutoRef& other)
 : mData(other.mData), mRefCount(other.mRefCount)
 {
-  if (mRefCount) { ++(*mRefCount); }
+  if (mRefCount) { AutoRefCounter::increment(mData, mRefCount); }
 }
 
 
@@ -161,20 +347,21 @@ template<class T, Bool array>
 Bool AutoRef<T,array>::allocate(SizeT nmb)
 {
   clear();
+  T* data;
   if (array) {
-    if (!(mData = gNew T[nmb])) {
+    if (!(data = gNew T[nmb])) {
       ERRLOG_RETURN_VALUE(FALSE, "AutoRef::allocate(): Could not allocate data array.");
     }
   } else {
-    if (!(mData = gNew T)) {
+    if (!(data = gNew T)) {
       ERRLOG_RETURN_VALUE(FALSE, "AutoRef::allocate(): Could not allocate data.");
     }
   }
-  if (!(mRefCount = gNew SizeT(1))) {
+  if (!attach(data)) {
     if (array) {
-      bDelete(mData);
+      bDelete(data);
     } else {
-      gDelete(mData);
+      gDelete(data);
     }
     ERRLOG_RETURN_VALUE(FALSE, "AutoRef::allocate(): Could not allocate reference counter.");
   }
@@ -184,20 +371,24 @@ Bool AutoRef<T,array>::allocate(SizeT nmb)
 
 /// Decreases the reference counter and then releases this AutoRef from the
 /// referenced object. If the reference counter reaches zero the referenced
-/// data is deallocated. The internal data pointer is always NULL afterwards.
+/// data is deallocated. The AutoRef is always empty afterwards.
 template<class T, Bool array>
 void AutoRef<T,array>::clear(void)
 {
-  if (mRefCount) {
-    if (--(*mRefCount) == 0) {
+  if (mRefCount && (AutoRefCounter::decrement(mData, mRefCount) == 0)) {
+    if (mRefCount != embeddedCounter(mData)) {
       gDelete(mRefCount);
-      if (array) {
-        bDelete(mData);
-      } else {
-        gDelete(mData);
-      }
+    }
+    if (array) {
+      bDelete(mData);
+    } else if (AutoRefCounter::isInArena(mData)) {
+      mData->~T();
+    } else {
+      gDelete(mData);
     }
   }
+  mData     = 0;
+  mRefCount = 0;
 }
 
 
@@ -213,7 +404,7 @@ inline Bool AutoRef<T,array>::bad(void) const
 template<class T, Bool array>
 inline ULONG AutoRef<T,array>::count(void) const
 {
-  return (mRefCount) ? (*mRefCount) : 0;
+  return (mRefCount) ? (ULONG)(*mRefCount) : 0;
 }
 
 
@@ -283,10 +474,14 @@ template<class T, Bool array>
 AutoRef<T,array>& AutoRef<T,array>::operator=(const AutoRef& src)
 {
   if (src.mData != mData) {
+    // take the reference before releasing ours, as SRC might be owned by the
+    // data we are referencing
+    T*         data  = src.mData;
+    RefCountT* count = src.mRefCount;
+    if (count) { AutoRefCounter::increment(data, count); }
     clear();
-    mData     = src.mData;
-    mRefCount = src.mRefCount;
-    if (mRefCount) { ++(*mRefCount); }
+    mData     = data;
+    mRefCount = count;
   }
   return *this;
 }
@@ -308,8 +503,7 @@ AutoRef<T,array>& AutoRef<T,array>::operator=(T* data)
   if (data != mData) {
     clear();
     if (!data)  { return *this; }
-    mData = data;
-    if (!(mRefCount = gNew SizeT(1)))  {
+    if (!attach(data)) {
       ERRLOG("AutoRef::operator=(): Could not allocate reference counter.");
     }
   }
@@ -330,6 +524,8 @@ template<class T, Bool array>
 template<class trgT>
 inline AutoRef<T,array>::operator AutoRef<trgT,array>(void) const
 {
+  GeAssert(!mData || array ||
+           (AutoRefCounter::embedded(static_cast<trgT*>(mData)) == embeddedCounter(mData)));
   return AutoRef<trgT,array>(mData, mRefCount);
 }
 
@@ -341,10 +537,45 @@ inline AutoRef<T,array>::operator AutoRef<trgT,array>(void) const
 /// no access to private/protected members of objects with other template
 /// parameters.
 template<class T, Bool array>
-inline AutoRef<T,array>::AutoRef(T* data, SizeT* count)
+inline AutoRef<T,array>::AutoRef(T* data, RefCountT* count)
 : mData(data), mRefCount(count)
 {
-  if (mRefCount) { ++(*mRefCount); }
+  if (mRefCount) { AutoRefCounter::increment(mData, mRefCount); }
+}
+
+
+/// Lets an empty AutoRef reference an object and increments the reference
+/// counter, which is either the one embedded in the object or a new one.
+///
+/// @param[in]  data
+///   Pointer to the object, must not be NULL.
+/// @return
+///   TRUE if successful, FALSE if the separate reference counter couldn't be
+///   allocated (the AutoRef stays empty then).
+template<class T, Bool array>
+Bool AutoRef<T,array>::attach(T* data)
+{
+  GeAssert(data);
+  GeAssert(!mRefCount);
+
+  RefCountT* count = embeddedCounter(data);
+  if (count) {
+    AutoRefCounter::increment(data, count);
+  } else if (!(count = gNew RefCountT(1))) {
+    return FALSE;
+  }
+  mData     = data;
+  mRefCount = count;
+  return TRUE;
+}
+
+
+/// Returns the counter embedded in an object or NULL, if the object isn't
+/// derived from RefCounted or AtomicRefCounted or if we are handling arrays.
+template<class T, Bool array>
+inline RefCountT* AutoRef<T,array>::embeddedCounter(T* data)
+{
+  return array ? 0 : AutoRefCounter::embedded(data);
 }
 
 
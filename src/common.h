@@ -72,6 +72,9 @@ class AutoBitmap
 
 #define BaseVideoPost                         PluginVideoPost
 
+#define BUILDFLAGS                            Bool
+#define BUILDFLAGS_0                          FALSE
+
 #define COPYFLAGS                             LONG
 #define COPYFLAGS_0                           0,
 #define COPYFLAGS_NO_HIERARCHY                COPY_NO_HIERARCHY,
@@ -106,6 +109,9 @@ class AutoBitmap
 #define DESCFLAGS_SET_DONTAFFECTINHERITANCE   DESCFLAGS_DONTAFFECTINHERITANCE
 #define DESCFLAGS_SET_FORCESET                DESCFLAGS_FORCESET
 
+#define DIRTYFLAGS                            LONG
+#define DIRTYFLAGS_DATA                       DIRTY_DATA
+
 #define EXECUTIONPRIORITY_INITIAL             EXECUTION_INITIAL
 #define EXECUTIONPRIORITY_ANIMATION           EXECUTION_ANIMATION
 #define EXECUTIONPRIORITY_ANIMATION_NLA       EXECUTION_ANIMATION
@@ -137,6 +143,8 @@ class AutoBitmap
 #define FILESELECTTYPE_SCENES                 FSTYPE_SCENES
 #define FILESELECTTYPE_COFFEE                 FSTYPE_COFFEE
 
+#define FILETIME_MODIFIED                     GE_FILETIME_MODIFIED
+
 #define FreeChildren                          FreeChilds
 
 #define GEMB_R                                LONG
@@ -159,6 +167,9 @@ class AutoBitmap
 #define MINREALr                              MINREAL
 #define MAXREALr                              MAXREAL
 
+#define SAVEBIT                               LONG
+#define SAVEBIT_0                             0
+
 #define STRINGENCODING                        StringEncoding
 #define STRINGENCODING_XBIT                   StXbit
 #define STRINGENCODING_8BIT                   St8bit
@@ -167,6 +178,9 @@ class AutoBitmap
 #define STRINGENCODING_UTF8                   StUTF8
 #define STRINGENCODING_HTML                   StHTML
 
+#define THREADMODE                            Bool
+#define THREADMODE_ASYNC                      TRUE
+
 #define UVWHandle                             const void*
 
 #define SReal                                 Real
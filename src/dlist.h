@@ -28,30 +28,39 @@
 
 
 
+#include <new>
+
 #include <c4d.h>
 
+#include "nodepool.h"
 #include "utilities.h"
 
 
 
 /* Class prototypes */
-template <class T> class DListIterator;
-template <class T> class ConstDListIterator;
+template <class T, template <class> class ALLOCATOR> class DListIterator;
+template <class T, template <class> class ALLOCATOR> class ConstDListIterator;
+
 
 
+/**************************************************************************//*!
+ A double linked list. The nodes are allocated by ALLOCATOR<Node>, which is
+ NodeHeapAllocator by default. Lists that use NodePool can't move nodes to
+ other lists, i.e. adopt(), adoptFront() and adoptBack() copy the values
+ instead.
+*//***************************************************************************/
 
-///
-template<class T>
+template <class T, template <class> class ALLOCATOR=NodeHeapAllocator>
 class DList
 {
-  friend class ConstDListIterator<T>;
-  friend class DListIterator<T>;
+  friend class ConstDListIterator<T,ALLOCATOR>;
+  friend class DListIterator<T,ALLOCATOR>;
 
 
   public:
 
-    typedef ConstDListIterator<T> ConstIteratorT;
-    typedef DListIterator<T>      IteratorT;
+    typedef ConstDListIterator<T,ALLOCATOR> ConstIteratorT;
+    typedef DListIterator<T,ALLOCATOR>      IteratorT;
 
 
     DList();
@@ -129,6 +138,18 @@ private:
     Node* mFront;
     Node* mBack;
     SizeT mSize;
+
+    ALLOCATOR<Node> mAllocator;
+
+
+    inline Node* newNode(Node* previous,
+                         Node* next);
+    inline Node* newNode(Node*    previous,
+                         Node*    next,
+                         const T& value);
+    inline void  deleteNode(Node*& node);
+
+    void unlink(Node* node);
 };
 
 
@@ -136,16 +157,16 @@ private:
 /**************************************************************************//*!
 *//***************************************************************************/
 
-template <class T>
+template <class T, template <class> class ALLOCATOR>
 class DListIterator
 {
-  friend class DList<T>;
-  friend class ConstDListIterator<T>;
+  friend class DList<T,ALLOCATOR>;
+  friend class ConstDListIterator<T,ALLOCATOR>;
 
 
   public:
 
-    typedef DList<T> ContainerT;
+    typedef DList<T,ALLOCATOR> ContainerT;
 
 
     DListIterator();
@@ -161,10 +182,10 @@ class DListIterator
     inline DListIterator& operator++();
     inline DListIterator& operator--();
 
-    inline Bool operator==(const ConstDListIterator<T>& other) const;
-    inline Bool operator==(const DListIterator<T>& other) const;
-    inline Bool operator!=(const ConstDListIterator<T>& other) const;
-    inline Bool operator!=(const DListIterator<T>& other) const;
+    inline Bool operator==(const ConstDListIterator<T,ALLOCATOR>& other) const;
+    inline Bool operator==(const DListIterator<T,ALLOCATOR>& other) const;
+    inline Bool operator!=(const ConstDListIterator<T,ALLOCATOR>& other) const;
+    inline Bool operator!=(const DListIterator<T,ALLOCATOR>& other) const;
 
 
   private:
@@ -184,22 +205,22 @@ class DListIterator
 /**************************************************************************//*!
 *//***************************************************************************/
 
-template <class T>
+template <class T, template <class> class ALLOCATOR>
 class ConstDListIterator
 {
-  friend class DList<T>;
-  friend class DListIterator<T>;
+  friend class DList<T,ALLOCATOR>;
+  friend class DListIterator<T,ALLOCATOR>;
 
 
   public:
 
-    typedef DList<T> ContainerT;
+    typedef DList<T,ALLOCATOR> ContainerT;
 
 
     ConstDListIterator();
 
-    ConstDListIterator(const DListIterator<T>& other);
-    ConstDListIterator& operator=(const DListIterator<T>& other);
+    ConstDListIterator(const DListIterator<T,ALLOCATOR>& other);
+    ConstDListIterator& operator=(const DListIterator<T,ALLOCATOR>& other);
 
     inline Bool isValid() const;
     inline Bool isFront() const;
@@ -212,10 +233,10 @@ class ConstDListIterator
     inline ConstDListIterator& operator++();
     inline ConstDListIterator& operator--();
 
-    inline Bool operator==(const ConstDListIterator<T>& other) const;
-    inline Bool operator==(const DListIterator<T>& other) const;
-    inline Bool operator!=(const ConstDListIterator<T>& other) const;
-    inline Bool operator!=(const DListIterator<T>& other) const;
+    inline Bool operator==(const ConstDListIterator<T,ALLOCATOR>& other) const;
+    inline Bool operator==(const DListIterator<T,ALLOCATOR>& other) const;
+    inline Bool operator!=(const ConstDListIterator<T,ALLOCATOR>& other) const;
+    inline Bool operator!=(const DListIterator<T,ALLOCATOR>& other) const;
 
 
   private:
@@ -230,7 +251,7 @@ class ConstDListIterator
                        const NodeT*      node);
 };
 
-#include "DList_impl.h"
+#include "dlist_impl.h"
 
 
 
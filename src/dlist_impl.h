@@ -36,23 +36,23 @@
  * Implementation of DList
  *****************************************************************************/
 
-template <class T>
-DList<T>::DList()
+template <class T, template <class> class ALLOCATOR>
+DList<T,ALLOCATOR>::DList()
 : mFront(0),
   mBack(0),
   mSize(0)
 {}
 
 
-template <class T>
-DList<T>::~DList()
+template <class T, template <class> class ALLOCATOR>
+DList<T,ALLOCATOR>::~DList()
 {
   erase();
 }
 
 
-template <class T>
-DList<T>::DList(const DList& other)
+template <class T, template <class> class ALLOCATOR>
+DList<T,ALLOCATOR>::DList(const DList& other)
 : mFront(0),
   mBack(0),
   mSize(0)
@@ -61,8 +61,8 @@ DList<T>::DList(const DList& other)
 }
 
 
-template <class T>
-DList<T>& DList<T>::operator=(const DList& other)
+template <class T, template <class> class ALLOCATOR>
+DList<T,ALLOCATOR>& DList<T,ALLOCATOR>::operator=(const DList& other)
 {
   erase();
   for (ConstIteratorT iter=other.begin(); iter.isValid(); ++iter) {
@@ -72,18 +72,18 @@ DList<T>& DList<T>::operator=(const DList& other)
 }
 
 
-template <class T>
-Bool DList<T>::appendFront()
+template <class T, template <class> class ALLOCATOR>
+Bool DList<T,ALLOCATOR>::appendFront()
 {
   if (mFront) {
-    mFront->mPrevious = gNew Node(0, mFront);
+    mFront->mPrevious = newNode(0, mFront);
     if (!mFront->mPrevious) {
       ERRLOG("DList::appendFront(): could not allocate new node for list");
       return FALSE;
     }
     mFront = mFront->mPrevious;
   } else {
-    mFront = mBack = gNew Node(0, 0);
+    mFront = mBack = newNode(0, 0);
     if (!mFront) {
       ERRLOG("DList::appendFront(): could not allocate new node for list");
       return FALSE;
@@ -94,18 +94,18 @@ Bool DList<T>::appendFront()
 }
 
 
-template <class T>
-Bool DList<T>::appendBack()
+template <class T, template <class> class ALLOCATOR>
+Bool DList<T,ALLOCATOR>::appendBack()
 {
   if (mBack) {
-    mBack->mNext = gNew Node(mBack, 0);
+    mBack->mNext = newNode(mBack, 0);
     if (!mBack->mNext) {
       ERRLOG("DList::appendBack(): could not allocate new node for list");
       return FALSE;
     }
     mBack = mBack->mNext;
   } else {
-    mFront = mBack = gNew Node(0, 0);
+    mFront = mBack = newNode(0, 0);
     if (!mFront) {
       ERRLOG("DList::appendBack(): could not allocate new node for list");
       return FALSE;
@@ -116,50 +116,50 @@ Bool DList<T>::appendBack()
 }
 
 
-template <class T>
-void DList<T>::removeFront()
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::removeFront()
 {
   if (!mFront) { return; }
 
   if (mFront == mBack) {
-    gDelete(mFront);
+    deleteNode(mFront);
     mBack = 0;
   } else {
     mFront = mFront->mNext;
-    gDelete(mFront->mPrevious);
+    deleteNode(mFront->mPrevious);
   }
   --mSize;
 }
 
 
-template <class T>
-void DList<T>::removeBack()
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::removeBack()
 {
   if (!mBack) { return; }
 
   if (mFront == mBack) {
-    gDelete(mFront);
+    deleteNode(mFront);
     mBack = 0;
   } else {
     mBack = mBack->mPrevious;
-    gDelete(mBack->mNext);
+    deleteNode(mBack->mNext);
   }
   --mSize;
 }
 
 
-template <class T>
-Bool DList<T>::pushFront(const T& value)
+template <class T, template <class> class ALLOCATOR>
+Bool DList<T,ALLOCATOR>::pushFront(const T& value)
 {
   if (mFront) {
-    mFront->mPrevious = gNew Node(0, mFront, value);
+    mFront->mPrevious = newNode(0, mFront, value);
     if (!mFront->mPrevious) {
       ERRLOG("DList::pushFront(): could not allocate new node for list");
       return FALSE;
     }
     mFront = mFront->mPrevious;
   } else {
-    mFront = mBack = gNew Node(0, 0, value);
+    mFront = mBack = newNode(0, 0, value);
     if (!mFront) {
       ERRLOG("DList::pushFront(): could not allocate new node for list");
       return FALSE;
@@ -170,18 +170,18 @@ Bool DList<T>::pushFront(const T& value)
 }
 
 
-template <class T>
-Bool DList<T>::pushBack(const T& value)
+template <class T, template <class> class ALLOCATOR>
+Bool DList<T,ALLOCATOR>::pushBack(const T& value)
 {
   if (mBack) {
-    mBack->mNext = gNew Node(mBack, 0, value);
+    mBack->mNext = newNode(mBack, 0, value);
     if (!mBack->mNext) {
       ERRLOG("DList::pushBack(): could not allocate new node for list");
       return FALSE;
     }
     mBack = mBack->mNext;
   } else {
-    mFront = mBack = gNew Node(0, 0, value);
+    mFront = mBack = newNode(0, 0, value);
     if (!mFront) {
       ERRLOG("DList::pushBack(): could not allocate new node for list");
       return FALSE;
@@ -192,9 +192,9 @@ Bool DList<T>::pushBack(const T& value)
 }
 
 
-template <class T>
-Bool DList<T>::pushFront(ConstIteratorT& start,
-                         ConstIteratorT& stop)
+template <class T, template <class> class ALLOCATOR>
+Bool DList<T,ALLOCATOR>::pushFront(ConstIteratorT& start,
+                                   ConstIteratorT& stop)
 {
   GeAssert(start.isValid());
   GeAssert(stop.isValid());
@@ -208,9 +208,9 @@ Bool DList<T>::pushFront(ConstIteratorT& start,
 }
 
 
-template <class T>
-Bool DList<T>::pushBack(ConstIteratorT& start,
-                        ConstIteratorT& stop)
+template <class T, template <class> class ALLOCATOR>
+Bool DList<T,ALLOCATOR>::pushBack(ConstIteratorT& start,
+                                  ConstIteratorT& stop)
 {
   GeAssert(start.isValid());
   GeAssert(stop.isValid());
@@ -224,8 +224,8 @@ Bool DList<T>::pushBack(ConstIteratorT& start,
 }
 
 
-template <class T>
-Bool DList<T>::pushFront(const DList& other)
+template <class T, template <class> class ALLOCATOR>
+Bool DList<T,ALLOCATOR>::pushFront(const DList& other)
 {
   for (const Node* node=other.mFront; node; node=node->mNext) {
     if (!pushFront(node->mData)) { return FALSE; }
@@ -234,8 +234,8 @@ Bool DList<T>::pushFront(const DList& other)
 }
 
 
-template <class T>
-Bool DList<T>::pushBack(const DList& other)
+template <class T, template <class> class ALLOCATOR>
+Bool DList<T,ALLOCATOR>::pushBack(const DList& other)
 {
   for (const Node* node=other.mFront; node; node=node->mNext) {
     if (!pushBack(node->mData)) { return FALSE; }
@@ -244,67 +244,57 @@ Bool DList<T>::pushBack(const DList& other)
 }
 
 
-template <class T>
-T DList<T>::popFront()
+template <class T, template <class> class ALLOCATOR>
+T DList<T,ALLOCATOR>::popFront()
 {
   GeAssert(mFront);
 
   T retValue = mFront->mData;
   if (mFront == mBack) {
-    gDelete(mFront);
+    deleteNode(mFront);
     mBack = 0;
   } else {
     mFront = mFront->mNext;
-    gDelete(mFront->mPrevious);
+    deleteNode(mFront->mPrevious);
   }
   --mSize;
   return retValue;
 }
 
 
-template <class T>
-T DList<T>::popBack()
+template <class T, template <class> class ALLOCATOR>
+T DList<T,ALLOCATOR>::popBack()
 {
   GeAssert(mBack);
 
   T retValue = mBack->mData;
   if (mFront == mBack) {
-    gDelete(mFront);
+    deleteNode(mFront);
     mBack = 0;
   } else {
     mBack = mBack->mPrevious;
-    gDelete(mBack->mNext);
+    deleteNode(mBack->mNext);
   }
   --mSize;
   return retValue;
 }
 
 
-template <class T>
-void DList<T>::remove(IteratorT& iter)
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::remove(IteratorT& iter)
 {
   GeAssert(iter.mNode);
   GeAssert(iter.mList == this);
 
   Node* node(iter.mNode);
   ++iter;
-  if (node->mPrevious) {
-    node->mPrevious->mNext = node->mNext;
-  } else {
-    mFront = node->mNext;
-  }
-  if (node->mNext) {
-    node->mNext->mPrevious = node->mPrevious;
-  } else {
-    mBack = node->mPrevious;
-  }
-  gDelete(node);
-  --iter.mList->mSize;
+  unlink(node);
+  deleteNode(node);
 }
 
 
-template <class T>
-void DList<T>::adopt(IteratorT& entry)
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::adopt(IteratorT& entry)
 {
   GeAssert(entry.mNode);
   GeAssert(entry.mList);
@@ -312,21 +302,24 @@ void DList<T>::adopt(IteratorT& entry)
 
   Node* node(entry.mNode);
 
-  // move node out of source list
-  if (node->mPrevious) {
-    node->mPrevious->mNext = node->mNext;
-  } else {
-    entry.mList->mFront = node->mNext;
-  }
-  if (node->mNext) {
-    node->mNext->mPrevious = node->mPrevious;
+  // move node out of source list (if our allocator doesn't allow to take over
+  // nodes of other lists, we replace the node by a copy)
+  if (!ALLOCATOR<Node>::cCanTransferNodes) {
+    Node* copy = newNode(0, 0, node->mData);
+    if (!copy) {
+      ERRLOG("DList::adopt(): could not allocate new node for list");
+      return;
+    }
+    entry.mList->unlink(node);
+    entry.mList->deleteNode(node);
+    node = copy;
   } else {
-    entry.mList->mBack = node->mPrevious;
+    entry.mList->unlink(node);
   }
-  --entry.mList->mSize;
 
   // append node to list
-  entry->mList = this;
+  entry.mList = this;
+  entry.mNode = node;
   node->mPrevious = mBack;
   node->mNext = 0;
   if (mBack) {
@@ -339,9 +332,9 @@ void DList<T>::adopt(IteratorT& entry)
 }
 
 
-template <class T>
-void DList<T>::adopt(IteratorT& entry,
-                     IteratorT& at)
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::adopt(IteratorT& entry,
+                               IteratorT& at)
 {
   GeAssert(entry.mNode);
   GeAssert(entry.mList);
@@ -351,19 +344,22 @@ void DList<T>::adopt(IteratorT& entry,
   Node* node(entry.mNode);
   Node* postNode(at.mNode);
 
-  // move node out of source list
-  ++entry;
-  if (node->mPrevious) {
-    node->mPrevious->mNext = node->mNext;
-  } else {
-    entry.mList->mFront = node->mNext;
-  }
-  if (node->mNext) {
-    node->mNext->mPrevious = node->mPrevious;
+  // move node out of source list (if our allocator doesn't allow to take over
+  // nodes of other lists, we replace the node by a copy)
+  if (!ALLOCATOR<Node>::cCanTransferNodes) {
+    Node* copy = newNode(0, 0, node->mData);
+    if (!copy) {
+      ERRLOG("DList::adopt(): could not allocate new node for list");
+      return;
+    }
+    ++entry;
+    entry.mList->unlink(node);
+    entry.mList->deleteNode(node);
+    node = copy;
   } else {
-    entry.mList->mBack = node->mPrevious;
+    ++entry;
+    entry.mList->unlink(node);
   }
-  --entry.mList->mSize;
 
   // append node to list
   if (!postNode) {
@@ -380,7 +376,7 @@ void DList<T>::adopt(IteratorT& entry,
     node->mNext = postNode;
     postNode->mPrevious = node;
     if (node->mPrevious) {
-      postNode->mPrevious->mNext = node;
+      node->mPrevious->mNext = node;
     } else {
       mFront = node;
     }
@@ -390,12 +386,23 @@ void DList<T>::adopt(IteratorT& entry,
 }
 
 
-template <class T>
-void DList<T>::adoptFront(DList& other)
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::adoptFront(DList& other)
 {
   GeAssert(&other != this);
 
   if (!other.mFront) { return; }
+
+  // if our allocator doesn't allow to take over nodes of other lists, we copy
+  // the values and empty the other list afterwards
+  if (!ALLOCATOR<Node>::cCanTransferNodes) {
+    for (const Node* node=other.mBack; node; node=node->mPrevious) {
+      if (!pushFront(node->mData)) { return; }
+    }
+    other.erase();
+    return;
+  }
+
   if (mFront) {
     mFront->mPrevious = other.mBack;
     other.mBack->mNext = mFront;
@@ -409,12 +416,23 @@ void DList<T>::adoptFront(DList& other)
 }
 
 
-template <class T>
-void DList<T>::adoptBack(DList& other)
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::adoptBack(DList& other)
 {
   GeAssert(&other != this);
 
   if (!other.mFront) { return; }
+
+  // if our allocator doesn't allow to take over nodes of other lists, we copy
+  // the values and empty the other list afterwards
+  if (!ALLOCATOR<Node>::cCanTransferNodes) {
+    for (const Node* node=other.mFront; node; node=node->mNext) {
+      if (!pushBack(node->mData)) { return; }
+    }
+    other.erase();
+    return;
+  }
+
   if (mBack) {
     mBack->mNext = other.mFront;
     other.mFront->mPrevious = mBack;
@@ -428,155 +446,214 @@ void DList<T>::adoptBack(DList& other)
 }
 
 
-template <class T>
-inline SizeT DList<T>::size() const
+template <class T, template <class> class ALLOCATOR>
+inline SizeT DList<T,ALLOCATOR>::size() const
 {
   return mSize;
 }
 
 
-template <class T>
-void DList<T>::erase()
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::erase()
 {
   Node* node(mFront);
   Node* temp;
   while (node) {
     temp = node->mNext;
-    gDelete(node);
+    deleteNode(node);
     node = temp;
   }
+  mAllocator.release();
   mFront = 0;
   mBack = 0;
   mSize = 0;
 }
 
 
-template <class T>
-inline const T& DList<T>::front() const
+template <class T, template <class> class ALLOCATOR>
+inline const T& DList<T,ALLOCATOR>::front() const
 {
   GeAssert(mFront);
   return mFront->mData;
 }
 
 
-template <class T>
-inline T& DList<T>::front()
+template <class T, template <class> class ALLOCATOR>
+inline T& DList<T,ALLOCATOR>::front()
 {
   GeAssert(mFront);
   return mFront->mData;
 }
 
 
-template <class T>
-inline const T& DList<T>::back() const
+template <class T, template <class> class ALLOCATOR>
+inline const T& DList<T,ALLOCATOR>::back() const
 {
   GeAssert(mBack);
   return mBack->mData;
 }
 
 
-template <class T>
-inline T& DList<T>::back()
+template <class T, template <class> class ALLOCATOR>
+inline T& DList<T,ALLOCATOR>::back()
 {
   GeAssert(mBack);
   return mBack->mData;
 }
 
 
-template <class T>
-inline typename DList<T>::ConstIteratorT DList<T>::begin() const
+template <class T, template <class> class ALLOCATOR>
+inline typename DList<T,ALLOCATOR>::ConstIteratorT DList<T,ALLOCATOR>::begin() const
 {
   return ConstIteratorT(*this, mFront);
 }
 
 
-template <class T>
-inline typename DList<T>::IteratorT DList<T>::begin()
+template <class T, template <class> class ALLOCATOR>
+inline typename DList<T,ALLOCATOR>::IteratorT DList<T,ALLOCATOR>::begin()
 {
   return IteratorT(*this, mFront);
 }
 
 
-template <class T>
-inline typename DList<T>::ConstIteratorT DList<T>::end() const
+template <class T, template <class> class ALLOCATOR>
+inline typename DList<T,ALLOCATOR>::ConstIteratorT DList<T,ALLOCATOR>::end() const
 {
   return ConstIteratorT(*this, mBack);
 }
 
 
-template <class T>
-inline typename DList<T>::IteratorT DList<T>::end()
+template <class T, template <class> class ALLOCATOR>
+inline typename DList<T,ALLOCATOR>::IteratorT DList<T,ALLOCATOR>::end()
 {
   return IteratorT(*this, mBack);
 }
 
 
 
+/// Allocates and constructs a new node with a default constructed value.
+///
+/// @return
+///   Pointer to the new node or NULL if we ran out of memory.
+template <class T, template <class> class ALLOCATOR>
+inline typename DList<T,ALLOCATOR>::Node* DList<T,ALLOCATOR>::newNode(Node* previous,
+                                                                      Node* next)
+{
+  void* memory = mAllocator.allocate();
+  return memory ? new (memory) Node(previous, next) : 0;
+}
+
+
+/// Allocates and constructs a new node, which stores a copy of a value.
+///
+/// @return
+///   Pointer to the new node or NULL if we ran out of memory.
+template <class T, template <class> class ALLOCATOR>
+inline typename DList<T,ALLOCATOR>::Node* DList<T,ALLOCATOR>::newNode(Node*    previous,
+                                                                      Node*    next,
+                                                                      const T& value)
+{
+  void* memory = mAllocator.allocate();
+  return memory ? new (memory) Node(previous, next, value) : 0;
+}
+
+
+/// Destroys a node, passes it back to the allocator and sets the pointer to
+/// NULL (like gDelete()).
+template <class T, template <class> class ALLOCATOR>
+inline void DList<T,ALLOCATOR>::deleteNode(Node*& node)
+{
+  if (!node)  return;
+  node->~Node();
+  mAllocator.deallocate(node);
+  node = 0;
+}
+
+
+/// Removes a node from the list without deleting it.
+template <class T, template <class> class ALLOCATOR>
+void DList<T,ALLOCATOR>::unlink(Node* node)
+{
+  if (node->mPrevious) {
+    node->mPrevious->mNext = node->mNext;
+  } else {
+    mFront = node->mNext;
+  }
+  if (node->mNext) {
+    node->mNext->mPrevious = node->mPrevious;
+  } else {
+    mBack = node->mPrevious;
+  }
+  --mSize;
+}
+
+
+
 /*****************************************************************************
  * Implementation of DListIterator
  *****************************************************************************/
 
-template <class T>
-DListIterator<T>::DListIterator()
+template <class T, template <class> class ALLOCATOR>
+DListIterator<T,ALLOCATOR>::DListIterator()
 : mList(0), mNode(0)
 {}
 
 
-template <class T>
-DListIterator<T>::DListIterator(ContainerT& list,
-                                NodeT*      node)
+template <class T, template <class> class ALLOCATOR>
+DListIterator<T,ALLOCATOR>::DListIterator(ContainerT& list,
+                                          NodeT*      node)
 : mList(&list), mNode(node)
 {}
 
 
-template <class T>
-inline Bool DListIterator<T>::isValid() const
+template <class T, template <class> class ALLOCATOR>
+inline Bool DListIterator<T,ALLOCATOR>::isValid() const
 {
   return (mNode != 0);
 }
 
 
-template <class T>
-inline Bool DListIterator<T>::isFront() const
+template <class T, template <class> class ALLOCATOR>
+inline Bool DListIterator<T,ALLOCATOR>::isFront() const
 {
   if (!mList) { return FALSE; }
   return (mNode == mList->mFront);
 }
 
 
-template <class T>
-inline Bool DListIterator<T>::isBack() const
+template <class T, template <class> class ALLOCATOR>
+inline Bool DListIterator<T,ALLOCATOR>::isBack() const
 {
   if (!mList) { return FALSE; }
   return (mNode == mList->mBack);
 }
 
 
-template <class T>
-inline typename DListIterator<T>::ContainerT* DListIterator<T>::container()
+template <class T, template <class> class ALLOCATOR>
+inline typename DListIterator<T,ALLOCATOR>::ContainerT* DListIterator<T,ALLOCATOR>::container()
 {
   return mList;
 }
 
 
-template <class T>
-inline T& DListIterator<T>::operator*() const
+template <class T, template <class> class ALLOCATOR>
+inline T& DListIterator<T,ALLOCATOR>::operator*() const
 {
   GeAssert(isValid());
   return mNode->mData;
 }
 
 
-template <class T>
-inline T* DListIterator<T>::operator->() const
+template <class T, template <class> class ALLOCATOR>
+inline T* DListIterator<T,ALLOCATOR>::operator->() const
 {
   GeAssert(isValid());
   return &(mNode->mData);
 }
 
 
-template <class T>
-inline DListIterator<T>& DListIterator<T>::operator++()
+template <class T, template <class> class ALLOCATOR>
+inline DListIterator<T,ALLOCATOR>& DListIterator<T,ALLOCATOR>::operator++()
 {
   GeAssert(isValid());
   mNode = mNode->mNext;
@@ -584,8 +661,8 @@ inline DListIterator<T>& DListIterator<T>::operator++()
 }
 
 
-template <class T>
-inline DListIterator<T>& DListIterator<T>::operator--()
+template <class T, template <class> class ALLOCATOR>
+inline DListIterator<T,ALLOCATOR>& DListIterator<T,ALLOCATOR>::operator--()
 {
   GeAssert(isValid());
   mNode = mNode->mPrevious;
@@ -593,32 +670,32 @@ inline DListIterator<T>& DListIterator<T>::operator--()
 }
 
 
-template <class T>
-inline Bool DListIterator<T>::operator==(const ConstDListIterator<T>& other) const
+template <class T, template <class> class ALLOCATOR>
+inline Bool DListIterator<T,ALLOCATOR>::operator==(const ConstDListIterator<T,ALLOCATOR>& other) const
 {
   GeAssert(mList == other.mList);
   return (other.mNode == mNode);
 }
 
 
-template <class T>
-inline Bool DListIterator<T>::operator==(const DListIterator<T>& other) const
+template <class T, template <class> class ALLOCATOR>
+inline Bool DListIterator<T,ALLOCATOR>::operator==(const DListIterator<T,ALLOCATOR>& other) const
 {
   GeAssert(mList == other.mList);
   return (other.mNode == mNode);
 }
 
 
-template <class T>
-inline Bool DListIterator<T>::operator!=(const ConstDListIterator<T>& other) const
+template <class T, template <class> class ALLOCATOR>
+inline Bool DListIterator<T,ALLOCATOR>::operator!=(const ConstDListIterator<T,ALLOCATOR>& other) const
 {
   GeAssert(mList == other.mList);
   return (other.mNode != mNode);
 }
 
 
-template <class T>
-inline Bool DListIterator<T>::operator!=(const DListIterator<T>& other) const
+template <class T, template <class> class ALLOCATOR>
+inline Bool DListIterator<T,ALLOCATOR>::operator!=(const DListIterator<T,ALLOCATOR>& other) const
 {
   GeAssert(mList == other.mList);
   return (other.mNode != mNode);
@@ -630,27 +707,27 @@ inline Bool DListIterator<T>::operator!=(const DListIterator<T>& other) const
  * Implementation of ConstDListIterator
  *****************************************************************************/
 
-template <class T>
-ConstDListIterator<T>::ConstDListIterator()
+template <class T, template <class> class ALLOCATOR>
+ConstDListIterator<T,ALLOCATOR>::ConstDListIterator()
 : mList(0),mNode(0)
 {}
 
 
-template <class T>
-ConstDListIterator<T>::ConstDListIterator(const ContainerT& list,
-                                          const NodeT*      node)
+template <class T, template <class> class ALLOCATOR>
+ConstDListIterator<T,ALLOCATOR>::ConstDListIterator(const ContainerT& list,
+                                                    const NodeT*      node)
 : mList(&list), mNode(node)
 {}
 
 
-template <class T>
-ConstDListIterator<T>::ConstDListIterator(const DListIterator<T>& other)
+template <class T, template <class> class ALLOCATOR>
+ConstDListIterator<T,ALLOCATOR>::ConstDListIterator(const DListIterator<T,ALLOCATOR>& other)
 : mList(other.mList), mNode(other.mNode)
 {}
 
 
-template <class T>
-ConstDListIterator<T>& ConstDListIterator<T>::operator=(const DListIterator<T>& other)
+template <class T, template <class> class ALLOCATOR>
+ConstDListIterator<T,ALLOCATOR>& ConstDListIterator<T,ALLOCATOR>::operator=(const DListIterator<T,ALLOCATOR>& other)
 {
   mList = other.mList;
   mNode = other.mNode;
@@ -658,54 +735,54 @@ ConstDListIterator<T>& ConstDListIterator<T>::operator=(const DListIterator<T>&
 }
 
 
-template <class T>
-inline Bool ConstDListIterator<T>::isValid() const
+template <class T, template <class> class ALLOCATOR>
+inline Bool ConstDListIterator<T,ALLOCATOR>::isValid() const
 {
   return (mNode != 0);
 }
 
 
-template <class T>
-inline Bool ConstDListIterator<T>::isFront() const
+template <class T, template <class> class ALLOCATOR>
+inline Bool ConstDListIterator<T,ALLOCATOR>::isFront() const
 {
   if (!mList) { return FALSE; }
   return (mNode == mList->mFront);
 }
 
 
-template <class T>
-inline Bool ConstDListIterator<T>::isBack() const
+template <class T, template <class> class ALLOCATOR>
+inline Bool ConstDListIterator<T,ALLOCATOR>::isBack() const
 {
   if (!mList) { return FALSE; }
   return (mNode == mList->mBack);
 }
 
 
-template <class T>
-inline const typename ConstDListIterator<T>::ContainerT* ConstDListIterator<T>::container() const
+template <class T, template <class> class ALLOCATOR>
+inline const typename ConstDListIterator<T,ALLOCATOR>::ContainerT* ConstDListIterator<T,ALLOCATOR>::container() const
 {
   return mList;
 }
 
 
-template <class T>
-inline const T& ConstDListIterator<T>::operator*() const
+template <class T, template <class> class ALLOCATOR>
+inline const T& ConstDListIterator<T,ALLOCATOR>::operator*() const
 {
   GeAssert(isValid());
   return mNode->mData;
 }
 
 
-template <class T>
-inline const T* ConstDListIterator<T>::operator->() const
+template <class T, template <class> class ALLOCATOR>
+inline const T* ConstDListIterator<T,ALLOCATOR>::operator->() const
 {
   GeAssert(isValid());
   return &(mNode->mData);
 }
 
 
-template <class T>
-inline ConstDListIterator<T>& ConstDListIterator<T>::operator++()
+template <class T, template <class> class ALLOCATOR>
+inline ConstDListIterator<T,ALLOCATOR>& ConstDListIterator<T,ALLOCATOR>::operator++()
 {
   GeAssert(isValid());
   mNode = mNode->mNext;
@@ -713,8 +790,8 @@ inline ConstDListIterator<T>& ConstDListIterator<T>::operator++()
 }
 
 
-template <class T>
-inline ConstDListIterator<T>& ConstDListIterator<T>::operator--()
+template <class T, template <class> class ALLOCATOR>
+inline ConstDListIterator<T,ALLOCATOR>& ConstDListIterator<T,ALLOCATOR>::operator--()
 {
   GeAssert(isValid());
   mNode = mNode->mPrevious;
@@ -722,32 +799,32 @@ inline ConstDListIterator<T>& ConstDListIterator<T>::operator--()
 }
 
 
-template <class T>
-inline Bool ConstDListIterator<T>::operator==(const ConstDListIterator<T>& other) const
+template <class T, template <class> class ALLOCATOR>
+inline Bool ConstDListIterator<T,ALLOCATOR>::operator==(const ConstDListIterator<T,ALLOCATOR>& other) const
 {
   GeAssert(mList == other.mList);
   return (other.mNode != mNode);
 }
 
 
-template <class T>
-inline Bool ConstDListIterator<T>::operator==(const DListIterator<T>& other) const
+template <class T, template <class> class ALLOCATOR>
+inline Bool ConstDListIterator<T,ALLOCATOR>::operator==(const DListIterator<T,ALLOCATOR>& other) const
 {
   GeAssert(mList == other.mList);
   return (other.mNode != mNode);
 }
 
 
-template <class T>
-inline Bool ConstDListIterator<T>::operator!=(const ConstDListIterator<T>& other) const
+template <class T, template <class> class ALLOCATOR>
+inline Bool ConstDListIterator<T,ALLOCATOR>::operator!=(const ConstDListIterator<T,ALLOCATOR>& other) const
 {
   GeAssert(mList == other.mList);
   return (other.mNode != mNode);
 }
 
 
-template <class T>
-inline Bool ConstDListIterator<T>::operator!=(const DListIterator<T>& other) const
+template <class T, template <class> class ALLOCATOR>
+inline Bool ConstDListIterator<T,ALLOCATOR>::operator!=(const DListIterator<T,ALLOCATOR>& other) const
 {
   GeAssert(mList == other.mList);
   return (other.mNode != mNode);
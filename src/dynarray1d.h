@@ -30,6 +30,7 @@
 
 #include <c4d.h>
 
+#include "arraytraits.h"
 #include "utilities.h"
 
 
@@ -40,11 +41,15 @@
  manually, if needed.
 
  WARNING: During a grow operation the array data will be copied into a new
-          (larger array). This copy is done bitwise, i.e. not using the copy
-          operator. As a consequence you should not keep any pointers to the
-          entries after a append(), push(), reserve() or adaptCapacity(). The
-          same applies to linking entries against each other using memory
-          addresses (i.e. pointers).
+          (larger array). As a consequence you should not keep any pointers
+          to the entries after a append(), emplace(), push(), pushSwap(),
+          reserve() or adaptCapacity(). The same applies to linking entries
+          against each other using memory addresses (i.e. pointers).
+
+ Arrays of trivial types (see ArrayTraits) are allocated uninitialised and
+ copied with memcpy(). Arrays of all other types are default constructed and
+ copied entry by entry with the copy operator. Values can be moved into the
+ array without copying them via pushSwap().
 
  The template type has to support the following functions:
  - default constructor ( T::T() )
@@ -84,7 +89,9 @@ class DynArray1D
     inline T&       back(void);
 
     inline Bool append(void);
+    inline T*   emplace(void);
     inline Bool push(const T& value);
+    inline Bool pushSwap(T& value);
     inline T    pop(void);
 
     void remove(SizeT pos);
@@ -92,9 +99,13 @@ class DynArray1D
     inline const T* arrayAddress(void) const;
     inline T*       arrayAddress(void);
 
+    void adopt(DynArray1D& other);
+
 
   private:
 
+    typedef ArrayStorage<T> StorageT;
+
     SizeT mSize;
     SizeT mCapacity;
     T*    mData;
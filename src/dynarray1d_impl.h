@@ -28,6 +28,8 @@
 
 
 
+#include <algorithm>
+
 #include "utilities.h"
 
 
@@ -62,8 +64,7 @@ DynArray1D<T>::~DynArray1D(void)
 }
 
 
-/// Constructs a new instance with a bitwise copy of the content of
-/// another instance.
+/// Constructs a new instance with a copy of the content of another instance.
 ///
 /// @param[in]  other
 ///   The other array to copy the content from.
@@ -75,8 +76,8 @@ DynArray1D<T>::DynArray1D(const DynArray1D& other)
 }
 
 
-/// Deallocates current content and creates a bitwise copy of the content
-/// of the other instance.
+/// Deallocates current content and creates a copy of the content of the other
+/// instance.
 ///
 /// @param[in]  other
 ///   The other array to copy the content from.
@@ -85,8 +86,8 @@ DynArray1D<T>::DynArray1D(const DynArray1D& other)
 template <class T>
 DynArray1D<T>& DynArray1D<T>::operator=(const DynArray1D& other)
 {
-  if (init(other.mSize, other.mCapacity) && other.mSize) {
-    memcpy(mData, other.mData, other.mSize*sizeof(T));
+  if ((this != &other) && init(other.mSize, other.mCapacity)) {
+    StorageT::copy(mData, other.mData, other.mSize);
   }
   return *this;
 }
@@ -115,7 +116,7 @@ Bool DynArray1D<T>::init(SizeT size, SizeT capacity)
   // if the array shoulf not be empty, allocate new memory block and update
   // members
   if (capacity > 0) {
-    if ((mData = bNew T[capacity]) == 0) {
+    if ((mData = StorageT::allocate(capacity)) == 0) {
       ERRLOG("DynArray1D::Init(): could not allocate array of size " + LLongToString(capacity));
       return FALSE;
     }
@@ -142,16 +143,12 @@ Bool DynArray1D<T>::reserve(SizeT capacity)
   // if we have enough memory allocated, return happily
   if (mCapacity >= capacity)  return TRUE;
 
-  // allocate new memory block
-  T* newData = bNew T[capacity];
+  // move data into a new memory block
+  T* newData = StorageT::reallocate(mData, mSize, capacity);
   if (!newData) {
-    ERRLOG("DynArray1D::reserve(): could not allocate new arrayof size " + LLongToString(size));
+    ERRLOG("DynArray1D::reserve(): could not allocate new array of size " + LLongToString(capacity));
     return FALSE;
   }
-
-  // copy data into new memory block and deallocate the old one
-  memcpy(mData, newData, mSize*sizeof(T));
-  bDelete(mData);
   mData = newData;
 
   // update capacity and return
@@ -173,16 +170,12 @@ Bool DynArray1D<T>::adaptCapacity(void)
     erase();
   // if the array is not empty, but its size doesn't match it's capacity:
   } else if (mSize != mCapacity) {
-    // allocate new memory block of correct size
-    T* newData = bNew T[mSize];
+    // move content into new memory block of correct size
+    T* newData = StorageT::reallocate(mData, mSize, mSize);
     if (!newData) {
       ERRLOG("DynArray1D::adaptCapacity(): could not allocate new array of size " + LLongToString(mSize));
       return FALSE;
     }
-    // copy content from old to new arrat
-    memcpy(newData, mData, mSize*sizeof(T));
-    // deallocate old memory and update members
-    bDelete(mData);
     mData = newData;
     mCapacity = mSize;
   }
@@ -215,8 +208,7 @@ void DynArray1D<T>::erase(void)
 {
   mSize = 0;
   mCapacity = 0;
-  bDelete(mData);
-  mData = 0;
+  StorageT::deallocate(mData);
 }
 
 
@@ -319,6 +311,19 @@ inline Bool DynArray1D<T>::append(void)
 }
 
 
+/// Increases the size of the array by 1 and returns the new entry, which can
+/// then be initialised in place.
+///
+/// @return
+///   Pointer to the new entry or NULL if we ran out of memory.
+template <class T>
+inline T* DynArray1D<T>::emplace(void)
+{
+  if (!append())  return 0;
+  return &mData[mSize-1];
+}
+
+
 /// Copies a value to the end of the array. The array size will be increased
 /// by 1.
 ///
@@ -338,6 +343,24 @@ inline Bool DynArray1D<T>::push(const T& value)
 }
 
 
+/// Moves a value to the end of the array by swapping it with the new entry,
+/// i.e. types like strings don't get copied. The array size will be increased
+/// by 1.
+///
+/// @param[in,out]  value
+///   The value to move. It gets the value of the previously unused entry
+///   afterwards (which is undefined for trivial types).
+/// @return
+///   TRUE if successful, FALSE if not.
+template <class T>
+inline Bool DynArray1D<T>::pushSwap(T& value)
+{
+  if (!append())  return FALSE;
+  std::swap(mData[mSize-1], value);
+  return TRUE;
+}
+
+
 /// Removes the last entry from the array and returns it's value.
 template <class T>
 inline T DynArray1D<T>::pop(void)
@@ -364,6 +387,26 @@ inline T* DynArray1D<T>::arrayAddress(void)
 }
 
 
+/// Deallocates the current content and adopts the data from another instance.
+/// The memory will be owned by this instance and the other one will be empty
+/// afterwards.
+///
+/// @param[in]  other
+///   The instance from where the data shall be adopted from.
+template <class T>
+void DynArray1D<T>::adopt(DynArray1D& other)
+{
+  if (this == &other)  return;
+  erase();
+  mData     = other.mData;
+  mSize     = other.mSize;
+  mCapacity = other.mCapacity;
+  other.mData     = 0;
+  other.mSize     = 0;
+  other.mCapacity = 0;
+}
+
+
 /// Removes the entry at position POS. Size() will be one less afterwards.
 template <class T>
 void DynArray1D<T>::remove(SizeT pos)
@@ -394,18 +437,14 @@ Bool DynArray1D<T>::increaseCapacity(void)
     return FALSE;
   }
 
-  // allocate new (larger) memory block
-  T* newData = bNew T[newCapacity];
+  // move data into new (larger) memory block
+  T* newData = StorageT::reallocate(mData, mSize, newCapacity);
   if (!newData) {
     ERRLOG("DynArray1D<T>::increaseCapacity(): could not allocate new array of size " + LLongToString(newCapacity));
     return FALSE;
   }
 
-  // copy from to new memory
-  memcpy(newData, mData, mSize*sizeof(T));
-
-  // deallocate old memory, update members and return
-  bDelete(mData);
+  // update members and return
   mData = newData;
   mCapacity = newCapacity;
   return TRUE;
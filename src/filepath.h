@@ -75,7 +75,7 @@ public:
 
 private:
 
-  typedef DList<String> TokensT;
+  typedef DList<String, NodePool> TokensT;
 
   CHAR    mDrive;
   Bool    mIsAbsolute;
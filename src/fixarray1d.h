@@ -30,6 +30,7 @@
 
 #include <c4d.h>
 
+#include "arraytraits.h"
 #include "utilities.h"
 
 
@@ -39,12 +40,22 @@
  functionality than POD arrays, except safety checks and automatic
  deallocation.
 
+ Arrays of trivial types (see ArrayTraits) are allocated uninitialised (or
+ cleared via initWithZero()) and copied with memcpy(). Arrays of all other
+ types are default constructed and copied entry by entry.
+
+ Arrays of trivial types can be aligned to ALIGNMENT bytes, which defaults to
+ the alignment declared for T (see ArrayTraits), i.e. the arrays of geometry
+ types are aligned for SIMD loads. As aligned arrays need their own memory
+ layout, memory passed to setArrayAddress() must come from release() of an
+ array with the same element type and alignment.
+
  The template type has to support the following functions:
  - default constructor ( T::T() )
  - default destructor ( T::~T() )
  - copy operator ( T::operator=(const T&) )
 *//****************************************************************************/
-template <class T>
+template <class T, int ALIGNMENT=ArrayTraits<T>::cAlignment>
 class FixArray1D
 {
   public:
@@ -56,6 +67,7 @@ class FixArray1D
     FixArray1D& operator=(const FixArray1D& other);
 
     Bool init(SizeT size=0);
+    Bool initWithZero(SizeT size);
     void fill(const T& value);
     void fillWithZero(void);
     void erase(void);
@@ -74,12 +86,15 @@ class FixArray1D
     inline T*       arrayAddress(void);
 
     void setArrayAddress(T* data, SizeT size);
+    T*   release(void);
 
     void adopt(FixArray1D& other);
 
 
   private:
 
+    typedef ArrayStorage<T, ArrayTraits<T>::cIsTrivial, ALIGNMENT> StorageT;
+
     SizeT mSize;
     T*    mData;
 };
@@ -33,12 +33,12 @@
  *******************************************************************************/
 
 /// Constructs a new instance. Allocated memory won't get cleared (except
-/// T initialises itself in the default constructor).
+/// T is not trivial and initialises itself in the default constructor).
 ///
 /// @param[in]  size
 ///   If set to !=0 the internal array will be allocated.
-template <class T>
-FixArray1D<T>::FixArray1D(SizeT size)
+template <class T, int ALIGNMENT>
+FixArray1D<T,ALIGNMENT>::FixArray1D(SizeT size)
 : mSize(0), mData(0)
 {
   init(size);
@@ -46,58 +46,57 @@ FixArray1D<T>::FixArray1D(SizeT size)
 
 
 /// Destroys a FixArray1D instance and frees all allocated resources.
-template <class T>
-FixArray1D<T>::~FixArray1D(void)
+template <class T, int ALIGNMENT>
+FixArray1D<T,ALIGNMENT>::~FixArray1D(void)
 {
   erase();
 }
 
 
-/// Constructs a new instance with a bitwise copy of the content of
-/// another instance.
+/// Constructs a new instance with a copy of the content of another instance.
 ///
 /// @param[in]  other
 ///   The other array to copy the content from.
-template <class T>
-FixArray1D<T>::FixArray1D(const FixArray1D& other)
+template <class T, int ALIGNMENT>
+FixArray1D<T,ALIGNMENT>::FixArray1D(const FixArray1D& other)
 : mSize(0), mData(0)
 {
   *this = other;
 }
 
 
-/// Deallocates current content and creates a bitwise copy of the content
-/// of the other instance.
+/// Deallocates current content and creates a copy of the content of the other
+/// instance.
 ///
 /// @param[in]  other
 ///   The other array to copy the content from.
 /// @return
 ///   A reference to this instance.
-template <class T>
-FixArray1D<T>& FixArray1D<T>::operator=(const FixArray1D& other)
+template <class T, int ALIGNMENT>
+FixArray1D<T,ALIGNMENT>& FixArray1D<T,ALIGNMENT>::operator=(const FixArray1D& other)
 {
-  if (init(other.mSize) && other.mSize) {
-    memcpy(mData, other.mData, other.mSize*sizeof(T));
+  if ((this != &other) && init(other.mSize)) {
+    StorageT::copy(mData, other.mData, other.mSize);
   }
   return *this;
 }
 
 
 /// Deallocates current content and allocates a new array. The new memory
-/// won't get cleared (except T initialises itself in the default
-/// constructor).
+/// won't get cleared (except T is not trivial and initialises itself in the
+/// default constructor).
 ///
 /// @param[in]  size
 ///   The size of the new array.
 /// @return
 ///   FALSE if allocation failed, otherwise TRUE.
-template <class T>
-Bool FixArray1D<T>::init(SizeT size)
+template <class T, int ALIGNMENT>
+Bool FixArray1D<T,ALIGNMENT>::init(SizeT size)
 {
   GeAssert(size >= 0);
   erase();
   if (size > 0) {
-    if ((mData = bNew T[size]) == 0) {
+    if ((mData = StorageT::allocate(size)) == 0) {
       ERRLOG("FixArray1D::init(): could not allocate array of size " + LLongToString(size));
       return FALSE;
     }
@@ -107,20 +106,44 @@ Bool FixArray1D<T>::init(SizeT size)
 }
 
 
+/// Deallocates current content and allocates a new array, whose bytes are all
+/// set to 0. For trivial types that's cheaper than init() plus
+/// fillWithZero(), as the memory gets cleared during allocation.
+///
+/// @param[in]  size
+///   The size of the new array.
+/// @return
+///   FALSE if allocation failed, otherwise TRUE.
+template <class T, int ALIGNMENT>
+Bool FixArray1D<T,ALIGNMENT>::initWithZero(SizeT size)
+{
+  GeAssert(size >= 0);
+  erase();
+  if (size > 0) {
+    if ((mData = StorageT::allocateZeroed(size)) == 0) {
+      ERRLOG("FixArray1D::initWithZero(): could not allocate array of size " + LLongToString(size));
+      return FALSE;
+    }
+    mSize = size;
+  }
+  return TRUE;
+}
+
+
 /// Copies a value to all entries of array.
 ///
 /// @param[in]  value
 ///   The value to copy.
-template <class T>
-void FixArray1D<T>::fill(const T& value)
+template <class T, int ALIGNMENT>
+void FixArray1D<T,ALIGNMENT>::fill(const T& value)
 {
   for (SizeT c=0; c<mSize; ++c)  mData[c] = value;
 }
 
 
 /// Sets all bytes of the array to 0.
-template <class T>
-void FixArray1D<T>::fillWithZero(void)
+template <class T, int ALIGNMENT>
+void FixArray1D<T,ALIGNMENT>::fillWithZero(void)
 {
   if (mSize) {
     memset(mData, 0, sizeof(T)*mSize);
@@ -129,17 +152,17 @@ void FixArray1D<T>::fillWithZero(void)
 
 
 /// Deallocates the current content.
-template <class T>
-void FixArray1D<T>::erase(void)
+template <class T, int ALIGNMENT>
+void FixArray1D<T,ALIGNMENT>::erase(void)
 {
-  bDelete(mData);
+  StorageT::deallocate(mData);
   mSize = 0;
 }
 
 
 /// Returns the size of the array.
-template <class T>
-inline SizeT FixArray1D<T>::size(void) const  
+template <class T, int ALIGNMENT>
+inline SizeT FixArray1D<T,ALIGNMENT>::size(void) const  
 { 
   return mSize; 
 }
@@ -151,8 +174,8 @@ inline SizeT FixArray1D<T>::size(void) const
 ///   The position of the value to retrieve. Must be >=0 and <size()!
 /// @return
 ///   A constant reference to the value.
-template <class T>
-inline const T& FixArray1D<T>::operator[](SizeT pos) const
+template <class T, int ALIGNMENT>
+inline const T& FixArray1D<T,ALIGNMENT>::operator[](SizeT pos) const
 {
   GeAssert((pos >= 0) && (pos < mSize));
   return mData[pos];
@@ -165,8 +188,8 @@ inline const T& FixArray1D<T>::operator[](SizeT pos) const
 ///   The position of the value to retrieve. Must be >=0 and <size()!
 /// @return
 ///   A reference to the value.
-template <class T>
-inline T& FixArray1D<T>::operator[](SizeT pos)
+template <class T, int ALIGNMENT>
+inline T& FixArray1D<T,ALIGNMENT>::operator[](SizeT pos)
 {
   GeAssert((pos >= 0) && (pos < mSize));
   return mData[pos];
@@ -175,8 +198,8 @@ inline T& FixArray1D<T>::operator[](SizeT pos)
 
 /// Returns a constant reference to the first entry of the array.
 /// (size() must be !=0)
-template <class T>
-inline const T& FixArray1D<T>::front(void) const
+template <class T, int ALIGNMENT>
+inline const T& FixArray1D<T,ALIGNMENT>::front(void) const
 {
   GeAssert(mSize >= 0);
   return mData[0];
@@ -185,8 +208,8 @@ inline const T& FixArray1D<T>::front(void) const
 
 /// Returns a non-constant reference to the first entry of the array.
 /// (size() must be !=0)
-template <class T>
-inline T& FixArray1D<T>::front(void)
+template <class T, int ALIGNMENT>
+inline T& FixArray1D<T,ALIGNMENT>::front(void)
 {
   GeAssert(mSize >= 0);
   return mData[0];
@@ -195,8 +218,8 @@ inline T& FixArray1D<T>::front(void)
 
 /// Returns a constant reference to the last entry of the array.
 /// (size() must be !=0)
-template <class T>
-inline const T& FixArray1D<T>::back(void) const
+template <class T, int ALIGNMENT>
+inline const T& FixArray1D<T,ALIGNMENT>::back(void) const
 {
   GeAssert(mSize >= 0);
   return mData[mSize-1];
@@ -205,8 +228,8 @@ inline const T& FixArray1D<T>::back(void) const
 
 /// Returns a non-constant reference to the last entry of the array.
 /// (size() must be !=0)
-template <class T>
-inline T& FixArray1D<T>::back(void)
+template <class T, int ALIGNMENT>
+inline T& FixArray1D<T,ALIGNMENT>::back(void)
 {
   GeAssert(mSize >= 0);
   return mData[mSize-1];
@@ -214,16 +237,16 @@ inline T& FixArray1D<T>::back(void)
 
 
 /// Returns a constant pointer to the internal data.
-template <class T>
-inline const T* FixArray1D<T>::arrayAddress(void) const  
+template <class T, int ALIGNMENT>
+inline const T* FixArray1D<T,ALIGNMENT>::arrayAddress(void) const  
 { 
   return mData; 
 }
 
 
 /// Returns a pointer to the internal data.
-template <class T>
-inline T* FixArray1D<T>::arrayAddress(void)  
+template <class T, int ALIGNMENT>
+inline T* FixArray1D<T,ALIGNMENT>::arrayAddress(void)  
 { 
   return mData; 
 }
@@ -231,30 +254,50 @@ inline T* FixArray1D<T>::arrayAddress(void)
 
 /// Allows you to specify the internal data. After that the instance owns
 /// the memory. You can pass in a NULL pointer, but the specified size must
-/// be 0 then.
+/// be 0 then. Arrays of trivial types must have been allocated with the C4D
+/// memory functions (GeAlloc() etc., like the arrays returned by the SDK),
+/// arrays of other types with bNew. Aligned arrays (ALIGNMENT != 0) must have
+/// been obtained via release() of an array of the same type.
 ///
 /// @param[in]  data
 ///   The pointer to the array to pass to instance.
 /// @param[in]  size
 ///   The size of the passed in array.
-template <class T>
-void FixArray1D<T>::setArrayAddress(T* data, SizeT size)
+template <class T, int ALIGNMENT>
+void FixArray1D<T,ALIGNMENT>::setArrayAddress(T* data, SizeT size)
 {
   GeAssert((!data && !size) || (data && size));
+  GeAssert(!ALIGNMENT || !((size_t)data & (size_t)(ALIGNMENT-1)));
   erase();
   mData = data;
   mSize = size;
 }
 
 
+/// Gives up the ownership of the internal data and returns it. The instance
+/// will be empty afterwards. The memory can be passed to setArrayAddress() of
+/// an array of the same type.
+///
+/// @return
+///   The pointer to the internal array (NULL if the array was empty).
+template <class T, int ALIGNMENT>
+T* FixArray1D<T,ALIGNMENT>::release(void)
+{
+  T* data = mData;
+  mData = 0;
+  mSize = 0;
+  return data;
+}
+
+
 /// Deallocates the current content and adopts the data from another instance.
 /// The memory will be owned by this instance and the other one will be empty
 /// afterwards.
 ///
 /// @param[in]  other
 ///   The instance from where the data shall be adapted from.
-template <class T>
-void FixArray1D<T>::adopt(FixArray1D& other)
+template <class T, int ALIGNMENT>
+void FixArray1D<T,ALIGNMENT>::adopt(FixArray1D& other)
 {
   erase();
   mData = other.mData;
@@ -0,0 +1,620 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include <cmath>
+#include <cstddef>
+
+#include "geometrykernels.h"
+
+
+
+/*****************************************************************************
+ * Detection of the available SIMD implementations.
+ *
+ * LUXC4D_KERNELS_SSE2/AVX2 are defined if the compiler can build the
+ * corresponding kernels. LUXC4D_TARGET_SSE2/AVX2 enable the instruction set
+ * for a single function, so the rest of the plugin still runs on any CPU.
+ *****************************************************************************/
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#  include <intrin.h>
+#  include <emmintrin.h>
+#  define LUXC4D_KERNELS_SSE2  1
+#  define LUXC4D_TARGET_SSE2
+#  if _MSC_VER >= 1700
+#    include <immintrin.h>
+#    define LUXC4D_KERNELS_AVX2  1
+#    define LUXC4D_TARGET_AVX2
+#  endif
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#  if defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9))
+#    include <immintrin.h>
+#    define LUXC4D_KERNELS_SSE2  1
+#    define LUXC4D_KERNELS_AVX2  1
+#    define LUXC4D_TARGET_SSE2   __attribute__((target("sse2")))
+#    define LUXC4D_TARGET_AVX2   __attribute__((target("avx2")))
+#  elif defined(__SSE2__)
+#    include <emmintrin.h>
+#    define LUXC4D_KERNELS_SSE2  1
+#    define LUXC4D_TARGET_SSE2
+#  endif
+#endif
+
+
+
+/*****************************************************************************
+ * Scalar implementations.
+ *****************************************************************************/
+
+/// Gathers points via an index array, scales them and converts them from
+/// double to float. Y and Z are swapped, as C4D uses a left-handed coordinate
+/// system.
+static void scalePointsScalar(const double*                  points,
+                              const GeometryKernels::IndexT* indices,
+                              GeometryKernels::IndexT        count,
+                              double                         scale,
+                              float*                         result)
+{
+  for (GeometryKernels::IndexT i=0; i<count; ++i, result+=3) {
+    const double* point = points + 3*(size_t)indices[i];
+    result[0] = (float)(point[0] * scale);
+    result[1] = (float)(point[2] * scale);
+    result[2] = (float)(point[1] * scale);
+  }
+}
+
+
+/// Normalises normals in Lux coordinates. The squared length is summed up in
+/// the C4D order of the axes (X, Z, Y in Lux coordinates), so we get the same
+/// results as normalize() for the original C4D vectors. Normals with length 0
+/// are set to (1,0,0).
+static void normalizeNormalsScalar(float*                  normals,
+                                   GeometryKernels::IndexT count)
+{
+  for (GeometryKernels::IndexT i=0; i<count; ++i, normals+=3) {
+    float length = std::sqrt(normals[0]*normals[0] + normals[2]*normals[2] +
+                             normals[1]*normals[1]);
+    if (length != 0.0f) {
+      float factor = 1.0f / length;
+      normals[0] *= factor;
+      normals[1] *= factor;
+      normals[2] *= factor;
+    } else {
+      normals[0] = 1.0f;
+      normals[1] = 0.0f;
+      normals[2] = 0.0f;
+    }
+  }
+}
+
+
+/// Returns true if all 4 normals of each polygon are equal, i.e. if the
+/// squared distance of the 2nd, 3rd and 4th normal to the 1st normal is
+/// smaller than maxDistanceSquared.
+static bool equalPolygonNormalsScalar(const float*            normals,
+                                      GeometryKernels::IndexT polygonCount,
+                                      double                  maxDistanceSquared)
+{
+  for (GeometryKernels::IndexT poly=0; poly<polygonCount; ++poly, normals+=12) {
+    for (int corner=1; corner<4; ++corner) {
+      float dx = normals[corner*3]   - normals[0];
+      float dy = normals[corner*3+1] - normals[1];
+      float dz = normals[corner*3+2] - normals[2];
+      if (!(dx*dx + dy*dy + dz*dz < maxDistanceSquared))  return false;
+    }
+  }
+  return true;
+}
+
+
+/// Splits polygons into triangles - see GeometryKernels::triangulate().
+static GeometryKernels::IndexT triangulateScalar(const int*              polygons,
+                                                 GeometryKernels::IndexT polygonCount,
+                                                 int*                    triangles)
+{
+  GeometryKernels::IndexT triangleIndex = 0;
+  const int*              polygon = polygons;
+  for (GeometryKernels::IndexT poly=0; poly<polygonCount; ++poly, polygon+=4) {
+    triangles[triangleIndex++] = polygon[0];
+    triangles[triangleIndex++] = polygon[2];
+    triangles[triangleIndex++] = polygon[1];
+    if (polygon[2] != polygon[3]) {
+      triangles[triangleIndex++] = polygon[0];
+      triangles[triangleIndex++] = polygon[3];
+      triangles[triangleIndex++] = polygon[2];
+    }
+  }
+  return triangleIndex;
+}
+
+
+
+/*****************************************************************************
+ * SSE2 implementations.
+ *****************************************************************************/
+
+#ifdef LUXC4D_KERNELS_SSE2
+
+/// Converts 4 vectors stored as X,Y,Z triples in A, B and C into the vectors
+/// X, Y and Z, which contain the corresponding components of the 4 vectors.
+/// Works with SSE registers and AVX registers (per 128 bit lane).
+#define TRANSPOSE_AOS_TO_SOA(T, SHUFFLE, a, b, c, x, y, z)                    \
+  {                                                                           \
+    T u = SHUFFLE(b, c, _MM_SHUFFLE(1,1,2,2));                                \
+    T v = SHUFFLE(a, b, _MM_SHUFFLE(0,0,1,1));                                \
+    T w = SHUFFLE(b, c, _MM_SHUFFLE(2,2,3,3));                                \
+    x = SHUFFLE(a, u, _MM_SHUFFLE(2,0,3,0));                                  \
+    y = SHUFFLE(v, w, _MM_SHUFFLE(2,0,2,0));                                  \
+    v = SHUFFLE(a, b, _MM_SHUFFLE(1,1,2,2));                                  \
+    w = SHUFFLE(c, c, _MM_SHUFFLE(3,3,0,0));                                  \
+    z = SHUFFLE(v, w, _MM_SHUFFLE(2,0,2,0));                                  \
+  }
+
+/// The inverse of TRANSPOSE_AOS_TO_SOA().
+#define TRANSPOSE_SOA_TO_AOS(T, SHUFFLE, x, y, z, a, b, c)                    \
+  {                                                                           \
+    T v = SHUFFLE(x, y, _MM_SHUFFLE(0,0,0,0));                                \
+    T w = SHUFFLE(z, x, _MM_SHUFFLE(1,1,0,0));                                \
+    a = SHUFFLE(v, w, _MM_SHUFFLE(2,0,2,0));                                  \
+    v = SHUFFLE(y, z, _MM_SHUFFLE(1,1,1,1));                                  \
+    w = SHUFFLE(x, y, _MM_SHUFFLE(2,2,2,2));                                  \
+    b = SHUFFLE(v, w, _MM_SHUFFLE(2,0,2,0));                                  \
+    v = SHUFFLE(z, x, _MM_SHUFFLE(3,3,2,2));                                  \
+    w = SHUFFLE(y, z, _MM_SHUFFLE(3,3,3,3));                                  \
+    c = SHUFFLE(v, w, _MM_SHUFFLE(2,0,2,0));                                  \
+  }
+
+
+/// SSE2 version of scalePointsScalar(). Every point is written with one 16
+/// byte store, which overwrites the first component of the next point. So the
+/// last point is done by the scalar code.
+LUXC4D_TARGET_SSE2
+static void scalePointsSSE2(const double*                  points,
+                            const GeometryKernels::IndexT* indices,
+                            GeometryKernels::IndexT        count,
+                            double                         scale,
+                            float*                         result)
+{
+  if (!count)  return;
+  const __m128d factor = _mm_set1_pd(scale);
+  for (GeometryKernels::IndexT i=0; i+1<count; ++i, result+=3) {
+    const double* point = points + 3*(size_t)indices[i];
+    __m128d xy = _mm_loadu_pd(point);
+    __m128d xz = _mm_mul_pd(_mm_unpacklo_pd(xy, _mm_load_sd(point+2)), factor);
+    __m128d yy = _mm_mul_pd(_mm_unpackhi_pd(xy, xy), factor);
+    _mm_storeu_ps(result, _mm_movelh_ps(_mm_cvtpd_ps(xz), _mm_cvtpd_ps(yy)));
+  }
+  scalePointsScalar(points, indices+count-1, 1, scale, result);
+}
+
+
+/// SSE2 version of normalizeNormalsScalar(), which processes 4 normals at
+/// once. If the array is aligned to 16 bytes, aligned loads and stores are
+/// used.
+LUXC4D_TARGET_SSE2
+static void normalizeNormalsSSE2(float*                  normals,
+                                 GeometryKernels::IndexT count)
+{
+  const __m128 zero    = _mm_setzero_ps();
+  const __m128 one     = _mm_set1_ps(1.0f);
+  const bool   aligned = !((size_t)normals & 15);
+  GeometryKernels::IndexT i = 0;
+  for (; i+4<=count; i+=4, normals+=12) {
+    __m128 a, b, c, x, y, z;
+    if (aligned) {
+      a = _mm_load_ps(normals);
+      b = _mm_load_ps(normals+4);
+      c = _mm_load_ps(normals+8);
+    } else {
+      a = _mm_loadu_ps(normals);
+      b = _mm_loadu_ps(normals+4);
+      c = _mm_loadu_ps(normals+8);
+    }
+    TRANSPOSE_AOS_TO_SOA(__m128, _mm_shuffle_ps, a, b, c, x, y, z)
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x),
+                                                      _mm_mul_ps(z, z)),
+                                           _mm_mul_ps(y, y)));
+    __m128 valid  = _mm_cmpneq_ps(length, zero);
+    __m128 factor = _mm_div_ps(one, length);
+    x = _mm_or_ps(_mm_and_ps(valid, _mm_mul_ps(x, factor)), _mm_andnot_ps(valid, one));
+    y = _mm_and_ps(valid, _mm_mul_ps(y, factor));
+    z = _mm_and_ps(valid, _mm_mul_ps(z, factor));
+    TRANSPOSE_SOA_TO_AOS(__m128, _mm_shuffle_ps, x, y, z, a, b, c)
+    if (aligned) {
+      _mm_store_ps(normals,   a);
+      _mm_store_ps(normals+4, b);
+      _mm_store_ps(normals+8, c);
+    } else {
+      _mm_storeu_ps(normals,   a);
+      _mm_storeu_ps(normals+4, b);
+      _mm_storeu_ps(normals+8, c);
+    }
+  }
+  normalizeNormalsScalar(normals, count-i);
+}
+
+
+/// SSE2 version of equalPolygonNormalsScalar(). The distances of the normals
+/// 1, 1, 2 and 3 of a polygon to normal 0 are calculated at once and
+/// converted to double for the comparison.
+LUXC4D_TARGET_SSE2
+static bool equalPolygonNormalsSSE2(const float*            normals,
+                                    GeometryKernels::IndexT polygonCount,
+                                    double                  maxDistanceSquared)
+{
+  const __m128d maxDistance = _mm_set1_pd(maxDistanceSquared);
+  for (GeometryKernels::IndexT poly=0; poly<polygonCount; ++poly, normals+=12) {
+    // a = (x0 y0 z0 x1), b = (y1 z1 x2 y2), c = (z2 x3 y3 z3)
+    __m128 a = _mm_loadu_ps(normals);
+    __m128 b = _mm_loadu_ps(normals+4);
+    __m128 c = _mm_loadu_ps(normals+8);
+    // (x1 x1 x2 x3), (y1 y1 y2 y3), (z1 z1 z2 z3)
+    __m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,3,3));
+    __m128 y = _mm_shuffle_ps(b, _mm_shuffle_ps(b, c, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,0,0));
+    __m128 z = _mm_shuffle_ps(b, c, _MM_SHUFFLE(3,0,1,1));
+    // differences to normal 0
+    x = _mm_sub_ps(x, _mm_shuffle_ps(a, a, _MM_SHUFFLE(0,0,0,0)));
+    y = _mm_sub_ps(y, _mm_shuffle_ps(a, a, _MM_SHUFFLE(1,1,1,1)));
+    z = _mm_sub_ps(z, _mm_shuffle_ps(a, a, _MM_SHUFFLE(2,2,2,2)));
+    __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)),
+                                 _mm_mul_ps(z, z));
+    __m128d low  = _mm_cmplt_pd(_mm_cvtps_pd(distance), maxDistance);
+    __m128d high = _mm_cmplt_pd(_mm_cvtps_pd(_mm_movehl_ps(distance, distance)),
+                                maxDistance);
+    if (_mm_movemask_pd(_mm_and_pd(low, high)) != 3)  return false;
+  }
+  return true;
+}
+
+
+/// SSE2 version of triangulateScalar() without branches. Both triangles of a
+/// polygon are always written with 16 byte stores, but the output position
+/// only advances over the second triangle for quads. As this writes up to 7
+/// entries, the last 2 polygons are done by the scalar code.
+LUXC4D_TARGET_SSE2
+static GeometryKernels::IndexT triangulateSSE2(const int*              polygons,
+                                               GeometryKernels::IndexT polygonCount,
+                                               int*                    triangles)
+{
+  GeometryKernels::IndexT triangleIndex = 0;
+  GeometryKernels::IndexT poly = 0;
+  const int*              polygon = polygons;
+  for (; poly+2<polygonCount; ++poly, polygon+=4) {
+    __m128i indices = _mm_loadu_si128((const __m128i*)polygon);
+    _mm_storeu_si128((__m128i*)(triangles+triangleIndex),
+                     _mm_shuffle_epi32(indices, _MM_SHUFFLE(3,1,2,0)));
+    _mm_storeu_si128((__m128i*)(triangles+triangleIndex+3),
+                     _mm_shuffle_epi32(indices, _MM_SHUFFLE(3,2,3,0)));
+    triangleIndex += (polygon[2] != polygon[3]) ? 6 : 3;
+  }
+  return triangleIndex + triangulateScalar(polygon, polygonCount-poly,
+                                           triangles+triangleIndex);
+}
+
+#endif  // #ifdef LUXC4D_KERNELS_SSE2
+
+
+
+/*****************************************************************************
+ * AVX2 implementations.
+ *****************************************************************************/
+
+#ifdef LUXC4D_KERNELS_AVX2
+
+/// AVX2 version of scalePointsScalar(). Points are loaded with a masked load,
+/// which doesn't touch the memory behind the point.
+LUXC4D_TARGET_AVX2
+static void scalePointsAVX2(const double*                  points,
+                            const GeometryKernels::IndexT* indices,
+                            GeometryKernels::IndexT        count,
+                            double                         scale,
+                            float*                         result)
+{
+  if (!count)  return;
+  const __m256d factor = _mm256_set1_pd(scale);
+  const __m256i mask   = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+  for (GeometryKernels::IndexT i=0; i+1<count; ++i, result+=3) {
+    __m256d point = _mm256_maskload_pd(points + 3*(size_t)indices[i], mask);
+    __m128  xyz   = _mm256_cvtpd_ps(_mm256_mul_pd(point, factor));
+    _mm_storeu_ps(result, _mm_shuffle_ps(xyz, xyz, _MM_SHUFFLE(3,1,2,0)));
+  }
+  _mm256_zeroupper();
+  scalePointsScalar(points, indices+count-1, 1, scale, result);
+}
+
+
+/// AVX2 version of normalizeNormalsScalar(), which processes 8 normals at
+/// once. Each 128 bit lane holds 4 normals, so the transposition works like
+/// in the SSE2 version and the loads and stores only need an alignment of 16
+/// bytes.
+LUXC4D_TARGET_AVX2
+static void normalizeNormalsAVX2(float*                  normals,
+                                 GeometryKernels::IndexT count)
+{
+  const __m256 zero    = _mm256_setzero_ps();
+  const __m256 one     = _mm256_set1_ps(1.0f);
+  const bool   aligned = !((size_t)normals & 15);
+  GeometryKernels::IndexT i = 0;
+  for (; i+8<=count; i+=8, normals+=24) {
+    __m256 a, b, c, x, y, z;
+    if (aligned) {
+      a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(normals)),   _mm_load_ps(normals+12), 1);
+      b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(normals+4)), _mm_load_ps(normals+16), 1);
+      c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load_ps(normals+8)), _mm_load_ps(normals+20), 1);
+    } else {
+      a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(normals)),   _mm_loadu_ps(normals+12), 1);
+      b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(normals+4)), _mm_loadu_ps(normals+16), 1);
+      c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(normals+8)), _mm_loadu_ps(normals+20), 1);
+    }
+    TRANSPOSE_AOS_TO_SOA(__m256, _mm256_shuffle_ps, a, b, c, x, y, z)
+    __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x),
+                                                               _mm256_mul_ps(z, z)),
+                                                 _mm256_mul_ps(y, y)));
+    __m256 valid  = _mm256_cmp_ps(length, zero, _CMP_NEQ_UQ);
+    __m256 factor = _mm256_div_ps(one, length);
+    x = _mm256_blendv_ps(one, _mm256_mul_ps(x, factor), valid);
+    y = _mm256_and_ps(valid, _mm256_mul_ps(y, factor));
+    z = _mm256_and_ps(valid, _mm256_mul_ps(z, factor));
+    TRANSPOSE_SOA_TO_AOS(__m256, _mm256_shuffle_ps, x, y, z, a, b, c)
+    if (aligned) {
+      _mm_store_ps(normals,    _mm256_castps256_ps128(a));
+      _mm_store_ps(normals+4,  _mm256_castps256_ps128(b));
+      _mm_store_ps(normals+8,  _mm256_castps256_ps128(c));
+      _mm_store_ps(normals+12, _mm256_extractf128_ps(a, 1));
+      _mm_store_ps(normals+16, _mm256_extractf128_ps(b, 1));
+      _mm_store_ps(normals+20, _mm256_extractf128_ps(c, 1));
+    } else {
+      _mm_storeu_ps(normals,    _mm256_castps256_ps128(a));
+      _mm_storeu_ps(normals+4,  _mm256_castps256_ps128(b));
+      _mm_storeu_ps(normals+8,  _mm256_castps256_ps128(c));
+      _mm_storeu_ps(normals+12, _mm256_extractf128_ps(a, 1));
+      _mm_storeu_ps(normals+16, _mm256_extractf128_ps(b, 1));
+      _mm_storeu_ps(normals+20, _mm256_extractf128_ps(c, 1));
+    }
+  }
+  _mm256_zeroupper();
+  normalizeNormalsScalar(normals, count-i);
+}
+
+#endif  // #ifdef LUXC4D_KERNELS_AVX2
+
+
+
+/*****************************************************************************
+ * Dispatching.
+ *****************************************************************************/
+
+/// The kernel implementations that are currently used.
+struct KernelTable
+{
+  GeometryKernels::InstructionSet instructionSet;
+  void (*scalePoints)(const double*, const GeometryKernels::IndexT*,
+                      GeometryKernels::IndexT, double, float*);
+  void (*normalizeNormals)(float*, GeometryKernels::IndexT);
+  bool (*equalPolygonNormals)(const float*, GeometryKernels::IndexT, double);
+  GeometryKernels::IndexT (*triangulate)(const int*, GeometryKernels::IndexT, int*);
+};
+
+/// The scalar kernels, which are used until GeometryKernels::init() is called.
+static const KernelTable cScalarKernels = {
+  GeometryKernels::INSTRUCTIONS_SCALAR,
+  scalePointsScalar,
+  normalizeNormalsScalar,
+  equalPolygonNormalsScalar,
+  triangulateScalar
+};
+
+static KernelTable sKernels = cScalarKernels;
+
+
+/// Returns the best instruction set, which is supported by the CPU, the
+/// operating system and the kernels compiled into this build.
+static GeometryKernels::InstructionSet detectInstructionSet(void)
+{
+  GeometryKernels::InstructionSet instructionSet = GeometryKernels::INSTRUCTIONS_SCALAR;
+
+#if defined(_MSC_VER) && defined(LUXC4D_KERNELS_SSE2)
+  int info[4];
+  __cpuid(info, 0);
+  int maxLeaf = info[0];
+  __cpuid(info, 1);
+  if (info[3] & (1 << 26)) {
+    instructionSet = GeometryKernels::INSTRUCTIONS_SSE2;
+  }
+#  ifdef LUXC4D_KERNELS_AVX2
+  // AVX needs the CPU flags OSXSAVE and AVX, and the OS must save the YMM
+  // registers on context switches
+  const int avxFlags = (1 << 27) | (1 << 28);
+  if ((maxLeaf >= 7) && ((info[2] & avxFlags) == avxFlags) && ((_xgetbv(0) & 6) == 6)) {
+    __cpuidex(info, 7, 0);
+    if (info[1] & (1 << 5)) {
+      instructionSet = GeometryKernels::INSTRUCTIONS_AVX2;
+    }
+  }
+#  else
+  (void)maxLeaf;
+#  endif
+#elif defined(LUXC4D_KERNELS_AVX2)
+  // GCC and clang check the OS support of AVX themselves
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) {
+    instructionSet = GeometryKernels::INSTRUCTIONS_SSE2;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    instructionSet = GeometryKernels::INSTRUCTIONS_AVX2;
+  }
+#elif defined(LUXC4D_KERNELS_SSE2)
+  // the whole build requires SSE2
+  instructionSet = GeometryKernels::INSTRUCTIONS_SSE2;
+#endif
+
+  return instructionSet;
+}
+
+
+
+/*****************************************************************************
+ * Implementation of public member functions of class GeometryKernels.
+ *****************************************************************************/
+
+/// Selects the kernel implementations for the best instruction set, that is
+/// available. Must be called before any kernel is used by another thread, e.g.
+/// on plugin start.
+///
+/// @param[in]  maxInstructionSet
+///   The best instruction set that may be used. Pass INSTRUCTIONS_SCALAR to
+///   disable all SIMD kernels.
+/// @return
+///   The instruction set that will be used.
+GeometryKernels::InstructionSet GeometryKernels::init(InstructionSet maxInstructionSet)
+{
+  InstructionSet instructionSet = detectInstructionSet();
+  if (instructionSet > maxInstructionSet) {
+    instructionSet = maxInstructionSet;
+  }
+
+  KernelTable kernels = cScalarKernels;
+#ifdef LUXC4D_KERNELS_SSE2
+  if (instructionSet >= INSTRUCTIONS_SSE2) {
+    kernels.instructionSet      = INSTRUCTIONS_SSE2;
+    kernels.scalePoints         = scalePointsSSE2;
+    kernels.normalizeNormals    = normalizeNormalsSSE2;
+    kernels.equalPolygonNormals = equalPolygonNormalsSSE2;
+    kernels.triangulate         = triangulateSSE2;
+  }
+#endif
+#ifdef LUXC4D_KERNELS_AVX2
+  // the other kernels are limited by memory accesses and gain nothing from
+  // wider registers
+  if (instructionSet >= INSTRUCTIONS_AVX2) {
+    kernels.instructionSet      = INSTRUCTIONS_AVX2;
+    kernels.scalePoints         = scalePointsAVX2;
+    kernels.normalizeNormals    = normalizeNormalsAVX2;
+  }
+#endif
+  sKernels = kernels;
+
+  return sKernels.instructionSet;
+}
+
+
+/// Returns the instruction set of the kernels that are currently used.
+GeometryKernels::InstructionSet GeometryKernels::instructionSet(void)
+{
+  return sKernels.instructionSet;
+}
+
+
+/// Returns the name of an instruction set (for logging).
+const char* GeometryKernels::instructionSetName(InstructionSet instructionSet)
+{
+  switch (instructionSet) {
+    case INSTRUCTIONS_SSE2:  return "SSE2";
+    case INSTRUCTIONS_AVX2:  return "AVX2";
+    default:                 return "scalar";
+  }
+}
+
+
+/// Gathers points via an index array, scales them and converts them from
+/// C4D coordinates (double) into Lux coordinates (float), i.e. Y and Z are
+/// swapped.
+///
+/// @param[in]  points
+///   The C4D points (3 doubles per point).
+/// @param[in]  indices
+///   The indices of the points to convert.
+/// @param[in]  count
+///   The number of indices.
+/// @param[in]  scale
+///   The scale factor.
+/// @param[out]  result
+///   The converted points will be stored here (3 floats per index).
+void GeometryKernels::scalePoints(const double* points,
+                                  const IndexT* indices,
+                                  IndexT        count,
+                                  double        scale,
+                                  float*        result)
+{
+  sKernels.scalePoints(points, indices, count, scale, result);
+}
+
+
+/// Normalises an array of normals in Lux coordinates in place. The results
+/// are the same as normalize() of the corresponding C4D vectors, i.e. normals
+/// of length 0 become (1,0,0).
+///
+/// @param[in,out]  normals
+///   The normals to normalise (3 floats per normal). If the array is aligned
+///   to 16 bytes, the SIMD kernels use aligned loads and stores.
+/// @param[in]  count
+///   The number of normals.
+void GeometryKernels::normalizeNormals(float* normals,
+                                       IndexT count)
+{
+  sKernels.normalizeNormals(normals, count);
+}
+
+
+/// Checks if all polygons are flat shaded, i.e. if all 4 normals of each
+/// polygon are equal within some error margin.
+///
+/// @param[in]  normals
+///   The normals of the polygons (4 normals per polygon, 3 floats per normal).
+/// @param[in]  polygonCount
+///   The number of polygons.
+/// @param[in]  maxDistanceSquared
+///   Two normals are equal, if their squared distance is smaller than this
+///   value.
+/// @return
+///   true if the normals of each polygon are equal, false otherwise.
+bool GeometryKernels::equalPolygonNormals(const float* normals,
+                                          IndexT       polygonCount,
+                                          double       maxDistanceSquared)
+{
+  return sKernels.equalPolygonNormals(normals, polygonCount, maxDistanceSquared);
+}
+
+
+/// Splits polygons into triangles using the correct order for right-handed
+/// coordinates. Polygons with the same third and fourth index are triangles,
+/// all others are quads and are split into two triangles.
+///
+/// @param[in]  polygons
+///   The point indices of the polygons (4 per polygon).
+/// @param[in]  polygonCount
+///   The number of polygons.
+/// @param[out]  triangles
+///   The triangle indices will be written to this array, which must have
+///   (at least) 3 entries per triangle and 6 per quad. The SIMD kernels write
+///   entries behind the current triangle, but never beyond that size.
+/// @return
+///   The number of written triangle indices.
+GeometryKernels::IndexT GeometryKernels::triangulate(const int* polygons,
+                                                     IndexT     polygonCount,
+                                                     int*       triangles)
+{
+  return sKernels.triangulate(polygons, polygonCount, triangles);
+}
@@ -0,0 +1,87 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __GEOMETRYKERNELS_H__
+#define __GEOMETRYKERNELS_H__  1
+
+
+
+// NOTE: This file must not depend on the C4D SDK, i.e. it may only include
+//       standard headers. That allows building and testing it on its own.
+
+
+
+/***************************************************************************//*!
+ This class bundles the inner loops of the geometry conversion, which work on
+ plain float, double and int arrays. Each kernel has a scalar implementation
+ and SIMD implementations (SSE2 and partly AVX2), which are selected at
+ runtime by init(), depending on what the CPU supports. Until init() was
+ called, the scalar implementations are used.
+
+ All implementations of a kernel return bit-identical results, i.e. the
+ SIMD code performs exactly the same floating point operations in the same
+ order as the scalar code. (That's not true for 32 bit builds that do scalar
+ float math on the x87 FPU, where the scalar results depend on the compiler
+ settings anyway.)
+
+ Points and normals are stored as 3 consecutive components per vector.
+*//****************************************************************************/
+class GeometryKernels
+{
+public:
+
+  /// The type of all counts and indices.
+  typedef unsigned int IndexT;
+
+  /// The instruction sets, for which we have kernel implementations.
+  enum InstructionSet {
+    INSTRUCTIONS_SCALAR = 0,
+    INSTRUCTIONS_SSE2,
+    INSTRUCTIONS_AVX2
+  };
+
+
+  static InstructionSet init(InstructionSet maxInstructionSet=INSTRUCTIONS_AVX2);
+  static InstructionSet instructionSet(void);
+  static const char* instructionSetName(InstructionSet instructionSet);
+
+  static void scalePoints(const double* points,
+                          const IndexT* indices,
+                          IndexT        count,
+                          double        scale,
+                          float*        result);
+  static void normalizeNormals(float* normals,
+                               IndexT count);
+  static bool equalPolygonNormals(const float* normals,
+                                  IndexT       polygonCount,
+                                  double       maxDistanceSquared);
+  static IndexT triangulate(const int* polygons,
+                            IndexT     polygonCount,
+                            int*       triangles);
+};
+
+
+
+#endif  // #ifndef __GEOMETRYKERNELS_H__
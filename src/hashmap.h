@@ -0,0 +1,129 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __HASHMAP_H__
+#define __HASHMAP_H__ 1
+
+
+
+#include <cstring>
+#include <new>
+
+#include "hashtraits.h"
+#include "utilities.h"
+
+
+
+/***************************************************************************//*!
+ This class implements a map as hash table with open addressing and linear
+ probing. The hash values are stored in their own array, so a lookup usually
+ touches only a few consecutive hash values and a single entry. The capacity
+ is always a power of 2 and the table grows if it's filled to more than 3/4.
+
+ WARNING: When the table grows, all entries are moved, i.e. pointers returned
+          by add() and get() are only valid until the next call of add().
+
+ The template key type K has to be supported by the hasher H - see
+ HashTraits.
+
+ The template types K and T have to support the following functions:
+  - Copy constructor  T::T(const T&)
+  - Copy operator     T::operator=(const T&)
+*//****************************************************************************/
+
+template <class K, class T, class H=HashTraits<K> >
+class HashMap
+{
+public:
+
+  /// The key type.
+  typedef K       KeyT;
+  /// The value type.
+  typedef T       ValueT;
+  /// The hasher type.
+  typedef H       HasherT;
+  /// The size type.
+  typedef VULONG  SizeT;
+
+
+  HashMap(void);
+  ~HashMap(void);
+
+  void erase(void);
+  Bool reserve(SizeT size);
+
+  inline SizeT size(void) const;
+
+  ValueT* add(const KeyT& key, const ValueT& value);
+
+  const ValueT* get(const KeyT& key) const;
+  ValueT*       get(const KeyT& key);
+
+
+private:
+
+  /// This helper structure stores a single key/value pair of the table.
+  struct Entry
+  {
+    KeyT   mKey;
+    ValueT mValue;
+
+    /// Constructs a new entry.
+    inline Entry(const KeyT& key, const ValueT& value)
+    : mKey(key),
+      mValue(value)
+    {}
+  };
+
+
+  /// The capacity of the table, when the first entry is added.
+  static const SizeT cMinCapacity = 16;
+
+
+  ULONG* mHashes;
+  Entry* mEntries;
+  SizeT  mCapacity;
+  SizeT  mSize;
+
+
+  // At the moment, we don't allow copying of HashMaps.
+  HashMap(const HashMap& other);
+  HashMap& operator=(const HashMap& other);
+
+  inline static ULONG keyHash(const KeyT& key);
+  inline SizeT findSlot(const KeyT& key,
+                        ULONG       hash) const;
+  Bool rehash(SizeT capacity);
+  static void freeTable(ULONG* hashes,
+                        Entry* entries,
+                        SizeT  capacity);
+};
+
+
+#include "hashmap_impl.h"
+
+
+
+#endif  // #ifndef __HASHMAP_H__
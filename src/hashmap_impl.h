@@ -0,0 +1,249 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __HASHMAP_IMPL_H__
+#define __HASHMAP_IMPL_H__ 1
+
+
+
+/*******************************************************************************
+ * Implementation of public member functions of template class HashMap.
+ *******************************************************************************/
+
+/// Constructs a new (empty) hash map. No memory is allocated until the first
+/// entry is added.
+template <class K, class T, class H>
+HashMap<K,T,H>::HashMap(void)
+: mHashes(0), mEntries(0), mCapacity(0), mSize(0)
+{}
+
+
+/// Destroys a hash map and deallocates its resources.
+template <class K, class T, class H>
+HashMap<K,T,H>::~HashMap(void)
+{
+  erase();
+}
+
+
+/// Deallocates all resources of a hash map. The map will be empty afterwards.
+template <class K, class T, class H>
+void HashMap<K,T,H>::erase(void)
+{
+  freeTable(mHashes, mEntries, mCapacity);
+  mHashes   = 0;
+  mEntries  = 0;
+  mCapacity = 0;
+  mSize     = 0;
+}
+
+
+/// Makes sure that the specified number of entries can be stored without
+/// growing the table again.
+///
+/// @param[in]  size
+///   The number of entries the map should be able to store.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+template <class K, class T, class H>
+Bool HashMap<K,T,H>::reserve(SizeT size)
+{
+  SizeT capacity = mCapacity ? mCapacity : cMinCapacity;
+  while (size * 4 > capacity * 3) {
+    capacity *= 2;
+  }
+  return (capacity == mCapacity) || rehash(capacity);
+}
+
+
+/// Returns the number of entries of the hash map.
+template <class K, class T, class H>
+inline typename HashMap<K,T,H>::SizeT HashMap<K,T,H>::size(void) const
+{
+  return mSize;
+}
+
+
+/// Adds a new key/entry pair to the hash map. If there was already one with
+/// the same key, we overwrite it.
+///
+/// @param[in]  key
+///   The key of the value to add to the map.
+/// @param[in]  value
+///   The value to add.
+/// @return
+///   NULL if we ran out of memory, otherwise the pointer to the stored value.
+template <class K, class T, class H>
+typename HashMap<K,T,H>::ValueT* HashMap<K,T,H>::add(const KeyT&   key,
+                                                     const ValueT& value)
+{
+  // look up the key first, as overwriting an entry never grows the table
+  ULONG hash = keyHash(key);
+  SizeT slot = 0;
+  if (mCapacity) {
+    slot = findSlot(key, hash);
+    if (mHashes[slot]) {
+      mEntries[slot].mValue = value;
+      return &mEntries[slot].mValue;
+    }
+  }
+
+  // a new entry might need a larger table, which moves its slot
+  SizeT capacity = mCapacity;
+  if (!reserve(mSize + 1))  return 0;
+  if (mCapacity != capacity)  slot = findSlot(key, hash);
+  new (&mEntries[slot]) Entry(key, value);
+  mHashes[slot] = hash;
+  ++mSize;
+  return &mEntries[slot].mValue;
+}
+
+
+/// Returns the (const) value for a specified key from the map.
+///
+/// @param[in]  key
+///   The key for which the value will be looked up.
+/// @return
+///   Pointer to the found value, or NULL if there is no matching value.
+template <class K, class T, class H>
+const typename HashMap<K,T,H>::ValueT* HashMap<K,T,H>::get(const KeyT& key) const
+{
+  if (!mSize)  return 0;
+  SizeT slot = findSlot(key, keyHash(key));
+  return mHashes[slot] ? &mEntries[slot].mValue : 0;
+}
+
+
+/// Returns the (non-const) value for a specified key from the map.
+///
+/// @param[in]  key
+///   The key for which the value will be looked up.
+/// @return
+///   Pointer to the found value, or NULL if there is no matching value.
+template <class K, class T, class H>
+typename HashMap<K,T,H>::ValueT* HashMap<K,T,H>::get(const KeyT& key)
+{
+  if (!mSize)  return 0;
+  SizeT slot = findSlot(key, keyHash(key));
+  return mHashes[slot] ? &mEntries[slot].mValue : 0;
+}
+
+
+
+/*******************************************************************************
+ * Implementation of private member functions of template class HashMap.
+ *******************************************************************************/
+
+/// Returns the hash value of a key. As 0 marks empty slots, it's never
+/// returned.
+template <class K, class T, class H>
+inline ULONG HashMap<K,T,H>::keyHash(const KeyT& key)
+{
+  ULONG hash = HasherT::hash(key);
+  return hash ? hash : 1;
+}
+
+
+/// Returns the slot which stores a key or, if the key is not in the table,
+/// the empty slot where it would be stored. The table must not be empty.
+///
+/// @param[in]  key
+///   The key to look up.
+/// @param[in]  hash
+///   The hash value of the key (see keyHash()).
+/// @return
+///   The index of the slot.
+template <class K, class T, class H>
+inline typename HashMap<K,T,H>::SizeT HashMap<K,T,H>::findSlot(const KeyT& key,
+                                                               ULONG       hash) const
+{
+  SizeT mask = mCapacity - 1;
+  SizeT slot = hash & mask;
+  while (mHashes[slot] &&
+         ((mHashes[slot] != hash) || !HasherT::equal(mEntries[slot].mKey, key)))
+  {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+
+/// Moves all entries into a new table of the specified capacity.
+///
+/// @param[in]  capacity
+///   The new capacity, which must be a power of 2 and large enough for all
+///   entries.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+template <class K, class T, class H>
+Bool HashMap<K,T,H>::rehash(SizeT capacity)
+{
+  ULONG* hashes = bNew ULONG[capacity];
+  CHAR*  entryMemory = bNew CHAR[capacity * sizeof(Entry)];
+  if (!hashes || !entryMemory) {
+    bDelete(hashes);
+    bDelete(entryMemory);
+    ERRLOG_RETURN_VALUE(FALSE, "HashMap::rehash(): could not allocate table of size " + LLongToString(capacity));
+  }
+  memset(hashes, 0, capacity * sizeof(ULONG));
+
+  // copy the entries into the new table and destroy the old ones (entries
+  // are not copied bitwise, as they might reference themselves)
+  ULONG* oldHashes   = mHashes;
+  Entry* oldEntries  = mEntries;
+  SizeT  oldCapacity = mCapacity;
+  mHashes   = hashes;
+  mEntries  = (Entry*)entryMemory;
+  mCapacity = capacity;
+  for (SizeT i=0; i<oldCapacity; ++i) {
+    if (oldHashes[i]) {
+      SizeT slot = findSlot(oldEntries[i].mKey, oldHashes[i]);
+      new (&mEntries[slot]) Entry(oldEntries[i]);
+      mHashes[slot] = oldHashes[i];
+    }
+  }
+  freeTable(oldHashes, oldEntries, oldCapacity);
+  return TRUE;
+}
+
+
+/// Destroys all entries of a table and deallocates its memory.
+template <class K, class T, class H>
+void HashMap<K,T,H>::freeTable(ULONG* hashes,
+                               Entry* entries,
+                               SizeT  capacity)
+{
+  if (!hashes)  return;
+  for (SizeT i=0; i<capacity; ++i) {
+    if (hashes[i])  entries[i].~Entry();
+  }
+  CHAR* entryMemory = (CHAR*)entries;
+  bDelete(entryMemory);
+  bDelete(hashes);
+}
+
+
+
+#endif  // #ifndef __HASHMAP_IMPL_H__
@@ -0,0 +1,109 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __HASHSET_H__
+#define __HASHSET_H__ 1
+
+
+
+#include <cstring>
+#include <new>
+
+#include "hashtraits.h"
+#include "utilities.h"
+
+
+
+/***************************************************************************//*!
+ This class implements a set as hash table with open addressing and linear
+ probing. The hash values are stored in their own array, so a lookup usually
+ touches only a few consecutive hash values and a single value. The capacity
+ is always a power of 2 and the table grows if it's filled to more than 3/4.
+
+ WARNING: When the table grows, all values are moved, i.e. pointers returned
+          by add() and get() are only valid until the next call of add().
+
+ The template type T has to be supported by the hasher H - see HashTraits.
+ It has to support the following functions:
+  - Copy constructor  T::T(const T&)
+  - Copy operator     T::operator=(const T&)
+*//****************************************************************************/
+
+template <class T, class H=HashTraits<T> >
+class HashSet
+{
+public:
+
+  /// The value type.
+  typedef T       ValueT;
+  /// The hasher type.
+  typedef H       HasherT;
+  /// The size type.
+  typedef VULONG  SizeT;
+
+
+  HashSet(void);
+  ~HashSet(void);
+
+  void erase(void);
+  Bool reserve(SizeT size);
+
+  inline SizeT size(void) const;
+
+  const ValueT* add(const ValueT& value);
+  const ValueT* get(const ValueT& value) const;
+
+
+private:
+
+  /// The capacity of the table, when the first entry is added.
+  static const SizeT cMinCapacity = 16;
+
+
+  ULONG*  mHashes;
+  ValueT* mValues;
+  SizeT   mCapacity;
+  SizeT   mSize;
+
+
+  // At the moment, we don't allow copying of HashSets.
+  HashSet(const HashSet& other);
+  HashSet& operator=(const HashSet& other);
+
+  inline static ULONG valueHash(const ValueT& value);
+  inline SizeT findSlot(const ValueT& value,
+                        ULONG         hash) const;
+  Bool rehash(SizeT capacity);
+  static void freeTable(ULONG*  hashes,
+                        ValueT* values,
+                        SizeT   capacity);
+};
+
+
+#include "hashset_impl.h"
+
+
+
+#endif  // #ifndef __HASHSET_H__
@@ -0,0 +1,232 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __HASHSET_IMPL_H__
+#define __HASHSET_IMPL_H__ 1
+
+
+
+/*******************************************************************************
+ * Implementation of public member functions of template class HashSet.
+ *******************************************************************************/
+
+/// Constructs a new (empty) hash set. No memory is allocated until the first
+/// value is added.
+template <class T, class H>
+HashSet<T,H>::HashSet(void)
+: mHashes(0), mValues(0), mCapacity(0), mSize(0)
+{}
+
+
+/// Destroys a hash set and deallocates its resources.
+template <class T, class H>
+HashSet<T,H>::~HashSet(void)
+{
+  erase();
+}
+
+
+/// Deallocates all resources of a hash set. The set will be empty afterwards.
+template <class T, class H>
+void HashSet<T,H>::erase(void)
+{
+  freeTable(mHashes, mValues, mCapacity);
+  mHashes   = 0;
+  mValues   = 0;
+  mCapacity = 0;
+  mSize     = 0;
+}
+
+
+/// Makes sure that the specified number of values can be stored without
+/// growing the table again.
+///
+/// @param[in]  size
+///   The number of values the set should be able to store.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+template <class T, class H>
+Bool HashSet<T,H>::reserve(SizeT size)
+{
+  SizeT capacity = mCapacity ? mCapacity : cMinCapacity;
+  while (size * 4 > capacity * 3) {
+    capacity *= 2;
+  }
+  return (capacity == mCapacity) || rehash(capacity);
+}
+
+
+/// Returns the number of values of the hash set.
+template <class T, class H>
+inline typename HashSet<T,H>::SizeT HashSet<T,H>::size(void) const
+{
+  return mSize;
+}
+
+
+/// Adds a new value to the hash set. If there was already an equal one, we
+/// overwrite it.
+///
+/// @param[in]  value
+///   The value to add.
+/// @return
+///   NULL if we ran out of memory, otherwise the pointer to the stored value.
+template <class T, class H>
+const typename HashSet<T,H>::ValueT* HashSet<T,H>::add(const ValueT& value)
+{
+  // look up the value first, as overwriting a value never grows the table
+  ULONG hash = valueHash(value);
+  SizeT slot = 0;
+  if (mCapacity) {
+    slot = findSlot(value, hash);
+    if (mHashes[slot]) {
+      mValues[slot] = value;
+      return &mValues[slot];
+    }
+  }
+
+  // a new value might need a larger table, which moves its slot
+  SizeT capacity = mCapacity;
+  if (!reserve(mSize + 1))  return 0;
+  if (mCapacity != capacity)  slot = findSlot(value, hash);
+  new (&mValues[slot]) ValueT(value);
+  mHashes[slot] = hash;
+  ++mSize;
+  return &mValues[slot];
+}
+
+
+/// Looks up a value in the set.
+///
+/// @param[in]  value
+///   The value to look up.
+/// @return
+///   Pointer to the found value, or NULL if there is no equal value.
+template <class T, class H>
+const typename HashSet<T,H>::ValueT* HashSet<T,H>::get(const ValueT& value) const
+{
+  if (!mSize)  return 0;
+  SizeT slot = findSlot(value, valueHash(value));
+  return mHashes[slot] ? &mValues[slot] : 0;
+}
+
+
+
+/*******************************************************************************
+ * Implementation of private member functions of template class HashSet.
+ *******************************************************************************/
+
+/// Returns the hash value of a value. As 0 marks empty slots, it's never
+/// returned.
+template <class T, class H>
+inline ULONG HashSet<T,H>::valueHash(const ValueT& value)
+{
+  ULONG hash = HasherT::hash(value);
+  return hash ? hash : 1;
+}
+
+
+/// Returns the slot which stores a value or, if the value is not in the
+/// table, the empty slot where it would be stored. The table must not be
+/// empty.
+///
+/// @param[in]  value
+///   The value to look up.
+/// @param[in]  hash
+///   The hash value of the value (see valueHash()).
+/// @return
+///   The index of the slot.
+template <class T, class H>
+inline typename HashSet<T,H>::SizeT HashSet<T,H>::findSlot(const ValueT& value,
+                                                           ULONG         hash) const
+{
+  SizeT mask = mCapacity - 1;
+  SizeT slot = hash & mask;
+  while (mHashes[slot] &&
+         ((mHashes[slot] != hash) || !HasherT::equal(mValues[slot], value)))
+  {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+
+/// Moves all values into a new table of the specified capacity.
+///
+/// @param[in]  capacity
+///   The new capacity, which must be a power of 2 and large enough for all
+///   values.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+template <class T, class H>
+Bool HashSet<T,H>::rehash(SizeT capacity)
+{
+  ULONG* hashes = bNew ULONG[capacity];
+  CHAR*  valueMemory = bNew CHAR[capacity * sizeof(ValueT)];
+  if (!hashes || !valueMemory) {
+    bDelete(hashes);
+    bDelete(valueMemory);
+    ERRLOG_RETURN_VALUE(FALSE, "HashSet::rehash(): could not allocate table of size " + LLongToString(capacity));
+  }
+  memset(hashes, 0, capacity * sizeof(ULONG));
+
+  // copy the values into the new table and destroy the old ones (values are
+  // not copied bitwise, as they might reference themselves)
+  ULONG*  oldHashes   = mHashes;
+  ValueT* oldValues   = mValues;
+  SizeT   oldCapacity = mCapacity;
+  mHashes   = hashes;
+  mValues   = (ValueT*)valueMemory;
+  mCapacity = capacity;
+  for (SizeT i=0; i<oldCapacity; ++i) {
+    if (oldHashes[i]) {
+      SizeT slot = findSlot(oldValues[i], oldHashes[i]);
+      new (&mValues[slot]) ValueT(oldValues[i]);
+      mHashes[slot] = oldHashes[i];
+    }
+  }
+  freeTable(oldHashes, oldValues, oldCapacity);
+  return TRUE;
+}
+
+
+/// Destroys all values of a table and deallocates its memory.
+template <class T, class H>
+void HashSet<T,H>::freeTable(ULONG*  hashes,
+                             ValueT* values,
+                             SizeT   capacity)
+{
+  if (!hashes)  return;
+  for (SizeT i=0; i<capacity; ++i) {
+    if (hashes[i])  values[i].~ValueT();
+  }
+  CHAR* valueMemory = (CHAR*)values;
+  bDelete(valueMemory);
+  bDelete(hashes);
+}
+
+
+
+#endif  // #ifndef __HASHSET_IMPL_H__
@@ -0,0 +1,145 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __HASHTRAITS_H__
+#define __HASHTRAITS_H__ 1
+
+
+
+#include <c4d.h>
+
+#include "luxtypes.h"
+
+
+
+/***************************************************************************//*!
+ This template defines how HashMap and HashSet hash and compare their keys.
+ The generic version requires the key type K to support the following
+ functions:
+  - Hash function     ULONG K::hash() const
+  - Equal operator    bool K::operator==(const K&) const
+
+ There are specialisations for pointers, C4D Strings and LuxStrings. Other
+ hashers can be passed as template parameter to HashMap and HashSet, if they
+ implement the same two static functions.
+*//****************************************************************************/
+template <class K>
+struct HashTraits
+{
+  /// Returns the hash value of a key.
+  static inline ULONG hash(const K& key)
+  {
+    return key.hash();
+  }
+
+  /// Returns TRUE if two keys are equal.
+  static inline Bool equal(const K& key1, const K& key2)
+  {
+    return (key1 == key2);
+  }
+};
+
+
+/// Scrambles the bits of a hash value, so that the lower bits of the result
+/// depend on all bits of the input (the finaliser of MurmurHash3).
+inline ULONG hashMix(ULONG hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6B;
+  hash ^= hash >> 13;
+  hash *= 0xC2B2AE35;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+
+/// Combines a hash value with the hash value of another part of a key.
+inline ULONG hashCombine(ULONG hash,
+                         ULONG partHash)
+{
+  return hash ^ (partHash + 0x9E3779B9 + (hash << 6) + (hash >> 2));
+}
+
+
+/// Hashes pointers by their address.
+template <class P>
+struct HashTraits<P*>
+{
+  static inline ULONG hash(const P* key)
+  {
+    VULONG address = (VULONG)key;
+    return hashMix((ULONG)address ^ (ULONG)((address >> 16) >> 16));
+  }
+
+  static inline Bool equal(const P* key1, const P* key2)
+  {
+    return (key1 == key2);
+  }
+};
+
+
+/// Hashes C4D Strings by their characters (FNV-1a).
+template <>
+struct HashTraits<String>
+{
+  static inline ULONG hash(const String& key)
+  {
+    ULONG hash = 2166136261u;
+    LONG  length = key.GetLength();
+    for (LONG i=0; i<length; ++i) {
+      hash = (hash ^ (ULONG)key[i]) * 16777619u;
+    }
+    return hash;
+  }
+
+  static inline Bool equal(const String& key1, const String& key2)
+  {
+    return (key1 == key2);
+  }
+};
+
+
+/// Hashes LuxStrings by their characters (FNV-1a).
+template <>
+struct HashTraits<LuxString>
+{
+  static inline ULONG hash(const LuxString& key)
+  {
+    ULONG hash = 2166136261u;
+    for (LuxString::size_type i=0; i<key.size(); ++i) {
+      hash = (hash ^ (ULONG)(unsigned char)key[i]) * 16777619u;
+    }
+    return hash;
+  }
+
+  static inline Bool equal(const LuxString& key1, const LuxString& key2)
+  {
+    return (key1 == key2);
+  }
+};
+
+
+
+#endif  // #ifndef __HASHTRAITS_H__
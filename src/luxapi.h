@@ -31,6 +31,7 @@
 #include <c4d.h>
 
 #include "filepath.h"
+#include "luxtexturecache.h"
 #include "luxtypes.h"
 #include "luxparamset.h"
 
@@ -75,6 +76,20 @@ public:
   ///
   virtual Filename getSceneFilename(void) =0;
 
+  /// Returns the filename from which data is derived, that is shared by all
+  /// frames of an animation export (e.g. the texture cache directory). For a
+  /// single scene it's the same as getSceneFilename().
+  virtual Filename getSharedFilename(void) =0;
+
+  /// Returns the texture cache of this implementation, which can be used to
+  /// replace images by preprocessed copies. Implementations that don't write
+  /// files, can return NULL.
+  virtual LuxTextureCache* textureCache(void) =0;
+
+  /// Returns the number of bytes that were written so far. It's only used for
+  /// profiling, so implementations that don't write files, can return 0.
+  virtual VULONG bytesWritten(void) =0;
+
 
   /// Specifies the comment for the next Lux API command. This should be used
   /// by an exporter implementation that writes Lux scene files and should be
@@ -359,6 +374,78 @@ public:
   ///   TRUE if executed successfully, otherwise FALSE.
   virtual Bool portalShape(IdentifierName     type,
                            const LuxParamSet& paramSet) =0;
+
+
+  /// Looks up the shard of the previous export that was recorded with a dirty
+  /// checksum, i.e. a checksum of the change state of its source objects,
+  /// which is much cheaper to calculate than the checksum of their content.
+  /// Implementations that don't support shards return FALSE.
+  ///
+  /// @param[in]  dirtyChecksum
+  ///   The dirty checksum that was passed to shardBegin() (must not be 0).
+  /// @param[out]  name
+  ///   Will be set to the name of the shard, if it was found.
+  /// @param[out]  checksum
+  ///   Will be set to the checksum of the shard, if it was found.
+  /// @return
+  ///   TRUE if the shard was found, otherwise FALSE.
+  virtual Bool findShard(ULONG      dirtyChecksum,
+                         LuxString& name,
+                         ULONG&     checksum) =0;
+
+  /// Checks if a shard that was written by a previous export (or earlier in
+  /// the current export) can be reused, i.e. if it was recorded with the same
+  /// checksum and transformation. Implementations that don't support shards
+  /// return FALSE.
+  ///
+  /// @param[in]  name
+  ///   The name of the shard, which identifies it across exports.
+  /// @param[in]  checksum
+  ///   The checksum of all source data of the shard (except the material).
+  /// @param[in]  matrix
+  ///   The transformation of the object(s) in the shard.
+  /// @return
+  ///   TRUE if the shard can be reused, otherwise FALSE.
+  virtual Bool isShardCurrent(IdentifierName   name,
+                              ULONG            checksum,
+                              const LuxMatrix& matrix) =0;
+
+  /// Starts a shard, i.e. a group of object commands which an implementation
+  /// might write into its own file and reuse in the next export. If the shard
+  /// can be reused, the object commands must not be sent and shardEnd() must
+  /// not be called. A shard that was already written by the current export
+  /// can be started again with the same checksum, transformation and
+  /// material, which just references it once more. Implementations that don't
+  /// support shards just set reused to FALSE and receive the commands as
+  /// usual.
+  ///
+  /// @param[in]  name
+  ///   The name of the shard, which identifies it across exports.
+  /// @param[in]  checksum
+  ///   The checksum of all source data of the shard (except the material).
+  /// @param[in]  dirtyChecksum
+  ///   The checksum of the change state of the source data, under which the
+  ///   shard can be found by findShard() in the next export (0 = unknown).
+  /// @param[in]  matrix
+  ///   The transformation of the object(s) in the shard.
+  /// @param[in]  material
+  ///   The name of the material that is referenced in the shard.
+  /// @param[out]  reused
+  ///   Will be set to TRUE if an already written shard is reused.
+  /// @return
+  ///   TRUE if executed successfully, otherwise FALSE.
+  virtual Bool shardBegin(IdentifierName   name,
+                          ULONG            checksum,
+                          ULONG            dirtyChecksum,
+                          const LuxMatrix& matrix,
+                          IdentifierName   material,
+                          Bool&            reused) =0;
+
+  /// Ends the shard that was started by shardBegin().
+  ///
+  /// @return
+  ///   TRUE if executed successfully, otherwise FALSE.
+  virtual Bool shardEnd(void) =0;
 };
 
 
@@ -27,12 +27,14 @@
 #include <olight.h>
 
 #include "filepath.h"
+#include "geometrykernels.h"
 #include "luxapiconverter.h"
 #include "luxc4dcameratag.h"
 #include "luxc4dlighttag.h"
 #include "luxc4dmaterial.h"
 #include "luxc4dsettings.h"
 #include "luxmaterialdata.h"
+#include "luxprofiler.h"
 #include "tluxc4dcameratag.h"
 #include "tluxc4dlighttag.h"
 #include "tluxc4dportaltag.h"
@@ -61,6 +63,43 @@ static inline Bool equalUVs(const LuxVector2D& uv1, const LuxVector2D& uv2)
 }
 
 
+/// Adds the bytes of a value to a (FNV-1a) checksum.
+template <class T>
+static inline ULONG hashValue(ULONG checksum, const T& value)
+{
+  const UCHAR* bytes = (const UCHAR*)&value;
+  for (SizeT i=0; i<sizeof(T); ++i) {
+    checksum = (checksum ^ bytes[i]) * 16777619;
+  }
+  return checksum;
+}
+
+
+/// Adds a block of bytes to a 64 bit (FNV-1a) checksum.
+static inline VULONG hashBytes64(VULONG checksum, const void* data, SizeT size)
+{
+  const UCHAR* bytes = (const UCHAR*)data;
+  for (SizeT i=0; i<size; ++i) {
+    checksum = (checksum ^ bytes[i]) * 1099511628211ULL;
+  }
+  return checksum;
+}
+
+
+/// Adds the bytes of a value to a 64 bit (FNV-1a) checksum.
+template <class T>
+static inline VULONG hashValue64(VULONG checksum, const T& value)
+{
+  return hashBytes64(checksum, &value, sizeof(T));
+}
+
+
+/// The token that identifies the current session, i.e. that is different each
+/// time C4D is started. It's used to invalidate checksums that contain dirty
+/// counts or addresses and is set once by LuxAPIConverter::initSession().
+static ULONG sSessionToken = 0;
+
+
 /// Converts a C4D dispersion into Lux roughness.
 static inline LuxFloat c4dDispersionToLuxRoughness(LuxFloat dispersion)
 {
@@ -76,6 +115,8 @@ static inline LuxFloat c4dDispersionToLuxRoughness(LuxFloat dispersion)
 /// Constructs and initialises a new LuxAPIConverter instance.
 LuxAPIConverter::LuxAPIConverter(void)
 : mReceiver(0),
+  mProgress(0),
+  mObjectChecksums(0),
   mTempParamSet(64)
 {}
 
@@ -85,6 +126,42 @@ LuxAPIConverter::~LuxAPIConverter(void)
 {}
 
 
+/// Initialises the data that is shared by all converters of a session. It has
+/// to be called once when the plugin is started, i.e. before any conversion
+/// can run in another thread.
+void LuxAPIConverter::initSession(void)
+{
+  if (!sSessionToken) {
+    sSessionToken = hashValue(hashValue((ULONG)2166136261U, GeGetTimer()), &sSessionToken) | 1;
+  }
+}
+
+
+/// Returns the token of the current session, which is set by initSession().
+ULONG LuxAPIConverter::sessionToken(void)
+{
+  return sSessionToken;
+}
+
+
+/// Records the dirty checksums of all polygon objects of a document, which
+/// allow an incremental export of a copy of the document to find the unchanged
+/// shards of the previous export without reading the geometry (the dirty
+/// counts of the copy don't tell anything about the original). It has to be
+/// called from the main thread before the document is copied.
+///
+/// @param[in]  document
+///   The original document.
+/// @param[out]  checksums
+///   The dictionary which will contain the checksums afterwards.
+void LuxAPIConverter::recordObjectChecksums(BaseDocument&     document,
+                                            ObjectChecksumsT& checksums)
+{
+  checksums.erase();
+  recordObjectTree(document.GetFirstObject(), 0, checksums);
+}
+
+
 /// Converts a scene into a set of Lux API commands and sends them to a LuxAPI
 /// implementation, which can consume the data.
 ///
@@ -96,73 +173,116 @@ LuxAPIConverter::~LuxAPIConverter(void)
 ///   If enabled just the global scene data will be written.
 /// @param[in]  forceFullExport
 ///   Exports everything, even if resume is TRUE.
+/// @param[in]  animation
+///   If set to TRUE, the scene is exported as a frame of an animation, i.e.
+///   all objects go into content-addressed shards, which are shared with the
+///   other frames, and only their transformations are written per frame.
 /// @return
 ///   TRUE if the scene could be exported, otherwise FALSE
 Bool LuxAPIConverter::convertScene(BaseDocument& document,
                                    LuxAPI&       receiver,
                                    Bool          resume,
-                                   Bool          forceFullExport)
+                                   Bool          forceFullExport,
+                                   Bool          animation)
 {
   Bool     returnValue = FALSE;
   DateTime time;
   CHAR     buffer[256];
 
-  // show hourglass as mouse pointer
-  SetMousePointer(MOUSE_BUSY);
+  // show hourglass as mouse pointer (frames of an animation can be converted
+  // in worker threads, which must not touch the GUI)
+  Bool mainThread = GeIsMainThread();
+  if (mainThread) {
+    SetMousePointer(MOUSE_BUSY);
+  }
 
   // init internal data
   mDocument = &document;
   mReceiver = &receiver;
+  mAnimation = animation;
   clearTemporaryData();
 
   // get global scene data like camera, environment, render settings...
-  if (!obtainGlobalSceneData()) {
-    goto CLEANUP_AND_RETURN;
-  }
+  {
+    LuxProfileScope profileScope("global settings", mReceiver);
+    if (!startProgressPhase(LuxExportProgress::PHASE_SETTINGS) ||
+        !obtainGlobalSceneData())
+    {
+      goto CLEANUP_AND_RETURN;
+    }
 
-  // create file head (only important for file export)
-  GetDateTimeNow(time);
-  sprintf(buffer, "# LuxRender scene file\n# Exported by LuxC4D on %d/%d/%d",
+    // create file head (only important for file export)
+    GetDateTimeNow(time);
+    sprintf(buffer, "# LuxRender scene file\n# Exported by LuxC4D on %d/%d/%d",
 #if _C4D_VERSION < 120
-                  (int)time.lDay, (int)time.lMonth, (int)time.lYear);
+                    (int)time.lDay, (int)time.lMonth, (int)time.lYear);
 #else
-                  (int)time.day, (int)time.month, (int)time.year);
+                    (int)time.day, (int)time.month, (int)time.year);
 #endif
 
-  // start the scene
-  if (!mReceiver->startScene(buffer)) { 
-    goto CLEANUP_AND_RETURN;
-  }
+    // start the scene
+    if (!mReceiver->startScene(buffer)) { 
+      goto CLEANUP_AND_RETURN;
+    }
 
-  // export global data
-  if (!exportFilm(resume) ||
-      !exportCamera() ||
-      !exportPixelFilter() ||
-      !exportSampler() ||
-      !exportSurfaceIntegrator() ||
-      !exportAccelerator())
-  {
-    goto CLEANUP_AND_RETURN;
+    // export global data
+    if (!exportFilm(resume) ||
+        !exportCamera() ||
+        !exportPixelFilter() ||
+        !exportSampler() ||
+        !exportSurfaceIntegrator() ||
+        !exportAccelerator())
+    {
+      goto CLEANUP_AND_RETURN;
+    }
   }
 
   if (!resume || forceFullExport) {
     // export scene description
     if (!mReceiver->worldBegin() ||
-        !exportLights() ||
-        !exportStandardMaterials() ||
-        !exportGeometry() ||
-        !exportInfiniteLight() ||
-        !exportAutoLight() ||
-
-        !mReceiver->worldEnd())
+        !collectSceneObjects())
     {
       goto CLEANUP_AND_RETURN;
     }
+    {
+      LuxProfileScope profileScope("lights", mReceiver);
+      if (!exportLights())  goto CLEANUP_AND_RETURN;
+    }
+    {
+      LuxProfileScope profileScope("materials", mReceiver);
+      if (!exportStandardMaterials())  goto CLEANUP_AND_RETURN;
+    }
+    {
+      LuxProfileScope profileScope("geometry", mReceiver);
+      if (!exportGeometry())  goto CLEANUP_AND_RETURN;
+    }
+    {
+      LuxProfileScope profileScope("infinite light", mReceiver);
+      if (!exportInfiniteLight() ||
+          !exportAutoLight() ||
+          !mReceiver->worldEnd())
+      {
+        goto CLEANUP_AND_RETURN;
+      }
+    }
   }
 
-  // close scene
-  if (!mReceiver->endScene()) {
-    goto CLEANUP_AND_RETURN;
+  {
+    LuxProfileScope profileScope("writer flush", mReceiver);
+
+    // create the preprocessed copies of all referenced textures
+    if (mReceiver->textureCache() &&
+        (!startProgressPhase(LuxExportProgress::PHASE_TEXTURES,
+                             (ULONG)mReceiver->textureCache()->imageCount()) ||
+         !mReceiver->textureCache()->processImages()))
+    {
+      goto CLEANUP_AND_RETURN;
+    }
+
+    // close scene
+    if (!mReceiver->endScene()) {
+      goto CLEANUP_AND_RETURN;
+    }
   }
 
   // everything was fine ...
@@ -171,35 +291,37 @@ Bool LuxAPIConverter::convertScene(BaseDocument& document,
 CLEANUP_AND_RETURN:
 
   clearTemporaryData();
-  SetMousePointer(MOUSE_NORMAL);
+  if (mainThread) {
+    SetMousePointer(MOUSE_NORMAL);
+  }
   return returnValue;
 }
 
 
 /// Allocates a new instance of HierarchyData which will be used to keep track
 /// of implicit visibility. It will be called during the object tree traversal
-/// in Hierarchy::Run().
+/// in Hierarchy::Run(). The instance lives in the arena of the export.
 ///
 /// @return
-///    Pointer to the allocated HierarchyData. C4D owns the memory.
+///    Pointer to the allocated HierarchyData. C4D owns the instance.
 void* LuxAPIConverter::Alloc(void)
 {
-  return gNew HierarchyData();
+  return new (mArena) HierarchyData();
 }
 
 
-/// Deallocates an instance of HierarchyData. It will be called during the
-/// object tree traversal in Hierarchy::Run().
+/// Destroys an instance of HierarchyData. It will be called during the
+/// object tree traversal in Hierarchy::Run(). The memory is given back when
+/// the arena is released by clearTemporaryData().
 ///
 /// If for the corresponding node of the hierarchy a new scope was opened,
 /// it will be closed here.
 ///
 /// @param[in]  data
-///   The pointer to the HierarchyData instance to be deallocated.
+///   The pointer to the HierarchyData instance to be destroyed.
 void LuxAPIConverter::Free(void* data)
 {
-  HierarchyData* hierarchyData = (HierarchyData*)data;
-  gDelete(hierarchyData);
+  if (data)  ((HierarchyData*)data)->~HierarchyData();
 }
 
 
@@ -214,16 +336,14 @@ void LuxAPIConverter::CopyTo(void* src, void* dst)
 {
   if (src && dst) {
     ((HierarchyData*)dst)->mVisible = ((HierarchyData*)src)->mVisible;
-    ((HierarchyData*)dst)->mMaterialName = ((HierarchyData*)src)->mMaterialName;
-    ((HierarchyData*)dst)->mHasEmissionChannel = ((HierarchyData*)src)->mHasEmissionChannel;
-    ((HierarchyData*)dst)->mLightGroup = ((HierarchyData*)src)->mLightGroup;
+    ((HierarchyData*)dst)->mMaterialObject = ((HierarchyData*)src)->mMaterialObject;
   }
 }
 
 
-/// Does the actual object export. It will be called during the object tree
-/// traversal in Hierarchy::Run() for every object and will call this->mDo()
-/// which exports that object.
+/// Handles a single object. It will be called during the object tree
+/// traversal in Hierarchy::Run() for every object and will call doCollect()
+/// which records the object, if it has to be exported.
 ///
 /// @param[in/out]  data
 ///   Private helper data that was passed from the parent object (as a copy).
@@ -253,7 +373,7 @@ Bool LuxAPIConverter::Do(void*         data,
     ((HierarchyData*)data)->mVisible = (mode == MODE_ON);
   }
 
-  return (this->*mDo)(*((HierarchyData*)data), *object, globalMatrix, controlObject);
+  return doCollect(*((HierarchyData*)data), *object, globalMatrix, controlObject);
 }
 
 
@@ -265,7 +385,8 @@ Bool LuxAPIConverter::Do(void*         data,
 SizeT LuxAPIConverter::cMaxTextureTags(64);
 
 
-/// Clears all data that is stored during the conversion process.
+/// Clears all data that is stored during the conversion process. The arena is
+/// released last, as the other data might reference objects in it.
 void LuxAPIConverter::clearTemporaryData(void)
 {
   mTempParamSet.clear();
@@ -273,18 +394,64 @@ void LuxAPIConverter::clearTemporaryData(void)
   mCamera          = 0;
   mXResolution     = 0;
   mYResolution     = 0;
+  mCameraPosition  = Vector();
+  mCameraIsOrtho   = FALSE;
+  mCameraPixelScale = 0.0;
   mSkyObject       = 0;
   mPortalCount     = 0;
   mLightCount      = 0;
   mAreaLightObjects.erase();
-  mMaterialUsage.erase();
+  mSymbols.erase();
+  mMaterialNames.erase();
   mReusableMaterials.erase();
+  mBlendMaterials.erase();
+  mObjectMaterials.erase();
   mCachedObject    = 0;
   mPolygonCache.erase();
   mPointCache.erase();
   mNormalCache.erase();
   mUVCache.erase();
-  mDo              = 0;
+  mLightJobs.erase();
+  mGeometryJobs.erase();
+  mSceneIR.clear();
+  mShardCounts.erase();
+  mArena.release();
+}
+
+
+/// Starts a new phase of the conversion in the progress object (if there is
+/// one).
+///
+/// @param[in]  phase
+///   The phase to start.
+/// @param[in]  total  (optional)
+///   The number of items that will be processed in this phase or 0 if it's
+///   unknown.
+/// @return
+///   FALSE if the export was cancelled, TRUE otherwise.
+Bool LuxAPIConverter::startProgressPhase(LuxExportProgress::Phase phase,
+                                         ULONG                    total)
+{
+  if (mProgress && !mProgress->startPhase(phase, total)) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter: export was cancelled");
+  }
+  return TRUE;
+}
+
+
+/// Reports a processed item of a conversion phase to the progress object (if
+/// there is one).
+///
+/// @param[in]  phase
+///   The phase the item belongs to.
+/// @return
+///   FALSE if the export was cancelled, TRUE otherwise.
+Bool LuxAPIConverter::stepProgress(LuxExportProgress::Phase phase)
+{
+  if (mProgress && !mProgress->step(phase)) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter: export was cancelled");
+  }
+  return TRUE;
 }
 
 
@@ -326,6 +493,39 @@ Bool LuxAPIConverter::obtainGlobalSceneData(void)
     mBumpSampleDistance = 0.001 * mC4D2LuxScale;
     mColorGamma = mTextureGamma = getRenderGamma(*mC4DRenderSettings);
   }
+  mIncremental = mAnimation ||
+                 (mLuxC4DSettings && mLuxC4DSettings->useIncrementalExport());
+
+  // set up the texture cache of the receiver (if it has one), which stores
+  // its files in the directory "<scene name>_textures" next to the scene file
+  // (which is the shared scene file for all frames of an animation)
+  LuxTextureCache* textureCache = mReceiver->textureCache();
+  if (textureCache) {
+    LONG maxResolution = 0;
+    LONG memoryBudget = 0;
+    LONG maxEnvironmentResolution = 0;
+    LONG shaderResolution = 0;
+    if (mLuxC4DSettings) {
+      maxResolution = mLuxC4DSettings->getMaxTextureResolution();
+      memoryBudget  = mLuxC4DSettings->getTextureMemoryBudget();
+      maxEnvironmentResolution = mLuxC4DSettings->getMaxEnvironmentResolution();
+      shaderResolution = mLuxC4DSettings->getShaderBakeResolution();
+    }
+    Filename sceneFilename(mReceiver->getSharedFilename());
+    Filename cacheName(sceneFilename.GetFile());
+    cacheName.ClearSuffix();
+    Filename cacheDirectory(sceneFilename.GetDirectory());
+    cacheDirectory += Filename(cacheName.GetString() + "_textures");
+    if (!textureCache->init(cacheDirectory,
+                            maxResolution,
+                            memoryBudget,
+                            maxEnvironmentResolution,
+                            shaderResolution))
+    {
+      ERRLOG("LuxAPIConverter::obtainGlobalSceneData(): could not initialise texture cache -> textures will be exported unprocessed");
+    }
+  }
+  mBakeShaders = (textureCache && textureCache->bakesShaders());
 
   // obtain stage object if there is one
   BaseObject *stageObject = mDocument->GetHighest(Ostage, FALSE);
@@ -396,6 +596,16 @@ Bool LuxAPIConverter::exportFilm(Bool resume)
       outputFilename = mDocument->GetDocumentName();
     }
   }
+  // the frames of an animation get their own image - if the image isn't named
+  // after the (frame) scene file already, the frame number is appended
+  if (mAnimation && (outputFilename != mReceiver->getSceneFilename())) {
+    Filename frameFile(outputFilename.GetFile());
+    frameFile.ClearSuffix();
+    CHAR frameNumber[32];
+    sprintf(frameNumber, "_%04d",
+            (int)mDocument->GetTime().GetFrame(mDocument->GetFps()));
+    outputFilename.SetFile(Filename(frameFile.GetString() + frameNumber));
+  }
   FilePath outputFilePath(outputFilename);
   outputFilePath.setSuffix(String());
   mReceiver->processFilePath(outputFilePath);
@@ -425,7 +635,8 @@ Bool LuxAPIConverter::exportFilm(Bool resume)
   
   // otherwise, obtain settings from object
   const char *name;
-  mLuxC4DSettings->getFilm(resume, name, mTempParamSet);
+  mSettingsBuffer.clear();
+  mLuxC4DSettings->getFilm(resume, name, mTempParamSet, mSettingsBuffer);
   return mReceiver->film(name, mTempParamSet);
 }
 
@@ -483,6 +694,21 @@ Bool LuxAPIConverter::exportCamera(void)
     return FALSE;
   }
 
+  // store what we need for estimating the on-screen size of objects: for
+  // perspective cameras the size in pixels of an object of size 1 at
+  // distance 1, for orthographic cameras the number of pixels per unit
+  mCameraPosition = c4dCamMat.off;
+  mCameraIsOrtho  = (parameters.mType == LuxC4DCameraTag::CAMERA_TYPE_ORTHOGRAPHIC);
+  if (mCameraIsOrtho) {
+    mCameraPixelScale = (LReal)mXResolution *
+                        getParameterReal(*mCamera, CAMERA_ZOOM) / 1024.0;
+  } else {
+    LReal filmWidth = getParameterReal(*mCamera, CAMERAOBJECT_APERTURE);
+    mCameraPixelScale = (filmWidth > 0.0) ?
+                        (LReal)mXResolution * getParameterReal(*mCamera, CAMERA_FOCUS) / filmWidth :
+                        0.0;
+  }
+
   // setup parameter set
   LuxString lensSamplingType;
   mTempParamSet.clear();
@@ -549,7 +775,8 @@ Bool LuxAPIConverter::exportPixelFilter(void)
 
   // otherwise, obtain settings from object
   const char *name;
-  mLuxC4DSettings->getPixelFilter(name, mTempParamSet);
+  mSettingsBuffer.clear();
+  mLuxC4DSettings->getPixelFilter(name, mTempParamSet, mSettingsBuffer);
   return mReceiver->pixelFilter(name, mTempParamSet);
 }
 
@@ -573,7 +800,8 @@ Bool LuxAPIConverter::exportSampler(void)
 
   // otherwise, obtain settings from object
   const char *name;
-  mLuxC4DSettings->getSampler(name, mTempParamSet, mXResolution, mYResolution);
+  mSettingsBuffer.clear();
+  mLuxC4DSettings->getSampler(name, mTempParamSet, mSettingsBuffer, mXResolution, mYResolution);
   return mReceiver->sampler(name, mTempParamSet);
 }
 
@@ -600,7 +828,8 @@ Bool LuxAPIConverter::exportSurfaceIntegrator(void)
 
   // otherwise, obtain settings from object
   const char *name;
-  mLuxC4DSettings->getSurfaceIntegrator(name, mTempParamSet, mIsBidirectional);
+  mSettingsBuffer.clear();
+  mLuxC4DSettings->getSurfaceIntegrator(name, mTempParamSet, mSettingsBuffer, mIsBidirectional);
   return mReceiver->surfaceIntegrator(name, mTempParamSet);
 }
 
@@ -624,24 +853,28 @@ Bool LuxAPIConverter::exportAccelerator(void)
 
   // otherwise, obtain settings from object
   const char *name;
-  mLuxC4DSettings->getAccelerator(name, mTempParamSet);
+  mSettingsBuffer.clear();
+  mLuxC4DSettings->getAccelerator(name, mTempParamSet, mSettingsBuffer);
   return mReceiver->accelerator(name, mTempParamSet);
 }
 
 
-/// Exports all enabled lights of the scene. Objects used as area lights will
-/// be stored in a set and later the geometry export ignores these.
+/// Traverses the scene hierarchy once and collects everything we have to
+/// export: lights, the sky object and polygon objects (including portal and
+/// area light shape objects). The actual export is done afterwards from the
+/// collected lists, in the order LuxRender needs.
 ///
 /// @return
 ///   TRUE, if successful, FALSE otherwise.
-Bool LuxAPIConverter::exportLights(void)
+Bool LuxAPIConverter::collectSceneObjects(void)
 {
   // safety checks
   GeAssert(mDocument);
   GeAssert(mReceiver);
 
-  // traverse complete scene hierarchy and export all needed objects
-  mDo = &LuxAPIConverter::doLightExport;
+  if (!startProgressPhase(LuxExportProgress::PHASE_COLLECT))  return FALSE;
+
+  // traverse complete scene hierarchy and collect all needed objects
   HierarchyData data;
 #if _C4D_VERSION >= 120
   return Run(mDocument, FALSE, 1.0, FALSE, BUILDFLAGS_EXTERNALRENDERER, &data, 0);
@@ -651,50 +884,100 @@ Bool LuxAPIConverter::exportLights(void)
 }
 
 
-/// Does the actual export of a light object and will be called by Do().
+/// Records an object for later export, if it's needed. It will be called by
+/// Do().
 ///
 /// @param[in]  data
 ///   The hierarchy data for this object.
 /// @param[in]  object
-///   The object to export.
+///   The object to check.
 /// @param[in]  globalMatrix
-///   The global matrix of the object to export.
+///   The global matrix of the object.
 /// @param[in]  controlObject
 ///   TRUE if this object is a control object for generated geometry further
 ///   down the hierarchy.
 /// @return
 ///   TRUE, if successful, FALSE otherwise.
-Bool LuxAPIConverter::doLightExport(HierarchyData& hierarchyData,
-                                    BaseObject&    object,
-                                    const Matrix&  globalMatrix,
-                                    Bool           controlObject)
-{
-  // skip generator objects, invisible objects, objects that are no lights
-  // or lights that are not enabled
-  if (controlObject ||
-      !hierarchyData.mVisible ||
-      ((object.GetType() != Olight) && (object.GetType() != Osky)) ||
-      !object.GetDeformMode())
-  {
-    return TRUE;
+Bool LuxAPIConverter::doCollect(HierarchyData& hierarchyData,
+                                BaseObject&    object,
+                                const Matrix&  globalMatrix,
+                                Bool           controlObject)
+{
+  // if the object has a valid texture tag, its material will be used by the
+  // object and its children - but it's only exported when the first shape
+  // that uses it gets exported (this has to be tracked for invisible objects,
+  // too, as their children may be visible)
+  TextureTagsT textureTags(0, cMaxTextureTags);
+  if (collectTextureTags(object, textureTags)) {
+    hierarchyData.mMaterialObject = &object;
   }
 
+  // skip generator objects and invisible objects as early as possible
+  if (controlObject || !hierarchyData.mVisible) { return TRUE; }
+
 #if _C4D_VERSION>=100
   // skip objects that belong to a layer that should not be rendered
   const LayerData* layerData = object.GetLayerData(mDocument);
   if (layerData && !layerData->render) { return TRUE; }
 #endif
 
-  // if the object is a sky object, record it if haven't done it already
-  // (we will create the according light object later, when we know if there
-  // are any portal objects in the scene)
-  if (object.GetType() == Osky) {
-    if (!mSkyObject) { mSkyObject = &object; }
-    return TRUE;
+  switch (object.GetType()) {
+
+    // record enabled lights
+    case Olight:
+      if (object.GetDeformMode()) {
+        LightJob job;
+        job.mObject       = &object;
+        job.mGlobalMatrix = globalMatrix;
+        if (!mLightJobs.push(job)) {
+          ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::doCollect(): not enough memory to store light");
+        }
+      }
+      break;
+
+    // if the object is an enabled sky object, record it if haven't done it
+    // already (we will create the according light object later, when we know
+    // if there are any portal objects in the scene)
+    case Osky:
+      if (object.GetDeformMode() && !mSkyObject) { mSkyObject = &object; }
+      break;
+
+    // record polygon objects
+    case Opolygon:
+      {
+        GeometryJob job;
+        job.mObject         = (PolygonObject*)&object;
+        job.mGlobalMatrix   = globalMatrix;
+        job.mMaterialObject = hierarchyData.mMaterialObject;
+        if (!mGeometryJobs.push(job)) {
+          ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::doCollect(): not enough memory to store polygon object");
+        }
+      }
+      break;
   }
 
-  // export light object
-  return exportLight(object, globalMatrix);
+  return TRUE;
+}
+
+
+/// Exports all collected lights of the scene. Objects used as area lights will
+/// be stored in a set and later the geometry export ignores these.
+///
+/// @return
+///   TRUE, if successful, FALSE otherwise.
+Bool LuxAPIConverter::exportLights(void)
+{
+  if (!startProgressPhase(LuxExportProgress::PHASE_LIGHTS, (ULONG)mLightJobs.size())) {
+    return FALSE;
+  }
+  for (SizeT i=0; i<mLightJobs.size(); ++i) {
+    if (!exportLight(*mLightJobs[i].mObject, mLightJobs[i].mGlobalMatrix) ||
+        !stepProgress(LuxExportProgress::PHASE_LIGHTS))
+    {
+      return FALSE;
+    }
+  }
+  return TRUE;
 }
 
 
@@ -732,14 +1015,13 @@ Bool LuxAPIConverter::exportLight(BaseObject&   lightObject,
   if (!mReceiver->setComment("light '" + lightObject.GetName() + "'"))  return FALSE;
   if (!mReceiver->attributeBegin())  return FALSE;
   if (parameters.mGroup.Content()) {
-    LuxString lightGroup;
-    convert2LuxString(parameters.mGroup, lightGroup);
-    if (!mReceiver->lightGroup(lightGroup.c_str()))  return FALSE;
+    LuxSymbol lightGroup = mSymbols.intern(parameters.mGroup);
+    if (!lightGroup || !mReceiver->lightGroup(lightGroup->c_str()))  return FALSE;
   }
 
   // now determine the data depending on the light type and export the data
   // needed for this type
-  debugLog("exporting light object '" + lightObject.GetName() + "' ...");
+  LOG_DEBUG("exporting light object '" + lightObject.GetName() + "' ...");
   switch (parameters.mType) {
 
     case IDD_LIGHT_TYPE_POINT:
@@ -929,7 +1211,7 @@ Bool LuxAPIConverter::exportDistantLight(DistantLightData& data)
 ///   TRUE, if successful, FALSE otherwise
 Bool LuxAPIConverter::exportAreaLight(AreaLightData& data)
 {
-  LuxParamSet shapeParams(8);
+  LuxParamSetN<8> shapeParams;
   const char* shapeName;
   LuxFloat    radius, zMin, zMax;
   Real        xRad, yRad, zRad;
@@ -1163,7 +1445,7 @@ Bool LuxAPIConverter::exportAutoLight(void)
     return TRUE;
   }
 
-  debugLog("exporting auto light ...");
+  LOG_DEBUG("exporting auto light ...");
 
   // setup and export point light at the position of the camera (works with all
   // integrators)
@@ -1200,7 +1482,7 @@ Bool LuxAPIConverter::exportInfiniteLight(void)
   }
 
   // start new attribute scope
-  debugLog("exporting infinite/sky light ...");
+  LOG_DEBUG("exporting infinite/sky light ...");
   if (!mReceiver->setComment("start of infinite light '" + mSkyObject->GetName() + "'"))  return FALSE;
   if (!mReceiver->attributeBegin())  return FALSE;
 
@@ -1210,9 +1492,8 @@ Bool LuxAPIConverter::exportInfiniteLight(void)
 
   // write light group if available
   if (parameters.mGroup.Content()) {
-    LuxString lightGroup;
-    convert2LuxString(parameters.mGroup, lightGroup);
-    if (!mReceiver->lightGroup(lightGroup.c_str()))  return FALSE;
+    LuxSymbol lightGroup = mSymbols.intern(parameters.mGroup);
+    if (!lightGroup || !mReceiver->lightGroup(lightGroup->c_str()))  return FALSE;
   }
 
   // store all parameters except the light type name
@@ -1231,7 +1512,13 @@ Bool LuxAPIConverter::exportInfiniteLight(void)
   Bool       hasTexture = FALSE;
   if (parameters.mSkyTexFilename.Content()) {
     l = LuxColor(1.0);
-    FilePath mapPath(parameters.mSkyTexFilename);
+    // use the downscaled copy of the texture cache, if the receiver has one
+    Filename mapFilename(parameters.mSkyTexFilename);
+    if (mReceiver->textureCache()) {
+      mReceiver->textureCache()->addEnvironmentMap(parameters.mSkyTexFilename,
+                                                   mapFilename);
+    }
+    FilePath mapPath(mapFilename);
     mReceiver->processFilePath(mapPath);
     mapName = mapPath.getLuxString();
     mTempParamSet.addParam(LUX_STRING, "mapname", &mapName);
@@ -1268,29 +1555,44 @@ Bool LuxAPIConverter::exportStandardMaterials(void)
 {
   LuxMatteData defaultMaterial;
   defaultMaterial.setChannel(LuxMatteData::DIFFUSE,
-                             gNew LuxConstantTextureData(LuxColor(0.8f, 0.8f, 0.8f),
-                                                         mColorGamma));
+                             inArena(new (mArena) LuxConstantTextureData(LuxColor(0.8f, 0.8f, 0.8f),
+                                                                         mColorGamma)));
   if (!defaultMaterial.sendToAPI(*mReceiver, "_default")) {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::exportStandardMaterials(): Could not export default material.");
   }
-  mMaterialUsage.add("_default", 1);
+  if (!mMaterialNames.reserve("_default") ||
+      !mMaterialNames.reserve("_null"))
+  {
+    return FALSE;
+  }
+  LuxSymbol defaultName = mSymbols.intern(LuxString("_default"));
+  if (!defaultName ||
+      !mObjectMaterials.add(0, ReusableMaterial(defaultName, FALSE, 0, 0, 0, 0)))
+  {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::exportStandardMaterials(): not enough memory to store default material.");
+  }
 
   LuxNullMaterialData nullMaterial;
   if (!nullMaterial.sendToAPI(*mReceiver, "_null")) {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::exportStandardMaterials(): Could not export null material.");
   }
-  mMaterialUsage.add("_null", 1);
 
   return TRUE;
 }
 
 
-/// Exports all geometry objects of the scene that are not used by area lights.
+/// Exports all collected geometry objects of the scene that are not used by
+/// area lights. The objects are converted into the scene IR, which is emitted
+/// and cleared whenever its mesh data exceeds a budget. That way we never
+/// hold much more than the budget or the largest single mesh in memory.
 ///
 /// @return
 ///   TRUE, if successful, FALSE otherwise
 Bool LuxAPIConverter::exportGeometry(void)
 {
+  // the mesh data size of the scene IR from which on it gets emitted
+  static const size_t cSceneIRBudget = 64 * 1024 * 1024;
+
   // safety checks
   GeAssert(mDocument);
   GeAssert(mReceiver);
@@ -1302,17 +1604,21 @@ Bool LuxAPIConverter::exportGeometry(void)
     return FALSE;
   }
 
-  // traverse complete scene hierarchy and export all needed objects
-  mDo = &LuxAPIConverter::doGeometryExport;
-  HierarchyData data;
-  data.mMaterialName = "_default";
-#if _C4D_VERSION >= 120
-  if (!Run(mDocument, FALSE, 1.0, FALSE, BUILDFLAGS_EXTERNALRENDERER, &data, 0)) {
-#else
-  if (!Run(mDocument, FALSE, 1.0, VFLAG_EXTERNALRENDERER | VFLAG_POLYGONAL, &data, 0)) {
-#endif
+  // convert all collected polygon objects and emit them in batches
+  mSceneIR.clear();
+  if (!startProgressPhase(LuxExportProgress::PHASE_GEOMETRY, (ULONG)mGeometryJobs.size())) {
     return FALSE;
   }
+  for (SizeT i=0; i<mGeometryJobs.size(); ++i) {
+    if (!convertGeometryJob(mGeometryJobs[i], (LuxSceneIR::IndexT)i))  return FALSE;
+    if ((mSceneIR.meshDataSize() >= cSceneIRBudget) || (i+1 == mGeometryJobs.size())) {
+      for (LuxSceneIR::IndexT instance=0; instance<mSceneIR.instanceCount(); ++instance) {
+        if (!exportInstance(instance))  return FALSE;
+      }
+      mSceneIR.clear();
+    }
+    if (!stepProgress(LuxExportProgress::PHASE_GEOMETRY))  return FALSE;
+  }
 
   // close global attribute scope
   if (!mReceiver->setComment("end of world scope") || !mReceiver->attributeEnd()) {
@@ -1323,112 +1629,607 @@ Bool LuxAPIConverter::exportGeometry(void)
 }
 
 
-/// Does the actual export of a geometry object and will be called by Do().
+/// Converts a collected polygon object into an instance of the scene IR.
 ///
-/// @param[in]  data
-///   The hierarchy data for this object.
-/// @param[in]  object
-///   The object to export.
-/// @param[in]  globalMatrix
-///   The global matrix of the object to export.
-/// @param[in]  controlObject
-///   TRUE if this object is a control object for generated geometry further
-///   down the hierarchy.
+/// In incremental mode, the meshes are only converted, if the shard of the
+/// previous export can't be reused.
+///
+/// @param[in]  job
+///   The collected polygon object.
+/// @param[in]  jobIndex
+///   The index of the job in mGeometryJobs.
 /// @return
 ///   TRUE, if successful, FALSE otherwise.
-Bool LuxAPIConverter::doGeometryExport(HierarchyData& hierarchyData,
-                                       BaseObject&    object,
-                                       const Matrix&  globalMatrix,
-                                       Bool           controlObject)
+Bool LuxAPIConverter::convertGeometryJob(const GeometryJob&  job,
+                                         LuxSceneIR::IndexT jobIndex)
 {
-  // collect all texture tags with a valid link and which are not restricted
-  // to a selection
-  TextureTagsT textureTags(0, cMaxTextureTags);
-  for (BaseTag* tag=object.GetFirstTag(); tag; tag=tag->GetNext()) {
-    if (tag->GetType() == Ttexture) {
-      if (!getParameterLink(*tag, TEXTURETAG_MATERIAL, Mbase) ||
-          getParameterString(*tag, TEXTURETAG_RESTRICTION).Content())
-      {
-        continue;
-      }
-      textureTags.push((TextureTag*)tag);
-      if (textureTags.size() == cMaxTextureTags) { break; }
+  PolygonObject& object(*job.mObject);
+  const Matrix&  globalMatrix(job.mGlobalMatrix);
+
+  // skip objects that have already been exported as area light
+  if (mAreaLightObjects.get(&object))  return TRUE;
+
+  LuxProfileScope profileScope("convert object");
+  profileScope.setObject(object);
+
+  // add material reference and transformation
+  LuxMatrix          transformMatrix(globalMatrix, mC4D2LuxScale);
+  LuxSceneIR::IndexT material = mSceneIR.addMaterial(job.mMaterialObject);
+  LuxSceneIR::IndexT transform = mSceneIR.addTransform(transformMatrix.values);
+  if ((material == LuxSceneIR::cInvalidIndex) ||
+      (transform == LuxSceneIR::cInvalidIndex))
+  {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertGeometryJob(): not enough memory to store object in scene IR");
+  }
+
+  // in incremental mode, check if the shard of the previous export is still
+  // current - shards are addressed by their content and material, as we
+  // convert a copy of the document, whose addresses and dirty counts don't
+  // tell anything about the objects of the previous export; if the object
+  // didn't change since then according to the dirty checksum recorded from
+  // the original document, we take name and checksum of its shard from the
+  // manifest instead of reading the geometry; in animation mode the shard
+  // might have been written by a previous frame, too
+  LuxString shardName;
+  ULONG     checksum = 0;
+  ULONG     dirtyChecksum = 0;
+  Bool      cached = FALSE;
+  if (mIncremental) {
+    ReusableMaterial* reusableMaterial = obtainObjectMaterial(job.mMaterialObject);
+    if (!reusableMaterial)  return FALSE;
+    if (!mAnimation)  dirtyChecksum = getShardDirtyChecksum(job, *reusableMaterial);
+    if (dirtyChecksum && mReceiver->findShard(dirtyChecksum, shardName, checksum)) {
+      // strip the suffix of repeated content, getShardName() adds it again
+      LuxString::size_type suffix = shardName.find('_');
+      if (suffix != LuxString::npos)  shardName.erase(suffix);
+    } else {
+      getShardContentChecksum(job, *reusableMaterial, shardName, checksum);
+    }
+    if (mAnimation) {
+      cached = mReceiver->isShardCurrent(shardName.c_str(), checksum, LuxMatrix());
+    } else {
+      if (!getShardName(shardName))  return FALSE;
+      cached = mReceiver->isShardCurrent(shardName.c_str(), checksum, transformMatrix);
     }
   }
 
-  // if we have found a valid texture tag, export material
-  if (textureTags.size()) {
-    if (!exportMaterial(object,
-                        textureTags,
-                        hierarchyData.mMaterialName,
-                        hierarchyData.mHasEmissionChannel,
-                        hierarchyData.mLightGroup))
+  // convert the meshes of the object and its portal
+  LuxSceneIR::IndexT mesh;
+  LuxSceneIR::IndexT portalMesh;
+  unsigned int       flags;
+  if (!convertJobMeshes(job, !cached, mesh, portalMesh, flags))  return FALSE;
+
+  // estimate the resolution the textures of the object need
+  LONG             textureResolution = 0;
+  LuxTextureCache* textureCache = mReceiver->textureCache();
+  if ((flags & LuxSceneIR::INSTANCE_SHAPE) && job.mMaterialObject &&
+      textureCache && textureCache->isEnabled())
+  {
+    textureResolution = estimateTextureResolution(object, globalMatrix);
+  }
+
+  // store the instance with its UTF-8 name, which is used for the comments
+  CHAR name[2048];
+  object.GetName().GetCString(name, sizeof(name), STRINGENCODING_UTF8);
+  name[sizeof(name)-1] = '\0';
+  LuxSceneIR::IndexT instance = mSceneIR.addInstance(name,
+                                                     mesh,
+                                                     transform,
+                                                     material,
+                                                     portalMesh,
+                                                     flags,
+                                                     textureResolution);
+  if (instance == LuxSceneIR::cInvalidIndex) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertGeometryJob(): not enough memory to store object in scene IR");
+  }
+  if (mIncremental) {
+    mSceneIR.setInstanceShard(instance, shardName, checksum, dirtyChecksum, jobIndex);
+  }
+
+  return TRUE;
+}
+
+
+/// Converts the meshes of a collected polygon object and its portal (if it
+/// has one) and determines the flags of its instance.
+///
+/// @param[in]  job
+///   The collected polygon object.
+/// @param[in]  convertMeshes
+///   If set to FALSE, only the flags are determined and the instance is
+///   marked as cached.
+/// @param[out]  mesh
+///   The index of the converted mesh or LuxSceneIR::cInvalidIndex.
+/// @param[out]  portalMesh
+///   The index of the converted portal mesh or LuxSceneIR::cInvalidIndex.
+/// @param[out]  flags
+///   The flags of the instance (see LuxSceneIR::InstanceFlags).
+/// @return
+///   TRUE, if successful, FALSE otherwise.
+Bool LuxAPIConverter::convertJobMeshes(const GeometryJob&  job,
+                                       Bool                convertMeshes,
+                                       LuxSceneIR::IndexT& mesh,
+                                       LuxSceneIR::IndexT& portalMesh,
+                                       unsigned int&       flags)
+{
+  PolygonObject& object(*job.mObject);
+
+  mesh = LuxSceneIR::cInvalidIndex;
+  portalMesh = LuxSceneIR::cInvalidIndex;
+  flags = 0;
+
+  // check if object has portal tag and if it does, convert the portal shape
+  BaseTag* portalTag = findTagForParamObject(&object, PID_LUXC4D_PORTAL_TAG);
+  Bool     doObjectExport = TRUE;
+  if (portalTag && convertMeshes) {
+    Bool flipPortal = FALSE;
+    if (!convertPortalObject(object,
+                             *portalTag,
+                             portalMesh,
+                             flipPortal,
+                             doObjectExport))
     {
       return FALSE;
     }
+    if (portalMesh != LuxSceneIR::cInvalidIndex) {
+      flags |= LuxSceneIR::INSTANCE_PORTAL;
+    }
+    if (flipPortal) {
+      flags |= LuxSceneIR::INSTANCE_PORTAL_FLIP;
+    }
+  } else if (portalTag) {
+    // only evaluate the portal settings without converting anything
+    BaseContainer* tagData = portalTag->GetDataInstance();
+    if (!tagData)  return FALSE;
+    if (object.GetPolygonCount() && tagData->GetBool(IDD_PORTAL_ENABLED)) {
+      flags |= LuxSceneIR::INSTANCE_PORTAL;
+      doObjectExport = tagData->GetBool(IDD_PORTAL_EXPORT_OBJECT);
+    }
   }
 
-  // skip generator objects, invisible objects, objects that are no polygon
-  // objects or objects that have already been exported as area light
-  if (controlObject || !hierarchyData.mVisible ||
-      (object.GetType() != Opolygon) || mAreaLightObjects.get(&object))
-  {
-    return TRUE;
+  // if we still want the object exported, convert its geometry
+  if (doObjectExport) {
+    flags |= LuxSceneIR::INSTANCE_SHAPE;
+    if (convertMeshes && !convertPolygonObject(object, mesh))  return FALSE;
+  }
+  if (!convertMeshes) {
+    flags |= LuxSceneIR::INSTANCE_CACHED;
   }
 
-#if _C4D_VERSION>=100
-  // skip objects that belong to a layer that should not be rendered
-  const LayerData* layerData = object.GetLayerData(mDocument);
-  if (layerData && !layerData->render) {
-    return TRUE;
+  return TRUE;
+}
+
+
+/// Makes the content name of a shard unique in incremental mode, where every
+/// instance gets its own shard including its transformation. If several
+/// objects of the export have the same content, a counter is appended to the
+/// name of each repetition. The objects are collected in the order of the
+/// object tree, so unchanged scenes get the same names again.
+///
+/// @param[in,out]  shardName
+///   The content name of the shard, which will be replaced by the unique name.
+/// @return
+///   TRUE, if successful, FALSE otherwise.
+Bool LuxAPIConverter::getShardName(LuxString& shardName)
+{
+  ULONG* count = mShardCounts.get(shardName);
+  if (!count) {
+    count = mShardCounts.add(shardName, 0);
+    if (!count) {
+      ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::getShardName(): not enough memory to store shard count");
+    }
+  }
+  if (*count) {
+    CHAR buffer[16];
+    sprintf(buffer, "_%u", (unsigned int)*count);
+    ++(*count);
+    shardName += buffer;
+  } else {
+    ++(*count);
+  }
+  return TRUE;
+}
+
+
+/// Calculates the content checksum and the name of the shard of a polygon
+/// object in incremental mode. Both are derived from everything that ends up
+/// in the shard, except its transformation, which is written into the frame in
+/// animation mode and checked separately otherwise: the scale, the points,
+/// polygons, vertex normals and UVs of the object, its portal settings and the
+/// name, light group and emission texture of its material. So deformed objects
+/// get a new shard, while the shard of an object that only moves is shared by
+/// all frames. The name is a 64 bit checksum, so collisions are very unlikely.
+///
+/// @param[in]  job
+///   The collected polygon object.
+/// @param[in]  material
+///   The material of the object.
+/// @param[out]  shardName
+///   The name of the shard will be stored here.
+/// @param[out]  checksum
+///   The checksum of the shard will be stored here.
+void LuxAPIConverter::getShardContentChecksum(const GeometryJob&      job,
+                                              const ReusableMaterial& material,
+                                              LuxString&              shardName,
+                                              ULONG&                  checksum)
+{
+  PolygonObject& object(*job.mObject);
+
+  VULONG hash = 14695981039346656037ULL;
+  hash = hashValue64(hash, mC4D2LuxScale);
+  hash = hashBytes64(hash, material.mName->c_str(), material.mName->size());
+  hash = hashValue64(hash, material.mHasEmissionChannel);
+  if (material.mHasEmissionChannel) {
+    if (material.mLightGroup) {
+      hash = hashBytes64(hash, material.mLightGroup->c_str(), material.mLightGroup->size());
+    }
+    if (material.mEmissionTexture) {
+      hash = hashBytes64(hash, material.mEmissionTexture->c_str(), material.mEmissionTexture->size());
+    }
+  }
+
+  // points and polygons
+  LONG            pointCount = object.GetPointCount();
+  LONG            polygonCount = object.GetPolygonCount();
+  const Vector*   points = getPoints(object);
+  const CPolygon* polygons = getPolygons(object);
+  hash = hashValue64(hash, pointCount);
+  hash = hashValue64(hash, polygonCount);
+  if (points)  hash = hashBytes64(hash, points, sizeof(Vector)*pointCount);
+  if (polygons)  hash = hashBytes64(hash, polygons, sizeof(CPolygon)*polygonCount);
+
+  // the vertex normals, which also depend on the phong tag
+  C4DNormalsT normals;
+  SVector*    c4dNormals = object.CreatePhongNormals();
+  if (c4dNormals) {
+    normals.setArrayAddress(c4dNormals, polygonCount*4);
+    hash = hashBytes64(hash, c4dNormals, sizeof(SVector)*polygonCount*4);
   }
+
+  // UVs of the first UVW tag
+  UVWTag* uvwTag = (UVWTag*)object.GetTag(Tuvw);
+  if (uvwTag) {
+    UVWStruct polygonUVWs;
+#if _C4D_VERSION>=115
+    UVWHandle tagData = uvwTag->GetDataAddressR();
+    for (LONG polygonIx=0; polygonIx<polygonCount; ++polygonIx) {
+      uvwTag->Get(tagData, polygonIx, polygonUVWs);
+#else
+    for (LONG polygonIx=0; polygonIx<polygonCount; ++polygonIx) {
+      polygonUVWs = uvwTag->Get(polygonIx);
 #endif
+      hash = hashValue64(hash, polygonUVWs);
+    }
+  }
+
+  // portal settings
+  BaseTag*       portalTag = findTagForParamObject(&object, PID_LUXC4D_PORTAL_TAG);
+  BaseContainer* tagData = portalTag ? portalTag->GetDataInstance() : 0;
+  if (tagData) {
+    hash = hashValue64(hash, tagData->GetBool(IDD_PORTAL_ENABLED));
+    hash = hashValue64(hash, tagData->GetBool(IDD_PORTAL_SIMPLIFY));
+    hash = hashValue64(hash, tagData->GetLong(IDD_PORTAL_FACE_DIRECTION));
+    hash = hashValue64(hash, tagData->GetBool(IDD_PORTAL_EXPORT_OBJECT));
+    hash = hashValue64(hash, tagData->GetBool(IDD_PORTAL_FLIP_NORMALS));
+  }
+
+  CHAR buffer[32];
+  sprintf(buffer, "%016llx", (unsigned long long)hash);
+  shardName = buffer;
+  checksum = (ULONG)(hash ^ (hash >> 32));
+}
+
+
+/// Calculates the dirty checksum of a polygon object in incremental mode,
+/// which identifies the shard of the object as long as neither the object
+/// nor its material were changed. It's derived from the checksum recorded for
+/// the original object (see recordObjectChecksums()), the scale and the
+/// material of the object.
+///
+/// @param[in]  job
+///   The collected polygon object.
+/// @param[in]  material
+///   The material of the object.
+/// @return
+///   The dirty checksum or 0, if the object wasn't recorded, e.g. because it
+///   was generated or deformed.
+ULONG LuxAPIConverter::getShardDirtyChecksum(const GeometryJob&      job,
+                                             const ReusableMaterial& material)
+{
+  PolygonObject& object(*job.mObject);
+  if (!mObjectChecksums || object.GetCacheParent())  return 0;
+  const ULONG* objectChecksum = mObjectChecksums->get(objectPath(object));
+  if (!objectChecksum || !*objectChecksum)  return 0;
+
+  VULONG hash = 14695981039346656037ULL;
+  hash = hashValue64(hash, *objectChecksum);
+  hash = hashValue64(hash, mC4D2LuxScale);
+  hash = hashBytes64(hash, material.mName->c_str(), material.mName->size());
+  ULONG checksum = (ULONG)(hash ^ (hash >> 32));
+  return checksum ? checksum : 1;
+}
+
+
+/// Records the dirty checksums of a list of objects and all their children.
+/// The checksum of a polygon object covers the session token and the dirty
+/// counts of the object, its tags and the texture tags and materials of its
+/// material object. Deformed objects are skipped, as their deformers don't
+/// change their dirty counts. Objects with the same path get the checksum 0.
+///
+/// @param[in]  object
+///   The first object of the list (can be NULL).
+/// @param[in]  materialObject
+///   The object whose texture tags define the material of the list (NULL =
+///   default material).
+/// @param[in,out]  checksums
+///   The dictionary to which the checksums are added.
+void LuxAPIConverter::recordObjectTree(BaseObject*       object,
+                                       BaseObject*       materialObject,
+                                       ObjectChecksumsT& checksums)
+{
+  for (; object; object=object->GetNext()) {
+    // the material is inherited like in doCollect()
+    BaseObject*  objectMaterial = materialObject;
+    TextureTagsT textureTags(0, cMaxTextureTags);
+    if (collectTextureTags(*object, textureTags))  objectMaterial = object;
+
+    if ((object->GetType() == Opolygon) && !object->GetDeformCache()) {
+      ULONG checksum = sessionToken();
+      checksum = hashValue(checksum, object->GetDirty(DIRTYFLAGS_DATA));
+      for (BaseTag* tag=object->GetFirstTag(); tag; tag=tag->GetNext()) {
+        checksum = hashValue(checksum, tag->GetType());
+        checksum = hashValue(checksum, tag->GetDirty(DIRTYFLAGS_DATA));
+      }
+      if (objectMaterial) {
+        textureTags.erase();
+        collectTextureTags(*objectMaterial, textureTags);
+        for (SizeT i=0; i<textureTags.size(); ++i) {
+          BaseMaterial* material = textureTags[i]->GetMaterial();
+          checksum = hashValue(checksum, textureTags[i]->GetDirty(DIRTYFLAGS_DATA));
+          checksum = hashValue(checksum, material ? material->GetDirty(DIRTYFLAGS_DATA) : 0);
+        }
+      }
+      String path(objectPath(*object));
+      ULONG* recorded = checksums.get(path);
+      if (recorded) {
+        *recorded = 0;
+      } else if (!checksums.add(path, checksum ? checksum : 1)) {
+        ERRLOG("LuxAPIConverter::recordObjectTree(): not enough memory to store object checksum");
+      }
+    }
+
+    recordObjectTree(object->GetDown(), objectMaterial, checksums);
+  }
+}
+
+
+/// Returns a path that describes the position of an object in the object
+/// hierarchy of its document, e.g. "/Cube:0/Plane:2". It's the same in a copy
+/// of the document.
+String LuxAPIConverter::objectPath(BaseObject& object)
+{
+  String path;
+  for (BaseObject* node=&object; node; node=node->GetUp()) {
+    LONG index = 0;
+    for (BaseObject* pred=node->GetPred(); pred; pred=pred->GetPred()) {
+      ++index;
+    }
+    path = "/" + node->GetName() + ":" + LongToString(index) + path;
+  }
+  return path;
+}
+
+
+/// Exports an instance of the scene IR including its material, its portal
+/// shape and its shape.
+///
+/// @param[in]  instance
+///   The index of the instance in the scene IR.
+/// @return
+///   TRUE, if successful, FALSE otherwise.
+Bool LuxAPIConverter::exportInstance(LuxSceneIR::IndexT instance)
+{
+  // export material, if that hasn't been done yet (outside of the attribute
+  // scope of the object, as named materials and textures are scoped)
+  LuxSceneIR::IndexT materialIx = mSceneIR.instanceMaterial(instance);
+  ReusableMaterial*  material =
+      obtainObjectMaterial((BaseObject*)mSceneIR.materialKey(materialIx));
+  if (!material)  return FALSE;
+
+  // get transformation
+  LuxMatrix    transformMatrix;
+  const float* transformValues = mSceneIR.transform(mSceneIR.instanceTransform(instance));
+  memcpy(transformMatrix.values, transformValues, sizeof(transformMatrix.values));
+
+  // in incremental mode the instance goes into its own shard, which might be
+  // the unchanged shard of the previous export - in animation mode the
+  // attribute scope and the transformation are written into the frame and
+  // only the untransformed object goes into the shard
+  const std::string& objectName(mSceneIR.instanceName(instance));
+  unsigned int       flags = mSceneIR.instanceFlags(instance);
+  Bool               reused = FALSE;
+  LuxProfileScope    profileScope("emit object", mReceiver);
+  if (LuxProfiler::isEnabled()) {
+    LuxSceneIR::IndexT mesh = mSceneIR.instanceMesh(instance);
+    LONG               polygonCount = -1;
+    if (mesh != LuxSceneIR::cInvalidIndex) {
+      polygonCount = (LONG)(mSceneIR.meshTriangleIndexCount(mesh) / 3 +
+                            mSceneIR.meshQuadIndexCount(mesh) / 4);
+    }
+    profileScope.setObject(objectName, polygonCount);
+  }
+  if (mIncremental) {
+    if (mAnimation) {
+      if (!mReceiver->setComment(("start of object '" + objectName + "'").c_str()) ||
+          !mReceiver->attributeBegin() ||
+          !mReceiver->transform(transformMatrix))
+      {
+        return FALSE;
+      }
+    }
+    if (!mReceiver->setComment(("object '" + objectName + "'").c_str()) ||
+        !mReceiver->shardBegin(mSceneIR.instanceShard(instance).c_str(),
+                               mSceneIR.instanceChecksum(instance),
+                               mSceneIR.instanceDirtyChecksum(instance),
+                               mAnimation ? LuxMatrix() : transformMatrix,
+                               material->mName->c_str(),
+                               reused))
+    {
+      return FALSE;
+    }
+    // if the shard looked current during the conversion but can't be reused
+    // (e.g. because the material name changed), convert the meshes now
+    if (!reused && (flags & LuxSceneIR::INSTANCE_CACHED)) {
+      LuxSceneIR::IndexT mesh;
+      LuxSceneIR::IndexT portalMesh;
+      GeAssert(mSceneIR.instanceSource(instance) < mGeometryJobs.size());
+      if (!convertJobMeshes(mGeometryJobs[mSceneIR.instanceSource(instance)],
+                            TRUE, mesh, portalMesh, flags))
+      {
+        return FALSE;
+      }
+      mSceneIR.setInstanceMeshes(instance, mesh, portalMesh, flags);
+    }
+  }
+
+  // if the shard is reused, we only have to keep track of the exported
+  // portals, lights and texture resolutions
+  if (reused) {
+    if (flags & LuxSceneIR::INSTANCE_PORTAL)  ++mPortalCount;
+    if (flags & LuxSceneIR::INSTANCE_SHAPE) {
+      if (material->mHasEmissionChannel)  ++mLightCount;
+      requestTextureResolution(*material, mSceneIR.instanceTextureResolution(instance));
+    }
+    return !mAnimation || endAnimatedInstance(objectName);
+  }
 
   // start new attribute scope
-  hierarchyData.mObjectName = object.GetName();
-  if (!mReceiver->setComment("start of object '" + hierarchyData.mObjectName + "'"))  return FALSE;
-  if (!mReceiver->attributeBegin())  return FALSE;
+  if (!mAnimation) {
+    if (!mReceiver->setComment(("start of object '" + objectName + "'").c_str()))  return FALSE;
+    if (!mReceiver->attributeBegin())  return FALSE;
+  }
 
-  // check if object has portal tag and if it does, export it as portal shape
-  BaseTag* portalTag = findTagForParamObject(&object, PID_LUXC4D_PORTAL_TAG);
-  Bool doObjectExport = TRUE;
-  if (portalTag) {
-    if (!exportPortalObject((PolygonObject&)object,
-                            globalMatrix,
-                            *portalTag,
-                            doObjectExport))
+  // export portal shape, if there is one
+  LuxSceneIR::IndexT portalMesh = mSceneIR.instancePortalMesh(instance);
+  if (portalMesh != LuxSceneIR::cInvalidIndex) {
+    // write transformation matrix
+    if (!mAnimation && !mReceiver->transform(transformMatrix))  return FALSE;
+    // setup shape parameters
+    mTempParamSet.clear();
+    mTempParamSet.addParam(LUX_POINT, "P",
+                           (void*)mSceneIR.meshPoints(portalMesh),
+                           mSceneIR.meshPointCount(portalMesh));
+    if (mSceneIR.meshTriangleIndexCount(portalMesh)) {
+      mTempParamSet.addParam(LUX_TRIANGLE, "triindices",
+                             (void*)mSceneIR.meshTriangles(portalMesh),
+                             mSceneIR.meshTriangleIndexCount(portalMesh));
+    }
+    if (mSceneIR.meshQuadIndexCount(portalMesh)) {
+      mTempParamSet.addParam(LUX_QUAD, "quadindices",
+                             (void*)mSceneIR.meshQuads(portalMesh),
+                             mSceneIR.meshQuadIndexCount(portalMesh));
+    }
+    // if the normals should be flipped, export "reverseorientation"
+    if ((flags & LuxSceneIR::INSTANCE_PORTAL_FLIP) &&
+        !mReceiver->reverseOrientation())
     {
       return FALSE;
     }
+    // export shape
+    if (!mReceiver->portalShape("mesh", mTempParamSet)) { return FALSE; }
+    // set flag that we have exported at least 1 portal -> influences infinite light
+    ++mPortalCount;
   }
 
   // if we still want the object exported:
-  if (doObjectExport) {
+  if (flags & LuxSceneIR::INSTANCE_SHAPE) {
     // export material reference
-    if (!mReceiver->namedMaterial(hierarchyData.mMaterialName.c_str()))  return FALSE;
-    if (hierarchyData.mHasEmissionChannel) {
-      if (hierarchyData.mLightGroup.size()) {
-        if (!mReceiver->lightGroup(hierarchyData.mLightGroup.c_str()))  return FALSE;
+    if (!mReceiver->namedMaterial(material->mName->c_str()))  return FALSE;
+    if (material->mHasEmissionChannel) {
+      if (material->mLightGroup) {
+        if (!mReceiver->lightGroup(material->mLightGroup->c_str()))  return FALSE;
       }
-      LuxParamSet areaParamSet(5);
-      LuxString   textureName = hierarchyData.mMaterialName + ".L";
+      LuxParamSetN<5> areaParamSet;
       LuxFloat    gain = 100.0;
       LuxFloat    power = 0.0;    // a power of 0 disables auto power adjust
-      areaParamSet.addParam(LUX_TEXTURE, "L",     &textureName);
+      areaParamSet.addParam(LUX_TEXTURE, "L",     (void*)material->mEmissionTexture);
       areaParamSet.addParam(LUX_FLOAT,   "gain",  &gain);
       areaParamSet.addParam(LUX_FLOAT,   "power", &power);
       if (!mReceiver->areaLightSource("area", areaParamSet))  return FALSE;
       ++mLightCount;
     }
-    // export polygon object
-    if (!exportPolygonObject((PolygonObject&)object, globalMatrix))  return FALSE;
+    // tell the texture cache which resolution the textures of this object need
+    requestTextureResolution(*material, mSceneIR.instanceTextureResolution(instance));
+    // export geometry/shape + normals + UVs (if given)
+    LuxSceneIR::IndexT mesh = mSceneIR.instanceMesh(instance);
+    if (mesh != LuxSceneIR::cInvalidIndex) {
+      if (!mAnimation && !mReceiver->transform(transformMatrix))  return FALSE;
+      mTempParamSet.clear();
+      mTempParamSet.addParam(LUX_TRIANGLE, "triindices",
+                             (void*)mSceneIR.meshTriangles(mesh),
+                             mSceneIR.meshTriangleIndexCount(mesh));
+      mTempParamSet.addParam(LUX_POINT, "P",
+                             (void*)mSceneIR.meshPoints(mesh),
+                             mSceneIR.meshPointCount(mesh));
+      if (mSceneIR.meshNormals(mesh)) {
+        mTempParamSet.addParam(LUX_NORMAL, "N",
+                               (void*)mSceneIR.meshNormals(mesh),
+                               mSceneIR.meshPointCount(mesh));
+      }
+      if (mSceneIR.meshUVs(mesh)) {
+        mTempParamSet.addParam(LUX_UV, "uv",
+                               (void*)mSceneIR.meshUVs(mesh),
+                               mSceneIR.meshPointCount(mesh) * 2);
+      }
+      if (!mReceiver->shape("mesh", mTempParamSet))  return FALSE;
+    }
   }
 
   // close attribute scope
-  if (!mReceiver->setComment("end of object '" + hierarchyData.mObjectName + "'"))  return FALSE;
-  if (!mReceiver->attributeEnd())  return FALSE;
+  if (!mAnimation) {
+    if (!mReceiver->setComment(("end of object '" + objectName + "'").c_str()))  return FALSE;
+    if (!mReceiver->attributeEnd())  return FALSE;
+  }
 
-  return TRUE;
+  // close the shard
+  if (mIncremental && !mReceiver->shardEnd())  return FALSE;
+
+  return !mAnimation || endAnimatedInstance(objectName);
+}
+
+
+/// Closes the attribute scope around the shard of an instance, that was
+/// started by exportInstance() in animation mode.
+///
+/// @param[in]  objectName
+///   The UTF-8 name of the object, which is used for the comment.
+/// @return
+///   TRUE, if successful, FALSE otherwise.
+Bool LuxAPIConverter::endAnimatedInstance(const std::string& objectName)
+{
+  return mReceiver->setComment(("end of object '" + objectName + "'").c_str()) &&
+         mReceiver->attributeEnd();
+}
+
+
+/// Tells the texture cache which resolution the textures of a material need
+/// for an object.
+///
+/// @param[in]  material
+///   The material of the object.
+/// @param[in]  resolution
+///   The estimated resolution (see estimateTextureResolution()).
+void LuxAPIConverter::requestTextureResolution(const ReusableMaterial& material,
+                                               LONG                    resolution)
+{
+  LuxTextureCache* textureCache = mReceiver->textureCache();
+  if (textureCache && textureCache->isEnabled() &&
+      (material.mImageUsageBegin < material.mImageUsageEnd))
+  {
+    textureCache->requestResolution(material.mImageUsageBegin,
+                                    material.mImageUsageEnd,
+                                    resolution);
+  }
 }
 
 
@@ -1451,6 +2252,90 @@ struct LuxMaterialStackEntry
 };
 
 
+/// Collects all texture tags of an object with a valid link and which are not
+/// restricted to a selection.
+///
+/// @param[in]  object
+///   The object of which we want to collect the texture tags.
+/// @param[out]  textureTags
+///   The array to which the texture tags will be appended.
+/// @return
+///   The number of texture tags in the array.
+SizeT LuxAPIConverter::collectTextureTags(BaseObject&   object,
+                                          TextureTagsT& textureTags)
+{
+  for (BaseTag* tag=object.GetFirstTag(); tag; tag=tag->GetNext()) {
+    if (tag->GetType() == Ttexture) {
+      if (!getParameterLink(*tag, TEXTURETAG_MATERIAL, Mbase) ||
+          getParameterString(*tag, TEXTURETAG_RESTRICTION).Content())
+      {
+        continue;
+      }
+      textureTags.push((TextureTag*)tag);
+      if (textureTags.size() == cMaxTextureTags) { break; }
+    }
+  }
+  return textureTags.size();
+}
+
+
+/// Makes sure that the material defined by the texture tags of a material
+/// object has been exported and returns its name and properties. The material
+/// is exported only the first time it's needed.
+///
+/// @param[in]  materialObject
+///   The object whose texture tags define the material or NULL for the default
+///   material.
+/// @return
+///   The exported material or NULL if an error occured.
+LuxAPIConverter::ReusableMaterial* LuxAPIConverter::obtainObjectMaterial(BaseObject* materialObject)
+{
+  // if the material wasn't exported yet, do it now and remember which range
+  // of the texture cache usage log belongs to its images (the default
+  // material was registered by exportStandardMaterials())
+  ReusableMaterial* material = mObjectMaterials.get(materialObject);
+  if (!material && materialObject) {
+    TextureTagsT textureTags(0, cMaxTextureTags);
+    collectTextureTags(*materialObject, textureTags);
+    LuxTextureCache* textureCache = mReceiver->textureCache();
+    SizeT imageUsageBegin = textureCache ? textureCache->usageLogSize() : 0;
+    LuxSymbol materialName;
+    Bool      hasEmissionChannel;
+    LuxSymbol lightGroup;
+    if (!exportMaterial(*materialObject,
+                        textureTags,
+                        materialName,
+                        hasEmissionChannel,
+                        lightGroup))
+    {
+      return 0;
+    }
+    SizeT imageUsageEnd = textureCache ? textureCache->usageLogSize() : 0;
+    // the emission texture is exported together with the material under the
+    // material name plus ".L"
+    LuxSymbol emissionTexture = 0;
+    if (hasEmissionChannel) {
+      emissionTexture = mSymbols.intern(*materialName + ".L");
+      if (!emissionTexture)  return 0;
+    }
+    material = mObjectMaterials.add(materialObject,
+                                    ReusableMaterial(materialName,
+                                                     hasEmissionChannel,
+                                                     lightGroup,
+                                                     emissionTexture,
+                                                     imageUsageBegin,
+                                                     imageUsageEnd));
+    if (!material) {
+      ERRLOG_RETURN_VALUE(0, "LuxAPIConverter::obtainObjectMaterial(): not enough memory to store exported material");
+    }
+  }
+  if (!material) {
+    ERRLOG_RETURN_VALUE(0, "LuxAPIConverter::obtainObjectMaterial(): default material is missing");
+  }
+  return material;
+}
+
+
 /// Exports a material including its textures.
 ///
 /// @param[in]  object,
@@ -1459,25 +2344,25 @@ struct LuxMaterialStackEntry
 /// @param[in]  textureTags
 ///   An array of texture tags that are assigned to the object we are exporting.
 /// @param[out]  materialName
-///   Here we return the name under which the material will be exported. Use
-///   that one to reference it in the object.
+///   Here we return the (interned) name under which the material will be
+///   exported. Use that one to reference it in the object.
 /// @param[out]  hasEmissionChannel
 ///   Will be set to TRUE if the material emits light and to FALSE if it doesn't.
 /// @param[out]  lightGroup
-///   Will contain the name of the light group, if the material has an emission
-///   channel that has a light group.
+///   Will contain the (interned) name of the light group, if the material has
+///   an emission channel that has a light group, and NULL otherwise.
 /// @return
 ///   TRUE, if successful, FALSE otherwise.
 Bool LuxAPIConverter::exportMaterial(BaseObject&   object,
                                      TextureTagsT& textureTags,
-                                     LuxString&    materialName,
+                                     LuxSymbol&    materialName,
                                      Bool&         hasEmissionChannel,
-                                     LuxString&    lightGroup)
+                                     LuxSymbol&    lightGroup)
 {
   // reset return values
-  materialName.clear();
+  materialName = 0;
   hasEmissionChannel = FALSE;
-  lightGroup.clear();
+  lightGroup = 0;
 
   // loop over all texture tags reverse order, convert their materials and
   // store the converted materials in a second array (i.e. in reverse ordeR)
@@ -1491,16 +2376,16 @@ Bool LuxAPIConverter::exportMaterial(BaseObject&   object,
     // get texture mapping
     switch (getParameterLong(*textureTag, TEXTURETAG_PROJECTION)) {
       case TEXTURETAG_PROJECTION_SPHERICAL:
-        entry.mMapping = gNew LuxSphericalMapping(*textureTag, mC4D2LuxScale);
+        entry.mMapping = inArena(new (mArena) LuxSphericalMapping(*textureTag, mC4D2LuxScale));
         break;
       case TEXTURETAG_PROJECTION_CYLINDRICAL:
-        entry.mMapping = gNew LuxCylindricalMapping(*textureTag, mC4D2LuxScale);
+        entry.mMapping = inArena(new (mArena) LuxCylindricalMapping(*textureTag, mC4D2LuxScale));
         break;
       case TEXTURETAG_PROJECTION_FLAT:
-        entry.mMapping = gNew LuxPlanarMapping(*textureTag, mC4D2LuxScale);
+        entry.mMapping = inArena(new (mArena) LuxPlanarMapping(*textureTag, mC4D2LuxScale));
         break;
       default:
-        entry.mMapping = gNew LuxUVMapping(*textureTag);
+        entry.mMapping = inArena(new (mArena) LuxUVMapping(*textureTag));
     }
     if (!entry.mMapping) { ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::exportMaterial(): Could not allocate texture mapping instance."); }
 
@@ -1518,7 +2403,8 @@ Bool LuxAPIConverter::exportMaterial(BaseObject&   object,
                                                               mC4D2LuxScale,
                                                               mColorGamma,
                                                               mTextureGamma,
-                                                              mBumpSampleDistance);
+                                                              mBumpSampleDistance,
+                                                              mBakeShaders);
 
     // ... from a standard C4D material:
     } else if (entry.mBaseMaterial->IsInstanceOf(Mmaterial)) {
@@ -1578,7 +2464,8 @@ Bool LuxAPIConverter::exportMaterial(BaseObject&   object,
 
   // export the Lux material stack, which is in reverse order, again in reverse
   // order, i.e. the order of the exported materials is then normal again
-  LuxString prevMaterialName;
+  LuxTextureCache* textureCache = mReceiver->textureCache();
+  LuxSymbol prevMaterialName = 0;
   Bool      first = TRUE;
   for (SizeT c=luxMaterialStack.size(); c>0; ) {
 
@@ -1589,55 +2476,79 @@ Bool LuxAPIConverter::exportMaterial(BaseObject&   object,
     ReusableMaterialKey reusableMatKey(entry.mBaseMaterial, entry.mMapping);
     ReusableMaterial* reusableMaterial = mReusableMaterials.get(reusableMatKey);
 
-    // if we could find it, just reuse it
+    // if we could find it, just reuse it (and its images)
     if (reusableMaterial) {
       materialName = reusableMaterial->mName;
+      if (textureCache &&
+          !textureCache->repeatUsage(reusableMaterial->mImageUsageBegin,
+                                     reusableMaterial->mImageUsageEnd))
+      {
+        return FALSE;
+      }
     // if not, export it without name of object and add it to the list of
     // reusable materials
     } else {
       // determine (unique) material name
-      String c4dMaterialName = entry.mBaseMaterial->GetName();
-      LONG* usageCount = mMaterialUsage.get(c4dMaterialName);
-      if (!usageCount) {
-        mMaterialUsage.add(c4dMaterialName, 1);
-        convert2LuxString(c4dMaterialName, materialName);
-      } else {
-        String testString;
-        do {
-          ++(*usageCount);
-          testString = c4dMaterialName + " " + LongToString(*usageCount);
-        } while (mMaterialUsage.get(testString));
-        convert2LuxString(testString, materialName);
+      LuxSymbol baseName = mSymbols.intern(entry.mBaseMaterial->GetName());
+      LuxString uniqueName;
+      if (!baseName ||
+          !mMaterialNames.allocate(*baseName, uniqueName) ||
+          !(materialName = mSymbols.intern(uniqueName)))
+      {
+        return FALSE;
       }
       // export material so that it can be reused later
-      if (!entry.mLuxMaterial->sendToAPI(*mReceiver, materialName))
+      SizeT imageUsageBegin = textureCache ? textureCache->usageLogSize() : 0;
+      if (!entry.mLuxMaterial->sendToAPI(*mReceiver, *materialName))
       {
         return FALSE;
       }
+      SizeT imageUsageEnd = textureCache ? textureCache->usageLogSize() : 0;
       // add to list of reusable materials
-      mReusableMaterials.add(reusableMatKey,
-                             ReusableMaterial(materialName,
-                                              entry.mLuxMaterial->hasEmissionChannel(),
-                                              entry.mLuxMaterial->getLightGroup()));
+      if (!mReusableMaterials.add(reusableMatKey,
+                                  ReusableMaterial(materialName,
+                                                   entry.mLuxMaterial->hasEmissionChannel(),
+                                                   0,
+                                                   0,
+                                                   imageUsageBegin,
+                                                   imageUsageEnd)))
+      {
+        ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::exportMaterial(): not enough memory to store reusable material");
+      }
     }
 
     // if this material has an alpha channel and it's not the first material,
     // we have to blend it with the underlying material. the blend material
-    // gets the object name added (to make it unique) and its name will be
-    // used for reference by the object later, but the blend material itself
-    // will not be used
+    // will then be used for reference by the object. objects with the same
+    // material stack share the same blend materials, i.e. each of them is
+    // exported only once
     if (!first && entry.mLuxMaterial->hasAlphaChannel()) {
-      LuxString objectName;
-      convert2LuxString(object.GetName(), objectName);
-      LuxString blendMatName = objectName + "::" + materialName;
-      if (!entry.mLuxMaterial->blendAndSendToAPI(*mReceiver,
-                                                 materialName,
-                                                 prevMaterialName,
-                                                 blendMatName))
-      {
-        return FALSE;
+      BlendMaterialKey blendMatKey(prevMaterialName, materialName);
+      LuxSymbol* blendMatName = mBlendMaterials.get(blendMatKey);
+      if (blendMatName) {
+        materialName = *blendMatName;
+      } else {
+        LuxSymbol baseName = mSymbols.intern(entry.mBaseMaterial->GetName());
+        LuxString uniqueName;
+        LuxSymbol newBlendMatName;
+        if (!baseName ||
+            !mMaterialNames.allocate(*baseName + "::blend", uniqueName) ||
+            !(newBlendMatName = mSymbols.intern(uniqueName)))
+        {
+          return FALSE;
+        }
+        if (!entry.mLuxMaterial->blendAndSendToAPI(*mReceiver,
+                                                   *materialName,
+                                                   *prevMaterialName,
+                                                   *newBlendMatName))
+        {
+          return FALSE;
+        }
+        if (!mBlendMaterials.add(blendMatKey, newBlendMatName)) {
+          ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::exportMaterial(): not enough memory to store blend material");
+        }
+        materialName = newBlendMatName;
       }
-      materialName = blendMatName;
     }
 
     // store material name for stacking
@@ -1648,13 +2559,84 @@ Bool LuxAPIConverter::exportMaterial(BaseObject&   object,
   // obtain emission channel and light group from top-most material
   hasEmissionChannel = luxMaterialStack[0].mLuxMaterial->hasEmissionChannel();
   if (hasEmissionChannel) {
-    lightGroup = luxMaterialStack[0].mLuxMaterial->getLightGroup();
+    const LuxString& topLightGroup = luxMaterialStack[0].mLuxMaterial->getLightGroup();
+    if (topLightGroup.size() && !(lightGroup = mSymbols.intern(topLightGroup))) {
+      return FALSE;
+    }
   }
 
   return TRUE;
 }
 
 
+/// Estimates the texture resolution an object needs, so that one texel of its
+/// textures covers about one pixel of the rendered image. The object is
+/// approximated by its bounding sphere and the texture is assumed to be spread
+/// over the area its polygons cover in UV space. Texture tag tiling is
+/// ignored.
+///
+/// @param[in]  object
+///   The object of which we want to estimate the texture resolution.
+/// @param[in]  globalMatrix
+///   The global matrix of the object.
+/// @return
+///   The estimated resolution in pixels or 0 if it couldn't be estimated (e.g.
+///   because the camera is inside the object).
+LONG LuxAPIConverter::estimateTextureResolution(PolygonObject& object,
+                                                const Matrix&  globalMatrix)
+{
+  if (mCameraPixelScale <= 0.0)  return 0;
+
+  // determine bounding sphere of the object in world space
+  Vector center = globalMatrix * object.GetMp();
+  LReal  scale = Len(globalMatrix.v1);
+  if (Len(globalMatrix.v2) > scale)  scale = Len(globalMatrix.v2);
+  if (Len(globalMatrix.v3) > scale)  scale = Len(globalMatrix.v3);
+  LReal  radius = Len(object.GetRad()) * scale;
+
+  // determine maximum size of the object on screen in pixels
+  LReal screenSize;
+  if (mCameraIsOrtho) {
+    screenSize = 2.0 * radius * mCameraPixelScale;
+  } else {
+    LReal distance = Len(center - mCameraPosition) - radius;
+    if (distance <= 0.0)  return 0;
+    screenSize = 2.0 * radius * mCameraPixelScale / distance;
+  }
+
+  // determine the area covered by the polygons in UV space - without UVW tag
+  // we assume that the texture is spread once over the object
+  LReal uvArea = 1.0;
+  UVWTag* uvwTag = (UVWTag*)object.GetTag(Tuvw);
+  if (uvwTag) {
+    uvArea = 0.0;
+    UVWStruct polygonUVWs;
+    LONG polygonCount = object.GetPolygonCount();
+#if _C4D_VERSION>=115
+    UVWHandle tagData = uvwTag->GetDataAddressR();
+    for (LONG polygonIx=0; polygonIx<polygonCount; ++polygonIx) {
+      uvwTag->Get(tagData, polygonIx, polygonUVWs);
+#else
+    for (LONG polygonIx=0; polygonIx<polygonCount; ++polygonIx) {
+      polygonUVWs = uvwTag->Get(polygonIx);
+#endif
+      const Vector& a = polygonUVWs.a;
+      const Vector& b = polygonUVWs.b;
+      const Vector& c = polygonUVWs.c;
+      const Vector& d = polygonUVWs.d;
+      uvArea += 0.5 * fabs((b.x-a.x)*(c.y-a.y) - (b.y-a.y)*(c.x-a.x));
+      uvArea += 0.5 * fabs((c.x-a.x)*(d.y-a.y) - (c.y-a.y)*(d.x-a.x));
+    }
+    if (uvArea < 1.0e-6)  uvArea = 1.0e-6;
+  }
+
+  // the used part of the texture has to cover the on-screen size
+  LReal resolution = screenSize / sqrt(uvArea);
+  if (resolution > 1048576.0)  return 1048576;
+  return (LONG)(resolution + 0.5);
+}
+
+
 /// Converts a BaseMaterial into a matte placeholder material that has the
 /// average color of the material as diffuse channel.
 ///
@@ -1666,11 +2648,11 @@ Bool LuxAPIConverter::exportMaterial(BaseObject&   object,
 LuxMaterialDataH LuxAPIConverter::convertDummyMaterial(BaseMaterial& material)
 {
   // export dummy matte material with average colour of input material
-  LuxMatteDataH materialData = gNew LuxMatteData;
+  LuxMatteDataH materialData = inArena(new (mArena) LuxMatteData);
   if (!materialData) { ERRLOG_RETURN_VALUE(materialData, "LuxAPIConverter::convertDummyMaterial(): Could not allocate LuxMatteData"); }
   materialData->setChannel(LuxMatteData::DIFFUSE,
-                           gNew LuxConstantTextureData(toSV(material.GetAverageColor()),
-                                                       mColorGamma));
+                           inArena(new (mArena) LuxConstantTextureData(toSV(material.GetAverageColor()),
+                                                                       mColorGamma)));
   return materialData;
 }
 
@@ -1688,7 +2670,7 @@ LuxMaterialDataH LuxAPIConverter::convertDiffuseMaterial(LuxTextureMappingH& map
                                                          Material&           material)
 {
   // allocate matte material
-  LuxMatteDataH materialData = gNew LuxMatteData;;
+  LuxMatteDataH materialData = inArena(new (mArena) LuxMatteData);;
   if (!materialData) { ERRLOG_RETURN_VALUE(materialData, "LuxAPIConverter::convertDiffuseMaterial(): Could not allocate LuxMatteData"); }
 
   // obtain diffuse channel
@@ -1709,7 +2691,7 @@ LuxMaterialDataH LuxAPIConverter::convertDiffuseMaterial(LuxTextureMappingH& map
     LuxFloat roughness = getParameterReal(material, MATERIAL_ILLUMINATION_ROUGHNESS);
     if (roughness > 0.001) {
       materialData->setChannel(LuxMatteData::SIGMA,
-                               gNew LuxConstantTextureData(roughness * 180.0));
+                               inArena(new (mArena) LuxConstantTextureData(roughness * 180.0)));
     }
   }
 
@@ -1735,7 +2717,7 @@ LuxMaterialDataH LuxAPIConverter::convertGlossyMaterial(LuxTextureMappingH& mapp
                                                         Material&           material)
 {
   // allocate glossy material
-  LuxGlossyDataH materialData = gNew LuxGlossyData;
+  LuxGlossyDataH materialData = inArena(new (mArena) LuxGlossyData);
   if (!materialData) { ERRLOG_RETURN_VALUE(materialData, "LuxAPIConverter::convertGlossyMaterial(): Could not allocate LuxGlossyData"); }
 
   // obtain diffuse channel
@@ -1763,9 +2745,9 @@ LuxMaterialDataH LuxAPIConverter::convertGlossyMaterial(LuxTextureMappingH& mapp
                                           0.0);
     roughness = c4dDispersionToLuxRoughness(roughness);
     materialData->setChannel(LuxGlossyData::UROUGHNESS,
-                             gNew LuxConstantTextureData(roughness));
+                             inArena(new (mArena) LuxConstantTextureData(roughness)));
     materialData->setChannel(LuxGlossyData::VROUGHNESS,
-                             gNew LuxConstantTextureData(roughness));
+                             inArena(new (mArena) LuxConstantTextureData(roughness)));
   }
 
   // obtain bump, emission and alpha channels
@@ -1802,7 +2784,7 @@ LuxMaterialDataH LuxAPIConverter::convertReflectiveMaterial(LuxTextureMappingH&
   if (roughness < 0.001) {
 
     // allocate mirror material
-    LuxMirrorDataH materialData = gNew LuxMirrorData;
+    LuxMirrorDataH materialData = inArena(new (mArena) LuxMirrorData);
     if (!materialData) { ERRLOG_RETURN_VALUE(materialData, "LuxAPIConverter::convertReflectiveMaterial(): Could not allocate LuxMirrorData"); }
 
     // obtain specular reflection channel + dispersion
@@ -1827,12 +2809,12 @@ LuxMaterialDataH LuxAPIConverter::convertReflectiveMaterial(LuxTextureMappingH&
   } else {
 
     // allocate shiny metal material
-    LuxShinyMetalDataH materialData = gNew LuxShinyMetalData;
+    LuxShinyMetalDataH materialData = inArena(new (mArena) LuxShinyMetalData);
     if (!materialData) { ERRLOG_RETURN_VALUE(materialData, "LuxAPIConverter::convertReflectiveMaterial(): Could not allocate LuxShinyMetalData"); }
 
     // set reflection channel to 0
     materialData->setChannel(LuxShinyMetalData::REFLECTION,
-                             gNew LuxConstantTextureData(LuxColor(0.0), 1.0));
+                             inArena(new (mArena) LuxConstantTextureData(LuxColor(0.0), 1.0)));
 
     // obtain specular reflection channel + dispersion
     if (getParameterLong(material, MATERIAL_USE_REFLECTION)) {
@@ -1845,9 +2827,9 @@ LuxMaterialDataH LuxAPIConverter::convertReflectiveMaterial(LuxTextureMappingH&
                                                    MATERIAL_REFLECTION_TEXTURESTRENGTH));
       roughness = c4dDispersionToLuxRoughness(roughness);
       materialData->setChannel(LuxShinyMetalData::UROUGHNESS,
-                               gNew LuxConstantTextureData(roughness));
+                               inArena(new (mArena) LuxConstantTextureData(roughness)));
       materialData->setChannel(LuxShinyMetalData::VROUGHNESS,
-                               gNew LuxConstantTextureData(roughness));
+                               inArena(new (mArena) LuxConstantTextureData(roughness)));
     }
 
     // obtain bump, emission and alpha channels
@@ -1890,7 +2872,7 @@ LuxMaterialDataH LuxAPIConverter::convertTransparentMaterial(LuxTextureMappingH&
   if (roughness < 0.001) {
 
     // allocate glass material
-    LuxGlassDataH materialData = gNew LuxGlassData;
+    LuxGlassDataH materialData = inArena(new (mArena) LuxGlassData);
     if (!materialData) { ERRLOG_RETURN_VALUE(materialData, "LuxAPIConverter::convertTransparentMaterial(): Could not allocate LuxGlassData"); }
 
     // obtain reflection channel
@@ -1920,11 +2902,11 @@ LuxMaterialDataH LuxAPIConverter::convertTransparentMaterial(LuxTextureMappingH&
     if (fabsf(ior - 1.0) < 0.0001) {
       materialData->mArchitectural = TRUE;
       materialData->setChannel(LuxGlassData::IOR,
-                               gNew LuxConstantTextureData(1.5));
+                               inArena(new (mArena) LuxConstantTextureData(1.5)));
     } else {
       materialData->mArchitectural = FALSE;
       materialData->setChannel(LuxGlassData::IOR,
-                               gNew LuxConstantTextureData(ior));
+                               inArena(new (mArena) LuxConstantTextureData(ior)));
     }
 
     // obtain bump, emission and alpha channels
@@ -1938,7 +2920,7 @@ LuxMaterialDataH LuxAPIConverter::convertTransparentMaterial(LuxTextureMappingH&
   } else {
 
     // allocate rough glass material
-    LuxRoughGlassDataH materialData = gNew LuxRoughGlassData;
+    LuxRoughGlassDataH materialData = inArena(new (mArena) LuxRoughGlassData);
     if (!materialData) { ERRLOG_RETURN_VALUE(materialData, "LuxAPIConverter::convertTransparentMaterial(): Could not allocate LuxRoughGlassData"); }
 
     // obtain reflection channel
@@ -1963,14 +2945,14 @@ LuxMaterialDataH LuxAPIConverter::convertTransparentMaterial(LuxTextureMappingH&
                                                    MATERIAL_TRANSPARENCY_TEXTURESTRENGTH));
       roughness = c4dDispersionToLuxRoughness(roughness);
       materialData->setChannel(LuxRoughGlassData::UROUGHNESS,
-                               gNew LuxConstantTextureData(roughness));
+                               inArena(new (mArena) LuxConstantTextureData(roughness)));
       materialData->setChannel(LuxRoughGlassData::VROUGHNESS,
-                               gNew LuxConstantTextureData(roughness));
+                               inArena(new (mArena) LuxConstantTextureData(roughness)));
     }
 
     // setup IOR texture
     materialData->setChannel(LuxRoughGlassData::IOR,
-                             gNew LuxConstantTextureData(ior));
+                             inArena(new (mArena) LuxConstantTextureData(ior)));
 
     // obtain bump, emission and alpha channels
     addBumpChannel(mapping, material, *materialData);
@@ -1995,7 +2977,7 @@ LuxMaterialDataH LuxAPIConverter::convertTranslucentMaterial(LuxTextureMappingH&
                                                              Material&           material)
 {
   // allocate rough glass material
-  LuxMatteTranslucentDataH materialData = gNew LuxMatteTranslucentData;
+  LuxMatteTranslucentDataH materialData = inArena(new (mArena) LuxMatteTranslucentData);
   if (!materialData) { ERRLOG_RETURN_VALUE(materialData, "LuxAPIConverter::convertTranslucentMaterial(): Could not allocate LuxMatteTranslucentData"); }
 
   // obtain diffuse channel
@@ -2027,7 +3009,7 @@ LuxMaterialDataH LuxAPIConverter::convertTranslucentMaterial(LuxTextureMappingH&
     LuxFloat roughness = getParameterReal(material, MATERIAL_ILLUMINATION_ROUGHNESS);
     if (roughness > 0.001) {
       materialData->setChannel(LuxMatteTranslucentData::SIGMA,
-                               gNew LuxConstantTextureData(roughness * 180.0));
+                               inArena(new (mArena) LuxConstantTextureData(roughness * 180.0)));
     }
   }
 
@@ -2116,11 +3098,11 @@ Bool LuxAPIConverter::addAlphaChannel(LuxTextureMappingH& mapping,
 {
   if (getParameterLong(material, MATERIAL_USE_ALPHA)) {
 
-    // fetch bitmap shader, and do nothing, if it's not there
-    BaseList2D* bitmapLink = getParameterLink(material,
+    // fetch shader, and do nothing, if it's not there
+    BaseList2D* shaderLink = getParameterLink(material,
                                               MATERIAL_ALPHA_SHADER,
-                                              Xbitmap);
-    if (!bitmapLink) { return TRUE; }
+                                              Xbase);
+    if (!shaderLink) { return TRUE; }
 
     // check if we should use the alpha channel of the image
     LuxImageMapData::Channel channel = LuxImageMapData::IMAGE_CHANNEL_NONE;
@@ -2139,22 +3121,16 @@ Bool LuxAPIConverter::addAlphaChannel(LuxTextureMappingH& mapping,
                             LuxImageMapData::WRAP_TYPE_BLACK;
     }
 
-    // determine texture path of the alpha texture
-    Filename bitmapPath = getParameterFilename(*bitmapLink, BITMAPSHADER_FILENAME);
-    Filename fullBitmapPath;
-    GenerateTexturePath(mDocument->GetDocumentPath(),
-                        bitmapPath,
-                        Filename(),
-                        &fullBitmapPath);
-
-    // create imagedata texture
-    LuxTextureDataH texture = gNew LuxImageMapData(LUX_FLOAT_TEXTURE,
-                                                   mapping,
-                                                   fullBitmapPath,
-                                                   1.0,
-                                                   channel,
-                                                   wrapType);
-    if (!texture) { ERRLOG_RETURN_VALUE(FALSE, "Could not allocate alpha channel texture"); }
+    // create imagedata texture (if the shader is not supported, there is no
+    // alpha channel)
+    LuxTextureDataH texture = LuxImageMapData::fromShader(*shaderLink,
+                                                          mBakeShaders,
+                                                          LUX_FLOAT_TEXTURE,
+                                                          mapping,
+                                                          1.0,
+                                                          channel,
+                                                          wrapType);
+    if (!texture) { return TRUE; }
 
     // set alpha channel and return
     return materialData.setAlphaChannel(texture, inverted);
@@ -2192,36 +3168,35 @@ LuxTextureDataH LuxAPIConverter::convertFloatChannel(LuxTextureMappingH&       m
                                                      Real                      strengthScale,
                                                      LuxImageMapData::Channel  channel)
 {
-  // fetch bitmap shader, if available
-  BaseList2D* bitmapLink = getParameterLink(material, shaderId, Xbitmap);
+  // fetch shader, if available
+  BaseList2D* shaderLink = getParameterLink(material, shaderId, Xbase);
 
   // get texture strength
   LuxFloat strength = getParameterReal(material, strengthId, 1.0);
 
-  // if the material channel doesn't have a bitmap shader or the texture
-  // strength is too small, just return NULL
-  if ((fabsf(strength) < 0.001) || !bitmapLink) {
+  // if the material channel doesn't have a shader or the texture strength is
+  // too small, just return NULL
+  if ((fabsf(strength) < 0.001) || !shaderLink) {
     return LuxTextureDataH();
   }
 
-  // if we are here, we've got a bitmap shader -> let's create an imagemap texture
-  Filename bitmapPath = getParameterFilename(*bitmapLink, BITMAPSHADER_FILENAME);
-  Filename fullBitmapPath;
-  GenerateTexturePath(mDocument->GetDocumentPath(),
-                      bitmapPath,
-                      Filename(),
-                      &fullBitmapPath);
-  LuxTextureDataH texture = gNew LuxImageMapData(LUX_FLOAT_TEXTURE,
-                                                 mapping,
-                                                 fullBitmapPath,
-                                                 1.0,
-                                                 channel);
+  // if we are here, we've got a shader -> let's create an imagemap texture,
+  // which is only possible for bitmap shaders or if shaders get baked
+  LuxTextureDataH texture = LuxImageMapData::fromShader(*shaderLink,
+                                                        mBakeShaders,
+                                                        LUX_FLOAT_TEXTURE,
+                                                        mapping,
+                                                        1.0,
+                                                        channel);
+  if (!texture) {
+    return LuxTextureDataH();
+  }
 
   // if strength is not ~1.0, scale texture
   strength *= strengthScale;
   if (fabsf(strength - 1.0) > 0.001) {
-    LuxScaleTextureDataH scaledTexture = gNew LuxScaleTextureData(LUX_FLOAT_TEXTURE);
-    scaledTexture->mTexture1 = gNew LuxConstantTextureData(strength);
+    LuxScaleTextureDataH scaledTexture = inArena(new (mArena) LuxScaleTextureData(LUX_FLOAT_TEXTURE));
+    scaledTexture->mTexture1 = inArena(new (mArena) LuxConstantTextureData(strength));
     scaledTexture->mTexture2 = texture;
     texture = scaledTexture;
   }
@@ -2255,8 +3230,8 @@ LuxTextureDataH LuxAPIConverter::convertColorChannel(LuxTextureMappingH& mapping
                                                      LONG                brightnessId,
                                                      LONG                mixerId)
 {
-  // fetch bitmap shader, if available
-  BaseList2D* bitmapLink = getParameterLink(material, shaderId, Xbitmap);
+  // fetch shader, if available
+  BaseList2D* shaderLink = getParameterLink(material, shaderId, Xbase);
 
   // get texture strength and base colour
   LuxFloat strength = getParameterReal(material, mixerId, 1.0);
@@ -2268,29 +3243,28 @@ LuxTextureDataH LuxAPIConverter::convertColorChannel(LuxTextureMappingH& mapping
   }
   color *= getParameterReal(material, brightnessId, 1.0);
 
-  // if the material channel doesn't have a bitmap shader or the texture
+  // if we've got a shader, let's create an imagemap texture, which is only
+  // possible for bitmap shaders or if shaders get baked
+  LuxTextureDataH texture;
+  if ((strength >= 0.001) && shaderLink) {
+    texture = LuxImageMapData::fromShader(*shaderLink,
+                                          mBakeShaders,
+                                          LUX_COLOR_TEXTURE,
+                                          mapping,
+                                          mTextureGamma);
+  }
+
+  // if the material channel doesn't have a supported shader or the texture
   // strength is too small, just create a constant texture of the colour which
   // is also specified in the channel
-  if ((strength < 0.001) || !bitmapLink) {
-    return gNew LuxConstantTextureData(color, 1.0);
-  }
-
-  // if we are here, we've got a bitmap shader -> let's create an imagemap texture
-  Filename bitmapPath = getParameterFilename(*bitmapLink, BITMAPSHADER_FILENAME);
-  Filename fullBitmapPath;
-  GenerateTexturePath(mDocument->GetDocumentPath(),
-                      bitmapPath,
-                      Filename(),
-                      &fullBitmapPath);
-  LuxTextureDataH texture = gNew LuxImageMapData(LUX_COLOR_TEXTURE,
-                                                 mapping,
-                                                 fullBitmapPath,
-                                                 mTextureGamma);
+  if (!texture) {
+    return inArena(new (mArena) LuxConstantTextureData(color, 1.0));
+  }
 
   // if the texture strength is < 100%, we mix the colour with the texture
   if (strength < 0.999) {
-    LuxMixTextureDataH mixTexture = gNew LuxMixTextureData(LUX_COLOR_TEXTURE);
-    mixTexture->mTexture1 = gNew LuxConstantTextureData(color, 1.0);
+    LuxMixTextureDataH mixTexture = inArena(new (mArena) LuxMixTextureData(LUX_COLOR_TEXTURE));
+    mixTexture->mTexture1 = inArena(new (mArena) LuxConstantTextureData(color, 1.0));
     mixTexture->mTexture2 = texture;
     mixTexture->mAmount = strength;
     texture = mixTexture;
@@ -2300,26 +3274,28 @@ LuxTextureDataH LuxAPIConverter::convertColorChannel(LuxTextureMappingH& mapping
 }
 
 
-/// Exports a polygon object and sends it to a LuxAPI implementation.
+/// Converts a polygon object into a mesh of the scene IR.
 ///
 /// @param[in]  object
-///   The polygon object to export.
-/// @param[in]  globalMatrix
-///   The global matrix of the object (will be obtained during scene hierarchy
-///   traversal).
+///   The polygon object to convert.
+/// @param[out]  mesh
+///   The index of the new mesh or LuxSceneIR::cInvalidIndex if the object is
+///   empty.
 /// @return
 ///   TRUE, if successful, FALSE otherwise
-Bool LuxAPIConverter::exportPolygonObject(PolygonObject& object,
-                                          const Matrix&  globalMatrix)
+Bool LuxAPIConverter::convertPolygonObject(PolygonObject&      object,
+                                           LuxSceneIR::IndexT& mesh)
 {
+  mesh = LuxSceneIR::cInvalidIndex;
+
   // only export get polygon object with geometry/polygons
   if (!object.GetPolygonCount()) {
     return TRUE;
   }
 
-  debugLog("exporting polygon object '" + object.GetName() + "' ...");
+  LOG_DEBUG("exporting polygon object '" + object.GetName() + "' ...");
 
-  // convert and cache geometry
+  // convert geometry
   TrianglesT     triangles;
   PointsT        points;
   NormalsT       normals;
@@ -2331,56 +3307,54 @@ Bool LuxAPIConverter::exportPolygonObject(PolygonObject& object,
   // skip empty objects
   if (!triangles.size() || !points.size())  return TRUE;
 
-  // write transformation matrix
-  LuxMatrix  transformMatrix(globalMatrix, mC4D2LuxScale);
-  if (!mReceiver->transform(transformMatrix))  return FALSE;
-
-  // export geometry/shape + normals + UVs (if given)
-  mTempParamSet.clear();
-  mTempParamSet.addParam(LUX_TRIANGLE, "triindices",
-                         triangles.arrayAddress(), triangles.size());
-  mTempParamSet.addParam(LUX_POINT, "P",
-                         points.arrayAddress(), points.size());
-  if (normals.size()) {
-    mTempParamSet.addParam(LUX_NORMAL, "N",
-                           normals.arrayAddress(), normals.size());
+  // store geometry + normals + UVs (if given) in scene IR
+  mesh = mSceneIR.addMesh((const float*)points.arrayAddress(),
+                          (LuxSceneIR::IndexT)points.size(),
+                          triangles.arrayAddress(),
+                          (LuxSceneIR::IndexT)triangles.size(),
+                          0, 0,
+                          normals.size() ? (const float*)normals.arrayAddress() : 0,
+                          uvs.size() ? uvs.arrayAddress() : 0);
+  if (mesh == LuxSceneIR::cInvalidIndex) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertPolygonObject(): not enough memory to store mesh in scene IR");
   }
-  if (uvs.size()) {
-    mTempParamSet.addParam(LUX_UV, "uv",
-                           uvs.arrayAddress(), uvs.size());
-  }
-  if (!mReceiver->shape("mesh", mTempParamSet))  return FALSE;
 
   return TRUE;
 }
 
 
-/// Exports a portal shape and sends it to a LuxAPI implementation.
+/// Converts a portal shape into a mesh of the scene IR.
 ///
 /// @param[in]  object
 ///   The polygon object wich defines the portal shape.
-/// @param[in]  globalMatrix
-///   The global matrix of the object (will be obtained during scene hierarchy
-///   traversal).
 /// @param[in]  tag
 ///   The portal tag with additional settings (must be of type
 ///   PID_LUXC4D_PORTAL_TAG!).
+/// @param[out]  mesh
+///   The index of the new mesh or LuxSceneIR::cInvalidIndex if no portal
+///   shape should be exported.
+/// @param[out]  flipNormals
+///   Will be set to TRUE, if the orientation of the portal shape should be
+///   reversed.
 /// @param[out]  exportObject
 ///   This will be set by this function and if it is set to TRUE, the portal
 ///   object should be exported also as a standard polygon object. If it's set
 ///   to FALSE it should be exported only as portal shap.
 /// @return
 ///   TRUE, if successful, FALSE otherwise
-Bool LuxAPIConverter::exportPortalObject(PolygonObject& object,
-                                         const Matrix&  globalMatrix,
-                                         BaseTag&       tag,
-                                         Bool&          exportObject)
+Bool LuxAPIConverter::convertPortalObject(PolygonObject&      object,
+                                          BaseTag&            tag,
+                                          LuxSceneIR::IndexT& mesh,
+                                          Bool&               flipNormals,
+                                          Bool&               exportObject)
 {
   static const Real cThicknessExtension = 1.1;
 
   // in the beginning we set exportObject to TRUE and only set it to FALSE,
   // when we really have exported the portal and the user doesn't want us to
   // export the object twice
+  mesh = LuxSceneIR::cInvalidIndex;
+  flipNormals = FALSE;
   exportObject = TRUE;
 
   // only export get polygon object with geometry/polygons
@@ -2392,10 +3366,10 @@ Bool LuxAPIConverter::exportPortalObject(PolygonObject& object,
   if (!tagData->GetBool(IDD_PORTAL_ENABLED)) { return TRUE; }
   Bool simplify = tagData->GetBool(IDD_PORTAL_SIMPLIFY);
   exportObject = tagData->GetBool(IDD_PORTAL_EXPORT_OBJECT);
-  Bool flipNormals = tagData->GetBool(IDD_PORTAL_FLIP_NORMALS);
+  flipNormals = tagData->GetBool(IDD_PORTAL_FLIP_NORMALS);
 
   // log
-  debugLog("exporting portal polygon object '" + object.GetName() + "' ...");
+  LOG_DEBUG("exporting portal polygon object '" + object.GetName() + "' ...");
 
   // the container for the geometry
   PointsT    points;
@@ -2459,35 +3433,21 @@ Bool LuxAPIConverter::exportPortalObject(PolygonObject& object,
 
   // skip empty objects
   if ((!triangles.size() && !quads.size()) || !points.size()) {
-    debugLog("  which is empty -> nothing exported");
+    LOG_TRACE("  which is empty -> nothing exported");
     return TRUE;
   }
 
-  // write transformation matrix
-  LuxMatrix  transformMatrix(globalMatrix, mC4D2LuxScale);
-  if (!mReceiver->transform(transformMatrix))  return FALSE;
-
-  // setup shape parameters
-  mTempParamSet.clear();
-  mTempParamSet.addParam(LUX_POINT, "P",
-                         points.arrayAddress(), points.size());
-  if (triangles.size()) {
-    mTempParamSet.addParam(LUX_TRIANGLE, "triindices",
-                           triangles.arrayAddress(), triangles.size());
+  // store portal shape in scene IR
+  mesh = mSceneIR.addMesh((const float*)points.arrayAddress(),
+                          (LuxSceneIR::IndexT)points.size(),
+                          triangles.size() ? triangles.arrayAddress() : 0,
+                          (LuxSceneIR::IndexT)triangles.size(),
+                          quads.size() ? quads.arrayAddress() : 0,
+                          (LuxSceneIR::IndexT)quads.size(),
+                          0, 0);
+  if (mesh == LuxSceneIR::cInvalidIndex) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertPortalObject(): not enough memory to store portal in scene IR");
   }
-  if (quads.size()) {
-    mTempParamSet.addParam(LUX_QUAD, "quadindices",
-                           quads.arrayAddress(), quads.size());
-  }
-
-  // if the normals should be flipped, export "reverseorientation"
-  if (flipNormals && !mReceiver->reverseOrientation())  return FALSE;
-
-  // export shape
-  if (!mReceiver->portalShape("mesh", mTempParamSet)) { return FALSE; }
-
-  // set flag that we have exported at least 1 portal -> influences infinite light
-  ++mPortalCount;
 
   return TRUE;
 }
@@ -2540,20 +3500,10 @@ Bool LuxAPIConverter::convertGeometry(PolygonObject&  object,
   }
 
   // store polygons as triangles in array using the correct order for right-handed coords
-  CPolygon* polygon;
-  ULONG     triangleIndex = 0;
-  for (ULONG poly=0; poly<mPolygonCache.size(); ++poly) {
-    polygon = &(mPolygonCache[poly]);
-    triangles[triangleIndex]   = polygon->a;
-    triangles[++triangleIndex] = polygon->c;
-    triangles[++triangleIndex] = polygon->b;
-    if (polygon->c != polygon->d) {
-      triangles[++triangleIndex] = polygon->a;
-      triangles[++triangleIndex] = polygon->d;
-      triangles[++triangleIndex] = polygon->c;
-    }
-    ++triangleIndex;
-  }
+  GeAssert(sizeof(CPolygon) == 4*sizeof(LuxInteger));
+  GeometryKernels::triangulate((const LuxInteger*)mPolygonCache.arrayAddress(),
+                               (GeometryKernels::IndexT)mPolygonCache.size(),
+                               triangles.arrayAddress());
 
   // delete polygon cache as we don't need it anymore
   mPolygonCache.erase();
@@ -2568,13 +3518,10 @@ Bool LuxAPIConverter::convertGeometry(PolygonObject&  object,
     if (!uvs->init(mUVCache.size() << 1)) {
       ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertGeometry(): not enough memory to allocate UV array");
     }
-    // copy UVs from 2D vectors to serialised floats
-    LuxVector2D* uv;
-    for (ULONG uvIx=0; uvIx<mUVCache.size(); ++uvIx) {
-      uv = &(mUVCache[uvIx]);
-      (*uvs)[ uvIx << 1   ] = uv->x;
-      (*uvs)[(uvIx << 1)+1] = uv->y;
-    }
+    // copy UVs from 2D vectors to serialised floats (they have the same
+    // memory layout)
+    GeAssert(sizeof(LuxVector2D) == 2*sizeof(LuxFloat));
+    memcpy(uvs->arrayAddress(), mUVCache.arrayAddress(), mUVCache.size()*sizeof(LuxVector2D));
   }
 
   return TRUE;
@@ -2628,19 +3575,14 @@ Bool LuxAPIConverter::convertAndCacheObject(PolygonObject& object,
     c4dNormals = object.CreatePhongNormals();
     if (c4dNormals) {
       normals.setArrayAddress(c4dNormals, polygonCount*4);
-      // check if normals are actually just plain face normals
-      SizeT polygonIx = 0;
-      for (polygonIx=0; polygonIx<polygonCount; ++polygonIx) {
-        if (!equalNormals(normals[polygonIx*4], normals[polygonIx*4+1]) ||
-            !equalNormals(normals[polygonIx*4], normals[polygonIx*4+2]) ||
-            !equalNormals(normals[polygonIx*4], normals[polygonIx*4+3]))
-        {
-          break;
-        }
-      }
-      // if all normals on each face are the same, we don't have to care about
-      // vertex normals at all
-      if (polygonIx >= polygonCount) {
+      // check if normals are actually just plain face normals - if all normals
+      // on each face are the same, we don't have to care about vertex normals
+      // at all (uses the same error margin as equalNormals())
+      GeAssert(sizeof(SVector) == 3*sizeof(float));
+      if (GeometryKernels::equalPolygonNormals((const float*)c4dNormals,
+                                               (GeometryKernels::IndexT)polygonCount,
+                                               0.001*0.001))
+      {
         normals.erase();
       }
     }
@@ -2672,16 +3614,16 @@ Bool LuxAPIConverter::convertAndCacheObject(PolygonObject& object,
 
   // log which vertex attributes are available
   if (uvs.size()) {
-    debugLog("  it has UV coordinates");
+    LOG_TRACE("  it has UV coordinates");
   } else {
-    debugLog("  it has no UV coordinates");
+    LOG_TRACE("  it has no UV coordinates");
   }
   if (normals.size()) {
-    debugLog("  it has vertex normals");
+    LOG_TRACE("  it has vertex normals");
   } else if (c4dNormals) {
-    debugLog("  it has vertex normals == face normals");
+    LOG_TRACE("  it has vertex normals == face normals");
   } else {
-    debugLog("  it has no vertex normals");
+    LOG_TRACE("  it has no vertex normals");
   }
 
   // if we have only points and polygons:
@@ -2716,10 +3658,9 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject& object)
 
   // initialise point map
   FixArray1D<ULONG> pointMap;
-  if (!pointMap.init(pointCount)) {
+  if (!pointMap.initWithZero(pointCount)) {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertAndCacheGeometry(): not enough memory to allocate point map");
   }
-  pointMap.fillWithZero();
 
   // count how many polygons use each point
   CPolygon* poly;
@@ -2753,44 +3694,46 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject& object)
   }
 
   // log the info we have at the moment
-  debugLog("  poly count:         %lu", (unsigned long)polyCount);
-  debugLog("  point count:        %lu", (unsigned long)pointCount);
-  debugLog("  new point count:    %lu", (unsigned long)newPointCount);
-
-  // initialise point cache array (which will hold only used points)
-  if (!mPointCache.init(newPointCount)) {
+  LOG_TRACE("  poly count:         %lu", (unsigned long)polyCount);
+  LOG_TRACE("  point count:        %lu", (unsigned long)pointCount);
+  LOG_TRACE("  new point count:    %lu", (unsigned long)newPointCount);
+
+  // initialise point cache array (which will hold only used points) and the
+  // array of the C4D points that are copied into it
+  PointMapT sourcePoints;
+  if (!mPointCache.init(newPointCount) || !sourcePoints.init(newPointCount)) {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertAndCacheGeometry(): not enough memory to allocate point map");
   }
 
-  // now fill point cache with used points and update polygons
+  // now determine used points and update polygons
   ULONG oldPointIx, newPointIx = 0;
   for (ULONG polyIx=0; polyIx<polyCount; ++polyIx) {
     // store pointer to polygon for convenience
     poly = &(mPolygonCache[polyIx]);
     // 1st point of polygon
     if (pointMap[oldPointIx = poly->a] == MAXULONG) {
-      mPointCache[newPointIx] = points[oldPointIx] * mC4D2LuxScale;
+      sourcePoints[newPointIx] = oldPointIx;
       pointMap[oldPointIx] = newPointIx;
       ++newPointIx;
     }
     poly->a = pointMap[oldPointIx];
     // 2nd point of polygon
     if (pointMap[oldPointIx = poly->b] == MAXULONG) {
-      mPointCache[newPointIx] = points[oldPointIx] * mC4D2LuxScale;
+      sourcePoints[newPointIx] = oldPointIx;
       pointMap[oldPointIx] = newPointIx;
       ++newPointIx;
     }
     poly->b = pointMap[oldPointIx];
     // 3rd point of polygon
     if (pointMap[oldPointIx = poly->c] == MAXULONG) {
-      mPointCache[newPointIx] = points[oldPointIx] * mC4D2LuxScale;
+      sourcePoints[newPointIx] = oldPointIx;
       pointMap[oldPointIx] = newPointIx;
       ++newPointIx;
     }
     poly->c = pointMap[oldPointIx];
     // 4th point of polygon
     if (pointMap[oldPointIx = poly->d] == MAXULONG) {
-      mPointCache[newPointIx] = points[oldPointIx] * mC4D2LuxScale;
+      sourcePoints[newPointIx] = oldPointIx;
       pointMap[oldPointIx] = newPointIx;
       ++newPointIx;
     }
@@ -2800,6 +3743,9 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject& object)
   // if that is not true, there is a hole in the logic
   GeAssert(newPointIx == newPointCount);
 
+  // copy used points into the point cache
+  fillPointCache(points, sourcePoints);
+
   return TRUE;
 }
 
@@ -2830,10 +3776,9 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject&     object,
 
   // initialise point2poly map
   Point2PolyMapT point2PolyMap;
-  if (!point2PolyMap.init(pointMap[pointCount])) {
+  if (!point2PolyMap.initWithZero(pointMap[pointCount])) {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertAndCacheWithNormals(): not enough memory to allocate poin2PolyMap");
   }
-  point2PolyMap.fillWithZero();
 
   // Collect point2poly information and create new entries only for points
   // with distinct normals. It basically works like that:
@@ -2897,23 +3842,25 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject&     object,
     }
     ++normal;
   }
-  debugLog("  new point count:     %lu", (unsigned long)newPointCount);
+  LOG_TRACE("  new point count:     %lu", (unsigned long)newPointCount);
 
   // initialise point cache and normal cache
-  if (!mPointCache.init(newPointCount) || !mNormalCache.init(newPointCount)) {
+  PointMapT sourcePoints;
+  if (!mPointCache.init(newPointCount) ||
+      !mNormalCache.init(newPointCount) ||
+      !sourcePoints.init(newPointCount))
+  {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertAndCacheWithNormals(): not enough memory to allocate point and/or normal cache");
   }
 
-  // now determine new node IDs and fill normal and point caches
-  ULONG   newPointIx = 0;
-  SVector normalised;
+  // now determine new node IDs and fill normal cache
+  ULONG newPointIx = 0;
   for (ULONG pointIx=0; pointIx<pointCount; ++pointIx) {
     for (ULONG point2PolyIx=pointMap[pointIx]; point2PolyIx<pointMap[pointIx+1]; ++point2PolyIx) {
       point2Poly = &(point2PolyMap[point2PolyIx]);
       if (!point2Poly->normalRef)  break;
-      mPointCache[newPointIx]  = points[pointIx] * mC4D2LuxScale;
-      normalised               = *(point2Poly->normalRef);
-      mNormalCache[newPointIx] = normalize(normalised);
+      sourcePoints[newPointIx] = pointIx;
+      mNormalCache[newPointIx] = *(point2Poly->normalRef);
       point2Poly->newPoint     = newPointIx;
       ++newPointIx;
     }
@@ -2922,6 +3869,10 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject&     object,
   // if that is not true, there is a hole in the logic
   GeAssert(newPointIx == newPointCount);
 
+  // fill point cache and normalise normals
+  fillPointCache(points, sourcePoints);
+  normalizeNormalCache();
+
   // set new points in polygon
   for (ULONG polyIx=0; polyIx<polyCount; ++polyIx) {
     poly = &mPolygonCache[polyIx];
@@ -2955,10 +3906,9 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject& object,
 
   // initialise point2poly map
   Point2PolyMapT point2PolyMap;
-  if (!point2PolyMap.init(pointMap[pointCount])) {
+  if (!point2PolyMap.initWithZero(pointMap[pointCount])) {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertAndCacheWithUVs(): not enough memory to allocate poin2PolyMap");
   }
-  point2PolyMap.fillWithZero();
 
   // Collect point2poly information and create new entries only for points
   // with distinct UVs. It basically works like that:
@@ -3022,20 +3972,24 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject& object,
     }
     ++uv;
   }
-  debugLog("  new point count:     %lu", (unsigned long)newPointCount);
+  LOG_TRACE("  new point count:     %lu", (unsigned long)newPointCount);
 
-  // initialise point cache and normal cache
-  if (!mPointCache.init(newPointCount) || !mUVCache.init(newPointCount)) {
+  // initialise point cache and UV cache
+  PointMapT sourcePoints;
+  if (!mPointCache.init(newPointCount) ||
+      !mUVCache.init(newPointCount) ||
+      !sourcePoints.init(newPointCount))
+  {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertAndCacheWithUVs(): not enough memory to allocate point and/or UV cache");
   }
 
-  // now determine new node IDs and fill normal and point caches
+  // now determine new node IDs and fill UV cache
   ULONG newPointIx = 0;
   for (ULONG pointIx=0; pointIx<pointCount; ++pointIx) {
     for (ULONG point2PolyIx=pointMap[pointIx]; point2PolyIx<pointMap[pointIx+1]; ++point2PolyIx) {
       point2Poly = &(point2PolyMap[point2PolyIx]);
       if (!point2Poly->uvRef)  break;
-      mPointCache[newPointIx] = points[pointIx] * mC4D2LuxScale;
+      sourcePoints[newPointIx] = pointIx;
       mUVCache[newPointIx] = *(point2Poly->uvRef);
       point2Poly->newPoint = newPointIx;
       ++newPointIx;
@@ -3045,6 +3999,9 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject& object,
   // if that is not true, there is a hole in the logic
   GeAssert(newPointIx == newPointCount);
 
+  // fill point cache
+  fillPointCache(points, sourcePoints);
+
   // set new points in polygon
   for (ULONG polyIx=0; polyIx<polyCount; ++polyIx) {
     poly = &mPolygonCache[polyIx];
@@ -3084,10 +4041,9 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject&     object,
 
   // initialise point2poly map
   Point2PolyMapT point2PolyMap;
-  if (!point2PolyMap.init(pointMap[pointCount])) {
+  if (!point2PolyMap.initWithZero(pointMap[pointCount])) {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertAndCacheWithUVsAndNormals(): not enough memory to allocate poin2PolyMap");
   }
-  point2PolyMap.fillWithZero();
 
   // Collect point2poly information and create new entries only for points
   // with distinct UVs. It basically works like that:
@@ -3176,27 +4132,27 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject&     object,
     ++uv;
     ++normal;
   }
-  debugLog("  new point count:     %lu", (unsigned long)newPointCount);
+  LOG_TRACE("  new point count:     %lu", (unsigned long)newPointCount);
 
-  // initialise point cache and normal cache
+  // initialise point cache, UV cache and normal cache
+  PointMapT sourcePoints;
   if (!mPointCache.init(newPointCount) ||
       !mUVCache.init(newPointCount) ||
-      !mNormalCache.init(newPointCount))
+      !mNormalCache.init(newPointCount) ||
+      !sourcePoints.init(newPointCount))
   {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::convertAndCacheWithUVsAndNormals(): not enough memory to allocate point, UV and/or normal cache");
   }
 
-  // now determine new node IDs and fill normal and point caches
-  ULONG   newPointIx = 0;
-  SVector normalised;
+  // now determine new node IDs and fill UV and normal caches
+  ULONG newPointIx = 0;
   for (ULONG pointIx=0; pointIx<pointCount; ++pointIx) {
     for (ULONG point2PolyIx=pointMap[pointIx]; point2PolyIx<pointMap[pointIx+1]; ++point2PolyIx) {
       point2Poly = &(point2PolyMap[point2PolyIx]);
       if (!point2Poly->ref.uv)  break;
-      mPointCache[newPointIx]  = points[pointIx] * mC4D2LuxScale;
+      sourcePoints[newPointIx] = pointIx;
       mUVCache[newPointIx]     = *(point2Poly->ref.uv);
-      normalised               = *(point2Poly->ref.normal);
-      mNormalCache[newPointIx] = normalize(normalised);
+      mNormalCache[newPointIx] = *(point2Poly->ref.normal);
       point2Poly->newPoint = newPointIx;
       ++newPointIx;
     }
@@ -3205,6 +4161,10 @@ Bool LuxAPIConverter::convertAndCacheGeometry(PolygonObject&     object,
   // if that is not true, there is a hole in the logic
   GeAssert(newPointIx == newPointCount);
 
+  // fill point cache and normalise normals
+  fillPointCache(points, sourcePoints);
+  normalizeNormalCache();
+
   // set new points in polygon
   for (ULONG polyIx=0; polyIx<polyCount; ++polyIx) {
     poly = &mPolygonCache[polyIx];
@@ -3254,10 +4214,9 @@ Bool LuxAPIConverter::setupPointMap(PolygonObject& object,
   }
 
   // initialise point map
-  if (!pointMap.init(pointCount+1)) {
+  if (!pointMap.initWithZero(pointCount+1)) {
     ERRLOG_RETURN_VALUE(FALSE, "LuxAPIConverter::setupPointMap(): not enough memory to allocate point map");
   }
-  pointMap.fillWithZero();
 
   // count number of polygons per point (+ number of quads)
   CPolygon* poly;
@@ -3271,8 +4230,8 @@ Bool LuxAPIConverter::setupPointMap(PolygonObject& object,
       ++mQuadCount;
     }
   }
-  debugLog("  poly count:          %lu", (unsigned long)polyCount);
-  debugLog("  point count:         %lu", (unsigned long)pointCount);
+  LOG_TRACE("  poly count:          %lu", (unsigned long)polyCount);
+  LOG_TRACE("  point count:         %lu", (unsigned long)pointCount);
 
   // convert polygon counts of point map into start positions in point2Poly map
   ULONG point2PolyCount, point2PolyMapSize = 0;
@@ -3281,7 +4240,7 @@ Bool LuxAPIConverter::setupPointMap(PolygonObject& object,
     pointMap[point]   =  point2PolyMapSize;
     point2PolyMapSize += point2PolyCount;
   }
-  debugLog("  point2poly map size: %lu", (unsigned long)point2PolyMapSize);
+  LOG_TRACE("  point2poly map size: %lu", (unsigned long)point2PolyMapSize);
 
   // make sure that there are not too many polygons, which might cause integer
   // overflows somewhere else
@@ -3291,3 +4250,42 @@ Bool LuxAPIConverter::setupPointMap(PolygonObject& object,
 
   return TRUE;
 }
+
+
+/// Fills the point cache with scaled copies of C4D points. The point cache
+/// must have been initialised with the size of sourcePoints.
+///
+/// @param[in]  points
+///   The point coordinate array of the polygon object.
+/// @param[in]  sourcePoints
+///   The index of the C4D point for each entry of the point cache.
+void LuxAPIConverter::fillPointCache(const Vector*    points,
+                                     const PointMapT& sourcePoints)
+{
+  GeAssert(mPointCache.size() == sourcePoints.size());
+#if _C4D_VERSION >= 120
+  GeAssert(sizeof(Vector) == 3*sizeof(double));
+  GeAssert(sizeof(LuxPoint) == 3*sizeof(float));
+  GeAssert(sizeof(ULONG) == sizeof(GeometryKernels::IndexT));
+  GeometryKernels::scalePoints((const double*)points,
+                               (const GeometryKernels::IndexT*)sourcePoints.arrayAddress(),
+                               (GeometryKernels::IndexT)sourcePoints.size(),
+                               mC4D2LuxScale,
+                               (float*)mPointCache.arrayAddress());
+#else
+  // before R12 the C4D points are floats, so there is nothing to convert
+  for (SizeT pointIx=0; pointIx<sourcePoints.size(); ++pointIx) {
+    mPointCache[pointIx] = points[sourcePoints[pointIx]] * mC4D2LuxScale;
+  }
+#endif
+}
+
+
+/// Normalises all normals of the normal cache. The result is the same as if
+/// the C4D normals were normalised via normalize() before converting them.
+void LuxAPIConverter::normalizeNormalCache(void)
+{
+  GeAssert(sizeof(LuxNormal) == 3*sizeof(float));
+  GeometryKernels::normalizeNormals((float*)mNormalCache.arrayAddress(),
+                                    (GeometryKernels::IndexT)mNormalCache.size());
+}
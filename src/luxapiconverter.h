@@ -32,13 +32,18 @@
 
 #include "dynarray1d.h"
 #include "fixarray1d.h"
+#include "hashmap.h"
+#include "hashset.h"
 #include "luxapi.h"
 #include "luxc4dportaltag.h"
 #include "luxc4dsettings.h"
+#include "luxexportprogress.h"
 #include "luxmaterialdata.h"
+#include "luxsceneir.h"
 #include "luxtexturedata.h"
-#include "rbtreeset.h"
-#include "rbtreemap.h"
+#include "memoryarena.h"
+#include "nameallocator.h"
+#include "symboltable.h"
 
 
 
@@ -56,13 +61,26 @@ class LuxAPIConverter : public Hierarchy
 {
 public:
 
+  /// Maps the path of each polygon object of a document (see objectPath()) to
+  /// the checksum of its dirty counts (0 = unknown).
+  typedef HashMap<String, ULONG> ObjectChecksumsT;
+
+
   LuxAPIConverter(void);
   ~LuxAPIConverter(void);
 
+  static void initSession(void);
+  static ULONG sessionToken(void);
+  static void recordObjectChecksums(BaseDocument&     document,
+                                    ObjectChecksumsT& checksums);
+
   Bool convertScene(BaseDocument& document,
                     LuxAPI&       receiver,
                     Bool          resume,
-                    Bool          forceFullExport);
+                    Bool          forceFullExport,
+                    Bool          animation=FALSE);
+  inline void setProgress(LuxExportProgress* progress);
+  inline void setObjectChecksums(const ObjectChecksumsT* checksums);
 
   // Callback functions called while Hierarchy traverses the hierarchy.
   virtual void* Alloc(void);
@@ -78,20 +96,34 @@ public:
 private:
 
   /// Helper structure to keep track of visibility and textures during
-  /// hierarchy traversal.
+  /// hierarchy traversal. mMaterialObject is the object whose texture tags
+  /// define the material of the current object (NULL = default material).
   struct HierarchyData {
 
-    Bool      mVisible;
-    String    mObjectName;
-    LuxString mMaterialName;
-    Bool      mHasEmissionChannel;
-    LuxString mLightGroup;
+    Bool        mVisible;
+    BaseObject* mMaterialObject;
 
     HierarchyData(Bool visible=TRUE)
     : mVisible(visible),
-      mHasEmissionChannel(FALSE)
+      mMaterialObject(0)
     {}
   };
+
+  /// Stores a light object that was found during the scene traversal and
+  /// will be exported later.
+  struct LightJob {
+    BaseObject* mObject;
+    Matrix      mGlobalMatrix;
+  };
+
+  /// Stores a polygon object that was found during the scene traversal and
+  /// will be exported later, together with the object that defines its
+  /// material.
+  struct GeometryJob {
+    PolygonObject* mObject;
+    Matrix         mGlobalMatrix;
+    BaseObject*    mMaterialObject;
+  };
  
 
   /// Structure that stores all parameters of a point light.
@@ -178,8 +210,9 @@ private:
   };
 
   // Stores the key of a reusable material, which constists of the material
-  // pointer plus texture mapping. It also implements the operators that are
-  // necessary for the map.
+  // pointer plus texture mapping. It also implements the functions that are
+  // necessary for the map. Only the material pointer is hashed, as materials
+  // rarely get used with many different mappings.
   struct ReusableMaterialKey {
     BaseMaterial*      mMaterial;
     LuxTextureMappingH mMapping;
@@ -203,20 +236,85 @@ private:
       return (mMaterial < other.mMaterial) ||
              ((mMaterial == other.mMaterial) && (*mMapping < *other.mMapping));
     }
+
+    bool operator==(const ReusableMaterialKey& other) const
+    {
+      return (mMaterial == other.mMaterial) &&
+             !(*mMapping < *other.mMapping) && !(*other.mMapping < *mMapping);
+    }
+
+    ULONG hash(void) const
+    {
+      return HashTraits<BaseMaterial*>::hash(mMaterial);
+    }
+  };
+
+
+  // Stores the key of a blend material, which consists of the names of the
+  // two blended materials. As the name of an exported material is unique for
+  // its material pointer plus texture mapping and the name of a blend material
+  // is unique for the materials it blends, the key represents the ordered
+  // list of all (material, mapping) pairs of a material stack. The names are
+  // interned, so they are hashed and compared as pointers.
+  struct BlendMaterialKey {
+    LuxSymbol mBaseName;
+    LuxSymbol mLayerName;
+
+    BlendMaterialKey(LuxSymbol baseName, LuxSymbol layerName)
+    : mBaseName(baseName), mLayerName(layerName)
+    {}
+
+    BlendMaterialKey(const BlendMaterialKey& other)
+    : mBaseName(other.mBaseName), mLayerName(other.mLayerName)
+    {}
+
+    BlendMaterialKey& operator=(const BlendMaterialKey& other)
+    {
+      mBaseName = other.mBaseName;  mLayerName = other.mLayerName;
+      return *this;
+    }
+
+    bool operator<(const BlendMaterialKey& other) const
+    {
+      return (mBaseName < other.mBaseName) ||
+             ((mBaseName == other.mBaseName) && (mLayerName < other.mLayerName));
+    }
+
+    bool operator==(const BlendMaterialKey& other) const
+    {
+      return (mBaseName == other.mBaseName) && (mLayerName == other.mLayerName);
+    }
+
+    ULONG hash(void) const
+    {
+      return hashCombine(HashTraits<LuxSymbol>::hash(mBaseName),
+                         HashTraits<LuxSymbol>::hash(mLayerName));
+    }
   };
 
 
   // Stores the name and additional information of a material, that can be
-  // reused.
+  // reused. The image usage range is the range in the usage log of the texture
+  // cache, which was recorded when the material was exported. All names are
+  // interned. The light group and the emission texture are only needed for
+  // the materials of objects and are NULL otherwise or if there are none.
   struct ReusableMaterial {
-    LuxString mName;
+    LuxSymbol mName;
     Bool      mHasEmissionChannel;
-    LuxString mLightGroup;
-
-    ReusableMaterial(const LuxString& name,
-                     Bool             hasEmissionChannel,
-                     const LuxString& lightGroup)
-    : mName(name), mHasEmissionChannel(hasEmissionChannel), mLightGroup(lightGroup)
+    LuxSymbol mLightGroup;
+    LuxSymbol mEmissionTexture;
+    SizeT     mImageUsageBegin;
+    SizeT     mImageUsageEnd;
+
+    ReusableMaterial(LuxSymbol name,
+                     Bool      hasEmissionChannel,
+                     LuxSymbol lightGroup,
+                     LuxSymbol emissionTexture,
+                     SizeT     imageUsageBegin,
+                     SizeT     imageUsageEnd)
+    : mName(name), mHasEmissionChannel(hasEmissionChannel), mLightGroup(lightGroup),
+      mEmissionTexture(emissionTexture),
+      mImageUsageBegin(imageUsageBegin), mImageUsageEnd(imageUsageEnd)
     {}
 
     ReusableMaterial(const ReusableMaterial& other)
@@ -229,6 +327,9 @@ private:
       mName               = other.mName;
       mHasEmissionChannel = other.mHasEmissionChannel;
       mLightGroup         = other.mLightGroup;
+      mEmissionTexture    = other.mEmissionTexture;
+      mImageUsageBegin    = other.mImageUsageBegin;
+      mImageUsageEnd      = other.mImageUsageEnd;
       return *this;
     }
   };
@@ -269,14 +370,23 @@ private:
   /// The container type for storing UV coordinates as 2D vectors.
   typedef FixArray1D<LuxVector2D> UVsT;
   /// The container type for storing UV coordinates as float array.
-  typedef FixArray1D<LuxFloat>    UVsSerialisedT;
+  typedef FixArray1D<LuxFloat, LUXC4D_SIMD_ALIGNMENT> UVsSerialisedT;
 
   /// The container type for storing a set of objects.
-  typedef RBTreeSet<BaseList2D*>                            ObjectsT;
-  /// The map from material name to number of materials that use this name.
-  typedef RBTreeMap<String, LONG>                           MaterialUsageMapT;
+  typedef HashSet<BaseList2D*>                              ObjectsT;
   /// The lookup map of reusable materials.
-  typedef RBTreeMap<ReusableMaterialKey, ReusableMaterial>  ReusableMaterialsT;
+  typedef HashMap<ReusableMaterialKey, ReusableMaterial>    ReusableMaterialsT;
+  /// The lookup map of the materials already exported for material objects.
+  typedef HashMap<BaseObject*, ReusableMaterial>            ObjectMaterialsT;
+  /// The lookup map of already exported blend materials.
+  typedef HashMap<BlendMaterialKey, LuxSymbol>              BlendMaterialsT;
+  /// The container type for storing the lights found during scene traversal.
+  typedef DynArray1D<LightJob>                              LightJobsT;
+  /// The container type for storing the polygon objects found during scene
+  /// traversal.
+  typedef DynArray1D<GeometryJob>                           GeometryJobsT;
+  /// The map from shard content name to the number of shards that got it.
+  typedef HashMap<LuxString, ULONG>                         ShardCountsT;
   /// The container type for storing the texture tags of an object.
   typedef DynArray1D<TextureTag*>                           TextureTagsT;
   /// The container type for storing C4D polygons.
@@ -285,34 +395,56 @@ private:
   typedef FixArray1D<SVector>                               C4DNormalsT;
   /// Helper array, which is used during the geometry conversion.
   typedef FixArray1D<ULONG>                                 PointMapT;
+  /// The buffer for the parameter values of the LuxC4DSettings object.
+  typedef LuxC4DSettings::ParamBuffer                       SettingsBufferT;
 
 
   // static costants
   static SizeT cMaxTextureTags;
 
   // references used by the whole conversion process and stored for convenience
-  BaseDocument*   mDocument;
-  LuxAPI*         mReceiver;
-  BaseContainer*  mC4DRenderSettings;
-  LuxC4DSettings* mLuxC4DSettings;
-  LReal           mC4D2LuxScale;
-  Real            mBumpSampleDistance;
-  Real            mColorGamma;
-  Real            mTextureGamma;
+  BaseDocument*      mDocument;
+  LuxAPI*            mReceiver;
+  LuxExportProgress* mProgress;
+  BaseContainer*     mC4DRenderSettings;
+  LuxC4DSettings*    mLuxC4DSettings;
+  LReal              mC4D2LuxScale;
+  Real               mBumpSampleDistance;
+  Real               mColorGamma;
+  Real               mTextureGamma;
+  Bool               mBakeShaders;
+  Bool               mIncremental;
+  Bool               mAnimation;
+
+  // the dirty checksums of the objects of the original document (or NULL)
+  const ObjectChecksumsT* mObjectChecksums;
 
   // temporary data stored during the conversion and shared between
-  // several functions
+  // several functions (the arena comes first, so it's destroyed after all
+  // objects that might reference objects in it)
+  MemoryArena        mArena;
   LuxParamSet        mTempParamSet;
+  SettingsBufferT    mSettingsBuffer;
   Bool               mIsBidirectional;
   CameraObject*      mCamera;
   LONG               mXResolution;
   LONG               mYResolution;
+  Vector             mCameraPosition;
+  Bool               mCameraIsOrtho;
+  LReal              mCameraPixelScale;
   BaseObject*        mSkyObject;
   ULONG              mPortalCount;
   ULONG              mLightCount;
   ObjectsT           mAreaLightObjects;
-  MaterialUsageMapT  mMaterialUsage;
+  SymbolTable        mSymbols;
+  NameAllocator      mMaterialNames;
   ReusableMaterialsT mReusableMaterials;
+  BlendMaterialsT    mBlendMaterials;
+  ObjectMaterialsT   mObjectMaterials;
+  LightJobsT         mLightJobs;
+  GeometryJobsT      mGeometryJobs;
+  LuxSceneIR         mSceneIR;
+  ShardCountsT       mShardCounts;
 
 
   // the currently cached object
@@ -328,15 +460,12 @@ private:
   // number of quads in polygon cache (used for calculating triangle count)
   ULONG         mQuadCount;
 
-  // the current conversion function that will be called by Do()
-  Bool            (LuxAPIConverter::*mDo)(HierarchyData& hierarchyData,
-                                          BaseObject&    object,
-                                          const Matrix&  globalMatrix,
-                                          Bool           controlObject);
-
 
   void clearTemporaryData(void);
   Bool obtainGlobalSceneData(void);
+  Bool startProgressPhase(LuxExportProgress::Phase phase,
+                          ULONG                    total=0);
+  Bool stepProgress(LuxExportProgress::Phase phase);
   
   Bool exportFilm(Bool resume);
   Bool exportCamera(void);
@@ -345,11 +474,13 @@ private:
   Bool exportSurfaceIntegrator(void);
   Bool exportAccelerator(void);
 
+  Bool collectSceneObjects(void);
+  Bool doCollect(HierarchyData& data,
+                 BaseObject&    object,
+                 const Matrix&  globalMatrix,
+                 Bool           controlObject);
+
   Bool exportLights(void);
-  Bool doLightExport(HierarchyData& data,
-                     BaseObject&    object,
-                     const Matrix&  globalMatrix,
-                     Bool           controlObject);
 
   Bool exportLight(BaseObject&   object,
                    const Matrix& globalMatrix);
@@ -368,16 +499,39 @@ private:
   Bool exportStandardMaterials(void);
 
   Bool exportGeometry(void);
-  Bool doGeometryExport(HierarchyData& data,
-                        BaseObject&    object,
-                        const Matrix&  globalMatrix,
-                        Bool           controlObject);
+  Bool convertGeometryJob(const GeometryJob&  job,
+                          LuxSceneIR::IndexT jobIndex);
+  Bool convertJobMeshes(const GeometryJob&  job,
+                        Bool                convertMeshes,
+                        LuxSceneIR::IndexT& mesh,
+                        LuxSceneIR::IndexT& portalMesh,
+                        unsigned int&       flags);
+  Bool getShardName(LuxString& shardName);
+  ULONG getShardDirtyChecksum(const GeometryJob&      job,
+                              const ReusableMaterial& material);
+  static void recordObjectTree(BaseObject*       object,
+                               BaseObject*       materialObject,
+                               ObjectChecksumsT& checksums);
+  static String objectPath(BaseObject& object);
+  void getShardContentChecksum(const GeometryJob&      job,
+                               const ReusableMaterial& material,
+                               LuxString&              shardName,
+                               ULONG&                  checksum);
+  Bool exportInstance(LuxSceneIR::IndexT instance);
+  Bool endAnimatedInstance(const std::string& objectName);
+  void requestTextureResolution(const ReusableMaterial& material,
+                                LONG                    resolution);
+  static SizeT collectTextureTags(BaseObject&   object,
+                                  TextureTagsT& textureTags);
+  ReusableMaterial* obtainObjectMaterial(BaseObject* materialObject);
 
   Bool exportMaterial(BaseObject&   object,
                       TextureTagsT& textureTags,
-                      LuxString&    materialName,
+                      LuxSymbol&    materialName,
                       Bool&         hasEmissionChannel,
-                      LuxString&    lightGroup);
+                      LuxSymbol&    lightGroup);
+  LONG estimateTextureResolution(PolygonObject& object,
+                                 const Matrix&  globalMatrix);
 
   LuxMaterialDataH convertDummyMaterial(BaseMaterial& material);
   LuxMaterialDataH convertDiffuseMaterial(LuxTextureMappingH& mapping,
@@ -414,12 +568,13 @@ private:
                                       LONG                brightnessId,
                                       LONG                mixerId);
 
-  Bool exportPolygonObject(PolygonObject& object,
-                           const Matrix&  globalMatrix);
-  Bool exportPortalObject(PolygonObject& object,
-                          const Matrix&  globalMatrix,
-                          BaseTag&       tag,
-                          Bool&          exportObject);
+  Bool convertPolygonObject(PolygonObject&      object,
+                            LuxSceneIR::IndexT& mesh);
+  Bool convertPortalObject(PolygonObject&      object,
+                           BaseTag&            tag,
+                           LuxSceneIR::IndexT& mesh,
+                           Bool&               flipNormals,
+                           Bool&               exportObject);
   Bool convertGeometry(PolygonObject&  object,
                        TrianglesT&     triangles,
                        PointsT&        points,
@@ -441,8 +596,33 @@ private:
                      ULONG&         pointCount,
                      const Vector*& points,
                      PointMapT&     pointMap);
+  void fillPointCache(const Vector*    points,
+                      const PointMapT& sourcePoints);
+  void normalizeNormalCache(void);
 };
 
 
 
+/*****************************************************************************
+ * Inlined functions of LuxAPIConverter
+ *****************************************************************************/
+
+/// Sets the object the progress of the following conversions gets reported
+/// to and which is checked for cancellation. Pass NULL to disable it.
+inline void LuxAPIConverter::setProgress(LuxExportProgress* progress)
+{
+  mProgress = progress;
+}
+
+
+/// Sets the dirty checksums of the objects of the original document, which
+/// was copied for the following conversions (see recordObjectChecksums()).
+/// Pass NULL if there are none.
+inline void LuxAPIConverter::setObjectChecksums(const ObjectChecksumsT* checksums)
+{
+  mObjectChecksums = checksums;
+}
+
+
+
 #endif  // #ifndef __LUXAPICONVERTER_H__
@@ -23,15 +23,22 @@
  * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
  ************************************************************************/
 
+#include <algorithm>
 #include <cstdio>
 
 #include "c4d_symbols.h"
 #include "common.h"
+#include "filepath.h"
 #include "luxapiwriter.h"
 #include "utilities.h"
 
 
 
+/// The first line of a shard manifest, which identifies its format.
+static const CHAR* cManifestHeader = "# LuxC4D shard manifest 2";
+
+
+
 /*****************************************************************************
  * Implementation of public member functions of class LuxAPIWriter.
  *****************************************************************************/
@@ -42,6 +49,13 @@ LuxAPIWriter::LuxAPIWriter()
 : mFilesOpen(FALSE),
   mUseRelativePaths(FALSE),
   mResume(FALSE),
+  mSceneCreated(FALSE),
+  mMaterialsCreated(FALSE),
+  mSequence(FALSE),
+  mObjectsOut(0),
+  mOpenShard(0),
+  mSequenceWriter(0),
+  mClosedBytes(0),
   mWorldStarted(FALSE),
   mErrorStringID(0)
 {
@@ -58,6 +72,8 @@ LuxAPIWriter::~LuxAPIWriter(void)
     ERRLOG("LuxAPIWriter::~LuxAPIWriter(): scene file wasn't closed properly");
     endScene();
   }
+  freeOldShards();
+  freeShards(mShards, mShardIndices);
 }
 
 
@@ -93,12 +109,19 @@ Bool LuxAPIWriter::init(const Filename &sceneFile,
   }
 
   // just store the filenames - they will be opened later
+  mSharedFilename     = sceneFile;
   mSceneFilename      = sceneFile;
   mSceneFileDirectory = FilePath(sceneFile).getDirectoryPath();
   mMaterialsFilename  = mSceneFilename;
   mMaterialsFilename.SetSuffix("lxm");
   mObjectsFilename    = mSceneFilename;
   mObjectsFilename.SetSuffix("lxo");
+  mManifestFilename   = mSceneFilename;
+  mManifestFilename.SetSuffix("lxd");
+  Filename shardDirectoryName(mSceneFilename.GetFile());
+  shardDirectoryName.ClearSuffix();
+  mShardDirectoryName = shardDirectoryName.GetString() + "_shards";
+  mShardDirectory     = mSceneFilename.GetDirectory() + Filename(mShardDirectoryName);
 
   // check if the materials and object files already exist
   sceneFilesExist = (GeFExist(mSceneFilename) &&
@@ -108,13 +131,171 @@ Bool LuxAPIWriter::init(const Filename &sceneFile,
   // initialise other stuff
   mUseRelativePaths = useRelativePaths;
   mResume           = resume && sceneFilesExist;
+  mSceneCreated     = FALSE;
+  mMaterialsCreated = FALSE;
+  mSequence         = FALSE;
+  mSequenceWriter   = 0;
+  mClosedBytes      = 0;
   mWorldStarted     = FALSE;
   mErrorStringID    = 0;
   mCommentLen       = 0;
+  mTextureCache.setSourceCache(0);
+
+  // read the shard manifest of the previous export (if there is one)
+  freeOldShards();
+  freeShards(mShards, mShardIndices);
+  if (!mResume && !readManifest()) {
+    ERRLOG("LuxAPIWriter::init(): could not read shard manifest -> all shards will be written again");
+    freeOldShards();
+  }
+  return TRUE;
+}
+
+
+/// Switches to the next frame of an animation export. The frame gets its own
+/// scene, materials and objects file, while the manifest and the shards stay
+/// the ones of the scene file passed to init(). Must be called after init()
+/// and before startScene().
+///
+/// @param[in]  frameFile
+///   The file name of the scene file of the frame.
+/// @return
+///   TRUE if successful, otherwise FALSE.
+Bool LuxAPIWriter::setFrame(const Filename& frameFile)
+{
+  if (mFilesOpen || mResume) {
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_INTERNAL,
+                           "LuxAPIWriter::setFrame(): scene file is still open or writer is in resume mode");
+  }
+  mSequence           = TRUE;
+  mSceneCreated       = FALSE;
+  mMaterialsCreated   = FALSE;
+  mSceneFilename      = frameFile;
+  mSceneFileDirectory = FilePath(frameFile).getDirectoryPath();
+  mMaterialsFilename  = frameFile;
+  mMaterialsFilename.SetSuffix("lxm");
+  mObjectsFilename    = frameFile;
+  mObjectsFilename.SetSuffix("lxo");
   return TRUE;
 }
 
 
+/// Initialises the instance as writer of a single frame of an animation, which
+/// is exported in parallel to other frames. The frame shares the manifest,
+/// the shards and the processed textures with the sequence writer, which must
+/// have exported its first frame already and must stay alive until this
+/// writer has finished. The manifest is not written and no textures are
+/// processed by this writer: images and shaders that were processed for the
+/// first frame are referenced, all others are exported unprocessed.
+///
+/// @param[in]  sequence
+///   The writer of the animation sequence, i.e. the writer that was passed to
+///   the export of the first frame and on which endSequence() is called.
+/// @param[in]  frameFile
+///   The file name of the scene file of the frame.
+/// @return
+///   TRUE if successful, otherwise FALSE.
+Bool LuxAPIWriter::initFrame(LuxAPIWriter&   sequence,
+                             const Filename& frameFile)
+{
+  if (mFilesOpen || !sequence.mSequence || sequence.mSequenceWriter) {
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_INTERNAL,
+                           "LuxAPIWriter::initFrame(): scene file is still open or the sequence writer wasn't set up");
+  }
+
+  // take over the shared files of the sequence
+  mSharedFilename     = sequence.mSharedFilename;
+  mManifestFilename   = sequence.mManifestFilename;
+  mShardDirectory     = sequence.mShardDirectory;
+  mShardDirectoryName = sequence.mShardDirectoryName;
+  mUseRelativePaths   = sequence.mUseRelativePaths;
+
+  // initialise other stuff
+  mResume           = FALSE;
+  mMaterialsCreated = FALSE;
+  mSequenceWriter   = &sequence;
+  mClosedBytes      = 0;
+  mWorldStarted     = FALSE;
+  mErrorStringID    = 0;
+  mCommentLen       = 0;
+  freeOldShards();
+  freeShards(mShards, mShardIndices);
+  mTextureCache.setSourceCache(&sequence.mTextureCache);
+
+  return setFrame(frameFile);
+}
+
+
+/// Finishes an animation export, i.e. writes the manifest of all shards that
+/// were used by any of the frames and deletes the shards of the previous
+/// export that are not used anymore.
+///
+/// @return
+///   TRUE if successful, otherwise FALSE.
+Bool LuxAPIWriter::endSequence(void)
+{
+  Bool success = TRUE;
+  if (mFilesOpen) {
+    ERRLOG("LuxAPIWriter::endSequence(): scene file wasn't closed properly");
+    success &= endScene();
+  }
+  if (mSequence && (mShards.size() || mOldShards.size())) {
+    success &= writeManifest();
+    deleteUnusedShards();
+  }
+  freeOldShards();
+  freeShards(mShards, mShardIndices);
+  mSequence = FALSE;
+  return success;
+}
+
+
+/// Aborts the current export and deletes the files that were written by it:
+/// The scene, materials and objects file of the current scene or frame, and -
+/// if this is not a frame writer - all shards that were written by the
+/// export. The manifest of the previous export is kept. Can be called
+/// instead of endScene() or endSequence().
+void LuxAPIWriter::discard(void)
+{
+  // close all open files without finishing them
+  if (mOpenShard) {
+    mShardFile->Close();
+    mOpenShard = 0;
+  }
+  if (mFilesOpen) {
+    mSceneFile->Close();
+    if (!mResume) {
+      mMaterialsFile->Close();
+      mObjectsFile->Close();
+    }
+    mObjectsOut = 0;
+    mFilesOpen  = FALSE;
+  }
+
+  // delete the files of the current scene or frame
+  if (mSceneCreated) {
+    GeFKill(mSceneFilename);
+    if (!mResume)  GeFKill(mObjectsFilename);
+    mSceneCreated = FALSE;
+  }
+  if (mMaterialsCreated) {
+    GeFKill(mMaterialsFilename);
+    mMaterialsCreated = FALSE;
+  }
+
+  // delete the shards shared by all frames, if we own them (shards that were
+  // reused from the previous export are kept, as they are still valid)
+  if (!mSequenceWriter) {
+    for (SizeT i=0; i<mShards.size(); ++i) {
+      if (mShards[i]->mWritten)  GeFKill(shardPath(mShards[i]->mName));
+    }
+    freeOldShards();
+    freeShards(mShards, mShardIndices);
+  }
+  mSequence = FALSE;
+}
+
+
 /// Starts a new scene - see LuxAPI::startScene(const char*).
 Bool LuxAPIWriter::startScene(const char* head)
 {
@@ -141,7 +322,8 @@ Bool LuxAPIWriter::startScene(const char* head)
       ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_IO,
                              "LuxAPIWriter::startScene(): could not open file '" + mSceneFilename.GetString() + "'");
     }
-    mFilesOpen = TRUE;
+    mFilesOpen    = TRUE;
+    mSceneCreated = TRUE;
     // write header comments
     return writeLine(*mSceneFile, head) &&
            writeLine(*mSceneFile, "\n\n# Global Settings\n");
@@ -157,7 +339,10 @@ Bool LuxAPIWriter::startScene(const char* head)
       ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_IO,
                              "LuxAPIWriter::startScene(): could not open file '" + mSceneFilename.GetString() + "'");
     }
-    mFilesOpen = TRUE;
+    mFilesOpen        = TRUE;
+    mSceneCreated     = TRUE;
+    mMaterialsCreated = TRUE;
+    mObjectsOut       = mObjectsFile;
     // write header comments
     return writeLine(*mSceneFile, head) &&
            writeLine(*mSceneFile, "\n\n# Global Settings\n") &&
@@ -173,8 +358,14 @@ Bool LuxAPIWriter::endScene(void)
   // don't do anything if nothing was opened
   if (!mFilesOpen)  return TRUE;
 
-  // write the inclusion of the the materials and objects files into the scene
+  // close a shard which was left open
   Bool success = TRUE;
+  if (mOpenShard) {
+    ERRLOG("LuxAPIWriter::endScene(): shard wasn't closed properly");
+    success &= shardEnd();
+  }
+
+  // write the inclusion of the the materials and objects files into the scene
   success &= writeLine(*mSceneFile, "\n# The Scene");
   success &= writeLine(*mSceneFile, "WorldBegin\n");
   LuxString tempLuxStr;
@@ -187,11 +378,24 @@ Bool LuxAPIWriter::endScene(void)
   success &= writeLine(*mSceneFile, "\nWorldEnd");
 
   // close the files
+  mClosedBytes = bytesWritten();
   success &= mSceneFile->Close();
   if (!mResume) {
     success &= mMaterialsFile->Close();
     success &= mObjectsFile->Close();
   }
+  mObjectsOut = 0;
+
+  // the frames of an animation keep the shards until endSequence() is called
+  if (!mSequence) {
+    // update the shard manifest and remove the shards we don't need anymore
+    if (!mResume && (mShards.size() || mOldShards.size())) {
+      success &= writeManifest();
+      deleteUnusedShards();
+    }
+    freeOldShards();
+    freeShards(mShards, mShardIndices);
+  }
 
   // check if everything was done correctly
   if (!success) {
@@ -221,6 +425,39 @@ Filename LuxAPIWriter::getSceneFilename(void)
 }
 
 
+/// Returns the scene file passed to init(), which is shared by all frames of
+/// an animation export - see LuxAPI::getSharedFilename().
+Filename LuxAPIWriter::getSharedFilename(void)
+{
+  return mSharedFilename;
+}
+
+
+/// Returns the texture cache, which stores its images next to the scene file
+/// - see LuxAPI::textureCache().
+LuxTextureCache* LuxAPIWriter::textureCache(void)
+{
+  return &mTextureCache;
+}
+
+
+/// Returns the number of bytes written into the files of this writer so far
+/// - see LuxAPI::bytesWritten().
+VULONG LuxAPIWriter::bytesWritten(void)
+{
+  VULONG bytes = mClosedBytes;
+  if (mFilesOpen) {
+    bytes += (VULONG)mSceneFile->GetPosition();
+    if (!mResume) {
+      bytes += (VULONG)mMaterialsFile->GetPosition();
+      bytes += (VULONG)mObjectsFile->GetPosition();
+    }
+  }
+  if (mOpenShard)  bytes += (VULONG)mShardFile->GetPosition();
+  return bytes;
+}
+
+
 /// Specifies the comment for the next command - see
 /// LuxAPI::setComment(const char*).
 Bool LuxAPIWriter::setComment(const char* text)
@@ -344,55 +581,55 @@ Bool LuxAPIWriter::worldEnd(void)
 
 Bool LuxAPIWriter::attributeBegin(void)
 {
-  mObjectsFile->WriteChar('\n');
-  writeComment(mObjectsFile);
-  return writeLine(*mObjectsFile, "AttributeBegin");
+  mObjectsOut->WriteChar('\n');
+  writeComment(*mObjectsOut);
+  return writeLine(*mObjectsOut, "AttributeBegin");
 }
 
 
 Bool LuxAPIWriter::attributeEnd(void)
 {
-  writeComment(mObjectsFile);
-  return writeLine(*mObjectsFile, "AttributeEnd\n");
+  writeComment(*mObjectsOut);
+  return writeLine(*mObjectsOut, "AttributeEnd\n");
 }
 
 
 Bool LuxAPIWriter::objectBegin(const IdentifierName name)
 {
-  mObjectsFile->WriteChar('\n');
-  writeComment(mObjectsFile);
-  return writeSetting(*mObjectsFile, "\nObjectBegin", name);
+  mObjectsOut->WriteChar('\n');
+  writeComment(*mObjectsOut);
+  return writeSetting(*mObjectsOut, "\nObjectBegin", name);
 }
 
 
 Bool LuxAPIWriter::objectEnd(void)
 {
-  writeComment(mObjectsFile);
-  return writeLine(*mObjectsFile, "ObjectEnd");
+  writeComment(*mObjectsOut);
+  return writeLine(*mObjectsOut, "ObjectEnd");
 }
 
 
 Bool LuxAPIWriter::lightGroup(IdentifierName name)
 {
-  writeComment(mObjectsFile);
-  return writeSetting(*mObjectsFile, "LightGroup", name);
+  writeComment(*mObjectsOut);
+  return writeSetting(*mObjectsOut, "LightGroup", name);
 }
 
 
 Bool LuxAPIWriter::lightSource(IdentifierName     type,
                                const LuxParamSet& paramSet)
 {
-  mObjectsFile->WriteChar('\n');
-  writeComment(mObjectsFile);
-  return writeSetting(*mObjectsFile, "LightSource", type, 0, 0, paramSet, TRUE);
+  mObjectsOut->WriteChar('\n');
+  writeComment(*mObjectsOut);
+  return writeSetting(*mObjectsOut, "LightSource", type, 0, 0, paramSet, TRUE);
 }
 
 
 Bool LuxAPIWriter::areaLightSource(IdentifierName     type,
                                    const LuxParamSet& paramSet)
 {
-  writeComment(mObjectsFile);
-  return writeSetting(*mObjectsFile, "AreaLightSource", type, 0, 0, paramSet, TRUE);
+  writeComment(*mObjectsOut);
+  return writeSetting(*mObjectsOut, "AreaLightSource", type, 0, 0, paramSet, TRUE);
 }
 
 
@@ -405,7 +642,7 @@ Bool LuxAPIWriter::texture(IdentifierName     name,
   const static ULONG  sBufferSize(360);
   CHAR                buffer[sBufferSize];
 
-  mObjectsFile->WriteChar('\n');
+  mObjectsOut->WriteChar('\n');
 
   // write buffered comment, if there is one
   writeComment(mMaterialsFile);
@@ -457,16 +694,16 @@ Bool LuxAPIWriter::makeNamedMaterial(IdentifierName     name,
 
 Bool LuxAPIWriter::namedMaterial(IdentifierName name)
 {
-  writeComment(mObjectsFile);
-  return writeSetting(*mObjectsFile, "NamedMaterial", name);
+  writeComment(*mObjectsOut);
+  return writeSetting(*mObjectsOut, "NamedMaterial", name);
 }
 
 
 Bool LuxAPIWriter::material(IdentifierName     type,
                             const LuxParamSet& paramSet)
 {
-  writeComment(mObjectsFile);
-  return writeSetting(*mObjectsFile, "Material", type, 0, 0, paramSet, TRUE);
+  writeComment(*mObjectsOut);
+  return writeSetting(*mObjectsOut, "Material", type, 0, 0, paramSet, TRUE);
 }
 
 
@@ -475,7 +712,7 @@ Bool LuxAPIWriter::transform(const LuxMatrix& matrix)
   const static ULONG  sBufferSize(360);
   CHAR                buffer[sBufferSize];
 
-  BaseFile* outFile = mWorldStarted ? mObjectsFile : mSceneFile;
+  BaseFile* outFile = mWorldStarted ? mObjectsOut : (BaseFile*)mSceneFile;
 
   // write buffered comment, if there is one
   writeComment(*outFile);
@@ -499,24 +736,120 @@ Bool LuxAPIWriter::transform(const LuxMatrix& matrix)
 
 Bool LuxAPIWriter::reverseOrientation(void)
 {
-  writeComment(mObjectsFile);
-  return writeLine(*mObjectsFile, "ReverseOrientation");
+  writeComment(*mObjectsOut);
+  return writeLine(*mObjectsOut, "ReverseOrientation");
 }
 
 
 Bool LuxAPIWriter::shape(IdentifierName     type,
                          const LuxParamSet& paramSet)
 {
-  writeComment(mObjectsFile);
-  return writeSetting(*mObjectsFile, "Shape", type, 0, 0, paramSet, TRUE);
+  writeComment(*mObjectsOut);
+  return writeSetting(*mObjectsOut, "Shape", type, 0, 0, paramSet, TRUE);
 }
 
 
 Bool LuxAPIWriter::portalShape(IdentifierName     type,
                                const LuxParamSet& paramSet)
 {
-  writeComment(mObjectsFile);
-  return writeSetting(*mObjectsFile, "PortalShape", type, 0, 0, paramSet, TRUE);
+  writeComment(*mObjectsOut);
+  return writeSetting(*mObjectsOut, "PortalShape", type, 0, 0, paramSet, TRUE);
+}
+
+
+Bool LuxAPIWriter::findShard(ULONG      dirtyChecksum,
+                             LuxString& name,
+                             ULONG&     checksum)
+{
+  if (!dirtyChecksum)  return FALSE;
+  lockShards();
+  LuxAPIWriter& registry = shardRegistry();
+  const SizeT*  index = registry.mOldShardDirtyIndices.get(dirtyChecksum);
+  if (index) {
+    const Shard& shard = *registry.mOldShards[*index];
+    name     = shard.mName;
+    checksum = shard.mChecksum;
+  }
+  unlockShards();
+  return (index != 0);
+}
+
+
+Bool LuxAPIWriter::isShardCurrent(IdentifierName   name,
+                                  ULONG            checksum,
+                                  const LuxMatrix& matrix)
+{
+  lockShards();
+  Bool current = shardRegistry().isRegisteredShardCurrent(name, checksum, matrix);
+  unlockShards();
+  return current;
+}
+
+
+Bool LuxAPIWriter::shardBegin(IdentifierName   name,
+                              ULONG            checksum,
+                              ULONG            dirtyChecksum,
+                              const LuxMatrix& matrix,
+                              IdentifierName   material,
+                              Bool&            reused)
+{
+  reused = FALSE;
+  if (mOpenShard) {
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_INTERNAL,
+                           "LuxAPIWriter::shardBegin(): shard is already open");
+  }
+
+  // record the shard in the registry (which is shared by all frames of an
+  // animation) and include it in the objects file
+  Shard* shard = 0;
+  lockShards();
+  Bool registered = shardRegistry().registerShard(name, checksum, dirtyChecksum,
+                                                  matrix, material, shard, reused);
+  unlockShards();
+  if (!registered) {
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_INTERNAL,
+                           "LuxAPIWriter::shardBegin(): shard could not be registered");
+  }
+  if (!includeShard(shard->mName))  return FALSE;
+  if (reused)  return TRUE;
+
+  // otherwise open the shard file and redirect all object commands into it
+  Filename path(shardPath(shard->mName));
+  lockShards();
+  Bool opened = ((GeFExist(mShardDirectory, TRUE) || GeFCreateDir(mShardDirectory)) &&
+                 mShardFile->Open(path, FILEOPEN_WRITE, FILEDIALOG_ANY));
+  if (!opened) {
+    // make sure that the missing shard won't be reused by the next export
+    shard->mChecksum ^= 0xFFFFFFFF;
+  }
+  unlockShards();
+  if (!opened) {
+    mShardFile->Close();
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_IO,
+                           "LuxAPIWriter::shardBegin(): could not open file '" + path.GetString() + "'");
+  }
+  mOpenShard  = shard;
+  mObjectsOut = mShardFile;
+  return writeLine(*mShardFile, "# Geometry Shard");
+}
+
+
+Bool LuxAPIWriter::shardEnd(void)
+{
+  if (!mOpenShard)  return TRUE;
+  Shard* shard = mOpenShard;
+  mOpenShard  = 0;
+  mObjectsOut = mObjectsFile;
+  mClosedBytes += (VULONG)mShardFile->GetPosition();
+  if (!mShardFile->Close()) {
+    // make sure that the broken shard won't be reused by the next export
+    lockShards();
+    shard->mChecksum ^= 0xFFFFFFFF;
+    unlockShards();
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_IO,
+                           "LuxAPIWriter::shardEnd(): could not close shard file");
+  }
+  return TRUE;
 }
 
 
@@ -526,6 +859,318 @@ Bool LuxAPIWriter::portalShape(IdentifierName     type,
  *****************************************************************************/
 
 
+/// Locks the shard registry, which is shared by all frame writers of an
+/// animation. If the lock couldn't be allocated, the frames are never
+/// exported in parallel (see LuxC4DExporter::exportAnimation()).
+void LuxAPIWriter::lockShards(void)
+{
+  Semaphore* lock = shardRegistry().mShardLock;
+  if (lock)  lock->Lock();
+}
+
+
+/// Unlocks the shard registry again.
+void LuxAPIWriter::unlockShards(void)
+{
+  Semaphore* lock = shardRegistry().mShardLock;
+  if (lock)  lock->UnLock();
+}
+
+
+/// Checks if a shard of the registry of this writer is up to date. The caller
+/// must hold the lock of the registry.
+///
+/// @param[in]  name
+///   The name of the shard.
+/// @param[in]  checksum
+///   The checksum of the shard content.
+/// @param[in]  matrix
+///   The transformation that was baked into the shard.
+/// @return
+///   TRUE if the shard was already written by the current export or if the
+///   shard file of the previous export can be reused, otherwise FALSE.
+Bool LuxAPIWriter::isRegisteredShardCurrent(IdentifierName   name,
+                                            ULONG            checksum,
+                                            const LuxMatrix& matrix)
+{
+  // a shard which was already written by the current export
+  const SizeT* index = mShardIndices.get(name);
+  if (index) {
+    const Shard& shard = *mShards[*index];
+    return (shard.mChecksum == checksum) && (shard.mMatrix == matrix);
+  }
+
+  // a shard of the previous export
+  index = mOldShardIndices.get(name);
+  if (!index)  return FALSE;
+  const Shard& shard = *mOldShards[*index];
+  return (shard.mChecksum == checksum) &&
+         (shard.mMatrix == matrix) &&
+         GeFExist(shardPath(shard.mName));
+}
+
+
+/// Adds a shard to the registry of this writer, if it's not registered yet.
+/// The caller must hold the lock of the registry.
+///
+/// @param[in]  name
+///   The name of the shard.
+/// @param[in]  checksum
+///   The checksum of the shard content.
+/// @param[in]  dirtyChecksum
+///   The checksum of the change state of the shard content (0 = unknown).
+/// @param[in]  matrix
+///   The transformation that gets baked into the shard.
+/// @param[in]  material
+///   The name of the material that is referenced by the shard.
+/// @param[out]  shard
+///   Will be set to the registered shard entry.
+/// @param[out]  reused
+///   Will be set to TRUE if the shard file doesn't need to be written, i.e.
+///   if it was already written by the current export or if the file of the
+///   previous export can be reused.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory or if the shard was
+///   already registered with different content.
+Bool LuxAPIWriter::registerShard(IdentifierName   name,
+                                 ULONG            checksum,
+                                 ULONG            dirtyChecksum,
+                                 const LuxMatrix& matrix,
+                                 IdentifierName   material,
+                                 Shard*&          shard,
+                                 Bool&            reused)
+{
+  // if the shard was already written by this export, just include it again
+  const SizeT* index = mShardIndices.get(name);
+  if (index) {
+    shard = mShards[*index];
+    reused = TRUE;
+    return (shard->mChecksum == checksum) &&
+           (shard->mMatrix == matrix) &&
+           (shard->mMaterial == material);
+  }
+
+  // the shard can be reused, if it's current and references the same material
+  reused = FALSE;
+  if (isRegisteredShardCurrent(name, checksum, matrix)) {
+    reused = (mOldShards[*mOldShardIndices.get(name)]->mMaterial == material);
+  }
+
+  // record the shard for the new manifest
+  shard = gNew Shard;
+  if (!shard || !mShards.push(shard)) {
+    gDelete(shard);
+    return FALSE;
+  }
+  shard->mName          = name;
+  shard->mChecksum      = checksum;
+  shard->mDirtyChecksum = dirtyChecksum;
+  shard->mMatrix        = matrix;
+  shard->mMaterial      = material;
+  shard->mWritten       = !reused;
+  return (mShardIndices.add(shard->mName, mShards.size()-1) != 0);
+}
+
+
+/// Reads the shard manifest of the previous export, if it exists. After the
+/// header line cManifestHeader, each line of the manifest has the form
+///   <name> <checksum> <dirty checksum> <16 matrix values> <material name>
+/// Manifests without the header were written by an older version and are
+/// ignored, i.e. all their shards will be written again.
+///
+/// @return
+///   TRUE if successful or if there is no manifest, otherwise FALSE.
+Bool LuxAPIWriter::readManifest(void)
+{
+  if (!GeFExist(mManifestFilename))  return TRUE;
+
+  // read the whole file into a buffer
+  AutoAlloc<BaseFile> file;
+  if (!file || !file->Open(mManifestFilename, FILEOPEN_READ, FILEDIALOG_NONE)) {
+    return FALSE;
+  }
+  VLONG length = file->GetLength();
+  CHAR* buffer = bNew CHAR[length+1];
+  if (!buffer)  return FALSE;
+  Bool success = (file->ReadBytes(buffer, length) == length);
+  file->Close();
+  buffer[length] = '\0';
+
+  // skip the header or ignore the whole manifest, if it has none
+  SizeT headerLength = strlen(cManifestHeader);
+  CHAR* line = buffer + length;
+  if (success &&
+      (strncmp(buffer, cManifestHeader, headerLength) == 0) &&
+      (buffer[headerLength] == '\n'))
+  {
+    line = buffer + headerLength + 1;
+  }
+
+  // parse the lines
+  while (success && *line) {
+    CHAR* lineEnd = strchr(line, '\n');
+    if (lineEnd)  *lineEnd = '\0';
+    Shard*       shard = gNew Shard;
+    CHAR         name[64];
+    unsigned int checksum = 0;
+    unsigned int dirtyChecksum = 0;
+    int          materialOffset = 0;
+    if (!shard ||
+        (sscanf(line, "%63s %x %x %g %g %g %g %g %g %g %g %g %g %g %g %g %g %g %g %n",
+                name, &checksum, &dirtyChecksum,
+                &shard->mMatrix.values[0],  &shard->mMatrix.values[1],
+                &shard->mMatrix.values[2],  &shard->mMatrix.values[3],
+                &shard->mMatrix.values[4],  &shard->mMatrix.values[5],
+                &shard->mMatrix.values[6],  &shard->mMatrix.values[7],
+                &shard->mMatrix.values[8],  &shard->mMatrix.values[9],
+                &shard->mMatrix.values[10], &shard->mMatrix.values[11],
+                &shard->mMatrix.values[12], &shard->mMatrix.values[13],
+                &shard->mMatrix.values[14], &shard->mMatrix.values[15],
+                &materialOffset) < 19) ||
+        !materialOffset ||
+        !mOldShards.push(shard))
+    {
+      gDelete(shard);
+      success = FALSE;
+      break;
+    }
+    shard->mName          = name;
+    shard->mChecksum      = checksum;
+    shard->mDirtyChecksum = dirtyChecksum;
+    shard->mMaterial      = line + materialOffset;
+    shard->mWritten       = FALSE;
+    success = (mOldShardIndices.add(shard->mName, mOldShards.size()-1) != 0);
+    if (success && dirtyChecksum && !mOldShardDirtyIndices.get(dirtyChecksum)) {
+      success = (mOldShardDirtyIndices.add(dirtyChecksum, mOldShards.size()-1) != 0);
+    }
+    if (!lineEnd)  break;
+    line = lineEnd + 1;
+  }
+
+  bDelete(buffer);
+  return success;
+}
+
+
+/// Writes the manifest of all shards of the current export. If there are no
+/// shards, the manifest is deleted. The shards are sorted by name, as the
+/// order in which they were registered depends on the order in which the
+/// frames of an animation were exported.
+///
+/// @return
+///   TRUE if successful, otherwise FALSE.
+Bool LuxAPIWriter::writeManifest(void)
+{
+  if (!mShards.size()) {
+    GeFKill(mManifestFilename);
+    return TRUE;
+  }
+
+  AutoAlloc<BaseFile> file;
+  if (!file || !file->Open(mManifestFilename, FILEOPEN_WRITE, FILEDIALOG_ANY)) {
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_IO,
+                           "LuxAPIWriter::writeManifest(): could not open file '" + mManifestFilename.GetString() + "'");
+  }
+  ShardsT sortedShards;
+  if (!sortedShards.init(mShards.size())) {
+    file->Close();
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_INTERNAL,
+                           "LuxAPIWriter::writeManifest(): not enough memory to sort shards");
+  }
+  for (SizeT i=0; i<mShards.size(); ++i) {
+    sortedShards[i] = mShards[i];
+  }
+  std::sort(sortedShards.arrayAddress(),
+            sortedShards.arrayAddress() + sortedShards.size(),
+            isShardNameLess);
+
+  Bool success = writeLine(*file, cManifestHeader);
+  CHAR buffer[512];
+  for (SizeT i=0; i<sortedShards.size(); ++i) {
+    const Shard&     shard = *sortedShards[i];
+    const LuxFloat*  values = shard.mMatrix.values;
+    LONG len = sprintf(buffer,
+                       "%s %08x %08x %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g "
+                       "%.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g ",
+                       shard.mName.c_str(), (unsigned int)shard.mChecksum,
+                       (unsigned int)shard.mDirtyChecksum,
+                       values[0],  values[1],  values[2],  values[3],
+                       values[4],  values[5],  values[6],  values[7],
+                       values[8],  values[9],  values[10], values[11],
+                       values[12], values[13], values[14], values[15]);
+    success &= file->WriteBytes(buffer, len);
+    success &= writeLine(*file, shard.mMaterial.c_str());
+  }
+  success &= file->Close();
+  if (!success) {
+    GeFKill(mManifestFilename);
+    ERRLOG_ID_RETURN_VALUE(FALSE, IDS_ERROR_IO,
+                           "LuxAPIWriter::writeManifest(): writing to file failed");
+  }
+  return TRUE;
+}
+
+
+/// Deletes all shard files of the previous export, that are not used by the
+/// current export.
+void LuxAPIWriter::deleteUnusedShards(void)
+{
+  for (SizeT i=0; i<mOldShards.size(); ++i) {
+    if (!mShardIndices.get(mOldShards[i]->mName)) {
+      GeFKill(shardPath(mOldShards[i]->mName));
+    }
+  }
+}
+
+
+/// Writes the inclusion of a shard (and the buffered comment) into the objects
+/// file.
+Bool LuxAPIWriter::includeShard(const LuxString& name)
+{
+  LuxString includePath;
+  convert2LuxString(mShardDirectoryName, includePath);
+  includePath = "Include \"" + includePath + "/" + name + ".lxo\"";
+  writeComment(*mObjectsFile);
+  return writeLine(*mObjectsFile, includePath.c_str());
+}
+
+
+/// Returns the path of the file of a shard.
+Filename LuxAPIWriter::shardPath(const LuxString& name)
+{
+  return mShardDirectory + Filename(String(name.c_str()) + ".lxo");
+}
+
+
+/// Returns TRUE if the name of the first shard is smaller than the name of the
+/// second shard.
+bool LuxAPIWriter::isShardNameLess(const Shard* shard1,
+                                   const Shard* shard2)
+{
+  return (shard1->mName < shard2->mName);
+}
+
+
+/// Deletes all shard entries of the manifest of the previous export.
+void LuxAPIWriter::freeOldShards(void)
+{
+  freeShards(mOldShards, mOldShardIndices);
+  mOldShardDirtyIndices.erase();
+}
+
+
+/// Deletes all shard entries of a manifest.
+void LuxAPIWriter::freeShards(ShardsT&       shards,
+                              ShardIndicesT& indices)
+{
+  for (SizeT i=0; i<shards.size(); ++i) {
+    gDelete(shards[i]);
+  }
+  shards.erase();
+  indices.erase();
+}
+
+
 ///
 void LuxAPIWriter::writeComment(BaseFile& file)
 {
@@ -30,13 +30,38 @@
 
 #include <c4d.h>
 
+#include "dynarray1d.h"
 #include "luxapi.h"
+#include "rbtreemap.h"
 
 
 
 /***************************************************************************//*!
  This class implements LuxAPI and writes the passed commands into a .lxs scene
  file.
+
+ Shards are written into their own files in the directory "<scene name>_shards"
+ next to the scene file and are included by the .lxo file. For each written or
+ reused shard we store its checksum, dirty checksum, transformation and
+ material in the manifest file "<scene name>.lxd", which is read again by the
+ next export to decide which shards can be reused. Shards that are not used anymore get
+ deleted at the end of the export.
+
+ For the export of an animation, setFrame() is called before each frame is
+ exported. Each frame gets its own .lxs, .lxm and .lxo file, as every frame is
+ converted separately and may use other materials or material names, but all
+ frames share the shards of the scene file. The manifest is written and unused
+ shards are deleted by endSequence() after the last frame.
+
+ Frames can also be exported in parallel by separate writers, which are set up
+ via initFrame() after the first frame was exported by the sequence writer.
+ These frame writers register their shards in the sequence writer, which
+ protects its shard registry with a lock, so a shard that is needed by several
+ frames is written only once. Their texture caches reference the images that
+ were processed for the first frame.
+
+ If an export is cancelled or fails, discard() removes the partially written
+ files.
 *//****************************************************************************/
 class LuxAPIWriter : public LuxAPI
 {
@@ -49,13 +74,22 @@ public:
             Bool            useRelativePaths,
             Bool            resume,
             Bool            &sceneFilesExist);
+  Bool setFrame(const Filename& frameFile);
+  Bool initFrame(LuxAPIWriter&   sequence,
+                 const Filename& frameFile);
+  Bool endSequence(void);
+  void discard(void);
   inline LONG errorStringID(void) const;
+  inline Bool hasShardLock(void);
 
   virtual Bool startScene(const char* head);
   virtual Bool endScene(void);
 
   virtual void processFilePath(FilePath& path);
   virtual Filename getSceneFilename(void);
+  virtual Filename getSharedFilename(void);
+  virtual LuxTextureCache* textureCache(void);
+  virtual VULONG bytesWritten(void);
 
   virtual Bool setComment(const char* text);
   virtual Bool setComment(const String& text);
@@ -116,25 +150,95 @@ public:
   virtual Bool portalShape(IdentifierName     type,
                            const LuxParamSet& paramSet);
 
+  virtual Bool findShard(ULONG      dirtyChecksum,
+                         LuxString& name,
+                         ULONG&     checksum);
+  virtual Bool isShardCurrent(IdentifierName   name,
+                              ULONG            checksum,
+                              const LuxMatrix& matrix);
+  virtual Bool shardBegin(IdentifierName   name,
+                          ULONG            checksum,
+                          ULONG            dirtyChecksum,
+                          const LuxMatrix& matrix,
+                          IdentifierName   material,
+                          Bool&            reused);
+  virtual Bool shardEnd(void);
+
 
 private:
 
-  typedef const char* SettingNameT;
-
-  Bool                mFilesOpen;
-  Filename            mSceneFilename;
-  FilePath            mSceneFileDirectory;
-  Bool                mUseRelativePaths;
-  Bool                mResume;
-  AutoAlloc<BaseFile> mSceneFile;
-  Filename            mMaterialsFilename;
-  AutoAlloc<BaseFile> mMaterialsFile;
-  Filename            mObjectsFilename;
-  AutoAlloc<BaseFile> mObjectsFile;
-  Bool                mWorldStarted;
-  LONG                mErrorStringID;
-  CHAR                mComment[2048];
-  ULONG               mCommentLen;
+  /// Helper structure which stores the manifest entry of a single shard.
+  struct Shard {
+    LuxString mName;
+    ULONG     mChecksum;
+    ULONG     mDirtyChecksum;
+    LuxMatrix mMatrix;
+    LuxString mMaterial;
+    Bool      mWritten;
+  };
+
+  typedef const char*                           SettingNameT;
+  typedef DynArray1D<Shard*>                    ShardsT;
+  typedef RBTreeMap<LuxString, SizeT, NodePool> ShardIndicesT;
+  typedef RBTreeMap<ULONG, SizeT, NodePool>     ShardDirtyIndicesT;
+
+  Bool                 mFilesOpen;
+  Filename             mSharedFilename;
+  Filename             mSceneFilename;
+  FilePath             mSceneFileDirectory;
+  Bool                 mUseRelativePaths;
+  Bool                 mResume;
+  AutoAlloc<BaseFile>  mSceneFile;
+  Bool                 mSceneCreated;
+  Filename             mMaterialsFilename;
+  AutoAlloc<BaseFile>  mMaterialsFile;
+  Bool                 mMaterialsCreated;
+  Bool                 mSequence;
+  Filename             mObjectsFilename;
+  AutoAlloc<BaseFile>  mObjectsFile;
+  BaseFile*            mObjectsOut;
+  Filename             mManifestFilename;
+  Filename             mShardDirectory;
+  String               mShardDirectoryName;
+  AutoAlloc<BaseFile>  mShardFile;
+  Shard*               mOpenShard;
+  ShardsT              mOldShards;
+  ShardIndicesT        mOldShardIndices;
+  ShardDirtyIndicesT   mOldShardDirtyIndices;
+  ShardsT              mShards;
+  ShardIndicesT        mShardIndices;
+  LuxAPIWriter*        mSequenceWriter;
+  AutoAlloc<Semaphore> mShardLock;
+  VULONG               mClosedBytes;
+  Bool                 mWorldStarted;
+  LONG                 mErrorStringID;
+  CHAR                 mComment[2048];
+  ULONG                mCommentLen;
+  LuxTextureCache      mTextureCache;
+
+  inline LuxAPIWriter& shardRegistry(void);
+  void lockShards(void);
+  void unlockShards(void);
+  Bool isRegisteredShardCurrent(IdentifierName   name,
+                                ULONG            checksum,
+                                const LuxMatrix& matrix);
+  Bool registerShard(IdentifierName   name,
+                     ULONG            checksum,
+                     ULONG            dirtyChecksum,
+                     const LuxMatrix& matrix,
+                     IdentifierName   material,
+                     Shard*&          shard,
+                     Bool&            reused);
+  Bool readManifest(void);
+  Bool writeManifest(void);
+  void deleteUnusedShards(void);
+  Bool includeShard(const LuxString& name);
+  Filename shardPath(const LuxString& name);
+  void freeOldShards(void);
+  static void freeShards(ShardsT&       shards,
+                         ShardIndicesT& indices);
+  static bool isShardNameLess(const Shard* shard1,
+                              const Shard* shard2);
 
   void writeComment(BaseFile& file);
   Bool writeLine(BaseFile&   file,
@@ -160,5 +264,21 @@ inline LONG LuxAPIWriter::errorStringID(void) const
 }
 
 
+/// Returns TRUE if the shard registry of this writer can be locked, i.e. if
+/// frame writers may be used in parallel with this writer as sequence.
+inline Bool LuxAPIWriter::hasShardLock(void)
+{
+  return (mShardLock != 0);
+}
+
+
+/// Returns the writer that owns the shard registry, i.e. the sequence writer
+/// for a frame writer and this writer otherwise.
+inline LuxAPIWriter& LuxAPIWriter::shardRegistry(void)
+{
+  return mSequenceWriter ? *mSequenceWriter : *this;
+}
+
+
 
 #endif  // #ifndef __LUXAPIWRITER_H__
@@ -23,11 +23,17 @@
  * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
  ************************************************************************/
 
+#include <cstdio>
+
 #include "filepath.h"
+#include "fixarray1d.h"
 #include "luxapi.h"
 #include "luxapiconverter.h"
 #include "luxapiwriter.h"
 #include "luxc4dexporter.h"
+#include "luxc4dpreferences.h"
+#include "luxexportprogress.h"
+#include "luxprofiler.h"
 #include "utilities.h"
 
 
@@ -36,6 +42,10 @@
  * Implementation of public member functions of class LuxC4DExporter.
  *****************************************************************************/
 
+// the running export or NULL if there is none
+LuxC4DExporter::ExportThread* LuxC4DExporter::sExportThread = 0;
+
+
 /// Registers this plugin instance in CINEMA 4D.
 ///
 /// @return
@@ -64,6 +74,54 @@ Bool LuxC4DExporter::Execute(BaseDocument* document)
 }
 
 
+/// Updates the status bar with the progress of the running export and cancels
+/// it, if the user presses ESC. When the export thread has finished, the
+/// export gets finished. Must be called from the main thread.
+void LuxC4DExporter::updateExport(void)
+{
+  if (!sExportThread)  return;
+
+  // the export thread has finished -> finish the export
+  if (!sExportThread->IsRunning()) {
+    ExportThread* thread = sExportThread;
+    sExportThread = 0;
+    thread->Wait(FALSE);
+    finishExport(thread);
+    return;
+  }
+
+  // check for cancellation and show the progress
+  BaseContainer state;
+  if (!sExportThread->mProgress.isCancelled() &&
+      GetInputState(BFM_INPUT_KEYBOARD, KEY_ESC, state) &&
+      state.GetLong(BFM_INPUT_VALUE))
+  {
+    sExportThread->mProgress.cancel();
+  }
+  String text;
+  LONG   percent;
+  sExportThread->mProgress.getStatus(text, percent);
+  StatusSetText(text);
+  StatusSetBar(percent);
+}
+
+
+/// Cancels the running export (if there is one), waits until its thread has
+/// stopped and removes the partially written files. This is called when
+/// CINEMA 4D shuts down.
+void LuxC4DExporter::abortExport(void)
+{
+  if (!sExportThread)  return;
+  ExportThread* thread = sExportThread;
+  sExportThread = 0;
+  thread->mProgress.cancel();
+  thread->Wait(FALSE);
+  thread->mWriter.discard();
+  if (thread->mTraceFile.Content())  LuxProfiler::stop(thread->mTraceFile);
+  gDelete(thread);
+}
+
+
 
 /*****************************************************************************
  * Implementation of protected member functions of class LuxC4DExporter.
@@ -84,6 +142,13 @@ Bool LuxC4DExporter::exportScene(BaseDocument* document,
   // check if document is valid
   if (!document)  ERRLOG_RETURN_VALUE(FALSE, "LuxC4DExporter::exportScene(): no document passed");
 
+  // only one export can run at a time, as exports share the texture cache and
+  // the profiler and could write the same files
+  if (sExportThread) {
+    GeOutString(GeLoadString(IDS_EXPORT_RUNNING), GEMB_OK);
+    return FALSE;
+  }
+
   // get LuxC4DSettings video post effect node - if available
   LuxC4DSettings* settingsNode = 0;
   RenderData*     renderData = document->GetActiveRenderData();
@@ -161,22 +226,563 @@ Bool LuxC4DExporter::exportScene(BaseDocument* document,
     }
   }
 
-  // initialise file writer
-  LuxAPIWriter apiWriter;
+  // create the export thread, which owns the file writer and the progress
+  // object, and initialise the file writer
+  ExportThread* exportThread = gNew ExportThread;
+  if (!exportThread) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxC4DExporter::exportScene(): could not allocate export thread");
+  }
+  LuxAPIWriter& apiWriter(exportThread->mWriter);
   Bool sceneFilesExist;
   if (!apiWriter.init(mExportedFile, useRelativePaths, resume, sceneFilesExist)) {
+    gDelete(exportThread);
     GeOutString(GeLoadString(IDS_ERROR_INITIALISE_LUXAPIWRITER, mExportedFile.GetString()), GEMB_OK);
     return FALSE;
   }
 
-  // create exporter and export scene
-  LuxAPIConverter converter;
-  if (!converter.convertScene(*document, apiWriter, resume, !sceneFilesExist)) {
-    LONG errorStringID = apiWriter.errorStringID();
+  // if enabled in the preferences, record a profile of the export, which is
+  // written next to the scene file as "<scene name>_profile.json"
+  if (gPreferences && gPreferences->writeProfile()) {
+    Filename traceFile(mExportedFile);
+    traceFile.ClearSuffix();
+    traceFile.SetFile(Filename(traceFile.GetFileString() + "_profile.json"));
+    if (LuxProfiler::start())  exportThread->mTraceFile = traceFile;
+  }
+
+  // the dirty counts of the copy we export don't tell if a shader was changed,
+  // so the texture cache takes its shader checksums from the original
+  LuxTextureCache* textureCache = apiWriter.textureCache();
+  if (textureCache) {
+    textureCache->recordShaderChecksums(*document, LuxAPIConverter::sessionToken());
+  }
+
+  // the same goes for the objects, whose dirty checksums allow the converter
+  // to reuse the shards of unchanged objects without hashing their geometry
+  LuxAPIConverter::recordObjectChecksums(*document, exportThread->mObjectChecksums);
+
+  // export a copy of the document in a background thread and return - the
+  // export gets finished by updateExport(), when the thread is done; if the
+  // copy or the thread can't be created, we export the document ourselves
+  exportThread->mExporter        = this;
+  exportThread->mResume          = resume;
+  exportThread->mForceFullExport = !sceneFilesExist;
+  exportThread->mAnimation       = (!resume && settingsNode && settingsNode->exportAnimation());
+  exportThread->mDocument        = cloneDocument(*document);
+  if (exportThread->mDocument &&
+      exportThread->Start(THREADMODE_ASYNC, THREADPRIORITY_NORMAL))
+  {
+    sExportThread = exportThread;
+    return TRUE;
+  }
+  ERRLOG("LuxC4DExporter::exportScene(): could not start export thread -> exporting in main thread");
+  exportThread->mSuccess = exportDocument(*document, apiWriter, resume,
+                                          exportThread->mForceFullExport,
+                                          exportThread->mAnimation,
+                                          exportThread->mObjectChecksums,
+                                          exportThread->mProgress, 0,
+                                          exportThread->mErrorStringID);
+  return finishExport(exportThread);
+}
+
+
+/// Gets called in the main thread after an export has finished successfully
+/// and the exported files were closed. Derived classes can overwrite it to
+/// process the exported scene (mExportedFile).
+///
+/// @return
+///   TRUE if successfull, FALSE otherwise.
+Bool LuxC4DExporter::exportFinished(void)
+{
+  return TRUE;
+}
+
+
+/// Finishes an export after its thread has stopped: If the export failed or
+/// was cancelled, the partially written files are removed and the user gets
+/// notified. Otherwise the files are closed and exportFinished() of the
+/// exporter is called.
+///
+/// @param[in]  thread
+///   The stopped export thread, which gets deleted.
+/// @return
+///   TRUE if the export was successfull, FALSE otherwise.
+Bool LuxC4DExporter::finishExport(ExportThread* thread)
+{
+  StatusClear();
+  if (thread->mTraceFile.Content())  LuxProfiler::stop(thread->mTraceFile);
+
+  // if the export failed or was cancelled, remove the partially written files
+  Bool            success = thread->mSuccess;
+  Bool            cancelled = thread->mProgress.isCancelled();
+  LONG            errorStringID = thread->mErrorStringID;
+  LuxC4DExporter* exporter = thread->mExporter;
+  if (!success)  thread->mWriter.discard();
+  gDelete(thread);
+
+  if (!success) {
+    if (cancelled) {
+      StatusSetText(GeLoadString(IDS_EXPORT_CANCELLED));
+      return FALSE;
+    }
     if (errorStringID == 0) { errorStringID = IDS_ERROR_CONVERSION; }
     GeOutString(GeLoadString(errorStringID), GEMB_OK);
     return FALSE;
   }
 
+  return exporter->exportFinished();
+}
+
+
+/// Creates a copy of a document, which can be exported in another thread
+/// while the user continues to work with the original.
+///
+/// @param[in]  document
+///   The document to copy.
+/// @return
+///   The copy, which has to be freed by the caller, or NULL if it couldn't be
+///   created.
+BaseDocument* LuxC4DExporter::cloneDocument(BaseDocument& document)
+{
+#if _C4D_VERSION >= 120
+  BaseDocument* clone = (BaseDocument*)document.GetClone(COPYFLAGS_DOCUMENT, 0);
+#else
+  BaseDocument* clone = (BaseDocument*)document.GetClone(COPY_DOCUMENT, 0);
+#endif
+  if (clone) {
+    // relative paths (e.g. of the output image) are resolved via the document
+    clone->SetDocumentName(document.GetDocumentName());
+    clone->SetDocumentPath(document.GetDocumentPath());
+  }
+  return clone;
+}
+
+
+/// Exports a document into a writer. This is the part of the export which
+/// runs in the export thread.
+///
+/// @param[in]  document
+///   The document to export.
+/// @param[in]  apiWriter
+///   The file writer, which was already initialised with the scene file.
+/// @param[in]  resume
+///   If set to TRUE only the global scene data is exported that enabled
+///   resuming an FLM file.
+/// @param[in]  forceFullExport
+///   If set to TRUE the scene description is exported, even in resume mode.
+/// @param[in]  animation
+///   If set to TRUE the frame range of the render settings is exported.
+/// @param[in]  objectChecksums
+///   The object checksums recorded from the original document (see
+///   LuxAPIConverter::recordObjectChecksums()).
+/// @param[in]  progress
+///   The object the progress gets reported to and which is checked for
+///   cancellation.
+/// @param[in]  thread
+///   The thread we are running in or NULL, if we are in the main thread.
+/// @param[out]  errorStringID
+///   Will be set to the ID of the error message, if the export failed.
+/// @return
+///   TRUE if successfull, FALSE otherwise.
+Bool LuxC4DExporter::exportDocument(BaseDocument&                            document,
+                                    LuxAPIWriter&                            apiWriter,
+                                    Bool                                     resume,
+                                    Bool                                     forceFullExport,
+                                    Bool                                     animation,
+                                    const LuxAPIConverter::ObjectChecksumsT& objectChecksums,
+                                    LuxExportProgress&                       progress,
+                                    BaseThread*                              thread,
+                                    LONG&                                    errorStringID)
+{
+  LuxProfileScope profileScope("export", &apiWriter);
+
+  // make sure that the caches of the document were built
+  document.ExecutePasses(thread, TRUE, TRUE, TRUE, BUILDFLAGS_0);
+
+  // if the animation should be exported, export the frames instead
+  if (animation) {
+    return exportAnimation(document, apiWriter, progress, thread, errorStringID);
+  }
+
+  // create exporter and export scene
+  LuxAPIConverter converter;
+  converter.setProgress(&progress);
+  converter.setObjectChecksums(&objectChecksums);
+  if (!converter.convertScene(document, apiWriter, resume, forceFullExport)) {
+    errorStringID = apiWriter.errorStringID();
+    return FALSE;
+  }
+  return TRUE;
+}
+
+
+/// Exports the frame range of the render settings as a sequence of frame
+/// files "<scene name>_<frame>.lxs" next to the scene file. Each frame has its
+/// own materials file, but the frames share the geometry shards of the scene
+/// file, i.e. objects that are not deformed are written only once, while each
+/// frame contains the transformations of all objects and the shards of
+/// deformed objects. Afterwards mExportedFile is set to the first frame.
+///
+/// The first frame is exported from the document itself and processes the
+/// textures, which are then referenced by the other frames. The remaining
+/// frames are distributed over one worker thread per CPU, which evaluates its
+/// own copy of the document. As each frame file only depends on its frame,
+/// the result doesn't depend on the order in which the workers finish. If the
+/// export fails or gets cancelled, the finished frames are deleted again.
+///
+/// @param[in]  document
+///   The document, which will be exported.
+/// @param[in]  apiWriter
+///   The file writer, which was already initialised with the scene file.
+/// @param[in]  progress
+///   The object the progress gets reported to and which is checked for
+///   cancellation.
+/// @param[in]  thread
+///   The thread we are running in or NULL, if we are in the main thread.
+/// @param[out]  errorStringID
+///   Will be set to the ID of the error message, if the export failed.
+/// @return
+///   TRUE if successfull, FALSE otherwise.
+Bool LuxC4DExporter::exportAnimation(BaseDocument&      document,
+                                     LuxAPIWriter&      apiWriter,
+                                     LuxExportProgress& progress,
+                                     BaseThread*        thread,
+                                     LONG&              errorStringID)
+{
+  // determine the frame range
+  RenderData*    renderData = document.GetActiveRenderData();
+  BaseContainer* renderSettings = renderData ? renderData->GetDataInstance() : 0;
+  if (!renderSettings) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxC4DExporter::exportAnimation(): could not obtain render settings");
+  }
+  LONG fps = document.GetFps();
+  LONG firstFrame = renderSettings->GetTime(RDATA_FRAMEFROM).GetFrame(fps);
+  LONG lastFrame = renderSettings->GetTime(RDATA_FRAMETO).GetFrame(fps);
+  LONG frameStep = renderSettings->GetLong(RDATA_FRAMESTEP);
+  if (frameStep < 1)  frameStep = 1;
+  if (lastFrame < firstFrame)  lastFrame = firstFrame;
+  LONG frameCount = (lastFrame - firstFrame) / frameStep + 1;
+  FixArray1D<Bool> framesDone;
+  if (!framesDone.init(frameCount)) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxC4DExporter::exportAnimation(): not enough memory to allocate frame list");
+  }
+  framesDone.fill(FALSE);
+
+  // export the first frame, which also processes the textures
+  BaseTime        originalTime(document.GetTime());
+  Filename        firstFrameFile(frameFilename(firstFrame));
+  LuxAPIConverter converter;
+  converter.setProgress(&progress);
+  Bool            success;
+  {
+    LuxProfileScope profileScope("frame", &apiWriter);
+    document.SetTime(BaseTime(firstFrame, fps));
+    document.ExecutePasses(thread, TRUE, TRUE, TRUE, BUILDFLAGS_0);
+    success = apiWriter.setFrame(firstFrameFile) &&
+              converter.convertScene(document, apiWriter, FALSE, TRUE, TRUE);
+  }
+  if (success) {
+    framesDone[0] = TRUE;
+    success = progress.startPhase(LuxExportProgress::PHASE_FRAMES, frameCount) &&
+              progress.step(LuxExportProgress::PHASE_FRAMES);
+  } else {
+    errorStringID = apiWriter.errorStringID();
+  }
+
+  // determine number of worker threads for the remaining frames - if the
+  // shard registry can't be locked, we export them ourselves
+  LONG threadCount = apiWriter.hasShardLock() ? GeGetCPUCount() : 0;
+  if (threadCount > frameCount - 1)  threadCount = frameCount - 1;
+  if (success && (frameCount > 1) && (threadCount < 1)) {
+    success = exportFrameRange(document, apiWriter, firstFrame, frameStep,
+                               frameCount, 1, 1, progress, framesDone, thread,
+                               errorStringID);
+  } else if (success && (frameCount > 1)) {
+    // start workers - each one gets its own copy of the document, if a copy
+    // can't be created or the thread can't be started, its frames will be
+    // exported by us after the other threads were started
+    FixArray1D<FrameWorker> workers;
+    FixArray1D<Bool>        started;
+    if (!workers.init(threadCount) || !started.init(threadCount)) {
+      ERRLOG("LuxC4DExporter::exportAnimation(): not enough memory to allocate worker threads");
+      success = FALSE;
+    } else {
+      for (LONG t=0; t<threadCount; ++t) {
+        FrameWorker& worker = workers[t];
+        worker.mExporter   = this;
+        worker.mSequence   = &apiWriter;
+        worker.mProgress   = &progress;
+        worker.mFramesDone = &framesDone;
+        worker.mFirstFrame = firstFrame;
+        worker.mFrameStep  = frameStep;
+        worker.mFrameCount = frameCount;
+        worker.mFirst      = t + 1;
+        worker.mStride     = threadCount;
+        worker.mDocument   = cloneDocument(document);
+        started[t] = worker.mDocument &&
+                     worker.Start(THREADMODE_ASYNC, THREADPRIORITY_BELOW);
+      }
+      for (LONG t=0; t<threadCount; ++t) {
+        if (!started[t] && success) {
+          success = exportFrameRange(document, apiWriter, firstFrame, frameStep,
+                                     frameCount, t+1, threadCount, progress,
+                                     framesDone, thread, errorStringID);
+        }
+      }
+
+      // wait for all workers
+      for (LONG t=0; t<threadCount; ++t) {
+        if (!started[t])  continue;
+        workers[t].Wait(FALSE);
+        if (!workers[t].mSuccess && success) {
+          success       = FALSE;
+          errorStringID = workers[t].mErrorStringID;
+        }
+      }
+    }
+  }
+
+  // finish the sequence or remove the frames that were finished before the
+  // export failed (the shared files are removed by LuxAPIWriter::discard())
+  if (success) {
+    success = apiWriter.endSequence();
+  } else {
+    for (LONG i=0; i<frameCount; ++i) {
+      if (!framesDone[i])  continue;
+      Filename frameFile(frameFilename(firstFrame + i * frameStep));
+      GeFKill(frameFile);
+      frameFile.SetSuffix("lxm");
+      GeFKill(frameFile);
+      frameFile.SetSuffix("lxo");
+      GeFKill(frameFile);
+    }
+  }
+
+  // restore the document state
+  document.SetTime(originalTime);
+  document.ExecutePasses(thread, TRUE, TRUE, TRUE, BUILDFLAGS_0);
+
+  if (!success) {
+    if (errorStringID == 0) { errorStringID = apiWriter.errorStringID(); }
+    return FALSE;
+  }
+  mExportedFile = firstFrameFile;
+  return TRUE;
+}
+
+
+/// Exports every stride-th frame of an animation, starting with frame index
+/// first. Each frame is written by its own frame writer, which shares the
+/// shards and processed textures with the writer of the sequence. If a frame
+/// can't be exported, its files are removed again.
+///
+/// @param[in]  document
+///   The document to evaluate and export. It must not be accessed by any other
+///   thread at the same time.
+/// @param[in]  sequence
+///   The writer of the sequence, which has exported the first frame already.
+/// @param[in]  firstFrame
+///   The first frame of the animation.
+/// @param[in]  frameStep
+///   The number of frames between two exported frames.
+/// @param[in]  frameCount
+///   The number of frames that get exported.
+/// @param[in]  first
+///   The index of the first frame to export.
+/// @param[in]  stride
+///   The step between the indices of the frames to export.
+/// @param[in]  progress
+///   The object the progress gets reported to and which is checked for
+///   cancellation.
+/// @param[out]  framesDone
+///   The entries of the exported frames will be set to TRUE.
+/// @param[in]  thread
+///   The thread we are running in or NULL, if we are in the main thread.
+/// @param[out]  errorStringID
+///   Will be set to the ID of the error message, if the export failed.
+/// @return
+///   TRUE if successfull, FALSE otherwise.
+Bool LuxC4DExporter::exportFrameRange(BaseDocument&      document,
+                                      LuxAPIWriter&      sequence,
+                                      LONG               firstFrame,
+                                      LONG               frameStep,
+                                      LONG               frameCount,
+                                      LONG               first,
+                                      LONG               stride,
+                                      LuxExportProgress& progress,
+                                      FixArray1D<Bool>&  framesDone,
+                                      BaseThread*        thread,
+                                      LONG&              errorStringID)
+{
+  LONG fps = document.GetFps();
+  for (LONG i=first; i<frameCount; i+=stride) {
+    if ((thread && thread->TestBreak()) || progress.isCancelled())  return FALSE;
+    // evaluate the document at the frame
+    LuxAPIWriter    frameWriter;
+    LuxProfileScope profileScope("frame", &frameWriter);
+    LONG frame = firstFrame + i * frameStep;
+    document.SetTime(BaseTime(frame, fps));
+    document.ExecutePasses(thread, TRUE, TRUE, TRUE, BUILDFLAGS_0);
+    // export the frame into its own scene file
+    LuxAPIConverter converter;
+    converter.setProgress(&progress);
+    if (!frameWriter.initFrame(sequence, frameFilename(frame)) ||
+        !converter.convertScene(document, frameWriter, FALSE, TRUE, TRUE))
+    {
+      errorStringID = frameWriter.errorStringID();
+      frameWriter.discard();
+      return FALSE;
+    }
+    framesDone[i] = TRUE;
+    progress.step(LuxExportProgress::PHASE_FRAMES);
+  }
+  return TRUE;
+}
+
+
+/// Returns the scene file name of a frame of an animation export, i.e.
+/// "<scene name>_<frame>.lxs" next to the exported scene file.
+Filename LuxC4DExporter::frameFilename(LONG frame)
+{
+  Filename sceneName(mExportedFile.GetFile());
+  sceneName.ClearSuffix();
+  CHAR frameNumber[32];
+  sprintf(frameNumber, "_%04d", (int)frame);
+  Filename frameFile(mExportedFile);
+  frameFile.SetFile(Filename(sceneName.GetString() + frameNumber));
+  frameFile.SetSuffix("lxs");
+  return frameFile;
+}
+
+
+
+/*****************************************************************************
+ * Implementation of class LuxC4DExporter::FrameWorker.
+ *****************************************************************************/
+
+/// Constructs a worker without any frames to export.
+LuxC4DExporter::FrameWorker::FrameWorker(void)
+: mExporter(0),
+  mDocument(0),
+  mSequence(0),
+  mProgress(0),
+  mFramesDone(0),
+  mFirstFrame(0),
+  mFrameStep(1),
+  mFrameCount(0),
+  mFirst(0),
+  mStride(1),
+  mSuccess(FALSE),
+  mErrorStringID(0)
+{}
+
+
+/// Destroys the worker and the document copy it owns.
+LuxC4DExporter::FrameWorker::~FrameWorker(void)
+{
+  if (mDocument)  BaseDocument::Free(mDocument);
+}
+
+
+/// Thread main function, which exports the frames assigned to this worker.
+void LuxC4DExporter::FrameWorker::Main(void)
+{
+  if (mExporter && mDocument && mSequence && mProgress && mFramesDone) {
+    mSuccess = mExporter->exportFrameRange(*mDocument, *mSequence,
+                                           mFirstFrame, mFrameStep, mFrameCount,
+                                           mFirst, mStride, *mProgress,
+                                           *mFramesDone, Get(), mErrorStringID);
+  }
+}
+
+
+/// Returns the name of the worker thread.
+const CHAR* LuxC4DExporter::FrameWorker::GetThreadName(void)
+{
+  return "LuxC4D frame exporter";
+}
+
+
+
+/*****************************************************************************
+ * Implementation of class LuxC4DExporter::ExportThread.
+ *****************************************************************************/
+
+/// Constructs an export thread without a document to export.
+LuxC4DExporter::ExportThread::ExportThread(void)
+: mExporter(0),
+  mDocument(0),
+  mResume(FALSE),
+  mForceFullExport(FALSE),
+  mAnimation(FALSE),
+  mSuccess(FALSE),
+  mErrorStringID(0)
+{}
+
+
+/// Destroys the thread and the document copy it owns.
+LuxC4DExporter::ExportThread::~ExportThread(void)
+{
+  if (mDocument)  BaseDocument::Free(mDocument);
+}
+
+
+/// Thread main function, which exports the document copy and then tells the
+/// main thread via LuxC4DExportMonitor that it has finished.
+void LuxC4DExporter::ExportThread::Main(void)
+{
+  if (mExporter && mDocument) {
+    mSuccess = mExporter->exportDocument(*mDocument, mWriter, mResume,
+                                         mForceFullExport, mAnimation,
+                                         mObjectChecksums, mProgress, Get(),
+                                         mErrorStringID);
+  }
+  SpecialEventAdd(PID_LUXC4D_EXPORT_MONITOR);
+}
+
+
+/// Returns the name of the export thread.
+const CHAR* LuxC4DExporter::ExportThread::GetThreadName(void)
+{
+  return "LuxC4D exporter";
+}
+
+
+
+/*****************************************************************************
+ * Implementation of member functions of class LuxC4DExportMonitor.
+ *****************************************************************************/
+
+/// Registers the export monitor in CINEMA 4D.
+///
+/// @return
+///   TRUE if successfull, otherwise FALSE.
+Bool LuxC4DExportMonitor::registerPlugin(void)
+{
+  LuxC4DExportMonitor* monitor = gNew LuxC4DExportMonitor;
+  if (!monitor)  ERRLOG_RETURN_VALUE(FALSE, "LuxC4DExportMonitor::registerPlugin(): could not allocate monitor");
+  return RegisterMessagePlugin(PID_LUXC4D_EXPORT_MONITOR,
+                               "LuxC4D export monitor",
+                               0,
+                               monitor);
+}
+
+
+/// Returns the interval (in milliseconds) in which CoreMessage() gets called
+/// with MSG_TIMER, i.e. the status bar gets updated about 10 times per second.
+LONG LuxC4DExportMonitor::GetTimer(void)
+{
+  return 100;
+}
+
+
+/// Gets called in the main thread by the timer and when the export thread has
+/// finished (via SpecialEventAdd()) and updates or finishes the running
+/// export.
+Bool LuxC4DExportMonitor::CoreMessage(LONG                 id,
+                                      const BaseContainer& bc)
+{
+  if ((id == MSG_TIMER) || (id == PID_LUXC4D_EXPORT_MONITOR)) {
+    LuxC4DExporter::updateExport();
+  }
   return TRUE;
 }
@@ -31,15 +31,27 @@
 #include <c4d.h>
 
 #include "c4d_symbols.h"
+#include "fixarray1d.h"
+#include "luxapiconverter.h"
+#include "luxapiwriter.h"
+#include "luxexportprogress.h"
 
 
 
-#define PID_LUXC4D_EXPORTER  1022831
+#define PID_LUXC4D_EXPORTER        1022831
+#define PID_LUXC4D_EXPORT_MONITOR  1025206
 
 
 
 /***************************************************************************//*!
  The CommandData plugin that triggers an export into a .lxs file.
+
+ The export itself runs in a background thread on a copy of the document and
+ Execute() returns as soon as the thread was started, so the user can continue
+ to work. LuxC4DExportMonitor calls updateExport() in the main thread, which
+ shows the progress in the status bar and finishes the export when the thread
+ is done. If the user presses ESC, the export is cancelled and the partially
+ written files are removed. Only one export can run at a time.
 *//****************************************************************************/
 class LuxC4DExporter : public CommandData
 {
@@ -48,13 +60,119 @@ public:
   Bool registerPlugin(void);
   virtual Bool Execute(BaseDocument* document);
 
+  static void updateExport(void);
+  static void abortExport(void);
+
 
 protected:
 
+  /// Worker thread that exports every mStride-th frame of an animation,
+  /// starting with frame index mFirst, from its own copy of the document.
+  class FrameWorker : public C4DThread
+  {
+  public:
+
+    LuxC4DExporter*    mExporter;
+    BaseDocument*      mDocument;
+    LuxAPIWriter*      mSequence;
+    LuxExportProgress* mProgress;
+    FixArray1D<Bool>*  mFramesDone;
+    LONG               mFirstFrame;
+    LONG               mFrameStep;
+    LONG               mFrameCount;
+    LONG               mFirst;
+    LONG               mStride;
+    Bool               mSuccess;
+    LONG               mErrorStringID;
+
+    FrameWorker(void);
+    ~FrameWorker(void);
+
+    virtual void Main(void);
+    virtual const CHAR* GetThreadName(void);
+  };
+
+  /// Thread that exports a copy of the document in the background. It owns
+  /// the file writer and the progress object, which have to live until the
+  /// export was finished by the main thread.
+  class ExportThread : public C4DThread
+  {
+  public:
+
+    LuxC4DExporter*                   mExporter;
+    BaseDocument*                     mDocument;
+    LuxAPIConverter::ObjectChecksumsT mObjectChecksums;
+    LuxAPIWriter                      mWriter;
+    LuxExportProgress                 mProgress;
+    Filename                          mTraceFile;
+    Bool                              mResume;
+    Bool                              mForceFullExport;
+    Bool                              mAnimation;
+    Bool                              mSuccess;
+    LONG                              mErrorStringID;
+
+    ExportThread(void);
+    ~ExportThread(void);
+
+    virtual void Main(void);
+    virtual const CHAR* GetThreadName(void);
+  };
+
+  friend class FrameWorker;
+  friend class ExportThread;
+
+
+  static ExportThread* sExportThread;
+
   Filename mExportedFile;
 
   Bool exportScene(BaseDocument* document,
                    Bool          resumeOnly);
+  virtual Bool exportFinished(void);
+  static Bool finishExport(ExportThread* thread);
+  BaseDocument* cloneDocument(BaseDocument& document);
+  Bool exportDocument(BaseDocument&                            document,
+                      LuxAPIWriter&                            apiWriter,
+                      Bool                                     resume,
+                      Bool                                     forceFullExport,
+                      Bool                                     animation,
+                      const LuxAPIConverter::ObjectChecksumsT& objectChecksums,
+                      LuxExportProgress&                       progress,
+                      BaseThread*                              thread,
+                      LONG&                                    errorStringID);
+  Bool exportAnimation(BaseDocument&      document,
+                       LuxAPIWriter&      apiWriter,
+                       LuxExportProgress& progress,
+                       BaseThread*        thread,
+                       LONG&              errorStringID);
+  Bool exportFrameRange(BaseDocument&      document,
+                        LuxAPIWriter&      sequence,
+                        LONG               firstFrame,
+                        LONG               frameStep,
+                        LONG               frameCount,
+                        LONG               first,
+                        LONG               stride,
+                        LuxExportProgress& progress,
+                        FixArray1D<Bool>&  framesDone,
+                        BaseThread*        thread,
+                        LONG&              errorStringID);
+  Filename frameFilename(LONG frame);
+};
+
+
+
+/***************************************************************************//*!
+ The MessageData plugin that drives a running export from the main thread: it
+ calls LuxC4DExporter::updateExport() about 10 times per second and when the
+ export thread signals that it has finished.
+*//****************************************************************************/
+class LuxC4DExportMonitor : public MessageData
+{
+public:
+
+  static Bool registerPlugin(void);
+  virtual LONG GetTimer(void);
+  virtual Bool CoreMessage(LONG id, const BaseContainer& bc);
 };
 
 
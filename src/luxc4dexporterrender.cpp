@@ -68,6 +68,16 @@ Bool LuxC4DExporterRender::Execute(BaseDocument* document)
  * Implementation of protected member functions of class LuxC4DExporterRender.
  *****************************************************************************/
 
+/// Checks the path of the Lux executable and starts the export. Lux gets
+/// called by exportFinished(), when the export has finished.
+///
+/// @param[in]  document
+///   The current document, which will be exported.
+/// @param[in]  resumeOnly
+///   If set to TRUE only the global scene data is exported that enabled
+///   resuming an FLM file.
+/// @return
+///   TRUE if successfull, FALSE otherwise.
 Bool LuxC4DExporterRender::exportAndRender(BaseDocument* document,
                                            Bool          resumeOnly)
 {
@@ -93,16 +103,22 @@ Bool LuxC4DExporterRender::exportAndRender(BaseDocument* document,
     return FALSE;
   }
 
-  // export file
-  if (!exportScene(document, resumeOnly)) {
-    return FALSE;
-  }
+  // start the export
+  mLuxPath = luxPath;
+  return exportScene(document, resumeOnly);
+}
+
 
-  // call LuxRender
-  if (!executeProgram(luxPath, mExportedFile)) {
-    GeOutString(GeLoadString(IDS_ERROR_LUX_PATH_EXECUTE, luxPath.GetString()), GEMB_OK);
+/// Calls Lux to render the exported scene file, after the export has
+/// finished.
+///
+/// @return
+///   TRUE if successfull, FALSE otherwise.
+Bool LuxC4DExporterRender::exportFinished(void)
+{
+  if (!executeProgram(mLuxPath, mExportedFile)) {
+    GeOutString(GeLoadString(IDS_ERROR_LUX_PATH_EXECUTE, mLuxPath.GetString()), GEMB_OK);
     return FALSE;
   }
-
   return TRUE;
 }
@@ -39,7 +39,7 @@
 
 /***************************************************************************//*!
  The CommandData plugin that triggers an export into a .lxs file and then calls
- Lux to render it.
+ Lux to render it, once the export running in the background has finished.
 *//****************************************************************************/
 class LuxC4DExporterRender : public LuxC4DExporter
 {
@@ -51,8 +51,11 @@ public:
 
 protected:
 
+  Filename mLuxPath;
+
   Bool exportAndRender(BaseDocument* document,
                        Bool          resumeOnly);
+  virtual Bool exportFinished(void);
 };
 
 
@@ -23,8 +23,12 @@
  * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
  ************************************************************************/
 
+#include <cstdlib>
+
 #include <c4d.h>
 
+#include "geometrykernels.h"
+#include "luxapiconverter.h"
 #include "luxc4dcameratag.h"
 #include "luxc4dexporter.h"
 #include "luxc4dexporterrender.h"
@@ -51,6 +55,25 @@ Bool PluginStart(void)
     return FALSE;
   }
 
+  // initialise the debug log
+  if (!initLogging()) {
+    ERRLOG("Debug log could not be initialized.");
+  }
+
+  // select the SIMD kernels of the geometry conversion - they can be limited
+  // via the environment variable LUXC4D_SIMD_LEVEL (0 = scalar, 1 = SSE2,
+  // 2 = AVX2), e.g. to rule them out when diagnosing an export
+  GeometryKernels::InstructionSet maxInstructionSet = GeometryKernels::INSTRUCTIONS_AVX2;
+  const char* simdLevel = getenv("LUXC4D_SIMD_LEVEL");
+  if (simdLevel && *simdLevel) {
+    maxInstructionSet = (GeometryKernels::InstructionSet)atoi(simdLevel);
+  }
+  LOG_INFO("using %s geometry kernels",
+           GeometryKernels::instructionSetName(GeometryKernels::init(maxInstructionSet)));
+
+  // initialise the data shared by all scene conversions
+  LuxAPIConverter::initSession();
+
   // register LuxC4DPreferences
   gPreferences = gNew LuxC4DPreferences;
   if (!gPreferences) {
@@ -75,6 +98,12 @@ Bool PluginStart(void)
     return FALSE;
   }
 
+  // register LuxC4DExportMonitor, which drives the background exports
+  if (!LuxC4DExportMonitor::registerPlugin()) {
+    ERRLOG("Could not register LuxC4DExportMonitor plugin.");
+    return FALSE;
+  }
+
   // register LuxC4DExporterRender
   LuxC4DExporterRender* exporterRender = gNew LuxC4DExporterRender;
   if (!exporterRender) {
@@ -136,11 +165,20 @@ Bool PluginStart(void)
 /// Hook that is called during the shut down of CINEMA 4D. Here we can
 /// deallocate all resources, that are not owned by CINEMA 4D.
 void PluginEnd(void)
-{}
+{
+  freeLogging();
+}
 
 
 /// Hook that is called for different messages.
 Bool PluginMessage(LONG id, void *data)
 {
+  switch (id) {
+    // CINEMA 4D shuts down -> stop a running export before the plugins get
+    // freed
+    case C4DPL_ENDACTIVITY:
+      LuxC4DExporter::abortExport();
+      return TRUE;
+  }
   return FALSE;
 }
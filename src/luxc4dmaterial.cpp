@@ -61,6 +61,7 @@ Bool LuxC4DMaterial::Init(GeListNode* node)
 {
   // initialise update counter
   mUpdateCount = 0;
+  mBakeShaders = FALSE;
 
   // obtain container from node
   BaseContainer* data = getData();
@@ -427,7 +428,8 @@ LuxMaterialDataH LuxC4DMaterial::getLuxMaterialData(LuxTextureMappingH mapping,
                                                     LReal              c4d2LuxScale,
                                                     Real               colorGamma,
                                                     Real               textureGamma,
-                                                    Real               bumpSampleDistance)
+                                                    Real               bumpSampleDistance,
+                                                    Bool               bakeShaders)
 {
   // the metal types
   static const char* sMetalTypes[IDD_METAL_TYPE_NUMBER-1] = {
@@ -444,6 +446,9 @@ LuxMaterialDataH LuxC4DMaterial::getLuxMaterialData(LuxTextureMappingH mapping,
   BaseContainer* data = getData();
   if (!data) { return materialData; }
 
+  // remember if getTextureFromShader() should bake non-bitmap shaders
+  mBakeShaders = bakeShaders;
+
   // get material type and read corresponding channels
   LONG materialType = data->GetLong(IDD_MATERIAL_TYPE);
   switch (materialType) {
@@ -931,29 +936,23 @@ LuxTextureDataH LuxC4DMaterial::getTextureFromShader(BaseContainer&            d
                                                      LuxImageMapData::Channel  channel,
                                                      LuxImageMapData::WrapType wrapType) const
 {
-  // at the moment we support only the bitmap shader ...
-
   // get the link to the shader
   GeListNode* listNode = Get();
   if (!listNode) { return LuxTextureDataH(); }
   BaseDocument* doc = listNode->GetDocument();
   if (!doc) { return LuxTextureDataH(); }
-  BaseList2D* shaderLink = data.GetLink(shaderId, doc, Xbitmap);
+  BaseList2D* shaderLink = data.GetLink(shaderId, doc, Xbase);
   if (!shaderLink) { return LuxTextureDataH(); }
 
-  // now create an imagemap texture out of it
-  Filename bitmapPath = getParameterFilename(*shaderLink, BITMAPSHADER_FILENAME);
-  Filename fullBitmapPath;
-  GenerateTexturePath(doc->GetDocumentPath(),
-                      bitmapPath,
-                      Filename(),
-                      &fullBitmapPath);
-  return gNew LuxImageMapData(textureType,
-                              mapping,
-                              fullBitmapPath,
-                              textureGamma,
-                              channel,
-                              wrapType);
+  // now create an imagemap texture out of it (bitmap shaders are referenced
+  // directly, other shaders only if they get baked)
+  return LuxImageMapData::fromShader(*shaderLink,
+                                     mBakeShaders,
+                                     textureType,
+                                     mapping,
+                                     textureGamma,
+                                     channel,
+                                     wrapType);
 }
 
 
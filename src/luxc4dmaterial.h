@@ -75,12 +75,14 @@ public:
                                       LReal              c4d2LuxScale,
                                       Real               colorGamma,
                                       Real               textureGamma,
-                                      Real               bumpSampleDistance);
+                                      Real               bumpSampleDistance,
+                                      Bool               bakeShaders = FALSE);
 
 
 private:
 
   LONG mUpdateCount;
+  Bool mBakeShaders;
 
 
   BaseContainer* getData(void);
@@ -59,6 +59,9 @@ Bool LuxC4DPreferencesDialog::InitValues(void)
   SetFilename(IDD_LUXC4D_PREFS_LUX_PATH,
               &gPreferences->mSettings,
               IDV_LUXC4D_PREFS_LUX_PATH);
+  SetBool(IDD_LUXC4D_PREFS_PROFILE,
+          &gPreferences->mSettings,
+          IDV_LUXC4D_PREFS_PROFILE);
   return TRUE;
 }
 
@@ -93,6 +96,11 @@ Bool LuxC4DPreferencesDialog::Command(LONG                 id,
         }
       }
       break;
+    // store the profiling option in the preferences container
+    case IDD_LUXC4D_PREFS_PROFILE:
+      GetBool(id, &gPreferences->mSettings, IDV_LUXC4D_PREFS_PROFILE);
+      gPreferences->saveSettings();
+      break;
     //
     case IDB_LUXC4D_PREFS_OK:
       Close(TRUE);
@@ -177,3 +185,11 @@ Filename LuxC4DPreferences::getLuxPath(void)
 {
   return mSettings.GetFilename(IDV_LUXC4D_PREFS_LUX_PATH);
 }
+
+
+/// Returns TRUE if the exporter should write a profile of each export, which
+/// can be viewed in the trace viewer of Chrome.
+Bool LuxC4DPreferences::writeProfile(void)
+{
+  return mSettings.GetBool(IDV_LUXC4D_PREFS_PROFILE);
+}
@@ -77,6 +77,7 @@ public:
   void saveSettings(void);
 
   Filename getLuxPath(void);
+  Bool writeProfile(void);
 
 
 private:
@@ -216,7 +216,15 @@ Bool LuxC4DSettings::Init(GeListNode* node)
   data->SetReal(IDD_BUMP_SAMPLE_DISTANCE,        0.001);
   data->SetReal(IDD_TEXTURE_GAMMA_CORRECTION,    renderGamma);
   data->SetBool(IDD_USE_RELATIVE_PATHS,          TRUE);
+  data->SetBool(IDD_INCREMENTAL_EXPORT,          FALSE);
+  data->SetBool(IDD_EXPORT_ANIMATION,            FALSE);
   data->SetBool(IDD_DO_COLOUR_GAMMA_CORRECTION,  TRUE);
+  data->SetBool(IDD_PREPROCESS_TEXTURES,         FALSE);
+  data->SetLong(IDD_MAX_TEXTURE_RESOLUTION,      4096);
+  data->SetLong(IDD_TEXTURE_MEMORY_BUDGET,       0);
+  data->SetLong(IDD_MAX_ENVIRONMENT_RESOLUTION,  4096);
+  data->SetBool(IDD_BAKE_SHADERS,                FALSE);
+  data->SetLong(IDD_SHADER_BAKE_RESOLUTION,      1024);
 
 
   return TRUE;
@@ -335,6 +343,11 @@ Bool LuxC4DSettings::GetDDescription(GeListNode*     node,
   LONG exportFilenameMethod = data->GetLong(IDD_WHICH_EXPORT_FILENAME);
   showParameter(description, IDD_EXPORT_FILENAME,   params, exportFilenameMethod == IDD_DEFINE_EXPORT_FILENAME);
   showParameter(description, IDD_ALLOW_OVERWRITING, params, exportFilenameMethod != IDD_ASK_FOR_EXPORT_FILENAME);
+  showParameter(description, IDD_MAX_TEXTURE_RESOLUTION, params, data->GetBool(IDD_PREPROCESS_TEXTURES));
+  showParameter(description, IDD_TEXTURE_MEMORY_BUDGET, params, data->GetBool(IDD_PREPROCESS_TEXTURES));
+  showParameter(description, IDD_MAX_ENVIRONMENT_RESOLUTION, params, data->GetBool(IDD_PREPROCESS_TEXTURES));
+  showParameter(description, IDD_BAKE_SHADERS, params, data->GetBool(IDD_PREPROCESS_TEXTURES));
+  showParameter(description, IDD_SHADER_BAKE_RESOLUTION, params, data->GetBool(IDD_PREPROCESS_TEXTURES) && data->GetBool(IDD_BAKE_SHADERS));
 
   // set flag and return
   flags |= DESCFLAGS_DESC_LOADED;
@@ -432,9 +445,12 @@ Bool LuxC4DSettings::SetDParameter(GeListNode*    node,
 ///   Will receive the film name.
 /// @param[out]  paramSet
 ///   The set to which the parameters get added.
+/// @param[out]  buffer
+///   The buffer that stores the parameter values referenced by paramSet.
 void LuxC4DSettings::getFilm(Bool         resume,
                              const char*& name,
-                             LuxParamSet& paramSet)
+                             LuxParamSet& paramSet,
+                             ParamBuffer& buffer)
 {
   // the different film names
   static const char* sFilmNames[IDD_PIXEL_FILTER_NUMBER] = {
@@ -481,43 +497,37 @@ void LuxC4DSettings::getFilm(Bool         resume,
     };
 
   // parameters for fleximage
-  static Descr2Param<LuxInteger> sFleximageHaltSPP          (IDD_FLEXIMAGE_HALT_SPP,           "haltspp");
-  static Descr2Param<LuxFloat>   sFleximageGamma            (IDD_FLEXIMAGE_GAMMA,              "gamma");
-  static Descr2Param<LuxBool>    sFleximagePremultiply      (IDD_FLEXIMAGE_PREMULTIPLY,        "premultiplyalpha");
-  static Descr2Param<LuxInteger> sFleximageDisplayInterval  (IDD_FLEXIMAGE_DISPLAY_INTERVAL,   "displayinterval");
-  static Descr2Param<LuxInteger> sFleximageWriteInterval    (IDD_FLEXIMAGE_WRITE_INTERVAL,     "writeinterval");
-  static Descr2Param<LuxString>  sFleximageClampMethod      (IDD_FLEXIMAGE_CLAMP_METHOD,       "ldr_clamp_method");
-  static Descr2Param<LuxInteger> sFleximageRejectWarmup     (IDD_FLEXIMAGE_REJECT_WARMUP,      "reject_warmup");
-  static Descr2Param<LuxString>  sFleximageTonemapKernel    (IDD_FLEXIMAGE_TONEMAP_KERNEL,     "tonemapkernel");
-  static Descr2Param<LuxFloat>   sFleximageReinhardPrescale (IDD_FLEXIMAGE_REINHARD_PRESCALE,  "reinhard_prescale");
-  static Descr2Param<LuxFloat>   sFleximageReinhardPostscale(IDD_FLEXIMAGE_REINHARD_POSTSCALE, "reinhard_postscale");
-  static Descr2Param<LuxFloat>   sFleximageReinhardBurn     (IDD_FLEXIMAGE_REINHARD_BURN,      "reinhard_burn");
-  static Descr2Param<LuxFloat>   sFleximageLinearSensitivity(IDD_FLEXIMAGE_LINEAR_SENSITIVITY, "linear_sensitivity");
-  static Descr2Param<LuxFloat>   sFleximageLinearExposure   (IDD_FLEXIMAGE_LINEAR_EXPOSURE,    "linear_exposure");
-  static Descr2Param<LuxFloat>   sFleximageLinearFStop      (IDD_FLEXIMAGE_LINEAR_FSTOP,       "linear_fstop");
-  static Descr2Param<LuxFloat>   sFleximageLinearGamma      (IDD_FLEXIMAGE_LINEAR_GAMMA,       "linear_gamma");
-  static Descr2Param<LuxFloat>   sFleximageContrastYwa      (IDD_FLEXIMAGE_CONTRAST_YWA,       "contrast_ywa");
-  static Descr2Param<LuxBool>    sFleximageWriteEXR         (IDD_FLEXIMAGE_WRITE_EXR,          "write_exr");
-  static Descr2Param<LuxBool>    sFleximageWritePNG         (IDD_FLEXIMAGE_WRITE_PNG,          "write_png");
-  static Descr2Param<LuxBool>    sFleximageWriteTGA         (IDD_FLEXIMAGE_WRITE_TGA,          "write_tga");
-  static Descr2Param<LuxString>  sFleximageEXRChannels      (IDD_FLEXIMAGE_EXR_CHANNELS,       "write_exr_channels");
-  static Descr2Param<LuxBool>    sFleximageEXRHalftype      (IDD_FLEXIMAGE_EXR_HALFTYPE,       "write_exr_halftype");
-  static Descr2Param<LuxString>  sFleximageEXRCompression   (IDD_FLEXIMAGE_EXR_COMPRESSION,    "write_exr_compressiontype");
-  static Descr2Param<LuxBool>    sFleximageEXRApplyImaging  (IDD_FLEXIMAGE_EXR_APPLY_IMAGING,  "write_exr_applyimaging");
-  static Descr2Param<LuxBool>    sFleximageEXRGamutClamp    (IDD_FLEXIMAGE_EXR_GAMUT_CLAMP,    "write_exr_gamutclamp");
-  static Descr2Param<LuxBool>    sFleximageEXRWriteZBuf     (IDD_FLEXIMAGE_EXR_WRITE_ZBUF,     "write_exr_ZBuf");
-  static Descr2Param<LuxString>  sFleximageEXRZBufNormType  (IDD_FLEXIMAGE_EXR_ZBUF_NORM_TYPE, "write_exr_zbuf_normalizationtype");
-  static Descr2Param<LuxString>  sFleximagePNGChannels      (IDD_FLEXIMAGE_PNG_CHANNELS,       "write_png_channels");
-  static Descr2Param<LuxBool>    sFleximagePNG16Bit         (IDD_FLEXIMAGE_PNG_16BIT,          "write_png_16bit");
-  static Descr2Param<LuxBool>    sFleximagePNGGamutClamp    (IDD_FLEXIMAGE_PNG_GAMUT_CLAMP,    "write_png_gamutclamp");
-  static Descr2Param<LuxString>  sFleximageTGAChannels      (IDD_FLEXIMAGE_TGA_CHANNELS,       "write_tga_channels");
-  static Descr2Param<LuxBool>    sFleximageTGAGamutClamp    (IDD_FLEXIMAGE_TGA_GAMUT_CLAMP,    "write_tga_gamutclamp");
-  static LuxBool                 sFleximageWriteFLM;
-  static LuxBool                 sFleximageRestartFLM;
-  static LuxFloat                sFleximageColorspaceRed[2];
-  static LuxFloat                sFleximageColorspaceGreen[2];
-  static LuxFloat                sFleximageColorspaceBlue[2];
-  static LuxFloat                sFleximageWhitePoint[2];
+  static const Descr2Param<LuxInteger> sFleximageHaltSPP          = { IDD_FLEXIMAGE_HALT_SPP,           "haltspp" };
+  static const Descr2Param<LuxFloat>   sFleximageGamma            = { IDD_FLEXIMAGE_GAMMA,              "gamma" };
+  static const Descr2Param<LuxBool>    sFleximagePremultiply      = { IDD_FLEXIMAGE_PREMULTIPLY,        "premultiplyalpha" };
+  static const Descr2Param<LuxInteger> sFleximageDisplayInterval  = { IDD_FLEXIMAGE_DISPLAY_INTERVAL,   "displayinterval" };
+  static const Descr2Param<LuxInteger> sFleximageWriteInterval    = { IDD_FLEXIMAGE_WRITE_INTERVAL,     "writeinterval" };
+  static const Descr2Param<LuxString>  sFleximageClampMethod      = { IDD_FLEXIMAGE_CLAMP_METHOD,       "ldr_clamp_method" };
+  static const Descr2Param<LuxInteger> sFleximageRejectWarmup     = { IDD_FLEXIMAGE_REJECT_WARMUP,      "reject_warmup" };
+  static const Descr2Param<LuxString>  sFleximageTonemapKernel    = { IDD_FLEXIMAGE_TONEMAP_KERNEL,     "tonemapkernel" };
+  static const Descr2Param<LuxFloat>   sFleximageReinhardPrescale = { IDD_FLEXIMAGE_REINHARD_PRESCALE,  "reinhard_prescale" };
+  static const Descr2Param<LuxFloat>   sFleximageReinhardPostscale= { IDD_FLEXIMAGE_REINHARD_POSTSCALE, "reinhard_postscale" };
+  static const Descr2Param<LuxFloat>   sFleximageReinhardBurn     = { IDD_FLEXIMAGE_REINHARD_BURN,      "reinhard_burn" };
+  static const Descr2Param<LuxFloat>   sFleximageLinearSensitivity= { IDD_FLEXIMAGE_LINEAR_SENSITIVITY, "linear_sensitivity" };
+  static const Descr2Param<LuxFloat>   sFleximageLinearExposure   = { IDD_FLEXIMAGE_LINEAR_EXPOSURE,    "linear_exposure" };
+  static const Descr2Param<LuxFloat>   sFleximageLinearFStop      = { IDD_FLEXIMAGE_LINEAR_FSTOP,       "linear_fstop" };
+  static const Descr2Param<LuxFloat>   sFleximageLinearGamma      = { IDD_FLEXIMAGE_LINEAR_GAMMA,       "linear_gamma" };
+  static const Descr2Param<LuxFloat>   sFleximageContrastYwa      = { IDD_FLEXIMAGE_CONTRAST_YWA,       "contrast_ywa" };
+  static const Descr2Param<LuxBool>    sFleximageWriteEXR         = { IDD_FLEXIMAGE_WRITE_EXR,          "write_exr" };
+  static const Descr2Param<LuxBool>    sFleximageWritePNG         = { IDD_FLEXIMAGE_WRITE_PNG,          "write_png" };
+  static const Descr2Param<LuxBool>    sFleximageWriteTGA         = { IDD_FLEXIMAGE_WRITE_TGA,          "write_tga" };
+  static const Descr2Param<LuxString>  sFleximageEXRChannels      = { IDD_FLEXIMAGE_EXR_CHANNELS,       "write_exr_channels" };
+  static const Descr2Param<LuxBool>    sFleximageEXRHalftype      = { IDD_FLEXIMAGE_EXR_HALFTYPE,       "write_exr_halftype" };
+  static const Descr2Param<LuxString>  sFleximageEXRCompression   = { IDD_FLEXIMAGE_EXR_COMPRESSION,    "write_exr_compressiontype" };
+  static const Descr2Param<LuxBool>    sFleximageEXRApplyImaging  = { IDD_FLEXIMAGE_EXR_APPLY_IMAGING,  "write_exr_applyimaging" };
+  static const Descr2Param<LuxBool>    sFleximageEXRGamutClamp    = { IDD_FLEXIMAGE_EXR_GAMUT_CLAMP,    "write_exr_gamutclamp" };
+  static const Descr2Param<LuxBool>    sFleximageEXRWriteZBuf     = { IDD_FLEXIMAGE_EXR_WRITE_ZBUF,     "write_exr_ZBuf" };
+  static const Descr2Param<LuxString>  sFleximageEXRZBufNormType  = { IDD_FLEXIMAGE_EXR_ZBUF_NORM_TYPE, "write_exr_zbuf_normalizationtype" };
+  static const Descr2Param<LuxString>  sFleximagePNGChannels      = { IDD_FLEXIMAGE_PNG_CHANNELS,       "write_png_channels" };
+  static const Descr2Param<LuxBool>    sFleximagePNG16Bit         = { IDD_FLEXIMAGE_PNG_16BIT,          "write_png_16bit" };
+  static const Descr2Param<LuxBool>    sFleximagePNGGamutClamp    = { IDD_FLEXIMAGE_PNG_GAMUT_CLAMP,    "write_png_gamutclamp" };
+  static const Descr2Param<LuxString>  sFleximageTGAChannels      = { IDD_FLEXIMAGE_TGA_CHANNELS,       "write_tga_channels" };
+  static const Descr2Param<LuxBool>    sFleximageTGAGamutClamp    = { IDD_FLEXIMAGE_TGA_GAMUT_CLAMP,    "write_tga_gamutclamp" };
 
   // set default sampler
   name = sFilmNames[IDD_FILM_FLEXIMAGE];
@@ -534,78 +544,73 @@ void LuxC4DSettings::getFilm(Bool         resume,
 
     // film fleximage
     case IDD_FILM_FLEXIMAGE:
-      copyParam(sFleximageHaltSPP,           paramSet);
-      copyParam(sFleximageGamma,             paramSet);
-      copyParam(sFleximagePremultiply,       paramSet);
-      copyParam(sFleximageDisplayInterval,   paramSet);
-      copyParam(sFleximageWriteInterval,     paramSet);
-      copyParam(sFleximageClampMethod,       paramSet, sClampMethods,   IDD_CLAMP_METHOD_NUMBER);
-      copyParam(sFleximageRejectWarmup,      paramSet);
-      copyParam(sFleximageTonemapKernel,     paramSet, sTonemapKernels, IDD_TONEMAP_KERNEL_NUMBER);
+      copyParam(sFleximageHaltSPP,           paramSet, buffer);
+      copyParam(sFleximageGamma,             paramSet, buffer);
+      copyParam(sFleximagePremultiply,       paramSet, buffer);
+      copyParam(sFleximageDisplayInterval,   paramSet, buffer);
+      copyParam(sFleximageWriteInterval,     paramSet, buffer);
+      copyParam(sFleximageClampMethod,       paramSet, buffer, sClampMethods,   IDD_CLAMP_METHOD_NUMBER);
+      copyParam(sFleximageRejectWarmup,      paramSet, buffer);
+      copyParam(sFleximageTonemapKernel,     paramSet, buffer, sTonemapKernels, IDD_TONEMAP_KERNEL_NUMBER);
       switch (data->GetLong(IDD_FLEXIMAGE_TONEMAP_KERNEL)) {
         case IDD_TONEMAP_KERNEL_REINHARD:
-          copyParam(sFleximageReinhardPrescale,  paramSet);
-          copyParam(sFleximageReinhardPostscale, paramSet);
-          copyParam(sFleximageReinhardBurn,      paramSet);
+          copyParam(sFleximageReinhardPrescale,  paramSet, buffer);
+          copyParam(sFleximageReinhardPostscale, paramSet, buffer);
+          copyParam(sFleximageReinhardBurn,      paramSet, buffer);
           break;
         case IDD_TONEMAP_KERNEL_LINEAR:
-          copyParam(sFleximageLinearSensitivity, paramSet);
-          copyParam(sFleximageLinearExposure,    paramSet, 0.001f);
-          copyParam(sFleximageLinearFStop,       paramSet);
-          copyParam(sFleximageLinearGamma,       paramSet);
+          copyParam(sFleximageLinearSensitivity, paramSet, buffer);
+          copyParam(sFleximageLinearExposure,    paramSet, buffer, 0.001f);
+          copyParam(sFleximageLinearFStop,       paramSet, buffer);
+          copyParam(sFleximageLinearGamma,       paramSet, buffer);
           break;
         case IDD_TONEMAP_KERNEL_CONTRAST:
-          copyParam(sFleximageContrastYwa,       paramSet);
+          copyParam(sFleximageContrastYwa,       paramSet, buffer);
           break;
       }
-      copyParam(sFleximageWriteEXR,          paramSet);
-      copyParam(sFleximageWritePNG,          paramSet);
-      copyParam(sFleximageWriteTGA,          paramSet);
+      copyParam(sFleximageWriteEXR,          paramSet, buffer);
+      copyParam(sFleximageWritePNG,          paramSet, buffer);
+      copyParam(sFleximageWriteTGA,          paramSet, buffer);
       if (data->GetBool(IDD_FLEXIMAGE_WRITE_EXR)) {
-        copyParam(sFleximageEXRChannels,       paramSet, sImageChannels,    IDD_WRITE_CHANNELS_NUMBER);
-        copyParam(sFleximageEXRHalftype,       paramSet);
-        copyParam(sFleximageEXRCompression,    paramSet, sCompressionTypes, IDD_EXR_COMPRESSION_NUMBER);
-        copyParam(sFleximageEXRApplyImaging,   paramSet);
-        copyParam(sFleximageEXRGamutClamp,     paramSet);
-        copyParam(sFleximageEXRWriteZBuf,      paramSet);
-        copyParam(sFleximageEXRZBufNormType,   paramSet, sZBufNormTypes,    IDD_ZBUF_NORM_TYPE_NUMBER);
+        copyParam(sFleximageEXRChannels,       paramSet, buffer, sImageChannels,    IDD_WRITE_CHANNELS_NUMBER);
+        copyParam(sFleximageEXRHalftype,       paramSet, buffer);
+        copyParam(sFleximageEXRCompression,    paramSet, buffer, sCompressionTypes, IDD_EXR_COMPRESSION_NUMBER);
+        copyParam(sFleximageEXRApplyImaging,   paramSet, buffer);
+        copyParam(sFleximageEXRGamutClamp,     paramSet, buffer);
+        copyParam(sFleximageEXRWriteZBuf,      paramSet, buffer);
+        copyParam(sFleximageEXRZBufNormType,   paramSet, buffer, sZBufNormTypes,    IDD_ZBUF_NORM_TYPE_NUMBER);
       }
       if (data->GetBool(IDD_FLEXIMAGE_WRITE_PNG)) {
-        copyParam(sFleximagePNGChannels,       paramSet, sImageChannels,    IDD_WRITE_CHANNELS_NUMBER);
-        copyParam(sFleximagePNG16Bit,          paramSet);
-        copyParam(sFleximagePNGGamutClamp,     paramSet);
+        copyParam(sFleximagePNGChannels,       paramSet, buffer, sImageChannels,    IDD_WRITE_CHANNELS_NUMBER);
+        copyParam(sFleximagePNG16Bit,          paramSet, buffer);
+        copyParam(sFleximagePNGGamutClamp,     paramSet, buffer);
       }
       if (data->GetBool(IDD_FLEXIMAGE_WRITE_TGA)) {
-        copyParam(sFleximageTGAChannels,       paramSet, sImageChannels,    IDD_WRITE_CHANNELS_NUMBER);
-        copyParam(sFleximageTGAGamutClamp,     paramSet);
+        copyParam(sFleximageTGAChannels,       paramSet, buffer, sImageChannels,    IDD_WRITE_CHANNELS_NUMBER);
+        copyParam(sFleximageTGAGamutClamp,     paramSet, buffer);
       }
 
-      if (resume) {
-        sFleximageWriteFLM   = TRUE;
-        sFleximageRestartFLM = FALSE;
-      } else if (data->GetBool(IDD_FLEXIMAGE_WRITE_FLM)) {
-        sFleximageWriteFLM   = TRUE;
-        sFleximageRestartFLM = TRUE;
-      } else {
-        sFleximageWriteFLM   = FALSE;
-        sFleximageRestartFLM = FALSE;
+      {
+        LuxBool writeFLM   = resume || data->GetBool(IDD_FLEXIMAGE_WRITE_FLM);
+        LuxBool restartFLM = !resume && data->GetBool(IDD_FLEXIMAGE_WRITE_FLM);
+        addParam(LUX_BOOL, "write_resume_flm",   buffer.addBool(writeFLM),   paramSet);
+        addParam(LUX_BOOL, "restart_resume_flm", buffer.addBool(restartFLM), paramSet);
+
+        LuxFloat colorspace[8] = {
+            data->GetReal(IDD_FLEXIMAGE_COLORSPACE_RED_X),
+            data->GetReal(IDD_FLEXIMAGE_COLORSPACE_RED_Y),
+            data->GetReal(IDD_FLEXIMAGE_COLORSPACE_GREEN_X),
+            data->GetReal(IDD_FLEXIMAGE_COLORSPACE_GREEN_Y),
+            data->GetReal(IDD_FLEXIMAGE_COLORSPACE_BLUE_X),
+            data->GetReal(IDD_FLEXIMAGE_COLORSPACE_BLUE_Y),
+            data->GetReal(IDD_FLEXIMAGE_WHITEPOINT_X),
+            data->GetReal(IDD_FLEXIMAGE_WHITEPOINT_Y)
+          };
+        addParam(LUX_FLOAT, "colorspace_red",   buffer.addFloats(colorspace,   2), paramSet, 2);
+        addParam(LUX_FLOAT, "colorspace_green", buffer.addFloats(colorspace+2, 2), paramSet, 2);
+        addParam(LUX_FLOAT, "colorspace_blue",  buffer.addFloats(colorspace+4, 2), paramSet, 2);
+        addParam(LUX_FLOAT, "colorspace_white", buffer.addFloats(colorspace+6, 2), paramSet, 2);
       }
-      paramSet.addParam(LUX_BOOL, "write_resume_flm",   &sFleximageWriteFLM);
-      paramSet.addParam(LUX_BOOL, "restart_resume_flm", &sFleximageRestartFLM);
-
-      sFleximageColorspaceRed[0]   = data->GetReal(IDD_FLEXIMAGE_COLORSPACE_RED_X);
-      sFleximageColorspaceRed[1]   = data->GetReal(IDD_FLEXIMAGE_COLORSPACE_RED_Y);
-      sFleximageColorspaceGreen[0] = data->GetReal(IDD_FLEXIMAGE_COLORSPACE_GREEN_X);
-      sFleximageColorspaceGreen[1] = data->GetReal(IDD_FLEXIMAGE_COLORSPACE_GREEN_Y);
-      sFleximageColorspaceBlue[0]  = data->GetReal(IDD_FLEXIMAGE_COLORSPACE_BLUE_X);
-      sFleximageColorspaceBlue[1]  = data->GetReal(IDD_FLEXIMAGE_COLORSPACE_BLUE_Y);
-      paramSet.addParam(LUX_FLOAT, "colorspace_red",   &sFleximageColorspaceRed,   2);
-      paramSet.addParam(LUX_FLOAT, "colorspace_green", &sFleximageColorspaceGreen, 2);
-      paramSet.addParam(LUX_FLOAT, "colorspace_blue",  &sFleximageColorspaceBlue,  2);
-
-      sFleximageWhitePoint[0] = data->GetReal(IDD_FLEXIMAGE_WHITEPOINT_X);
-      sFleximageWhitePoint[1] = data->GetReal(IDD_FLEXIMAGE_WHITEPOINT_Y);
-      paramSet.addParam(LUX_FLOAT, "colorspace_white", &sFleximageWhitePoint, 2);
 
       break;
 
@@ -638,8 +643,11 @@ LONG LuxC4DSettings::getOutputFilePathSettings(Filename& userDefined)
 ///   Will receive the film name.
 /// @param[out]  paramSet
 ///   The set to which the parameters get added.
+/// @param[out]  buffer
+///   The buffer that stores the parameter values referenced by paramSet.
 void LuxC4DSettings::getPixelFilter(const char*& name,
-                                    LuxParamSet& paramSet)
+                                    LuxParamSet& paramSet,
+                                    ParamBuffer& buffer)
 {
   // the different pixel filter names
   static const char* sPixelFilterNames[IDD_PIXEL_FILTER_NUMBER] = {
@@ -651,29 +659,29 @@ void LuxC4DSettings::getPixelFilter(const char*& name,
     };
 
   // parameters for box filter
-  static Descr2Param<LuxFloat> sBoxWidth (IDD_BOX_FILTER_WIDTH,  "xwidth");
-  static Descr2Param<LuxFloat> sBoxHeight(IDD_BOX_FILTER_HEIGHT, "ywidth");
+  static const Descr2Param<LuxFloat> sBoxWidth = { IDD_BOX_FILTER_WIDTH,  "xwidth" };
+  static const Descr2Param<LuxFloat> sBoxHeight= { IDD_BOX_FILTER_HEIGHT, "ywidth" };
 
   // parameters for Gaussian filter
-  static Descr2Param<LuxFloat> sGaussianWidth (IDD_GAUSSIAN_FILTER_WIDTH,  "xwidth");
-  static Descr2Param<LuxFloat> sGaussianHeight(IDD_GAUSSIAN_FILTER_HEIGHT, "ywidth");
-  static Descr2Param<LuxFloat> sGaussianAlpha (IDD_GAUSSIAN_FILTER_ALPHA,  "alpha");
+  static const Descr2Param<LuxFloat> sGaussianWidth = { IDD_GAUSSIAN_FILTER_WIDTH,  "xwidth" };
+  static const Descr2Param<LuxFloat> sGaussianHeight= { IDD_GAUSSIAN_FILTER_HEIGHT, "ywidth" };
+  static const Descr2Param<LuxFloat> sGaussianAlpha = { IDD_GAUSSIAN_FILTER_ALPHA,  "alpha" };
 
   // parameters for Mitchell filter
-  static Descr2Param<LuxFloat> sMitchellWidth      (IDD_MITCHELL_FILTER_WIDTH,  "xwidth");
-  static Descr2Param<LuxFloat> sMitchellHeight     (IDD_MITCHELL_FILTER_HEIGHT, "ywidth");
-  static Descr2Param<LuxFloat> sMitchellB          (IDD_MITCHELL_FILTER_B,      "B");
-  static Descr2Param<LuxFloat> sMitchellC          (IDD_MITCHELL_FILTER_C,      "C");
-  static Descr2Param<LuxBool>  sMitchellSuperSample(IDD_MITCHELL_SUPERSAMPLE,   "supersample");
+  static const Descr2Param<LuxFloat> sMitchellWidth      = { IDD_MITCHELL_FILTER_WIDTH,  "xwidth" };
+  static const Descr2Param<LuxFloat> sMitchellHeight     = { IDD_MITCHELL_FILTER_HEIGHT, "ywidth" };
+  static const Descr2Param<LuxFloat> sMitchellB          = { IDD_MITCHELL_FILTER_B,      "B" };
+  static const Descr2Param<LuxFloat> sMitchellC          = { IDD_MITCHELL_FILTER_C,      "C" };
+  static const Descr2Param<LuxBool>  sMitchellSuperSample= { IDD_MITCHELL_SUPERSAMPLE,   "supersample" };
 
   // parameters for sinc filter
-  static Descr2Param<LuxFloat> sSincWidth (IDD_SINC_FILTER_WIDTH,  "xwidth");
-  static Descr2Param<LuxFloat> sSincHeight(IDD_SINC_FILTER_HEIGHT, "ywidth");
-  static Descr2Param<LuxFloat> sSincTau   (IDD_SINC_FILTER_TAU,    "tau");
+  static const Descr2Param<LuxFloat> sSincWidth = { IDD_SINC_FILTER_WIDTH,  "xwidth" };
+  static const Descr2Param<LuxFloat> sSincHeight= { IDD_SINC_FILTER_HEIGHT, "ywidth" };
+  static const Descr2Param<LuxFloat> sSincTau   = { IDD_SINC_FILTER_TAU,    "tau" };
 
   // parameters for triangle filter
-  static Descr2Param<LuxFloat> sTriangleWidth (IDD_TRIANGLE_FILTER_WIDTH,  "xwidth");
-  static Descr2Param<LuxFloat> sTriangleHeight(IDD_TRIANGLE_FILTER_HEIGHT, "ywidth");
+  static const Descr2Param<LuxFloat> sTriangleWidth = { IDD_TRIANGLE_FILTER_WIDTH,  "xwidth" };
+  static const Descr2Param<LuxFloat> sTriangleHeight= { IDD_TRIANGLE_FILTER_HEIGHT, "ywidth" };
 
 
   // set default sampler
@@ -690,33 +698,33 @@ void LuxC4DSettings::getPixelFilter(const char*& name,
   switch (pixelFilter) {
     // box filter 
     case IDD_PIXEL_FILTER_BOX:
-      copyParam(sBoxWidth,  paramSet);
-      copyParam(sBoxHeight, paramSet);
+      copyParam(sBoxWidth,  paramSet, buffer);
+      copyParam(sBoxHeight, paramSet, buffer);
       break;
     // Gaussian filter
     case IDD_PIXEL_FILTER_GAUSSIAN:
-      copyParam(sGaussianWidth,  paramSet);
-      copyParam(sGaussianHeight, paramSet);
-      copyParam(sGaussianAlpha,  paramSet);
+      copyParam(sGaussianWidth,  paramSet, buffer);
+      copyParam(sGaussianHeight, paramSet, buffer);
+      copyParam(sGaussianAlpha,  paramSet, buffer);
       break;
     // Mitchell filter
     case IDD_PIXEL_FILTER_MITCHELL:
-      copyParam(sMitchellWidth,       paramSet);
-      copyParam(sMitchellHeight,      paramSet);
-      copyParam(sMitchellB,           paramSet);
-      copyParam(sMitchellC,           paramSet);
-      copyParam(sMitchellSuperSample, paramSet);
+      copyParam(sMitchellWidth,       paramSet, buffer);
+      copyParam(sMitchellHeight,      paramSet, buffer);
+      copyParam(sMitchellB,           paramSet, buffer);
+      copyParam(sMitchellC,           paramSet, buffer);
+      copyParam(sMitchellSuperSample, paramSet, buffer);
       break;
     // sinc filter
     case IDD_PIXEL_FILTER_SINC:
-      copyParam(sSincWidth,  paramSet);
-      copyParam(sSincHeight, paramSet);
-      copyParam(sSincTau,    paramSet);
+      copyParam(sSincWidth,  paramSet, buffer);
+      copyParam(sSincHeight, paramSet, buffer);
+      copyParam(sSincTau,    paramSet, buffer);
       break;
     // triangle filter
     case IDD_PIXEL_FILTER_TRIANGLE:
-      copyParam(sTriangleWidth,  paramSet);
-      copyParam(sTriangleHeight, paramSet);
+      copyParam(sTriangleWidth,  paramSet, buffer);
+      copyParam(sTriangleHeight, paramSet, buffer);
       break;
     // invalid pixel filter -> error and return
     default:
@@ -734,12 +742,15 @@ void LuxC4DSettings::getPixelFilter(const char*& name,
 ///   Will receive the film name.
 /// @param[out]  paramSet
 ///   The set to which the parameters get added.
+/// @param[out]  buffer
+///   The buffer that stores the parameter values referenced by paramSet.
 /// @param[in]  xResolution
 ///   The horizontal resolution of the image to render.
 /// @param[in]  yResolution
 ///   The vertical resolution of the image to render.
 void LuxC4DSettings::getSampler(const char*& name,
                                 LuxParamSet& paramSet,
+                                ParamBuffer& buffer,
                                 LONG         xResolution,
                                 LONG         yResolution)
 {
@@ -762,24 +773,24 @@ void LuxC4DSettings::getSampler(const char*& name,
     };
 
   // parameters for lowdiscrepancy sampler
-  static Descr2Param<LuxString>  sLowdiscrepancyPixelSampler(IDD_LOWDISCREPANCY_PIXELSAMPLER, "pixelsampler");
-  static Descr2Param<LuxInteger> sLowdiscrepancyPixelSamples(IDD_LOWDISCREPANCY_PIXELSAMPLES, "pixelsamples");
+  static const Descr2Param<LuxString>  sLowdiscrepancyPixelSampler= { IDD_LOWDISCREPANCY_PIXELSAMPLER, "pixelsampler" };
+  static const Descr2Param<LuxInteger> sLowdiscrepancyPixelSamples= { IDD_LOWDISCREPANCY_PIXELSAMPLES, "pixelsamples" };
 
   // parameters for random sampler
-  static Descr2Param<LuxString>  sRandomPixelSampler(IDD_RANDOM_PIXELSAMPLER, "pixelsampler");
-  static Descr2Param<LuxInteger> sRandomPixelSamples(IDD_RANDOM_PIXELSAMPLES, "pixelsamples");
+  static const Descr2Param<LuxString>  sRandomPixelSampler= { IDD_RANDOM_PIXELSAMPLER, "pixelsampler" };
+  static const Descr2Param<LuxInteger> sRandomPixelSamples= { IDD_RANDOM_PIXELSAMPLES, "pixelsamples" };
 
   // parameters for metropolis sampler
-  static Descr2Param<LuxFloat>   sMetroLargeMutationProb(IDD_METROPOLIS_LARGE_MUTATION_PROB,  "largemutationprob");
-  static Descr2Param<LuxInteger> sMetroMaxConsecRejects (IDD_METROPOLIS_MAX_CONSEC_REJECTS,   "maxconsecrejects");
-  static Descr2Param<LuxBool>    sMetroUseVariance      (IDD_METROPOLIS_USE_VARIANCE,         "usevariance");
-  static Descr2Param<LuxFloat>   sMetroMutationRange    (IDD_METROPOLIS_MUTATION_RANGE_PIXEL, "mutationrange");
+  static const Descr2Param<LuxFloat>   sMetroLargeMutationProb= { IDD_METROPOLIS_LARGE_MUTATION_PROB,  "largemutationprob" };
+  static const Descr2Param<LuxInteger> sMetroMaxConsecRejects = { IDD_METROPOLIS_MAX_CONSEC_REJECTS,   "maxconsecrejects" };
+  static const Descr2Param<LuxBool>    sMetroUseVariance      = { IDD_METROPOLIS_USE_VARIANCE,         "usevariance" };
+  static const Descr2Param<LuxFloat>   sMetroMutationRange    = { IDD_METROPOLIS_MUTATION_RANGE_PIXEL, "mutationrange" };
 
   // parameters for ERPT sampler
-  static Descr2Param<LuxInteger> sERPTChainLength      (IDD_ERPT_CHAINLENGTH,          "chainlength");
-  static Descr2Param<LuxString>  sERPTPixelSampler     (IDD_ERPT_PIXELSAMPLER,         "pixelsampler");
-  static Descr2Param<LuxInteger> sERPTPixelSamples     (IDD_ERPT_PIXELSAMPLES,         "pixelsamples");
-  static Descr2Param<LuxFloat>   sERPTMutationRange    (IDD_ERPT_MUTATION_RANGE_PIXEL, "mutationrange");
+  static const Descr2Param<LuxInteger> sERPTChainLength      = { IDD_ERPT_CHAINLENGTH,          "chainlength" };
+  static const Descr2Param<LuxString>  sERPTPixelSampler     = { IDD_ERPT_PIXELSAMPLER,         "pixelsampler" };
+  static const Descr2Param<LuxInteger> sERPTPixelSamples     = { IDD_ERPT_PIXELSAMPLES,         "pixelsamples" };
+  static const Descr2Param<LuxFloat>   sERPTMutationRange    = { IDD_ERPT_MUTATION_RANGE_PIXEL, "mutationrange" };
 
 
   // set default sampler
@@ -796,39 +807,45 @@ void LuxC4DSettings::getSampler(const char*& name,
   switch (sampler) {
     // low discrepancy sampler
     case IDD_SAMPLER_LOWDISCREPANCY:
-      copyParam(sLowdiscrepancyPixelSampler, paramSet,
+      copyParam(sLowdiscrepancyPixelSampler, paramSet, buffer,
                 sPixelSamplerNames, IDD_PIXELSAMPLER_NUMBER);
-      copyParam(sLowdiscrepancyPixelSamples, paramSet);
+      copyParam(sLowdiscrepancyPixelSamples, paramSet, buffer);
       break;
     // random sampler
     case IDD_SAMPLER_RANDOM:
-      copyParam(sRandomPixelSampler, paramSet,
+      copyParam(sRandomPixelSampler, paramSet, buffer,
                 sPixelSamplerNames, IDD_PIXELSAMPLER_NUMBER);
-      copyParam(sRandomPixelSamples, paramSet);
+      copyParam(sRandomPixelSamples, paramSet, buffer);
       break;
     // metropolis sampler
     case IDD_SAMPLER_METROPOLIS:
-      copyParam(sMetroLargeMutationProb, paramSet);
+      copyParam(sMetroLargeMutationProb, paramSet, buffer);
       if (data->GetBool(IDD_ADVANCED_SAMPLER)) {
-        copyParam(sMetroMaxConsecRejects,  paramSet);
-        copyParam(sMetroUseVariance,       paramSet);
-        copyParam(sMetroMutationRange,     paramSet);
-        if (data->GetLong(IDD_METROPOLIS_MUTATION_RANGE_TYPE) == IDD_METROPOLIS_MUTATION_RANGE_AS_FRACTION) {
-          sMetroMutationRange.mParam = (Real)(xResolution + yResolution) /
-                                       (2.0 * data->GetReal(IDD_METROPOLIS_MUTATION_RANGE_FRACTION));
+        copyParam(sMetroMaxConsecRejects,  paramSet, buffer);
+        copyParam(sMetroUseVariance,       paramSet, buffer);
+        LuxFloat* mutationRange = copyParam(sMetroMutationRange, paramSet, buffer);
+        if (mutationRange &&
+            (data->GetLong(IDD_METROPOLIS_MUTATION_RANGE_TYPE) == IDD_METROPOLIS_MUTATION_RANGE_AS_FRACTION))
+        {
+          *mutationRange = (Real)(xResolution + yResolution) /
+                           (2.0 * data->GetReal(IDD_METROPOLIS_MUTATION_RANGE_FRACTION));
         }
       }
       break;
     // ERPT sampler
     case IDD_SAMPLER_ERPT:
-      copyParam(sERPTChainLength,   paramSet);
-      copyParam(sERPTPixelSampler,  paramSet,
-                sPixelSamplerNames, IDD_PIXELSAMPLER_NUMBER);
-      copyParam(sERPTPixelSamples,  paramSet);
-      copyParam(sERPTMutationRange, paramSet);
-      if (data->GetLong(IDD_ERPT_MUTATION_RANGE_TYPE) == IDD_ERPT_MUTATION_RANGE_AS_FRACTION) {
-        sERPTMutationRange.mParam = (Real)(xResolution + yResolution) /
-                                    (2.0 * data->GetReal(IDD_ERPT_MUTATION_RANGE_FRACTION));
+      {
+        copyParam(sERPTChainLength,   paramSet, buffer);
+        copyParam(sERPTPixelSampler,  paramSet, buffer,
+                  sPixelSamplerNames, IDD_PIXELSAMPLER_NUMBER);
+        copyParam(sERPTPixelSamples,  paramSet, buffer);
+        LuxFloat* mutationRange = copyParam(sERPTMutationRange, paramSet, buffer);
+        if (mutationRange &&
+            (data->GetLong(IDD_ERPT_MUTATION_RANGE_TYPE) == IDD_ERPT_MUTATION_RANGE_AS_FRACTION))
+        {
+          *mutationRange = (Real)(xResolution + yResolution) /
+                           (2.0 * data->GetReal(IDD_ERPT_MUTATION_RANGE_FRACTION));
+        }
       }
       break;
     // invalid sampler -> error and return
@@ -847,8 +864,11 @@ void LuxC4DSettings::getSampler(const char*& name,
 ///   Will receive the film name.
 /// @param[out]  paramSet
 ///   The set to which the parameters get added.
+/// @param[out]  buffer
+///   The buffer that stores the parameter values referenced by paramSet.
 void LuxC4DSettings::getSurfaceIntegrator(const char*& name,
                                           LuxParamSet& paramSet,
+                                          ParamBuffer& buffer,
                                           Bool&        isBidirectional)
 {
   // the different sampler names
@@ -874,37 +894,37 @@ void LuxC4DSettings::getSurfaceIntegrator(const char*& name,
     };
 
   // parameters for path integrator
-  static Descr2Param<LuxInteger> sPathMaxDepth           (IDD_PATH_MAX_DEPTH,             "maxdepth");
-  static Descr2Param<LuxString>  sPathDirectLightStrategy(IDD_PATH_DIRECT_LIGHT_STRATEGY, "strategy");
-  static Descr2Param<LuxString>  sPathRRStrategy         (IDD_PATH_RR_STRATEGY,           "rrstrategy");
-  static Descr2Param<LuxFloat>   sPathRRContinueProb     (IDD_PATH_RR_CONTINUE_PROB,      "rrcontinueprob");
-  static Descr2Param<LuxBool>    sPathIncludeEnvironment (IDD_PATH_INCLUDE_ENVIRONMENT,   "includeenvironment");
+  static const Descr2Param<LuxInteger> sPathMaxDepth           = { IDD_PATH_MAX_DEPTH,             "maxdepth" };
+  static const Descr2Param<LuxString>  sPathDirectLightStrategy= { IDD_PATH_DIRECT_LIGHT_STRATEGY, "strategy" };
+  static const Descr2Param<LuxString>  sPathRRStrategy         = { IDD_PATH_RR_STRATEGY,           "rrstrategy" };
+  static const Descr2Param<LuxFloat>   sPathRRContinueProb     = { IDD_PATH_RR_CONTINUE_PROB,      "rrcontinueprob" };
+  static const Descr2Param<LuxBool>    sPathIncludeEnvironment = { IDD_PATH_INCLUDE_ENVIRONMENT,   "includeenvironment" };
 
   // parameters for distributed path integrator
-  static Descr2Param<LuxString>  sDistriPathDirectLightStrategy       (IDD_DISTRIBUTED_PATH_DIRECT_LIGHT_STRATEGY,         "strategy");
-  static Descr2Param<LuxInteger> sDistriPathDirectDirectLightSamples  (IDD_DISTRIBUTED_PATH_DIRECT_DIRECT_LIGHT_SAMPLES,   "directsamples");
-  static Descr2Param<LuxInteger> sDistriPathInDirectDirectLightSamples(IDD_DISTRIBUTED_PATH_INDIRECT_DIRECT_LIGHT_SAMPLES, "indirectsamples");
-  static Descr2Param<LuxInteger> sDistriPathDiffuseReflectDepth       (IDD_DISTRIBUTED_PATH_DIFFUSE_REFLECT_DEPTH,         "diffusereflectdepth");
-  static Descr2Param<LuxInteger> sDistriPathDiffuseReflectSamples     (IDD_DISTRIBUTED_PATH_DIFFUSE_REFLECT_SAMPLES,       "diffusereflectsamples");
-  static Descr2Param<LuxInteger> sDistriPathDiffuseRefractDepth       (IDD_DISTRIBUTED_PATH_DIFFUSE_REFRACT_DEPTH,         "diffuserefractdepth");
-  static Descr2Param<LuxInteger> sDistriPathDiffuseRefractSamples     (IDD_DISTRIBUTED_PATH_DIFFUSE_REFRACT_SAMPLES,       "diffuserefractsamples");
-  static Descr2Param<LuxInteger> sDistriPathGlossyReflectDepth        (IDD_DISTRIBUTED_PATH_GLOSSY_REFLECT_DEPTH,          "glossyreflectdepth");
-  static Descr2Param<LuxInteger> sDistriPathGlossyReflectSamples      (IDD_DISTRIBUTED_PATH_GLOSSY_REFLECT_SAMPLES,        "glossyreflectsamples");
-  static Descr2Param<LuxInteger> sDistriPathGlossyRefractDepth        (IDD_DISTRIBUTED_PATH_GLOSSY_REFRACT_DEPTH,          "glossyrefractdepth");
-  static Descr2Param<LuxInteger> sDistriPathGlossyRefractSamples      (IDD_DISTRIBUTED_PATH_GLOSSY_REFRACT_SAMPLES,        "glossyrefractsamples");
-  static Descr2Param<LuxInteger> sDistriPathSpecularReflectDepth      (IDD_DISTRIBUTED_PATH_SPECULAR_REFLECT_DEPTH,        "specularreflectdepth");
-  static Descr2Param<LuxInteger> sDistriPathSpecularRefractDepth      (IDD_DISTRIBUTED_PATH_SPECULAR_REFRACT_DEPTH,        "specularrefractdepth");
+  static const Descr2Param<LuxString>  sDistriPathDirectLightStrategy       = { IDD_DISTRIBUTED_PATH_DIRECT_LIGHT_STRATEGY,         "strategy" };
+  static const Descr2Param<LuxInteger> sDistriPathDirectDirectLightSamples  = { IDD_DISTRIBUTED_PATH_DIRECT_DIRECT_LIGHT_SAMPLES,   "directsamples" };
+  static const Descr2Param<LuxInteger> sDistriPathInDirectDirectLightSamples= { IDD_DISTRIBUTED_PATH_INDIRECT_DIRECT_LIGHT_SAMPLES, "indirectsamples" };
+  static const Descr2Param<LuxInteger> sDistriPathDiffuseReflectDepth       = { IDD_DISTRIBUTED_PATH_DIFFUSE_REFLECT_DEPTH,         "diffusereflectdepth" };
+  static const Descr2Param<LuxInteger> sDistriPathDiffuseReflectSamples     = { IDD_DISTRIBUTED_PATH_DIFFUSE_REFLECT_SAMPLES,       "diffusereflectsamples" };
+  static const Descr2Param<LuxInteger> sDistriPathDiffuseRefractDepth       = { IDD_DISTRIBUTED_PATH_DIFFUSE_REFRACT_DEPTH,         "diffuserefractdepth" };
+  static const Descr2Param<LuxInteger> sDistriPathDiffuseRefractSamples     = { IDD_DISTRIBUTED_PATH_DIFFUSE_REFRACT_SAMPLES,       "diffuserefractsamples" };
+  static const Descr2Param<LuxInteger> sDistriPathGlossyReflectDepth        = { IDD_DISTRIBUTED_PATH_GLOSSY_REFLECT_DEPTH,          "glossyreflectdepth" };
+  static const Descr2Param<LuxInteger> sDistriPathGlossyReflectSamples      = { IDD_DISTRIBUTED_PATH_GLOSSY_REFLECT_SAMPLES,        "glossyreflectsamples" };
+  static const Descr2Param<LuxInteger> sDistriPathGlossyRefractDepth        = { IDD_DISTRIBUTED_PATH_GLOSSY_REFRACT_DEPTH,          "glossyrefractdepth" };
+  static const Descr2Param<LuxInteger> sDistriPathGlossyRefractSamples      = { IDD_DISTRIBUTED_PATH_GLOSSY_REFRACT_SAMPLES,        "glossyrefractsamples" };
+  static const Descr2Param<LuxInteger> sDistriPathSpecularReflectDepth      = { IDD_DISTRIBUTED_PATH_SPECULAR_REFLECT_DEPTH,        "specularreflectdepth" };
+  static const Descr2Param<LuxInteger> sDistriPathSpecularRefractDepth      = { IDD_DISTRIBUTED_PATH_SPECULAR_REFRACT_DEPTH,        "specularrefractdepth" };
 
   // parameters for bidirectional integrator
-  static Descr2Param<LuxInteger> sBidirectionalEyeDepth           (IDD_BIDIRECTIONAL_EYE_DEPTH,             "eyedepth");
-  static Descr2Param<LuxInteger> sBidirectionalLightDepth         (IDD_BIDIRECTIONAL_LIGHT_DEPTH,           "lightdepth");
-  static Descr2Param<LuxString>  sBidirectionalDirectLightStrategy(IDD_BIDIRECTIONAL_DIRECT_LIGHT_STRATEGY, "strategy");
-  static Descr2Param<LuxFloat>   sBidirectionalEyeRRThreshold     (IDD_BIDIRECTIONAL_EYE_RR_THRESHOLD,      "eyerrthreshold");
-  static Descr2Param<LuxFloat>   sBidirectionalLightRRThreshold   (IDD_BIDIRECTIONAL_LIGHT_RR_THRESHOLD,    "lightrrthreshold");
+  static const Descr2Param<LuxInteger> sBidirectionalEyeDepth           = { IDD_BIDIRECTIONAL_EYE_DEPTH,             "eyedepth" };
+  static const Descr2Param<LuxInteger> sBidirectionalLightDepth         = { IDD_BIDIRECTIONAL_LIGHT_DEPTH,           "lightdepth" };
+  static const Descr2Param<LuxString>  sBidirectionalDirectLightStrategy= { IDD_BIDIRECTIONAL_DIRECT_LIGHT_STRATEGY, "strategy" };
+  static const Descr2Param<LuxFloat>   sBidirectionalEyeRRThreshold     = { IDD_BIDIRECTIONAL_EYE_RR_THRESHOLD,      "eyerrthreshold" };
+  static const Descr2Param<LuxFloat>   sBidirectionalLightRRThreshold   = { IDD_BIDIRECTIONAL_LIGHT_RR_THRESHOLD,    "lightrrthreshold" };
 
   // parameters for direct lighting integrator
-  static Descr2Param<LuxInteger> sDirectLightingMaxDepth(IDD_DIRECT_LIGHTING_MAX_DEPTH, "maxdepth");
-  static Descr2Param<LuxString>  sDirectLightingStrategy(IDD_DIRECT_LIGHTING_STRATEGY,  "strategy");
+  static const Descr2Param<LuxInteger> sDirectLightingMaxDepth= { IDD_DIRECT_LIGHTING_MAX_DEPTH, "maxdepth" };
+  static const Descr2Param<LuxString>  sDirectLightingStrategy= { IDD_DIRECT_LIGHTING_STRATEGY,  "strategy" };
 
 
   // set default integrator
@@ -922,52 +942,52 @@ void LuxC4DSettings::getSurfaceIntegrator(const char*& name,
   switch (integrator) {
     // path integrator
     case IDD_INTEGRATOR_PATH:
-      copyParam(sPathMaxDepth,            paramSet);
-      copyParam(sPathIncludeEnvironment,  paramSet);
+      copyParam(sPathMaxDepth,            paramSet, buffer);
+      copyParam(sPathIncludeEnvironment,  paramSet, buffer);
       if (data->GetBool(IDD_ADVANCED_INTEGRATOR)) {
-        copyParam(sPathDirectLightStrategy, paramSet,
+        copyParam(sPathDirectLightStrategy, paramSet, buffer,
                   sDirectLightStrategies, IDD_DIRECT_LIGHT_STRATEGY_NUMBER);
-        copyParam(sPathRRStrategy, paramSet,
+        copyParam(sPathRRStrategy, paramSet, buffer,
                   sRRStrategies, IDD_PATH_RR_STRATEGY_NUMBER);
         if (data->GetLong(IDD_PATH_RR_STRATEGY) == IDD_PATH_RR_STRATEGY_PROBABILITY) {
-          copyParam(sPathRRContinueProb,    paramSet);
+          copyParam(sPathRRContinueProb,    paramSet, buffer);
         }
       }
       break;
     // distributed path integrator
     case IDD_INTEGRATOR_DISTRIBUTED_PATH:
-      copyParam(sDistriPathDirectLightStrategy, paramSet,
+      copyParam(sDistriPathDirectLightStrategy, paramSet, buffer,
                 sDirectLightStrategies, IDD_DIRECT_LIGHT_STRATEGY_NUMBER);
-      copyParam(sDistriPathDirectDirectLightSamples,   paramSet);
-      copyParam(sDistriPathInDirectDirectLightSamples, paramSet);
-      copyParam(sDistriPathDiffuseReflectDepth,        paramSet);
-      copyParam(sDistriPathDiffuseReflectSamples,      paramSet);
-      copyParam(sDistriPathDiffuseRefractDepth,        paramSet);
-      copyParam(sDistriPathDiffuseRefractSamples,      paramSet);
-      copyParam(sDistriPathGlossyReflectDepth,         paramSet);
-      copyParam(sDistriPathGlossyReflectSamples,       paramSet);
-      copyParam(sDistriPathGlossyRefractDepth,         paramSet);
-      copyParam(sDistriPathGlossyRefractSamples,       paramSet);
-      copyParam(sDistriPathSpecularReflectDepth,       paramSet);
-      copyParam(sDistriPathSpecularRefractDepth,       paramSet);
+      copyParam(sDistriPathDirectDirectLightSamples,   paramSet, buffer);
+      copyParam(sDistriPathInDirectDirectLightSamples, paramSet, buffer);
+      copyParam(sDistriPathDiffuseReflectDepth,        paramSet, buffer);
+      copyParam(sDistriPathDiffuseReflectSamples,      paramSet, buffer);
+      copyParam(sDistriPathDiffuseRefractDepth,        paramSet, buffer);
+      copyParam(sDistriPathDiffuseRefractSamples,      paramSet, buffer);
+      copyParam(sDistriPathGlossyReflectDepth,         paramSet, buffer);
+      copyParam(sDistriPathGlossyReflectSamples,       paramSet, buffer);
+      copyParam(sDistriPathGlossyRefractDepth,         paramSet, buffer);
+      copyParam(sDistriPathGlossyRefractSamples,       paramSet, buffer);
+      copyParam(sDistriPathSpecularReflectDepth,       paramSet, buffer);
+      copyParam(sDistriPathSpecularRefractDepth,       paramSet, buffer);
       break;
     // bidirectional integrator
     case IDD_INTEGRATOR_BIDIRECTIONAL:
-      copyParam(sBidirectionalEyeDepth,            paramSet);
-      copyParam(sBidirectionalLightDepth,          paramSet);
+      copyParam(sBidirectionalEyeDepth,            paramSet, buffer);
+      copyParam(sBidirectionalLightDepth,          paramSet, buffer);
       if (data->GetBool(IDD_ADVANCED_INTEGRATOR)) {
-        copyParam(sBidirectionalDirectLightStrategy, paramSet,
+        copyParam(sBidirectionalDirectLightStrategy, paramSet, buffer,
                   sDirectLightStrategies, IDD_DIRECT_LIGHT_STRATEGY_NUMBER);
-        copyParam(sBidirectionalEyeRRThreshold,      paramSet);
-        copyParam(sBidirectionalLightRRThreshold,    paramSet);
+        copyParam(sBidirectionalEyeRRThreshold,      paramSet, buffer);
+        copyParam(sBidirectionalLightRRThreshold,    paramSet, buffer);
       }
       isBidirectional = TRUE;
       break;
     // direct lighting integrator
     case IDD_INTEGRATOR_DIRECT_LIGHTING:
-      copyParam(sDirectLightingMaxDepth, paramSet);
+      copyParam(sDirectLightingMaxDepth, paramSet, buffer);
       if (data->GetBool(IDD_ADVANCED_INTEGRATOR)) {
-        copyParam(sDirectLightingStrategy, paramSet,
+        copyParam(sDirectLightingStrategy, paramSet, buffer,
                   sDirectLightStrategies, IDD_DIRECT_LIGHT_STRATEGY_NUMBER);
       }
       break;
@@ -987,8 +1007,11 @@ void LuxC4DSettings::getSurfaceIntegrator(const char*& name,
 ///   Will receive the accelerator name.
 /// @param[out]  paramSet
 ///   The set to which the parameters get added.
+/// @param[out]  buffer
+///   The buffer that stores the parameter values referenced by paramSet.
 void LuxC4DSettings::getAccelerator(const char*& name,
-                                    LuxParamSet& paramSet)
+                                    LuxParamSet& paramSet,
+                                    ParamBuffer& buffer)
 {
   // the different accelerator names
   static const char* sAcceleratorNames[IDD_ACCELERATION_TYPE_NUMBER] = {
@@ -998,23 +1021,23 @@ void LuxC4DSettings::getAccelerator(const char*& name,
     };
 
   // parameters for kd-tree
-  static Descr2Param<LuxInteger> sKdTreeIntersectionCost(IDD_KDTREE_INTERSECTION_COST, "intersectcost");
-  static Descr2Param<LuxInteger> sKdTreeTraversalCost   (IDD_KDTREE_TRAVERSAL_COST,    "traversalcost");
-  static Descr2Param<LuxFloat>   sKdTreeEmptyBonus      (IDD_KDTREE_EMPTY_BONUS,       "emptybonus");
-  static Descr2Param<LuxInteger> sKdTreeMaxPrimitives   (IDD_KDTREE_MAX_PRIMITIVES,    "maxprims");
-  static Descr2Param<LuxInteger> sKdTreeMaxDepth        (IDD_KDTREE_MAX_DEPTH,         "maxdepth");
+  static const Descr2Param<LuxInteger> sKdTreeIntersectionCost= { IDD_KDTREE_INTERSECTION_COST, "intersectcost" };
+  static const Descr2Param<LuxInteger> sKdTreeTraversalCost   = { IDD_KDTREE_TRAVERSAL_COST,    "traversalcost" };
+  static const Descr2Param<LuxFloat>   sKdTreeEmptyBonus      = { IDD_KDTREE_EMPTY_BONUS,       "emptybonus" };
+  static const Descr2Param<LuxInteger> sKdTreeMaxPrimitives   = { IDD_KDTREE_MAX_PRIMITIVES,    "maxprims" };
+  static const Descr2Param<LuxInteger> sKdTreeMaxDepth        = { IDD_KDTREE_MAX_DEPTH,         "maxdepth" };
 
   // parameters for bvh tree
-  static Descr2Param<LuxInteger> sBVHIntersectionCost(IDD_BVH_TREE_TYPE,         "treetype");
-  static Descr2Param<LuxInteger> sBVHTraversalCost   (IDD_BVH_COST_SAMPLES,      "costsamples");
-  static Descr2Param<LuxInteger> sBVHMaxPrimitives   (IDD_BVH_INTERSECTION_COST, "intersectcost");
-  static Descr2Param<LuxInteger> sBVHMaxDepth        (IDD_BVH_TRAVERSAL_COST,    "traversalcost");
-  static Descr2Param<LuxFloat>   sBVHEmptyBonus      (IDD_BVH_EMPTY_BONUS,       "emptybonus");
+  static const Descr2Param<LuxInteger> sBVHIntersectionCost= { IDD_BVH_TREE_TYPE,         "treetype" };
+  static const Descr2Param<LuxInteger> sBVHTraversalCost   = { IDD_BVH_COST_SAMPLES,      "costsamples" };
+  static const Descr2Param<LuxInteger> sBVHMaxPrimitives   = { IDD_BVH_INTERSECTION_COST, "intersectcost" };
+  static const Descr2Param<LuxInteger> sBVHMaxDepth        = { IDD_BVH_TRAVERSAL_COST,    "traversalcost" };
+  static const Descr2Param<LuxFloat>   sBVHEmptyBonus      = { IDD_BVH_EMPTY_BONUS,       "emptybonus" };
 
   // parameters for qbvh tree
-  static Descr2Param<LuxInteger> sQBVHTraversalCost(IDD_QBVH_MAX_PRIMITIVES,       "maxprimsperleaf");
-  static Descr2Param<LuxFloat>   sQBVHEmptyBonus   (IDD_QBVH_FULL_SWEEP_THRESHOLD, "fullsweepthreshold");
-  static Descr2Param<LuxInteger> sQBVHMaxPrimitives(IDD_QBVH_SKIP_FACTOR,          "skipfactor");
+  static const Descr2Param<LuxInteger> sQBVHTraversalCost= { IDD_QBVH_MAX_PRIMITIVES,       "maxprimsperleaf" };
+  static const Descr2Param<LuxFloat>   sQBVHEmptyBonus   = { IDD_QBVH_FULL_SWEEP_THRESHOLD, "fullsweepthreshold" };
+  static const Descr2Param<LuxInteger> sQBVHMaxPrimitives= { IDD_QBVH_SKIP_FACTOR,          "skipfactor" };
 
 
   // set default accelerator
@@ -1032,25 +1055,25 @@ void LuxC4DSettings::getAccelerator(const char*& name,
     switch (accelerator) {
       // kd-tree
       case IDD_INTEGRATOR_PATH:
-        copyParam(sKdTreeIntersectionCost, paramSet);
-        copyParam(sKdTreeTraversalCost,    paramSet);
-        copyParam(sKdTreeEmptyBonus,       paramSet);
-        copyParam(sKdTreeMaxPrimitives,    paramSet);
-        copyParam(sKdTreeMaxDepth,         paramSet);
+        copyParam(sKdTreeIntersectionCost, paramSet, buffer);
+        copyParam(sKdTreeTraversalCost,    paramSet, buffer);
+        copyParam(sKdTreeEmptyBonus,       paramSet, buffer);
+        copyParam(sKdTreeMaxPrimitives,    paramSet, buffer);
+        copyParam(sKdTreeMaxDepth,         paramSet, buffer);
         break;
       // bvh tree
       case IDD_ACCELERATION_BVH:
-        copyParam(sBVHIntersectionCost, paramSet);
-        copyParam(sBVHTraversalCost,    paramSet);
-        copyParam(sBVHMaxPrimitives,    paramSet);
-        copyParam(sBVHMaxDepth,         paramSet);
-        copyParam(sBVHEmptyBonus,       paramSet);
+        copyParam(sBVHIntersectionCost, paramSet, buffer);
+        copyParam(sBVHTraversalCost,    paramSet, buffer);
+        copyParam(sBVHMaxPrimitives,    paramSet, buffer);
+        copyParam(sBVHMaxDepth,         paramSet, buffer);
+        copyParam(sBVHEmptyBonus,       paramSet, buffer);
         break;
       // qbvh tree
       case IDD_ACCELERATION_QBVH:
-        copyParam(sQBVHTraversalCost, paramSet);
-        copyParam(sQBVHEmptyBonus,    paramSet);
-        copyParam(sQBVHMaxPrimitives, paramSet);
+        copyParam(sQBVHTraversalCost, paramSet, buffer);
+        copyParam(sQBVHEmptyBonus,    paramSet, buffer);
+        copyParam(sQBVHMaxPrimitives, paramSet, buffer);
         break;
       // invalid accelerator-> error and return
       default:
@@ -1158,6 +1181,82 @@ Bool LuxC4DSettings::useRelativePaths(void)
 }
 
 
+/// Returns TRUE if objects should be exported into shards, which are reused
+/// by the next export if they didn't change.
+Bool LuxC4DSettings::useIncrementalExport(void)
+{
+  // get base container and return setting of incremental export option
+  BaseContainer* data = getData();
+  if (!data) { return FALSE; }
+  return data->GetBool(IDD_INCREMENTAL_EXPORT);
+}
+
+
+/// Returns TRUE if the frame range of the render settings should be exported
+/// as a sequence of frame files instead of a single scene.
+Bool LuxC4DSettings::exportAnimation(void)
+{
+  // get base container and return setting of animation export option
+  BaseContainer* data = getData();
+  if (!data) { return FALSE; }
+  return data->GetBool(IDD_EXPORT_ANIMATION);
+}
+
+
+/// Returns the maximum resolution of exported image textures or 0 if textures
+/// shouldn't be preprocessed at all.
+LONG LuxC4DSettings::getMaxTextureResolution(void)
+{
+  // get base container and return the resolution, if preprocessing is enabled
+  BaseContainer* data = getData();
+  if (!data || !data->GetBool(IDD_PREPROCESS_TEXTURES)) {
+    return 0;
+  }
+  return data->GetLong(IDD_MAX_TEXTURE_RESOLUTION);
+}
+
+
+/// Returns the memory budget in MB for all preprocessed image textures or 0 if
+/// the memory usage should not be limited.
+LONG LuxC4DSettings::getTextureMemoryBudget(void)
+{
+  // get base container and return the budget, if preprocessing is enabled
+  BaseContainer* data = getData();
+  if (!data || !data->GetBool(IDD_PREPROCESS_TEXTURES)) {
+    return 0;
+  }
+  return data->GetLong(IDD_TEXTURE_MEMORY_BUDGET);
+}
+
+
+/// Returns the maximum width of exported environment maps or 0 if environment
+/// maps shouldn't be preprocessed at all.
+LONG LuxC4DSettings::getMaxEnvironmentResolution(void)
+{
+  // get base container and return the resolution, if preprocessing is enabled
+  BaseContainer* data = getData();
+  if (!data || !data->GetBool(IDD_PREPROCESS_TEXTURES)) {
+    return 0;
+  }
+  return data->GetLong(IDD_MAX_ENVIRONMENT_RESOLUTION);
+}
+
+
+/// Returns the resolution in which non-bitmap shaders should be baked into
+/// images or 0 if shaders shouldn't be baked.
+LONG LuxC4DSettings::getShaderBakeResolution(void)
+{
+  // get base container and return the resolution, if baking is enabled
+  BaseContainer* data = getData();
+  if (!data || !data->GetBool(IDD_PREPROCESS_TEXTURES) ||
+      !data->GetBool(IDD_BAKE_SHADERS))
+  {
+    return 0;
+  }
+  return data->GetLong(IDD_SHADER_BAKE_RESOLUTION);
+}
+
+
 
 /*****************************************************************************
  * Implementation of private member functions of class LuxC4DSettings.
@@ -1177,61 +1276,112 @@ BaseContainer* LuxC4DSettings::getData(void)
 }
 
 
+/// Adds a parameter, whose value is stored in a ParamBuffer, to a parameter
+/// set.
+///
+/// @param[in]  type
+///   The type of the parameter.
+/// @param[in]  name
+///   The name of the parameter.
+/// @param[in]  value
+///   The address of the value in the buffer (NULL if the buffer was full).
+/// @param[in]  paramSet
+///   The set where the parameter gets added to.
+/// @param[in]  arraySize
+///   The number of values of the parameter.
+/// @return
+///   The value address or NULL if the parameter couldn't be added.
+template<class T>
+T* LuxC4DSettings::addParam(LuxParamType type,
+                            LuxParamName name,
+                            T*           value,
+                            LuxParamSet& paramSet,
+                            ULONG        arraySize)
+{
+  if (!value) {
+    ERRLOG_RETURN_VALUE(NULL, "LuxC4DSettings::addParam(): parameter buffer is full -> parameter '" + String(name) + "' is skipped");
+  }
+  paramSet.addParam(type, name, value, arraySize);
+  return value;
+}
+
+
 /// Copies a bool parameter into the Lux parameter set.
 ///
 /// @param[in]  descr2Param
-///   Structure that contains the parameter ID, name and its value buffer.
+///   Structure that contains the parameter ID and name.
 /// @param[in]  paramSet
 ///   The set where the parameter gets added to.
-void LuxC4DSettings::copyParam(Descr2Param<LuxBool>& descr2Param,
-                               LuxParamSet&          paramSet)
+/// @param[in]  buffer
+///   The buffer where the parameter value gets stored.
+/// @return
+///   The address of the stored value or NULL if it couldn't be stored.
+LuxBool* LuxC4DSettings::copyParam(const Descr2Param<LuxBool>& descr2Param,
+                                   LuxParamSet&                paramSet,
+                                   ParamBuffer&                buffer)
 {
   // get base container of this object
   BaseContainer* data = getData();
-  if (!data)  return;
+  if (!data)  return NULL;
 
-  // get float and add it to parameter set
-  descr2Param.mParam = (data->GetBool(descr2Param.mID) != 0);
-  paramSet.addParam(LUX_BOOL, descr2Param.mParamName, &descr2Param.mParam);
+  // get bool and add it to parameter set
+  return addParam(LUX_BOOL, descr2Param.mParamName,
+                  buffer.addBool(data->GetBool(descr2Param.mID) != 0),
+                  paramSet);
 }
 
 
 /// Copies an integer parameter into the Lux parameter set.
 ///
 /// @param[in]  descr2Param
-///   Structure that contains the parameter ID, name and its value buffer.
+///   Structure that contains the parameter ID and name.
 /// @param[in]  paramSet
 ///   The set where the parameter gets added to.
-void LuxC4DSettings::copyParam(Descr2Param<LuxInteger>& descr2Param,
-                               LuxParamSet&             paramSet)
+/// @param[in]  buffer
+///   The buffer where the parameter value gets stored.
+/// @return
+///   The address of the stored value or NULL if it couldn't be stored.
+LuxInteger* LuxC4DSettings::copyParam(const Descr2Param<LuxInteger>& descr2Param,
+                                      LuxParamSet&                   paramSet,
+                                      ParamBuffer&                   buffer)
 {
   // get base container of this object
   BaseContainer* data = getData();
-  if (!data)  return;
+  if (!data)  return NULL;
 
-  // get float and add it to parameter set
-  descr2Param.mParam = data->GetLong(descr2Param.mID);
-  paramSet.addParam(LUX_INTEGER, descr2Param.mParamName, &descr2Param.mParam);
+  // get integer and add it to parameter set
+  return addParam(LUX_INTEGER, descr2Param.mParamName,
+                  buffer.addInteger(data->GetLong(descr2Param.mID)),
+                  paramSet);
 }
 
 
 /// Copies a float parameter into the Lux parameter set.
 ///
 /// @param[in]  descr2Param
-///   Structure that contains the parameter ID, name and its value buffer.
+///   Structure that contains the parameter ID and name.
 /// @param[in]  paramSet
 ///   The set where the parameter gets added to.
-void LuxC4DSettings::copyParam(Descr2Param<LuxFloat>& descr2Param,
-                               LuxParamSet&           paramSet,
-                               LuxFloat               scaleFactor)
+/// @param[in]  buffer
+///   The buffer where the parameter value gets stored.
+/// @param[in]  scaleFactor
+///   The factor the setting gets multiplied with.
+/// @return
+///   The address of the stored value or NULL if it couldn't be stored.
+LuxFloat* LuxC4DSettings::copyParam(const Descr2Param<LuxFloat>& descr2Param,
+                                    LuxParamSet&                 paramSet,
+                                    ParamBuffer&                 buffer,
+                                    LuxFloat                     scaleFactor)
 {
   // get base container of this object
   BaseContainer* data = getData();
-  if (!data)  return;
+  if (!data)  return NULL;
 
   // get float and add it to parameter set
-  descr2Param.mParam = data->GetReal(descr2Param.mID) * scaleFactor;
-  paramSet.addParam(LUX_FLOAT, descr2Param.mParamName, &descr2Param.mParam);
+  LuxFloat value = data->GetReal(descr2Param.mID) * scaleFactor;
+  return addParam(LUX_FLOAT, descr2Param.mParamName,
+                  buffer.addFloats(&value, 1),
+                  paramSet);
 }
 
 
@@ -1239,30 +1389,36 @@ void LuxC4DSettings::copyParam(Descr2Param<LuxFloat>& descr2Param,
 /// it converts the cycle value into a string.
 ///
 /// @param[in]  descr2Param
-///   Structure that contains the parameter ID, name and its value buffer.
+///   Structure that contains the parameter ID and name.
 /// @param[in]  paramSet
 ///   The set where the parameter gets added to.
+/// @param[in]  buffer
+///   The buffer where the parameter value gets stored.
 /// @param[in]  cycleEntries
 ///   An array of the cycle entries as C strings.
 /// @param[in]  cycleEntryCount
 ///   The number of entries in the cycle entry array.
-void LuxC4DSettings::copyParam(Descr2Param<LuxString>& descr2Param,
-                               LuxParamSet&            paramSet,
-                               const char**            cycleEntries,
-                               LONG                    cycleEntryCount)
+/// @return
+///   The address of the stored value or NULL if it couldn't be stored.
+LuxString* LuxC4DSettings::copyParam(const Descr2Param<LuxString>& descr2Param,
+                                     LuxParamSet&                  paramSet,
+                                     ParamBuffer&                  buffer,
+                                     const char**                  cycleEntries,
+                                     LONG                          cycleEntryCount)
 {
   // get base container of this object
   BaseContainer* data = getData();
-  if (!data)  return;
+  if (!data)  return NULL;
 
   // get and check entry from cycle
   LONG entry = data->GetLong(descr2Param.mID);
   if ((entry<0) || (entry>=cycleEntryCount))
-    ERRLOG_RETURN("LuxC4DSettings::CopyCycleParam(): invalid cycle entry found -> using default settings");
+    ERRLOG_RETURN_VALUE(NULL, "LuxC4DSettings::CopyCycleParam(): invalid cycle entry found -> using default settings");
 
   // map entry to string and add that to parameter set
-  descr2Param.mParam = cycleEntries[entry];
-  paramSet.addParam(LUX_STRING, descr2Param.mParamName, &descr2Param.mParam);
+  return addParam(LUX_STRING, descr2Param.mParamName,
+                  buffer.addString(cycleEntries[entry]),
+                  paramSet);
 }
 
 
@@ -1353,3 +1509,61 @@ void LuxC4DSettings::setWhitePointPreset(BaseContainer& data,
   data.SetReal(IDD_FLEXIMAGE_WHITEPOINT_X,      preset.mX);
   data.SetReal(IDD_FLEXIMAGE_WHITEPOINT_Y,      preset.mY);
 }
+
+
+
+/*****************************************************************************
+ * Implementation of class LuxC4DSettings::ParamBuffer.
+ *****************************************************************************/
+
+/// Stores a bool value.
+///
+/// @return
+///   The address of the stored value or NULL if the buffer is full.
+LuxBool* LuxC4DSettings::ParamBuffer::addBool(LuxBool value)
+{
+  if (mBoolCount >= cMaxValues)  return NULL;
+  mBools[mBoolCount] = value;
+  return &mBools[mBoolCount++];
+}
+
+
+/// Stores an integer value.
+///
+/// @return
+///   The address of the stored value or NULL if the buffer is full.
+LuxInteger* LuxC4DSettings::ParamBuffer::addInteger(LuxInteger value)
+{
+  if (mIntegerCount >= cMaxValues)  return NULL;
+  mIntegers[mIntegerCount] = value;
+  return &mIntegers[mIntegerCount++];
+}
+
+
+/// Stores an array of float values.
+///
+/// @return
+///   The address of the stored array or NULL if the buffer is full.
+LuxFloat* LuxC4DSettings::ParamBuffer::addFloats(const LuxFloat* values,
+                                                 ULONG           count)
+{
+  if (mFloatCount + count > sizeof(mFloats)/sizeof(mFloats[0]))  return NULL;
+  LuxFloat* stored = &mFloats[mFloatCount];
+  for (ULONG i=0; i<count; ++i) {
+    stored[i] = values[i];
+  }
+  mFloatCount += count;
+  return stored;
+}
+
+
+/// Stores a string value.
+///
+/// @return
+///   The address of the stored value or NULL if the buffer is full.
+LuxString* LuxC4DSettings::ParamBuffer::addString(const char* value)
+{
+  if (mStringCount >= cMaxValues)  return NULL;
+  mStrings[mStringCount] = value;
+  return &mStrings[mStringCount++];
+}
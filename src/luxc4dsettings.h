@@ -53,6 +53,41 @@ class LuxC4DSettings : public VideoPostData
 
 public:
 
+  /// Buffer that stores the parameter values returned by the get...()
+  /// functions, as the parameter sets only reference the values. Each caller
+  /// provides its own buffer, which has to live as long as the parameter set
+  /// is used. This way several exports can obtain their settings at the same
+  /// time.
+  class ParamBuffer
+  {
+  public:
+
+    inline ParamBuffer(void)  { clear(); }
+    inline void clear(void)  { mBoolCount = mIntegerCount = mFloatCount = mStringCount = 0; }
+
+    LuxBool*    addBool(LuxBool value);
+    LuxInteger* addInteger(LuxInteger value);
+    LuxFloat*   addFloats(const LuxFloat* values,
+                          ULONG           count);
+    LuxString*  addString(const char* value);
+
+
+  private:
+
+    /// The maximum number of values of one type a buffer can store.
+    static const ULONG cMaxValues = 64;
+
+    LuxBool    mBools[cMaxValues];
+    LuxInteger mIntegers[cMaxValues];
+    LuxFloat   mFloats[cMaxValues*2];
+    LuxString  mStrings[cMaxValues];
+    ULONG      mBoolCount;
+    ULONG      mIntegerCount;
+    ULONG      mFloatCount;
+    ULONG      mStringCount;
+  };
+
+
   static NodeData* alloc(void);
   static Bool registerPlugin(void);
 
@@ -67,19 +102,24 @@ public:
 
   void getFilm(Bool         resume,
                const char*& name,
-               LuxParamSet& paramSet);
+               LuxParamSet& paramSet,
+               ParamBuffer& buffer);
   LONG getOutputFilePathSettings(Filename& userDefined);
   void getPixelFilter(const char*& name,
-                      LuxParamSet& paramSet);
+                      LuxParamSet& paramSet,
+                      ParamBuffer& buffer);
   void getSampler(const char*& name,
                   LuxParamSet& paramSet,
+                  ParamBuffer& buffer,
                   LONG         xResolution,
                   LONG         yResolution);
   void getSurfaceIntegrator(const char*& name,
                             LuxParamSet& paramSet,
+                            ParamBuffer& buffer,
                             Bool&        isBidirectional);
   void getAccelerator(const char*& name,
-                      LuxParamSet& paramSet);
+                      LuxParamSet& paramSet,
+                      ParamBuffer& buffer);
   void getExportFilename(BaseDocument& document,
                          Filename&     path,
                          Bool&         overwritingAllowed);
@@ -88,41 +128,55 @@ public:
   Real getTextureGamma(void);
   Real getColorGamma(void);
   Bool useRelativePaths(void);
+  Bool useIncrementalExport(void);
+  Bool exportAnimation(void);
+  LONG getMaxTextureResolution(void);
+  LONG getTextureMemoryBudget(void);
+  LONG getMaxEnvironmentResolution(void);
+  LONG getShaderBakeResolution(void);
 
 
 private:
 
   /// Helper structure for retrieving a setting from the descriptions and for
-  /// converting it to a Lux parameter. It defines the parameter ID and name
-  /// and also provides the buffer where the parameter gets stored.
+  /// converting it to a Lux parameter. It defines the parameter ID and name.
+  /// It's an aggregate, so constant instances are initialised statically and
+  /// can be shared by all threads. The parameter value is stored in a
+  /// ParamBuffer.
   template<class T>
   struct Descr2Param {
     LONG         mID;
-    T            mParam;
     LuxParamName mParamName;
-
-    Descr2Param(LONG id, LuxParamName paramName)
-    : mID(id), mParamName(paramName)
-    {}
   };
 
 
   BaseContainer* getData(void);
 
-  void copyParam(Descr2Param<LuxBool>& descr2Param,
-                 LuxParamSet&          paramSet);
-
-  void copyParam(Descr2Param<LuxInteger>& descr2Param,
-                 LuxParamSet&             paramSet);
-
-  void copyParam(Descr2Param<LuxFloat>& descr2Param,
-                 LuxParamSet&           paramSet,
-                 LuxFloat               scaleFactor = 1.0);
-
-  void copyParam(Descr2Param<LuxString>& descr2Param,
-                 LuxParamSet&            paramSet,
-                 const char**            cycleEntries,
-                 LONG                    cycleEntryCount);
+  template<class T>
+  T* addParam(LuxParamType type,
+              LuxParamName name,
+              T*           value,
+              LuxParamSet& paramSet,
+              ULONG        arraySize = 1);
+
+  LuxBool* copyParam(const Descr2Param<LuxBool>& descr2Param,
+                     LuxParamSet&                paramSet,
+                     ParamBuffer&                buffer);
+
+  LuxInteger* copyParam(const Descr2Param<LuxInteger>& descr2Param,
+                        LuxParamSet&                   paramSet,
+                        ParamBuffer&                   buffer);
+
+  LuxFloat* copyParam(const Descr2Param<LuxFloat>& descr2Param,
+                      LuxParamSet&                 paramSet,
+                      ParamBuffer&                 buffer,
+                      LuxFloat                     scaleFactor = 1.0);
+
+  LuxString* copyParam(const Descr2Param<LuxString>& descr2Param,
+                       LuxParamSet&                  paramSet,
+                       ParamBuffer&                  buffer,
+                       const char**                  cycleEntries,
+                       LONG                          cycleEntryCount);
 
   void setColorspacePreset(BaseContainer& data,
                            LONG           preset);
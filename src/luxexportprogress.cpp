@@ -0,0 +1,174 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include <cstdio>
+
+#include "c4d_symbols.h"
+#include "luxexportprogress.h"
+
+
+
+/*****************************************************************************
+ * Implementation of public member functions of class LuxExportProgress.
+ *****************************************************************************/
+
+/// Constructs a progress that is in the first phase and not cancelled.
+LuxExportProgress::LuxExportProgress(void)
+: mCancelled(FALSE),
+  mPhase(PHASE_SETTINGS),
+  mPhaseStartTime(GeGetTimer()),
+  mDone(0),
+  mTotal(0)
+{}
+
+
+/// Starts a new phase of the export. If the frames of an animation are
+/// exported, the phases of the single frames are ignored.
+///
+/// @param[in]  phase
+///   The phase to start.
+/// @param[in]  total  (optional)
+///   The number of items that will be processed in this phase or 0 if it's
+///   unknown.
+/// @return
+///   FALSE if the export was cancelled, TRUE otherwise.
+Bool LuxExportProgress::startPhase(Phase phase,
+                                   ULONG total)
+{
+  lock();
+  if ((mPhase != PHASE_FRAMES) || (phase == PHASE_FRAMES)) {
+    mPhase          = phase;
+    mPhaseStartTime = GeGetTimer();
+    mDone           = 0;
+    mTotal          = total;
+  }
+  unlock();
+  return !mCancelled;
+}
+
+
+/// Reports that an item of a phase was processed. If the phase is not the
+/// current phase (which happens for the phases of the single frames of an
+/// animation), the step is ignored.
+///
+/// @param[in]  phase
+///   The phase the item belongs to.
+/// @return
+///   FALSE if the export was cancelled, TRUE otherwise.
+Bool LuxExportProgress::step(Phase phase)
+{
+  lock();
+  if ((phase == mPhase) && (mDone < mTotal))  ++mDone;
+  unlock();
+  return !mCancelled;
+}
+
+
+/// Returns the text and the percentage which should be shown in the status
+/// bar. Must be called from the main thread.
+///
+/// @param[out]  text
+///   Will be set to the phase, the number of items done and the estimated
+///   remaining time of the phase.
+/// @param[out]  percent
+///   Will be set to the estimated overall progress in percent.
+void LuxExportProgress::getStatus(String& text,
+                                  LONG&   percent)
+{
+  // the range of the overall progress (in percent) covered by each phase
+  static const LONG cPhaseRanges[PHASE_NUMBER][2] = {
+      {  0,   2 },    // PHASE_SETTINGS
+      {  2,   7 },    // PHASE_COLLECT
+      {  7,  10 },    // PHASE_LIGHTS
+      { 10,  90 },    // PHASE_GEOMETRY
+      { 90, 100 },    // PHASE_TEXTURES
+      {  0, 100 }     // PHASE_FRAMES
+    };
+  static const LONG cPhaseNames[PHASE_NUMBER] = {
+      IDS_EXPORT_PHASE_SETTINGS,
+      IDS_EXPORT_PHASE_COLLECT,
+      IDS_EXPORT_PHASE_LIGHTS,
+      IDS_EXPORT_PHASE_GEOMETRY,
+      IDS_EXPORT_PHASE_TEXTURES,
+      IDS_EXPORT_PHASE_FRAMES
+    };
+
+  // take a snapshot of the current state
+  lock();
+  Phase phase   = mPhase;
+  LONG  elapsed = GeGetTimer() - mPhaseStartTime;
+  ULONG done    = mDone;
+  ULONG total   = mTotal;
+  unlock();
+
+  // determine the overall progress
+  const LONG* range = cPhaseRanges[phase];
+  percent = range[0];
+  if (total)  percent += (LONG)((Real)(range[1] - range[0]) * (Real)done / (Real)total);
+
+  // compose the text - the remaining time of the phase is estimated from the
+  // average time per item so far
+  String phaseName(GeLoadString(cPhaseNames[phase]));
+  if (!total || !done) {
+    text = GeLoadString(IDS_EXPORT_PROGRESS, phaseName);
+  } else {
+    LONG remaining = (LONG)((Real)elapsed * (Real)(total - done) / (Real)done);
+    text = GeLoadString(IDS_EXPORT_PROGRESS_ITEMS,
+                        phaseName,
+                        LongToString((LONG)done),
+                        LongToString((LONG)total),
+                        formatTime(remaining));
+  }
+}
+
+
+
+/*****************************************************************************
+ * Implementation of private member functions of class LuxExportProgress.
+ *****************************************************************************/
+
+/// Locks the progress state. If the lock couldn't be allocated, the state is
+/// accessed without it, which may only produce a wrong status text.
+void LuxExportProgress::lock(void)
+{
+  if (mLock)  mLock->Lock();
+}
+
+
+/// Unlocks the progress state again.
+void LuxExportProgress::unlock(void)
+{
+  if (mLock)  mLock->UnLock();
+}
+
+
+/// Formats a duration as "<minutes>:<seconds>".
+String LuxExportProgress::formatTime(LONG milliseconds)
+{
+  LONG seconds = (milliseconds + 999) / 1000;
+  CHAR buffer[32];
+  sprintf(buffer, "%d:%02d", (int)(seconds / 60), (int)(seconds % 60));
+  return String(buffer);
+}
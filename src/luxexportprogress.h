@@ -0,0 +1,119 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __LUXEXPORTPROGRESS_H__
+#define __LUXEXPORTPROGRESS_H__  1
+
+
+
+#include <c4d.h>
+
+#include "common.h"
+
+
+
+/***************************************************************************//*!
+ This class tracks the progress of an export, which runs in a background
+ thread, while the main thread displays it in the status bar.
+
+ The export is divided into phases, which are started via startPhase(). Within
+ a phase the exporter calls step() after each processed item (object, light,
+ frame, ...), which allows us to display the number of items done and to
+ estimate the remaining time of the phase. Both functions return FALSE if the
+ user requested to cancel the export via cancel().
+
+ When exporting an animation, the phase PHASE_FRAMES is started after the
+ first frame was exported. From then on, the phases of the single frames are
+ not shown anymore, but they still notice cancellation.
+
+ All functions can be called from any thread.
+*//****************************************************************************/
+class LuxExportProgress
+{
+public:
+
+  /// The phases of an export in the order they occur.
+  enum Phase {
+    PHASE_SETTINGS = 0,
+    PHASE_COLLECT,
+    PHASE_LIGHTS,
+    PHASE_GEOMETRY,
+    PHASE_TEXTURES,
+    PHASE_FRAMES,
+    PHASE_NUMBER
+  };
+
+
+  LuxExportProgress(void);
+
+  Bool startPhase(Phase phase,
+                  ULONG total=0);
+  Bool step(Phase phase);
+
+  inline void cancel(void);
+  inline Bool isCancelled(void) const;
+
+  void getStatus(String& text,
+                 LONG&   percent);
+
+
+private:
+
+  AutoAlloc<Semaphore> mLock;
+  volatile Bool        mCancelled;
+  Phase                mPhase;
+  LONG                 mPhaseStartTime;
+  ULONG                mDone;
+  ULONG                mTotal;
+
+  void lock(void);
+  void unlock(void);
+
+  static String formatTime(LONG milliseconds);
+};
+
+
+
+/*****************************************************************************
+ * Inlined functions of LuxExportProgress
+ *****************************************************************************/
+
+/// Requests the cancellation of the export. The exporter will notice it the
+/// next time it starts a phase or finishes an item.
+inline void LuxExportProgress::cancel(void)
+{
+  mCancelled = TRUE;
+}
+
+
+/// Returns TRUE if the cancellation of the export was requested.
+inline Bool LuxExportProgress::isCancelled(void) const
+{
+  return mCancelled;
+}
+
+
+
+#endif  // #ifndef __LUXEXPORTPROGRESS_H__
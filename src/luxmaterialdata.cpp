@@ -239,10 +239,10 @@ Bool LuxMaterialData::sendToAPI(LuxAPI&          receiver,
 ///   mixed materials.
 /// @return
 ///   TRUE if successful, FALSE otherwise.
-Bool LuxMaterialData::blendAndSendToAPI(LuxAPI&    receiver,
-                                        LuxString& matName,
-                                        LuxString& otherMatName,
-                                        LuxString& blendMatName)
+Bool LuxMaterialData::blendAndSendToAPI(LuxAPI&          receiver,
+                                        const LuxString& matName,
+                                        const LuxString& otherMatName,
+                                        const LuxString& blendMatName)
 {
   // if we don't have an alpha channel, we can't blend
   if (!mAlphaChannel.mEnabled) { ERRLOG_RETURN_VALUE(FALSE, "LuxMaterialData::blendAndSendToAPI(): Material has no alpha channel"); }
@@ -252,20 +252,20 @@ Bool LuxMaterialData::blendAndSendToAPI(LuxAPI&    receiver,
   LuxString alphaTexName(matName + ".alpha");
 
   // setup blend material
-  LuxParamSet mixParamSet(4);
+  LuxParamSetN<4> mixParamSet;
   LuxString mixType("mix");
   mixParamSet.addParam(LUX_STRING, "type", &mixType);
   // if alpha is not inverted, add name of other material as param
   // "namedmaterial1" and name of this material (no-alpha) as param
   // "namedmaterial2"
   if (!mAlphaInverted) {
-    mixParamSet.addParam(LUX_STRING, "namedmaterial1", &otherMatName);
+    mixParamSet.addParam(LUX_STRING, "namedmaterial1", (void*)&otherMatName);
     mixParamSet.addParam(LUX_STRING, "namedmaterial2", &noAlphaMatName);
   // if alpha is inverted, add name of underlying material as param
   // "namedmaterial2" and name of this material as param "namedmaterial1"
   } else {
     mixParamSet.addParam(LUX_STRING, "namedmaterial1", &noAlphaMatName);
-    mixParamSet.addParam(LUX_STRING, "namedmaterial2", &otherMatName);
+    mixParamSet.addParam(LUX_STRING, "namedmaterial2", (void*)&otherMatName);
   }
   // add amount parameter using the alpha channel texture and write mix material
   mixParamSet.addParam(LUX_TEXTURE, "amount", &alphaTexName);
@@ -292,9 +292,10 @@ Bool LuxMaterialData::sendToAPI(LuxAPI&            receiver,
 {
   // initialise parameter set (the maximum possible number of parameters is
   // channel count + 3 (material type, bump texture, bump sample distance)
-  // + number of additional parameters)
-  LuxParamSet paramSet(mInfo.mChannelCount + 3 +
-                         (addParams ? addParams->paramNumber() : 0));
+  // + number of additional parameters), which fits into the inline storage
+  // for all material types we have
+  LuxParamSetN<20> paramSet(mInfo.mChannelCount + 3 +
+                              (addParams ? addParams->paramNumber() : 0));
 
   // add material type to parameter set
   LuxString type(mInfo.mName);
@@ -303,6 +304,17 @@ Bool LuxMaterialData::sendToAPI(LuxAPI&            receiver,
   // add additional parameters
   if (addParams) { paramSet.add(*addParams); }
 
+  // simplify the texture graphs of all active channels, so that Lux has to
+  // evaluate fewer textures
+  for (ULONG channelIx=0; channelIx<mChannels.size(); ++channelIx) {
+    if (mChannels[channelIx].mEnabled) {
+      LuxTextureData::simplify(mChannels[channelIx].mTexture);
+    }
+  }
+  if (mBumpChannel.mEnabled)      LuxTextureData::simplify(mBumpChannel.mTexture);
+  if (mEmissionChannel.mEnabled)  LuxTextureData::simplify(mEmissionChannel.mTexture);
+  if (mAlphaChannel.mEnabled)     LuxTextureData::simplify(mAlphaChannel.mTexture);
+
   // loop over active channels, export their textures and add them to parameter
   // set
   FixArray1D<LuxString> textureNames(mChannels.size()+1);
@@ -390,7 +402,7 @@ Bool LuxMaterialData::sendToAPI(LuxAPI&            receiver,
   // if alpha channel is active, export its texture and create a mix material,
   // mixing the material with a null material
   if (mAlphaChannel.mEnabled) {
-    LuxParamSet mixParamSet(4);
+    LuxParamSetN<4> mixParamSet;
     // add type of mix material
     LuxString mixType("mix");
     mixParamSet.addParam(LUX_STRING, "type", &mixType);
@@ -443,7 +455,7 @@ LuxGlassData::LuxGlassData()
 Bool LuxGlassData::sendToAPI(LuxAPI&          receiver,
                              const LuxString& name)
 {
-  LuxParamSet extraParams(1);
+  LuxParamSetN<1> extraParams;
   return (extraParams.addParam(LUX_BOOL, "architectural", &mArchitectural) &&
             LuxMaterialData::sendToAPI(receiver,
                                        name,
@@ -565,7 +577,7 @@ LuxMetalData::LuxMetalData(void)
 Bool LuxMetalData::sendToAPI(LuxAPI&          receiver,
                              const LuxString& name)
 {
-  LuxParamSet extraParams(1);
+  LuxParamSetN<1> extraParams;
   LuxString   metalName;
   if (!mIsFilename) {
     convert2LuxString(mName, metalName);
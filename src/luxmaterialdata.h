@@ -106,12 +106,15 @@ struct LuxMaterialInfo
  This generic class is the base class for storing a Lux material. It implements
  most of the functionality for handling channel settings as they are always the
  same. The derived classes only contain the explicit description of the channels
- and additional parameters (if available).
+ and additional parameters (if available). The reference counter of
+ LuxMaterialDataH is embedded in the object.
 *//****************************************************************************/
-class LuxMaterialData
+class LuxMaterialData : public RefCounted
 {
 public:
 
+  virtual ~LuxMaterialData() {}
+
   Bool setChannel(ULONG           channelId,
                   LuxTextureDataH texture);
 
@@ -131,10 +134,10 @@ public:
   virtual Bool sendToAPI(LuxAPI&          receiver,
                          const LuxString& name);
   
-  Bool blendAndSendToAPI(LuxAPI&    receiver,
-                         LuxString& matName,
-                         LuxString& otherMatName,
-                         LuxString& blendMatName);
+  Bool blendAndSendToAPI(LuxAPI&          receiver,
+                         const LuxString& matName,
+                         const LuxString& otherMatName,
+                         const LuxString& blendMatName);
 
 
 protected:
@@ -40,48 +40,29 @@
 ///   The maximum number of parameters this set can store.
 LuxParamSet::LuxParamSet(LuxParamNumber maxParamNumber)
 : mMaxParamNumber(maxParamNumber),
-  mParamNumber(0)
+  mParamNumber(0),
+  mParamTypes(0),
+  mParamNames(0),
+  mParamValues(0),
+  mParamArraySizes(0),
+  mOwnsArrays(TRUE)
 {
-  // if the parameter number is too low:
-  if (mMaxParamNumber <= 0) {
-    // reset everything and return
-    mMaxParamNumber  = 0;
-    mParamTypes      = 0;
-    mParamNames      = 0;
-    mParamValues     = 0;
-    mParamArraySizes = 0;
-    ERRLOG_RETURN("LuxParamSet::LuxParamSet(): maxParamNumber was <= 0!");
-  }
+  allocateArrays();
+}
 
-  // allocated arrays for the parameter attributes and values
-  mParamTypes      = bNew LuxParamType[mMaxParamNumber];
-  mParamNames      = bNew LuxParamName[mMaxParamNumber];
-  mParamValues     = bNew LuxParamRef[mMaxParamNumber];
-  mParamArraySizes = bNew ULONG[mMaxParamNumber];
 
-  // if we couldn't allocate all arrays:
-  if (!mParamTypes || !mParamNames || !mParamValues || !mParamArraySizes) {
-    // reset and deallocate everything and return
+/// Destroys the parameter set and deallocates its resources.
+LuxParamSet::~LuxParamSet()
+{
+  if (mOwnsArrays) {
     bDelete(mParamTypes);
     bDelete(mParamNames);
     bDelete(mParamValues);
     bDelete(mParamArraySizes);
-    mMaxParamNumber = 0;
-    ERRLOG_RETURN("LuxParamSet::LuxParamSet(): not enough memory");
   }
 }
 
 
-/// Destroys the parameter set and deallocates its resources.
-LuxParamSet::~LuxParamSet()
-{
-  bDelete(mParamTypes);
-  bDelete(mParamNames);
-  bDelete(mParamValues);
-  bDelete(mParamArraySizes);
-}
-
-
 /// Adds a new parameter to the list. The data is still owned by the caller.
 ///
 /// @param[in]  type
@@ -140,7 +121,7 @@ Bool LuxParamSet::add(const LuxParamSet& other)
     ++mParamNumber;
   }
 
-  return FALSE;
+  return TRUE;
 }
 
 
@@ -149,3 +130,78 @@ void LuxParamSet::clear()
 {
   mParamNumber = 0;
 }
+
+
+
+/*****************************************************************************
+ * Implementation of protected member functions of class LuxParamSet.
+ *****************************************************************************/
+
+/// Constructs an empty parameter set, which uses arrays provided by a derived
+/// class (see LuxParamSetN), if they are large enough. Otherwise the arrays
+/// are allocated on the heap.
+///
+/// @param[in]  maxParamNumber
+///   The maximum number of parameters this set can store.
+/// @param[in]  inlineParamNumber
+///   The size of the provided arrays.
+/// @param[in]  inlineTypes, inlineNames, inlineValues, inlineArraySizes
+///   The provided arrays (not initialised yet).
+LuxParamSet::LuxParamSet(LuxParamNumber maxParamNumber,
+                         LuxParamNumber inlineParamNumber,
+                         LuxParamType*  inlineTypes,
+                         LuxParamName*  inlineNames,
+                         LuxParamRef*   inlineValues,
+                         ULONG*         inlineArraySizes)
+: mMaxParamNumber(maxParamNumber),
+  mParamNumber(0),
+  mParamTypes(0),
+  mParamNames(0),
+  mParamValues(0),
+  mParamArraySizes(0),
+  mOwnsArrays(FALSE)
+{
+  if ((maxParamNumber > 0) && (maxParamNumber <= inlineParamNumber)) {
+    mParamTypes      = inlineTypes;
+    mParamNames      = inlineNames;
+    mParamValues     = inlineValues;
+    mParamArraySizes = inlineArraySizes;
+  } else {
+    mOwnsArrays = TRUE;
+    allocateArrays();
+  }
+}
+
+
+
+/*****************************************************************************
+ * Implementation of private member functions of class LuxParamSet.
+ *****************************************************************************/
+
+/// Allocates the arrays for mMaxParamNumber parameters on the heap. If that
+/// fails, the set can't store any parameters.
+void LuxParamSet::allocateArrays(void)
+{
+  // if the parameter number is too low:
+  if (mMaxParamNumber <= 0) {
+    mMaxParamNumber = 0;
+    ERRLOG_RETURN("LuxParamSet::allocateArrays(): maxParamNumber was <= 0!");
+  }
+
+  // allocated arrays for the parameter attributes and values
+  mParamTypes      = bNew LuxParamType[mMaxParamNumber];
+  mParamNames      = bNew LuxParamName[mMaxParamNumber];
+  mParamValues     = bNew LuxParamRef[mMaxParamNumber];
+  mParamArraySizes = bNew ULONG[mMaxParamNumber];
+
+  // if we couldn't allocate all arrays:
+  if (!mParamTypes || !mParamNames || !mParamValues || !mParamArraySizes) {
+    // reset and deallocate everything and return
+    bDelete(mParamTypes);
+    bDelete(mParamNames);
+    bDelete(mParamValues);
+    bDelete(mParamArraySizes);
+    mMaxParamNumber = 0;
+    ERRLOG_RETURN("LuxParamSet::allocateArrays(): not enough memory");
+  }
+}
@@ -40,7 +40,8 @@
  structure as what the Lux API expects, they can be passed directly to it.
 
  The parameters are stored in fix-sized arrays as there will be only a limited
- amount of parameters per statement.
+ amount of parameters per statement. This class allocates the arrays on the
+ heap, LuxParamSetN stores them in the object itself.
 *//****************************************************************************/
 class LuxParamSet
 {
@@ -63,6 +64,16 @@ public:
   inline const ULONG*        paramArraySizes() const  { return mParamArraySizes; }
 
 
+protected:
+
+  LuxParamSet(LuxParamNumber maxParamNumber,
+              LuxParamNumber inlineParamNumber,
+              LuxParamType*  inlineTypes,
+              LuxParamName*  inlineNames,
+              LuxParamRef*   inlineValues,
+              ULONG*         inlineArraySizes);
+
+
 private:
 
   LuxParamNumber mMaxParamNumber;
@@ -71,11 +82,49 @@ private:
   LuxParamName*  mParamNames;
   LuxParamRef*   mParamValues;
   ULONG*         mParamArraySizes;
+  Bool           mOwnsArrays;
 
 
   LuxParamSet() {}
   LuxParamSet(const LuxParamSet& other) {}
   LuxParamSet& operator=(const LuxParamSet& other) {}
+
+  void allocateArrays(void);
+};
+
+
+
+/***************************************************************************//*!
+ A parameter set that stores up to N parameters in the object itself, i.e.
+ creating it on the stack doesn't touch the heap. If a set needs more than N
+ parameters, the arrays are allocated on the heap like in LuxParamSet. It can
+ be passed to everything that accepts a LuxParamSet.
+*//****************************************************************************/
+template <LuxParamNumber N>
+class LuxParamSetN : public LuxParamSet
+{
+public:
+
+  /// Constructs an empty parameter set.
+  ///
+  /// @param[in]  maxParamNumber
+  ///   The maximum number of parameters this set can store (default: N).
+  inline LuxParamSetN(LuxParamNumber maxParamNumber=N)
+  : LuxParamSet(maxParamNumber, N, mTypes, mNames, mValues, mArraySizes)
+  {}
+
+
+private:
+
+  LuxParamType mTypes[N];
+  LuxParamName mNames[N];
+  LuxParamRef  mValues[N];
+  ULONG        mArraySizes[N];
+
+
+  // We don't allow copying of parameter sets.
+  LuxParamSetN(const LuxParamSetN& other);
+  LuxParamSetN& operator=(const LuxParamSetN& other);
 };
 
 
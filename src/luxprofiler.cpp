@@ -0,0 +1,247 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include <cstdio>
+
+#include "luxprofiler.h"
+#include "utilities.h"
+
+
+
+/// The profiler that is currently recording or NULL if profiling is disabled.
+LuxProfiler* LuxProfiler::sProfiler = 0;
+
+
+
+/*****************************************************************************
+ * Implementation of public member functions of class LuxProfiler.
+ *****************************************************************************/
+
+/// Enables the profiler. Events that were recorded before are discarded.
+///
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool LuxProfiler::start(void)
+{
+  gDelete(sProfiler);
+  LuxProfiler* profiler = gNew LuxProfiler;
+  if (!profiler || !profiler->mLock) {
+    gDelete(profiler);
+    ERRLOG_RETURN_VALUE(FALSE, "LuxProfiler::start(): not enough memory to start profiler");
+  }
+  sProfiler = profiler;
+  return TRUE;
+}
+
+
+/// Disables the profiler and writes all recorded events into a trace file.
+///
+/// @param[in]  traceFile
+///   The file the events are written to.
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool LuxProfiler::stop(const Filename& traceFile)
+{
+  if (!sProfiler)  return TRUE;
+  LuxProfiler* profiler = sProfiler;
+  sProfiler = 0;
+  Bool success = profiler->writeTrace(traceFile);
+  gDelete(profiler);
+  return success;
+}
+
+
+/// Starts the recording of an event. Called by LuxProfileScope.
+///
+/// @param[in]  name
+///   The name of the event, which must stay valid until the profiler was
+///   stopped.
+/// @param[in]  receiver
+///   The receiver whose written bytes should be recorded (can be NULL).
+/// @return
+///   The new event or NULL if the profiler is disabled or we ran out of
+///   memory.
+LuxProfiler::Event* LuxProfiler::beginEvent(const char* name,
+                                            LuxAPI*     receiver)
+{
+  if (!sProfiler)  return 0;
+  Event* event = gNew Event;
+  if (!event)  return 0;
+  event->mName         = name;
+  event->mDuration     = 0.0;
+  event->mThread       = 0;
+  event->mPolygonCount = -1;
+  event->mReceiver     = receiver;
+  event->mBytesStart   = receiver ? receiver->bytesWritten() : 0;
+  event->mBytes        = 0;
+  event->mStart        = GeGetMilliSeconds();
+  return event;
+}
+
+
+/// Finishes the recording of an event and stores it in the event list of the
+/// profiler. Called by LuxProfileScope.
+///
+/// @param[in]  event
+///   The event returned by beginEvent(). It's owned by the profiler
+///   afterwards.
+void LuxProfiler::endEvent(Event* event)
+{
+  if (!event)  return;
+  event->mDuration = GeGetMilliSeconds() - event->mStart;
+  if (event->mReceiver) {
+    event->mBytes = event->mReceiver->bytesWritten() - event->mBytesStart;
+  }
+  if (!sProfiler) {
+    gDelete(event);
+    return;
+  }
+  sProfiler->mLock->Lock();
+  event->mThread = sProfiler->threadIndex(GeGetCurrentThread());
+  if (!sProfiler->mEvents.push(event))  gDelete(event);
+  sProfiler->mLock->UnLock();
+}
+
+
+/// Attaches the name and the polygon count (for polygon objects) of an object
+/// to an event.
+void LuxProfiler::setEventObject(Event&      event,
+                                 BaseObject& object)
+{
+  convert2LuxString(object.GetName(), event.mObject);
+  if (object.GetType() == Opolygon) {
+    event.mPolygonCount = ((PolygonObject&)object).GetPolygonCount();
+  }
+}
+
+
+
+/*****************************************************************************
+ * Implementation of private member functions of class LuxProfiler.
+ *****************************************************************************/
+
+/// Constructs a profiler, which uses the current time as the start time of
+/// the trace.
+LuxProfiler::LuxProfiler(void)
+: mStartTime(GeGetMilliSeconds())
+{}
+
+
+/// Destroys the profiler and all recorded events.
+LuxProfiler::~LuxProfiler(void)
+{
+  for (SizeT i=0; i<mEvents.size(); ++i) {
+    gDelete(mEvents[i]);
+  }
+}
+
+
+/// Returns a small index for a thread, which is used as thread ID in the trace.
+/// The lock of the profiler must be held by the caller.
+ULONG LuxProfiler::threadIndex(BaseThread* thread)
+{
+  for (SizeT i=0; i<mThreads.size(); ++i) {
+    if (mThreads[i] == thread)  return (ULONG)i;
+  }
+  mThreads.push(thread);
+  return (ULONG)(mThreads.size() - 1);
+}
+
+
+/// Writes all recorded events as complete events ("ph":"X") in the Chrome
+/// trace event format into a file.
+///
+/// @param[in]  traceFile
+///   The file to write.
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool LuxProfiler::writeTrace(const Filename& traceFile)
+{
+  AutoAlloc<BaseFile> file;
+  if (!file || !file->Open(traceFile, FILEOPEN_WRITE, FILEDIALOG_NONE)) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxProfiler::writeTrace(): could not open file '" + traceFile.GetString() + "'");
+  }
+
+  Bool      success = TRUE;
+  CHAR      buffer[256];
+  LuxString line("{\"traceEvents\":[\n");
+  for (SizeT i=0; success && (i<mEvents.size()); ++i) {
+    const Event& event = *mEvents[i];
+    sprintf(buffer,
+            "{\"name\":\"%s\",\"cat\":\"export\",\"ph\":\"X\",\"ts\":%.1f,\"dur\":%.1f,\"pid\":1,\"tid\":%u,\"args\":{",
+            event.mName,
+            (double)((event.mStart - mStartTime) * 1000.0),
+            (double)(event.mDuration * 1000.0),
+            (unsigned int)event.mThread);
+    line += buffer;
+    Bool firstArg = TRUE;
+    if (event.mObject.size()) {
+      line += "\"object\":\"" + escapeJSON(event.mObject) + "\"";
+      firstArg = FALSE;
+    }
+    if (event.mPolygonCount >= 0) {
+      sprintf(buffer, "%s\"polygons\":%d", firstArg ? "" : ",", (int)event.mPolygonCount);
+      line += buffer;
+      firstArg = FALSE;
+    }
+    if (event.mReceiver) {
+      sprintf(buffer, "%s\"bytes\":%llu", firstArg ? "" : ",", (unsigned long long)event.mBytes);
+      line += buffer;
+    }
+    line += (i+1 < mEvents.size()) ? "}},\n" : "}}\n";
+    success = file->WriteBytes(line.c_str(), (VLONG)line.size());
+    line.clear();
+  }
+  line += "]}\n";
+  success = success && file->WriteBytes(line.c_str(), (VLONG)line.size());
+  success &= file->Close();
+
+  if (!success) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxProfiler::writeTrace(): could not write file '" + traceFile.GetString() + "'");
+  }
+  return TRUE;
+}
+
+
+/// Escapes quotes, backslashes and control characters of a string, so it can
+/// be used as JSON string.
+LuxString LuxProfiler::escapeJSON(const LuxString& text)
+{
+  LuxString escaped;
+  CHAR      buffer[8];
+  for (SizeT i=0; i<text.size(); ++i) {
+    unsigned char c = (unsigned char)text[i];
+    if ((c == '"') || (c == '\\')) {
+      escaped += '\\';
+      escaped += (char)c;
+    } else if (c < 0x20) {
+      sprintf(buffer, "\\u%04x", (unsigned int)c);
+      escaped += buffer;
+    } else {
+      escaped += (char)c;
+    }
+  }
+  return escaped;
+}
@@ -0,0 +1,188 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __LUXPROFILER_H__
+#define __LUXPROFILER_H__  1
+
+
+
+#include <c4d.h>
+
+#include "common.h"
+#include "dynarray1d.h"
+#include "luxapi.h"
+
+
+
+/***************************************************************************//*!
+ This class records the time spent in the scopes of an export and writes them
+ into a trace file, which can be loaded into the trace viewer of Chrome
+ ("chrome://tracing").
+
+ The profiler is enabled by start() and disabled again by stop(), which writes
+ the trace file. Scopes are recorded by creating a LuxProfileScope on the
+ stack. While the profiler is disabled, a scope costs only the check of a
+ static pointer. The scopes can be recorded by any thread, but
+ start() and stop() must not be called while an export is running.
+*//****************************************************************************/
+class LuxProfiler
+{
+public:
+
+  /// Stores a single recorded scope.
+  struct Event {
+    const char* mName;
+    Real        mStart;
+    Real        mDuration;
+    ULONG       mThread;
+    LuxString   mObject;
+    LONG        mPolygonCount;
+    LuxAPI*     mReceiver;
+    VULONG      mBytesStart;
+    VULONG      mBytes;
+  };
+
+
+  static Bool start(void);
+  static Bool stop(const Filename& traceFile);
+  static inline Bool isEnabled(void);
+
+  static Event* beginEvent(const char* name,
+                           LuxAPI*     receiver);
+  static void endEvent(Event* event);
+  static void setEventObject(Event&      event,
+                             BaseObject& object);
+
+
+private:
+
+  typedef DynArray1D<Event*>      EventsT;
+  typedef DynArray1D<BaseThread*> ThreadsT;
+
+
+  static LuxProfiler* sProfiler;
+
+  AutoAlloc<Semaphore> mLock;
+  Real                 mStartTime;
+  EventsT              mEvents;
+  ThreadsT             mThreads;
+
+  LuxProfiler(void);
+  ~LuxProfiler(void);
+
+  ULONG threadIndex(BaseThread* thread);
+  Bool writeTrace(const Filename& traceFile);
+
+  static LuxString escapeJSON(const LuxString& text);
+};
+
+
+
+/***************************************************************************//*!
+ Records the time between its construction and its destruction as an event of
+ the profiler, if the profiler is enabled. If a receiver is passed, the number
+ of bytes it writes during the scope is stored in the event, too.
+*//****************************************************************************/
+class LuxProfileScope
+{
+public:
+
+  inline LuxProfileScope(const char* name,
+                         LuxAPI*     receiver=0);
+  inline ~LuxProfileScope(void);
+
+  inline void setObject(BaseObject& object);
+  inline void setObject(const LuxString& name,
+                        LONG             polygonCount=-1);
+
+
+private:
+
+  LuxProfiler::Event* mEvent;
+
+  LuxProfileScope(const LuxProfileScope& other);
+  LuxProfileScope& operator=(const LuxProfileScope& other);
+};
+
+
+
+/*****************************************************************************
+ * Inlined functions of LuxProfiler
+ *****************************************************************************/
+
+/// Returns TRUE if the profiler is recording.
+inline Bool LuxProfiler::isEnabled(void)
+{
+  return (sProfiler != 0);
+}
+
+
+
+/*****************************************************************************
+ * Inlined functions of LuxProfileScope
+ *****************************************************************************/
+
+/// Starts the recording of a scope, if the profiler is enabled.
+///
+/// @param[in]  name
+///   The name of the scope, which must stay valid until the profiler was
+///   stopped (i.e. it should be a literal).
+/// @param[in]  receiver  (optional)
+///   The receiver whose written bytes should be recorded.
+inline LuxProfileScope::LuxProfileScope(const char* name,
+                                        LuxAPI*     receiver)
+: mEvent(LuxProfiler::isEnabled() ? LuxProfiler::beginEvent(name, receiver) : 0)
+{}
+
+
+/// Finishes the recording of the scope.
+inline LuxProfileScope::~LuxProfileScope(void)
+{
+  if (mEvent)  LuxProfiler::endEvent(mEvent);
+}
+
+
+/// Attaches the name and the polygon count of an object to the recorded event.
+/// Nothing is done if the profiler is disabled.
+inline void LuxProfileScope::setObject(BaseObject& object)
+{
+  if (mEvent)  LuxProfiler::setEventObject(*mEvent, object);
+}
+
+
+/// Attaches an object name and optionally a polygon count to the recorded
+/// event. Nothing is done if the profiler is disabled.
+inline void LuxProfileScope::setObject(const LuxString& name,
+                                       LONG             polygonCount)
+{
+  if (mEvent) {
+    mEvent->mObject       = name;
+    mEvent->mPolygonCount = polygonCount;
+  }
+}
+
+
+
+#endif  // #ifndef __LUXPROFILER_H__
@@ -0,0 +1,309 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include <new>
+
+#include "luxsceneir.h"
+
+
+
+/// Clears a vector and releases its memory, which std::vector::clear()
+/// doesn't do.
+template <class T>
+static void releaseVector(std::vector<T>& vector)
+{
+  std::vector<T>().swap(vector);
+}
+
+
+
+/*****************************************************************************
+ * Implementation of member functions of class LuxSceneIR.
+ *****************************************************************************/
+
+// definition of the static constant, which is needed when it's bound to a
+// reference (e.g. by std::vector::push_back())
+const LuxSceneIR::IndexT LuxSceneIR::cInvalidIndex;
+
+
+/// Constructs an empty scene IR.
+LuxSceneIR::LuxSceneIR(void)
+{
+  clear();
+}
+
+
+/// Removes all data from the IR. The memory of the mesh data is released, as
+/// a single batch of meshes can be huge.
+void LuxSceneIR::clear(void)
+{
+  mTransformValues.clear();
+
+  mMeshPointBegin.assign(1, 0);
+  mMeshTriangleBegin.assign(1, 0);
+  mMeshQuadBegin.assign(1, 0);
+  mMeshHasNormals.clear();
+  mMeshHasUVs.clear();
+  releaseVector(mPoints);
+  releaseVector(mNormals);
+  releaseVector(mUVs);
+  releaseVector(mTriangles);
+  releaseVector(mQuads);
+
+  mMaterialIndices.clear();
+  mMaterialKeys.clear();
+
+  mInstanceNames.clear();
+  mInstanceMeshes.clear();
+  mInstanceTransforms.clear();
+  mInstanceMaterials.clear();
+  mInstancePortalMeshes.clear();
+  mInstanceFlags.clear();
+  mInstanceTextureResolutions.clear();
+  mInstanceShards.clear();
+  mInstanceChecksums.clear();
+  mInstanceDirtyChecksums.clear();
+  mInstanceSources.clear();
+}
+
+
+/// Adds a transformation matrix.
+///
+/// @param[in]  matrix
+///   The 16 values of the matrix in the layout of the Lux API.
+/// @return
+///   The index of the new transformation or cInvalidIndex if we ran out of
+///   memory.
+LuxSceneIR::IndexT LuxSceneIR::addTransform(const float* matrix)
+{
+  IndexT transform = transformCount();
+  try {
+    mTransformValues.insert(mTransformValues.end(), matrix, matrix+16);
+  } catch (std::bad_alloc&) {
+    mTransformValues.resize(transform*16);
+    return cInvalidIndex;
+  }
+  return transform;
+}
+
+
+/// Adds a mesh. All arrays are copied.
+///
+/// @param[in]  points
+///   The point positions (3 floats per point).
+/// @param[in]  pointCount
+///   The number of points.
+/// @param[in]  triangles
+///   The triangle point indices (3 per triangle, can be NULL).
+/// @param[in]  triangleIndexCount
+///   The number of triangle indices.
+/// @param[in]  quads
+///   The quad point indices (4 per quad, can be NULL).
+/// @param[in]  quadIndexCount
+///   The number of quad indices.
+/// @param[in]  normals
+///   The point normals (3 floats per point) or NULL if there are none.
+/// @param[in]  uvs
+///   The point UVs (2 floats per point) or NULL if there are none.
+/// @return
+///   The index of the new mesh or cInvalidIndex if we ran out of memory.
+LuxSceneIR::IndexT LuxSceneIR::addMesh(const float* points,
+                                       IndexT       pointCount,
+                                       const int*   triangles,
+                                       IndexT       triangleIndexCount,
+                                       const int*   quads,
+                                       IndexT       quadIndexCount,
+                                       const float* normals,
+                                       const float* uvs)
+{
+  IndexT mesh = meshCount();
+  try {
+    // reserve the begin entries first, so that nothing can fail after the
+    // data arrays have been extended
+    mMeshPointBegin.reserve(mesh+2);
+    mMeshTriangleBegin.reserve(mesh+2);
+    mMeshQuadBegin.reserve(mesh+2);
+    mMeshHasNormals.reserve(mesh+1);
+    mMeshHasUVs.reserve(mesh+1);
+    mPoints.insert(mPoints.end(), points, points + pointCount*3);
+    if (normals) {
+      mNormals.resize(mPoints.size() - pointCount*3);
+      mNormals.insert(mNormals.end(), normals, normals + pointCount*3);
+    }
+    if (uvs) {
+      mUVs.resize((mPoints.size()/3 - pointCount) * 2);
+      mUVs.insert(mUVs.end(), uvs, uvs + pointCount*2);
+    }
+    if (triangles) {
+      mTriangles.insert(mTriangles.end(), triangles, triangles + triangleIndexCount);
+    }
+    if (quads) {
+      mQuads.insert(mQuads.end(), quads, quads + quadIndexCount);
+    }
+  } catch (std::bad_alloc&) {
+    mPoints.resize(mMeshPointBegin[mesh]*3);
+    mTriangles.resize(mMeshTriangleBegin[mesh]);
+    mQuads.resize(mMeshQuadBegin[mesh]);
+    return cInvalidIndex;
+  }
+  mMeshPointBegin.push_back((IndexT)(mPoints.size() / 3));
+  mMeshTriangleBegin.push_back((IndexT)mTriangles.size());
+  mMeshQuadBegin.push_back((IndexT)mQuads.size());
+  mMeshHasNormals.push_back(normals != 0);
+  mMeshHasUVs.push_back(uvs != 0);
+  return mesh;
+}
+
+
+/// Returns the material for a key and adds it if it doesn't exist yet.
+///
+/// @param[in]  key
+///   An opaque key identifying the material (e.g. the object defining it).
+///   NULL is a valid key, too.
+/// @return
+///   The index of the material or cInvalidIndex if we ran out of memory.
+LuxSceneIR::IndexT LuxSceneIR::addMaterial(const void* key)
+{
+  std::map<const void*, IndexT>::const_iterator found = mMaterialIndices.find(key);
+  if (found != mMaterialIndices.end())  return found->second;
+
+  IndexT material = materialCount();
+  try {
+    mMaterialKeys.push_back(key);
+    mMaterialIndices[key] = material;
+  } catch (std::bad_alloc&) {
+    mMaterialKeys.resize(material);
+    return cInvalidIndex;
+  }
+  return material;
+}
+
+
+/// Adds an instance, i.e. the placement of a mesh and/or portal mesh.
+///
+/// @param[in]  name
+///   The name of the instance (UTF-8).
+/// @param[in]  mesh
+///   The mesh exported as shape or cInvalidIndex if there is none.
+/// @param[in]  transform
+///   The transformation of the meshes.
+/// @param[in]  material
+///   The material of the shape.
+/// @param[in]  portalMesh
+///   The mesh exported as portal shape or cInvalidIndex if there is none.
+/// @param[in]  flags
+///   A combination of InstanceFlags.
+/// @param[in]  textureResolution
+///   The texture resolution the instance needs on screen (0 = unknown).
+/// @return
+///   The index of the new instance or cInvalidIndex if we ran out of memory.
+LuxSceneIR::IndexT LuxSceneIR::addInstance(const std::string& name,
+                                           IndexT             mesh,
+                                           IndexT             transform,
+                                           IndexT             material,
+                                           IndexT             portalMesh,
+                                           unsigned int       flags,
+                                           int                textureResolution)
+{
+  IndexT instance = instanceCount();
+  try {
+    mInstanceNames.push_back(name);
+    mInstanceMeshes.push_back(mesh);
+    mInstanceTransforms.push_back(transform);
+    mInstanceMaterials.push_back(material);
+    mInstancePortalMeshes.push_back(portalMesh);
+    mInstanceFlags.push_back(flags);
+    mInstanceTextureResolutions.push_back(textureResolution);
+    mInstanceShards.push_back(std::string());
+    mInstanceChecksums.push_back(0);
+    mInstanceDirtyChecksums.push_back(0);
+    mInstanceSources.push_back(cInvalidIndex);
+  } catch (std::bad_alloc&) {
+    mInstanceNames.resize(instance);
+    mInstanceMeshes.resize(instance);
+    mInstanceTransforms.resize(instance);
+    mInstanceMaterials.resize(instance);
+    mInstancePortalMeshes.resize(instance);
+    mInstanceFlags.resize(instance);
+    mInstanceTextureResolutions.resize(instance);
+    mInstanceShards.resize(instance);
+    mInstanceChecksums.resize(instance);
+    mInstanceDirtyChecksums.resize(instance);
+    mInstanceSources.resize(instance);
+    return cInvalidIndex;
+  }
+  return instance;
+}
+
+
+/// Replaces the meshes and flags of an instance, e.g. when the meshes of a
+/// cached instance had to be converted later.
+///
+/// @param[in]  instance
+///   The index of the instance.
+/// @param[in]  mesh
+///   The mesh exported as shape or cInvalidIndex if there is none.
+/// @param[in]  portalMesh
+///   The mesh exported as portal shape or cInvalidIndex if there is none.
+/// @param[in]  flags
+///   A combination of InstanceFlags.
+void LuxSceneIR::setInstanceMeshes(IndexT       instance,
+                                   IndexT       mesh,
+                                   IndexT       portalMesh,
+                                   unsigned int flags)
+{
+  mInstanceMeshes[instance]       = mesh;
+  mInstancePortalMeshes[instance] = portalMesh;
+  mInstanceFlags[instance]        = flags;
+}
+
+
+/// Assigns an instance to a shard, i.e. a unit of the output that can be
+/// reused by the next export, if the checksum of the source data of the
+/// instance didn't change.
+///
+/// @param[in]  instance
+///   The index of the instance.
+/// @param[in]  shard
+///   The name of the shard.
+/// @param[in]  checksum
+///   The checksum of the source data of the instance.
+/// @param[in]  dirtyChecksum
+///   The checksum of the change state of the source data, which identifies
+///   the shard cheaply as long as the source doesn't change (0 = unknown).
+/// @param[in]  source
+///   The index of the source object of the instance in the data of the
+///   caller, which is needed to convert cached instances later.
+void LuxSceneIR::setInstanceShard(IndexT             instance,
+                                  const std::string& shard,
+                                  unsigned int       checksum,
+                                  unsigned int       dirtyChecksum,
+                                  IndexT             source)
+{
+  mInstanceShards[instance]         = shard;
+  mInstanceChecksums[instance]      = checksum;
+  mInstanceDirtyChecksums[instance] = dirtyChecksum;
+  mInstanceSources[instance]        = source;
+}
@@ -0,0 +1,372 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __LUXSCENEIR_H__
+#define __LUXSCENEIR_H__  1
+
+
+
+// NOTE: This file must not depend on the C4D SDK, i.e. it may only include
+//       standard headers. That allows building and testing it on its own.
+#include <map>
+#include <string>
+#include <vector>
+
+
+
+/***************************************************************************//*!
+ This class stores the geometry part of a converted scene in a compact form,
+ that doesn't depend on the C4D SDK: meshes, transformations, material
+ references and instances, which combine the three. All data is stored as
+ structure of arrays, i.e. each property of meshes, transformations etc. is
+ stored in its own array and an entity is just an index into these arrays.
+
+ The C4D side of the exporter (LuxAPIConverter) fills the IR while it walks
+ the collected objects and emits it whenever meshDataSize() exceeds a budget,
+ after which the IR is cleared. That keeps the memory usage bounded for scenes
+ with huge meshes.
+ Points, normals and UVs are stored in Lux coordinates as floats, triangles
+ and quads as point indices. Materials are only referenced by an opaque key,
+ as their conversion is done by the backend when they are emitted.
+*//****************************************************************************/
+class LuxSceneIR
+{
+public:
+
+  /// The type of all indices into the IR arrays.
+  typedef unsigned int IndexT;
+
+  /// Index value that means "no entry".
+  static const IndexT cInvalidIndex = 0xFFFFFFFFU;
+
+  /// Flags of an instance.
+  enum InstanceFlags {
+    /// the instance is exported as normal shape (otherwise only as portal)
+    INSTANCE_SHAPE       = 1,
+    /// the orientation of the portal shape is reversed
+    INSTANCE_PORTAL_FLIP = 2,
+    /// the instance has a portal shape (even if its mesh wasn't stored)
+    INSTANCE_PORTAL      = 4,
+    /// the meshes of the instance were not stored, as the output of a
+    /// previous export can probably be reused
+    INSTANCE_CACHED      = 8
+  };
+
+
+  LuxSceneIR(void);
+
+  void clear(void);
+
+  IndexT addTransform(const float* matrix);
+  inline IndexT transformCount(void) const;
+  inline const float* transform(IndexT transform) const;
+
+  IndexT addMesh(const float* points,
+                 IndexT       pointCount,
+                 const int*   triangles,
+                 IndexT       triangleIndexCount,
+                 const int*   quads,
+                 IndexT       quadIndexCount,
+                 const float* normals,
+                 const float* uvs);
+  inline IndexT meshCount(void) const;
+  inline IndexT meshPointCount(IndexT mesh) const;
+  inline const float* meshPoints(IndexT mesh) const;
+  inline const float* meshNormals(IndexT mesh) const;
+  inline const float* meshUVs(IndexT mesh) const;
+  inline IndexT meshTriangleIndexCount(IndexT mesh) const;
+  inline const int* meshTriangles(IndexT mesh) const;
+  inline IndexT meshQuadIndexCount(IndexT mesh) const;
+  inline const int* meshQuads(IndexT mesh) const;
+  inline size_t meshDataSize(void) const;
+
+  IndexT addMaterial(const void* key);
+  inline IndexT materialCount(void) const;
+  inline const void* materialKey(IndexT material) const;
+
+  IndexT addInstance(const std::string& name,
+                     IndexT             mesh,
+                     IndexT             transform,
+                     IndexT             material,
+                     IndexT             portalMesh,
+                     unsigned int       flags,
+                     int                textureResolution);
+  inline IndexT instanceCount(void) const;
+  inline const std::string& instanceName(IndexT instance) const;
+  inline IndexT instanceMesh(IndexT instance) const;
+  inline IndexT instanceTransform(IndexT instance) const;
+  inline IndexT instanceMaterial(IndexT instance) const;
+  inline IndexT instancePortalMesh(IndexT instance) const;
+  inline unsigned int instanceFlags(IndexT instance) const;
+  inline int instanceTextureResolution(IndexT instance) const;
+  void setInstanceMeshes(IndexT       instance,
+                         IndexT       mesh,
+                         IndexT       portalMesh,
+                         unsigned int flags);
+  void setInstanceShard(IndexT             instance,
+                        const std::string& shard,
+                        unsigned int       checksum,
+                        unsigned int       dirtyChecksum,
+                        IndexT             source);
+  inline const std::string& instanceShard(IndexT instance) const;
+  inline unsigned int instanceChecksum(IndexT instance) const;
+  inline unsigned int instanceDirtyChecksum(IndexT instance) const;
+  inline IndexT instanceSource(IndexT instance) const;
+
+
+private:
+
+  // transforms (16 floats per transform)
+  std::vector<float>        mTransformValues;
+
+  // meshes (the begin arrays store one more entry than there are meshes,
+  // i.e. the data of mesh m is in the range [begin[m], begin[m+1]) )
+  std::vector<IndexT>       mMeshPointBegin;
+  std::vector<IndexT>       mMeshTriangleBegin;
+  std::vector<IndexT>       mMeshQuadBegin;
+  std::vector<bool>         mMeshHasNormals;
+  std::vector<bool>         mMeshHasUVs;
+  std::vector<float>        mPoints;
+  std::vector<float>        mNormals;
+  std::vector<float>        mUVs;
+  std::vector<int>          mTriangles;
+  std::vector<int>          mQuads;
+
+  // materials
+  std::map<const void*, IndexT> mMaterialIndices;
+  std::vector<const void*>  mMaterialKeys;
+
+  // instances
+  std::vector<std::string>  mInstanceNames;
+  std::vector<IndexT>       mInstanceMeshes;
+  std::vector<IndexT>       mInstanceTransforms;
+  std::vector<IndexT>       mInstanceMaterials;
+  std::vector<IndexT>       mInstancePortalMeshes;
+  std::vector<unsigned int> mInstanceFlags;
+  std::vector<int>          mInstanceTextureResolutions;
+  std::vector<std::string>  mInstanceShards;
+  std::vector<unsigned int> mInstanceChecksums;
+  std::vector<unsigned int> mInstanceDirtyChecksums;
+  std::vector<IndexT>       mInstanceSources;
+};
+
+
+
+/*****************************************************************************
+ * Inlined functions of LuxSceneIR
+ *****************************************************************************/
+
+/// Returns the number of stored transformations.
+inline LuxSceneIR::IndexT LuxSceneIR::transformCount(void) const
+{
+  return (IndexT)(mTransformValues.size() / 16);
+}
+
+
+/// Returns the 16 values of a transformation matrix.
+inline const float* LuxSceneIR::transform(IndexT transform) const
+{
+  return &mTransformValues[transform*16];
+}
+
+
+/// Returns the number of stored meshes.
+inline LuxSceneIR::IndexT LuxSceneIR::meshCount(void) const
+{
+  return (IndexT)(mMeshPointBegin.size() - 1);
+}
+
+
+/// Returns the number of points of a mesh.
+inline LuxSceneIR::IndexT LuxSceneIR::meshPointCount(IndexT mesh) const
+{
+  return mMeshPointBegin[mesh+1] - mMeshPointBegin[mesh];
+}
+
+
+/// Returns the points of a mesh (3 floats per point).
+inline const float* LuxSceneIR::meshPoints(IndexT mesh) const
+{
+  return &mPoints[mMeshPointBegin[mesh]*3];
+}
+
+
+/// Returns the normals of a mesh (3 floats per point) or NULL if the mesh has
+/// no normals.
+inline const float* LuxSceneIR::meshNormals(IndexT mesh) const
+{
+  return mMeshHasNormals[mesh] ? &mNormals[mMeshPointBegin[mesh]*3] : 0;
+}
+
+
+/// Returns the UVs of a mesh (2 floats per point) or NULL if the mesh has
+/// no UVs.
+inline const float* LuxSceneIR::meshUVs(IndexT mesh) const
+{
+  return mMeshHasUVs[mesh] ? &mUVs[mMeshPointBegin[mesh]*2] : 0;
+}
+
+
+/// Returns the number of triangle indices (3 per triangle) of a mesh.
+inline LuxSceneIR::IndexT LuxSceneIR::meshTriangleIndexCount(IndexT mesh) const
+{
+  return mMeshTriangleBegin[mesh+1] - mMeshTriangleBegin[mesh];
+}
+
+
+/// Returns the triangle indices of a mesh or NULL if it has none.
+inline const int* LuxSceneIR::meshTriangles(IndexT mesh) const
+{
+  return meshTriangleIndexCount(mesh) ? &mTriangles[mMeshTriangleBegin[mesh]] : 0;
+}
+
+
+/// Returns the number of quad indices (4 per quad) of a mesh.
+inline LuxSceneIR::IndexT LuxSceneIR::meshQuadIndexCount(IndexT mesh) const
+{
+  return mMeshQuadBegin[mesh+1] - mMeshQuadBegin[mesh];
+}
+
+
+/// Returns the quad indices of a mesh or NULL if it has none.
+inline const int* LuxSceneIR::meshQuads(IndexT mesh) const
+{
+  return meshQuadIndexCount(mesh) ? &mQuads[mMeshQuadBegin[mesh]] : 0;
+}
+
+
+/// Returns the number of bytes used by the points, normals, UVs and indices of
+/// all stored meshes.
+inline size_t LuxSceneIR::meshDataSize(void) const
+{
+  return (mPoints.size() + mNormals.size() + mUVs.size()) * sizeof(float) +
+         (mTriangles.size() + mQuads.size()) * sizeof(int);
+}
+
+
+/// Returns the number of referenced materials.
+inline LuxSceneIR::IndexT LuxSceneIR::materialCount(void) const
+{
+  return (IndexT)mMaterialKeys.size();
+}
+
+
+/// Returns the key of a material, which was passed to addMaterial().
+inline const void* LuxSceneIR::materialKey(IndexT material) const
+{
+  return mMaterialKeys[material];
+}
+
+
+/// Returns the number of stored instances.
+inline LuxSceneIR::IndexT LuxSceneIR::instanceCount(void) const
+{
+  return (IndexT)mInstanceNames.size();
+}
+
+
+/// Returns the name of an instance (UTF-8).
+inline const std::string& LuxSceneIR::instanceName(IndexT instance) const
+{
+  return mInstanceNames[instance];
+}
+
+
+/// Returns the mesh of an instance or cInvalidIndex if it has none.
+inline LuxSceneIR::IndexT LuxSceneIR::instanceMesh(IndexT instance) const
+{
+  return mInstanceMeshes[instance];
+}
+
+
+/// Returns the transformation of an instance.
+inline LuxSceneIR::IndexT LuxSceneIR::instanceTransform(IndexT instance) const
+{
+  return mInstanceTransforms[instance];
+}
+
+
+/// Returns the material of an instance.
+inline LuxSceneIR::IndexT LuxSceneIR::instanceMaterial(IndexT instance) const
+{
+  return mInstanceMaterials[instance];
+}
+
+
+/// Returns the portal mesh of an instance or cInvalidIndex if it has none.
+inline LuxSceneIR::IndexT LuxSceneIR::instancePortalMesh(IndexT instance) const
+{
+  return mInstancePortalMeshes[instance];
+}
+
+
+/// Returns the flags (see InstanceFlags) of an instance.
+inline unsigned int LuxSceneIR::instanceFlags(IndexT instance) const
+{
+  return mInstanceFlags[instance];
+}
+
+
+/// Returns the texture resolution that was estimated for an instance or 0 if
+/// it's unknown.
+inline int LuxSceneIR::instanceTextureResolution(IndexT instance) const
+{
+  return mInstanceTextureResolutions[instance];
+}
+
+
+/// Returns the name of the shard (see setInstanceShard()) of an instance or
+/// an empty string if it has none.
+inline const std::string& LuxSceneIR::instanceShard(IndexT instance) const
+{
+  return mInstanceShards[instance];
+}
+
+
+/// Returns the checksum of the source data of an instance.
+inline unsigned int LuxSceneIR::instanceChecksum(IndexT instance) const
+{
+  return mInstanceChecksums[instance];
+}
+
+
+/// Returns the dirty checksum of the source data of an instance or 0 if it's
+/// unknown.
+inline unsigned int LuxSceneIR::instanceDirtyChecksum(IndexT instance) const
+{
+  return mInstanceDirtyChecksums[instance];
+}
+
+
+/// Returns the index of the source object of an instance in the data of the
+/// caller or cInvalidIndex if it wasn't set.
+inline LuxSceneIR::IndexT LuxSceneIR::instanceSource(IndexT instance) const
+{
+  return mInstanceSources[instance];
+}
+
+
+
+#endif  // #ifndef __LUXSCENEIR_H__
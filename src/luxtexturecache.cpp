@@ -0,0 +1,1193 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include "fixarray1d.h"
+#include "luxtexturecache.h"
+#include "utilities.h"
+
+
+
+/*****************************************************************************
+ * Implementation of public member functions of class LuxTextureCache.
+ *****************************************************************************/
+
+/// Constructs an empty and disabled texture cache.
+LuxTextureCache::LuxTextureCache(void)
+: mSourceCache(0),
+  mMaxResolution(0),
+  mMemoryBudget(0),
+  mMaxEnvironmentResolution(0),
+  mShaderResolution(0)
+{}
+
+
+/// Destroys the texture cache. The cached files are not touched.
+LuxTextureCache::~LuxTextureCache(void)
+{
+  erase();
+}
+
+
+/// Initialises the texture cache and creates the cache directory, if it
+/// doesn't exist yet. All previously registered images will be discarded.
+///
+/// @param[in]  cacheDirectory
+///   The directory where the processed copies will be stored.
+/// @param[in]  maxResolution
+///   The maximum width/height of a cached image. Larger images will be
+///   downscaled. If <= 0, the cache will be disabled.
+/// @param[in]  memoryBudget (optional)
+///   The memory budget in MB for all cached images. If <= 0, the memory usage
+///   is not limited.
+/// @param[in]  maxEnvironmentResolution (optional)
+///   The maximum width of cached environment maps. If <= 0, environment maps
+///   will not be cached.
+/// @param[in]  shaderResolution (optional)
+///   The width/height in which shaders get baked into images. If <= 0, shaders
+///   will not be baked.
+/// @return
+///   TRUE if successful, FALSE otherwise (the cache will then be disabled).
+Bool LuxTextureCache::init(const Filename& cacheDirectory,
+                           LONG            maxResolution,
+                           LONG            memoryBudget,
+                           LONG            maxEnvironmentResolution,
+                           LONG            shaderResolution)
+{
+  erase();
+  if (maxResolution <= 0)  return TRUE;
+
+  // create cache directory if needed
+  if (!GeFExist(cacheDirectory, TRUE) && !GeFCreateDir(cacheDirectory)) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::init(): could not create cache directory '" + cacheDirectory.GetString() + "'");
+  }
+
+  mCacheDirectory = cacheDirectory;
+  mMaxResolution  = maxResolution;
+  mMemoryBudget   = (memoryBudget > 0) ? memoryBudget : 0;
+  mMaxEnvironmentResolution = (maxEnvironmentResolution > 0) ? maxEnvironmentResolution : 0;
+  mShaderResolution = (shaderResolution > 0) ? shaderResolution : 0;
+  if (mShaderResolution > mMaxResolution)  mShaderResolution = mMaxResolution;
+  return TRUE;
+}
+
+
+/// Removes all registered images and disables the cache.
+void LuxTextureCache::erase(void)
+{
+  for (SizeT i=0; i<mImages.size(); ++i) {
+    gDelete(mImages[i]);
+  }
+  mImages.erase();
+  mImageIndices.erase();
+  mUsageLog.erase();
+  mCacheDirectory = Filename();
+  mMaxResolution  = 0;
+  mMemoryBudget   = 0;
+  mMaxEnvironmentResolution = 0;
+  mShaderResolution = 0;
+}
+
+
+/// Registers an image for processing and returns the path of its processed
+/// copy. The copy itself will be created later in processImages(). Every
+/// successful call is appended to the usage log.
+///
+/// @param[in]  imagePath
+///   The absolute path of the source image.
+/// @param[out]  cachedPath
+///   Receives the path of the processed copy or the source path, if the image
+///   can't be cached.
+/// @return
+///   TRUE if the image will be cached, FALSE if the source image should be
+///   used.
+Bool LuxTextureCache::addImage(const Filename& imagePath,
+                               Filename&       cachedPath)
+{
+  return registerImage(imagePath, FALSE, cachedPath);
+}
+
+
+/// Registers an environment map (latlong HDR image) for processing and returns
+/// the path of its processed copy. Environment maps are not recorded in the
+/// usage log.
+///
+/// @param[in]  imagePath
+///   The absolute path of the source image.
+/// @param[out]  cachedPath
+///   Receives the path of the processed copy or the source path, if the image
+///   can't be cached.
+/// @return
+///   TRUE if the image will be cached, FALSE if the source image should be
+///   used.
+Bool LuxTextureCache::addEnvironmentMap(const Filename& imagePath,
+                                        Filename&       cachedPath)
+{
+  if (mMaxEnvironmentResolution <= 0) {
+    cachedPath = imagePath;
+    return FALSE;
+  }
+  return registerImage(imagePath, TRUE, cachedPath);
+}
+
+
+/// Registers a shader, that will be baked into an image, and returns the path
+/// of that image. The shader must stay alive until processImages() returned.
+/// Every successful call is appended to the usage log.
+///
+/// @param[in]  shader
+///   The shader to bake.
+/// @param[out]  cachedPath
+///   Receives the path of the baked image.
+/// @return
+///   TRUE if the shader will be baked, FALSE otherwise.
+Bool LuxTextureCache::addShader(BaseShader& shader,
+                                Filename&   cachedPath)
+{
+  cachedPath = Filename();
+  if (!bakesShaders())  return FALSE;
+
+  // the key is built from the position of the shader in its material, which
+  // makes the image name stable across sessions - different shaders with the
+  // same position (e.g. in materials with the same name) get a suffix
+  String path(shaderPath(shader));
+  String key("shader:" + path);
+  if (mSourceCache) {
+    // a shader path that was ambiguous in the source document can't be
+    // mapped to the right baked image
+    if (mSourceCache->mImageIndices.get(key + "#1"))  return FALSE;
+    return mSourceCache->findProcessedImage(key, cachedPath);
+  }
+  const SizeT* index;
+  for (LONG suffix=1; (index = mImageIndices.get(key)) != 0; ++suffix) {
+    if (mImages[*index]->mShader == &shader) {
+      if (!mUsageLog.push(*index)) {
+        ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::addShader(): not enough memory to store usage log entry");
+      }
+      cachedPath = mImages[*index]->mCachedPath;
+      return TRUE;
+    }
+    key = "shader:" + path + "#" + LongToString(suffix);
+  }
+
+  // create new entry
+  BaseDocument* document = shader.GetDocument();
+  const ULONG* shaderDirty = mShaderChecksums.get(path);
+  Image* image = gNew Image;
+  if (!image) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::addShader(): not enough memory to allocate image entry");
+  }
+  LuxString keyStr;
+  convert2LuxString(key, keyStr);
+  CHAR name[32];
+  sprintf(name, "%08x_shader.png", (unsigned int)hashBytes(keyStr.c_str(), keyStr.size(), 2166136261U));
+  image->mCachedPath.SetDirectory(mCacheDirectory);
+  image->mCachedPath.SetFile(Filename(name));
+  image->mFilterID            = FILTER_PNG;
+  image->mMaxResolution       = mShaderResolution;
+  image->mRequestedResolution = 0;
+  image->mTargetResolution    = mShaderResolution;
+  image->mSourceMemoryKB      = 0;
+  image->mCachedMemoryKB      = 0;
+  image->mShader              = &shader;
+  image->mShaderDirty         = shaderDirty ? *shaderDirty : 0;
+  image->mShaderTime          = document ? document->GetTime().Get() : 0.0;
+  image->mShaderReady         = FALSE;
+  image->mEnvironment         = FALSE;
+  image->mSuccess             = FALSE;
+  image->mSourcePath          = Filename(path);
+  if (!storeImage(image, key, TRUE))  return FALSE;
+
+  cachedPath = image->mCachedPath;
+  return TRUE;
+}
+
+
+/// Records the dirty checksums of all shader trees of the materials of a
+/// document, which are used by the next export to decide if a baked shader is
+/// still current. As the export converts a copy of the document, this has to
+/// be called in the main thread with the original document before the copy is
+/// made. The checksums replace the ones recorded before and are kept by init()
+/// and erase().
+///
+/// @param[in]  document
+///   The original document.
+/// @param[in]  sessionToken
+///   The token of the current session, which is included in each checksum, as
+///   dirty counts are only valid during a session.
+void LuxTextureCache::recordShaderChecksums(BaseDocument& document,
+                                            ULONG         sessionToken)
+{
+  mShaderChecksums.erase();
+  for (BaseMaterial* material=document.GetFirstMaterial(); material; material=material->GetNext()) {
+    for (BaseShader* shader=material->GetFirstShader(); shader; shader=shader->GetNext()) {
+      recordShaderTree(*shader, sessionToken);
+    }
+  }
+}
+
+
+/// Appends a range of the usage log to the end of the log again. This is used
+/// when already exported images are referenced again, e.g. by a reused
+/// material, so that their usage can be found in a contiguous log range.
+///
+/// @param[in]  begin
+///   The index of the first log entry to repeat.
+/// @param[in]  end
+///   The index after the last log entry to repeat.
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool LuxTextureCache::repeatUsage(SizeT begin,
+                                  SizeT end)
+{
+  if (end > mUsageLog.size())  end = mUsageLog.size();
+  for (SizeT i=begin; i<end; ++i) {
+    if (!mUsageLog.push(mUsageLog[i])) {
+      ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::repeatUsage(): not enough memory to store usage log entry");
+    }
+  }
+  return TRUE;
+}
+
+
+/// Requests a minimum resolution for all images in a range of the usage log.
+/// An image will be cached with the largest resolution requested for it, but
+/// never larger than the maximum resolution.
+///
+/// @param[in]  begin
+///   The index of the first log entry.
+/// @param[in]  end
+///   The index after the last log entry.
+/// @param[in]  resolution
+///   The requested width/height in pixels. If <= 0, the maximum resolution
+///   will be requested.
+void LuxTextureCache::requestResolution(SizeT begin,
+                                        SizeT end,
+                                        LONG  resolution)
+{
+  if ((resolution <= 0) || (resolution > mMaxResolution)) {
+    resolution = mMaxResolution;
+  }
+  if (end > mUsageLog.size())  end = mUsageLog.size();
+  for (SizeT i=begin; i<end; ++i) {
+    Image* image = mImages[mUsageLog[i]];
+    if (image->mRequestedResolution < resolution) {
+      image->mRequestedResolution = resolution;
+    }
+  }
+}
+
+
+/// Processes all registered images, unless processing was disabled. The images
+/// are distributed over one worker thread per CPU and the function returns
+/// after all threads have finished.
+///
+/// @return
+///   TRUE if all images could be processed or copied, FALSE otherwise.
+Bool LuxTextureCache::processImages(void)
+{
+  if (!mImages.size())  return TRUE;
+
+  // determine the resolution every image will be cached with and prepare
+  // the shaders that will be baked
+  determineTargetResolutions();
+  initShaders();
+
+  // determine number of worker threads
+  SizeT threadCount = (SizeT)GeGetCPUCount();
+  if (threadCount < 1)  threadCount = 1;
+  if (threadCount > mImages.size())  threadCount = mImages.size();
+
+  // start workers - if a thread can't be started, its images will be
+  // processed by us after the other threads were started
+  FixArray1D<Worker> workers;
+  FixArray1D<Bool>   started;
+  if (!workers.init(threadCount) || !started.init(threadCount)) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::processImages(): not enough memory to allocate worker threads");
+  }
+  for (SizeT t=0; t<threadCount; ++t) {
+    workers[t].mCache  = this;
+    workers[t].mFirst  = t;
+    workers[t].mStride = threadCount;
+    started[t] = workers[t].Start(THREADMODE_ASYNC, THREADPRIORITY_BELOW);
+  }
+  for (SizeT t=0; t<threadCount; ++t) {
+    if (!started[t])  processImageRange(t, threadCount, 0);
+  }
+
+  // wait for all workers
+  for (SizeT t=0; t<threadCount; ++t) {
+    if (started[t])  workers[t].Wait(FALSE);
+  }
+  freeShaders();
+
+  // report images that couldn't be processed
+  Bool success = TRUE;
+  for (SizeT i=0; i<mImages.size(); ++i) {
+    if (!mImages[i]->mSuccess) {
+      ERRLOG("LuxTextureCache::processImages(): could not process image '" + mImages[i]->mSourcePath.GetString() + "'");
+      success = FALSE;
+    }
+  }
+
+  reportMemoryUsage();
+  return success;
+}
+
+
+
+/*****************************************************************************
+ * Implementation of private member functions of class LuxTextureCache.
+ *****************************************************************************/
+
+/// Registers an image or environment map. If the image was already registered,
+/// its existing entry is used.
+///
+/// @param[in]  imagePath
+///   The absolute path of the source image.
+/// @param[in]  environment
+///   TRUE if the image is an environment map.
+/// @param[out]  cachedPath
+///   Receives the path of the processed copy or the source path, if the image
+///   can't be cached.
+/// @return
+///   TRUE if the image will be cached, FALSE if the source image should be
+///   used.
+Bool LuxTextureCache::registerImage(const Filename& imagePath,
+                                    Bool            environment,
+                                    Filename&       cachedPath)
+{
+  // by default we use the original image
+  cachedPath = imagePath;
+  if (!isEnabled() || !imagePath.Content() || !GeFExist(imagePath)) {
+    return FALSE;
+  }
+
+  // we can only cache images that we are able to write again
+  LONG filterID = environment ? environmentFilterFromSuffix(imagePath) :
+                                filterFromSuffix(imagePath);
+  if (!filterID)  return FALSE;
+
+  // if the image was already registered, just return its cached path
+  // (environment maps get their own entries, as they are processed differently)
+  String key(imagePath.GetString());
+  if (environment)  key = "env:" + key;
+  if (mSourceCache)  return mSourceCache->findProcessedImage(key, cachedPath);
+  const SizeT* index = mImageIndices.get(key);
+  if (index) {
+    if (!environment && !mUsageLog.push(*index)) {
+      ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::registerImage(): not enough memory to store usage log entry");
+    }
+    cachedPath = mImages[*index]->mCachedPath;
+    return TRUE;
+  }
+
+  // create new entry, which gets a unique name by prefixing the filename with
+  // the hash of the key
+  Image* image = gNew Image;
+  if (!image) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::registerImage(): not enough memory to allocate image entry");
+  }
+  LuxString keyStr;
+  convert2LuxString(key, keyStr);
+  CHAR prefix[16];
+  sprintf(prefix, "%08x_", (unsigned int)hashBytes(keyStr.c_str(), keyStr.size(), 2166136261U));
+  image->mSourcePath = imagePath;
+  image->mCachedPath.SetDirectory(mCacheDirectory);
+  image->mCachedPath.SetFile(Filename(String(prefix) + imagePath.GetFileString()));
+  image->mFilterID            = filterID;
+  image->mMaxResolution       = environment ? mMaxEnvironmentResolution : mMaxResolution;
+  image->mRequestedResolution = 0;
+  image->mTargetResolution    = image->mMaxResolution;
+  image->mSourceMemoryKB      = 0;
+  image->mCachedMemoryKB      = 0;
+  image->mShader              = 0;
+  image->mShaderDirty         = 0;
+  image->mShaderTime          = 0.0;
+  image->mShaderReady         = FALSE;
+  image->mEnvironment         = environment;
+  image->mSuccess             = FALSE;
+  if (!storeImage(image, key, !environment))  return FALSE;
+
+  cachedPath = image->mCachedPath;
+  return TRUE;
+}
+
+
+/// Stores a new image entry and its index. If that fails, the entry will be
+/// deleted.
+///
+/// @param[in]  image
+///   The new image entry (we take ownership of it).
+/// @param[in]  key
+///   The key under which the entry can be found again.
+/// @param[in]  logUsage
+///   TRUE if the image should be appended to the usage log.
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool LuxTextureCache::storeImage(Image*        image,
+                                 const String& key,
+                                 Bool          logUsage)
+{
+  if (!mImages.push(image)) {
+    gDelete(image);
+    ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::storeImage(): not enough memory to store image entry");
+  }
+  if (!mImageIndices.add(key, mImages.size()-1)) {
+    gDelete(image);
+    mImages.pop();
+    ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::storeImage(): not enough memory to store image index");
+  }
+  if (logUsage && !mUsageLog.push(mImages.size()-1)) {
+    ERRLOG_RETURN_VALUE(FALSE, "LuxTextureCache::storeImage(): not enough memory to store usage log entry");
+  }
+  return TRUE;
+}
+
+
+/// Looks up an image that was processed by this cache, which is used by caches
+/// that take their images from it.
+///
+/// @param[in]  key
+///   The key under which the image was stored.
+/// @param[out]  cachedPath
+///   Receives the path of the processed copy, if the image was processed
+///   successfully. Otherwise it's not changed.
+/// @return
+///   TRUE if the image was found and processed, FALSE otherwise.
+Bool LuxTextureCache::findProcessedImage(const String& key,
+                                         Filename&     cachedPath) const
+{
+  const SizeT* index = mImageIndices.get(key);
+  if (!index || !mImages[*index]->mSuccess)  return FALSE;
+  cachedPath = mImages[*index]->mCachedPath;
+  return TRUE;
+}
+
+
+/// Determines the target resolution of every image. Images without requested
+/// resolution (e.g. because we couldn't estimate it) use their maximum
+/// resolution, all others the next power of two of the requested resolution.
+/// If a memory budget is set, the largest targets are halved until the
+/// estimated memory usage (4 bytes per pixel of a square image) fits into the
+/// budget or all images reached the minimum resolution. Environment maps keep
+/// the maximum environment resolution.
+void LuxTextureCache::determineTargetResolutions(void)
+{
+  // round requested resolutions up to the next power of two
+  for (SizeT i=0; i<mImages.size(); ++i) {
+    Image& image = *mImages[i];
+    if (image.mEnvironment)  continue;
+    LONG target = image.mMaxResolution;
+    if (image.mRequestedResolution > 0) {
+      target = cMinResolution;
+      while ((target < image.mRequestedResolution) && (target < image.mMaxResolution)) {
+        target *= 2;
+      }
+      if (target > image.mMaxResolution)  target = image.mMaxResolution;
+    }
+    image.mTargetResolution = target;
+  }
+
+  // reduce the largest images until the estimate fits into the budget
+  if (mMemoryBudget <= 0)  return;
+  LReal budget = (LReal)mMemoryBudget * 1024.0 * 1024.0;
+  for (;;) {
+    LReal memory = 0.0;
+    LONG  largest = 0;
+    for (SizeT i=0; i<mImages.size(); ++i) {
+      if (mImages[i]->mEnvironment)  continue;
+      LReal resolution = (LReal)mImages[i]->mTargetResolution;
+      memory += resolution * resolution * 4.0;
+      if (mImages[i]->mTargetResolution > largest) {
+        largest = mImages[i]->mTargetResolution;
+      }
+    }
+    if ((memory <= budget) || (largest <= cMinResolution))  break;
+    for (SizeT i=0; i<mImages.size(); ++i) {
+      if (!mImages[i]->mEnvironment && (mImages[i]->mTargetResolution == largest)) {
+        mImages[i]->mTargetResolution = largest / 2;
+      }
+    }
+  }
+}
+
+
+/// Records the dirty checksum of a shader and all its child shaders under
+/// their shader paths. If two shaders have the same path (e.g. because their
+/// materials have the same name), the path gets the checksum 0, i.e. its baked
+/// image is never treated as current.
+///
+/// @param[in]  shader
+///   The shader to record.
+/// @param[in]  sessionToken
+///   The token of the current session.
+void LuxTextureCache::recordShaderTree(BaseShader& shader,
+                                       ULONG       sessionToken)
+{
+  String path(shaderPath(shader));
+  ULONG* checksum = mShaderChecksums.get(path);
+  if (checksum) {
+    *checksum = 0;
+  } else if (!mShaderChecksums.add(path, shaderDirtyChecksum(shader, sessionToken))) {
+    ERRLOG("LuxTextureCache::recordShaderTree(): not enough memory to store shader checksum");
+  }
+  for (BaseShader* child=shader.GetDown(); child; child=child->GetNext()) {
+    recordShaderTree(*child, sessionToken);
+  }
+}
+
+
+/// Prepares all registered shaders for sampling, before the workers are
+/// started. This runs in the thread that runs the export, which is usually
+/// not the main thread. That is safe, as the shaders belong to the private
+/// copy of the document the export converts, which no other thread accesses
+/// (C4D's renderer initialises the shaders of its document copy in its own
+/// thread, too). Shaders that can't be initialised will fail later during
+/// processing.
+void LuxTextureCache::initShaders(void)
+{
+  for (SizeT i=0; i<mImages.size(); ++i) {
+    Image& image = *mImages[i];
+    if (!image.mShader)  continue;
+    BaseDocument* document = image.mShader->GetDocument();
+    if (!document)  continue;
+    InitRenderStruct irs;
+    irs.doc     = document;
+    irs.docpath = document->GetDocumentPath();
+    irs.time    = document->GetTime();
+    irs.fps     = document->GetFps();
+    image.mShaderReady = (image.mShader->InitRender(irs) == INITRENDERRESULT_OK);
+  }
+}
+
+
+/// Releases the render data of all shaders that were initialised by
+/// initShaders().
+void LuxTextureCache::freeShaders(void)
+{
+  for (SizeT i=0; i<mImages.size(); ++i) {
+    if (mImages[i]->mShaderReady) {
+      mImages[i]->mShader->FreeRender();
+      mImages[i]->mShaderReady = FALSE;
+    }
+  }
+}
+
+
+/// Prints the memory the cached images will need compared to the originals.
+void LuxTextureCache::reportMemoryUsage(void)
+{
+  LReal sourceMB = 0.0;
+  LReal cachedMB = 0.0;
+  for (SizeT i=0; i<mImages.size(); ++i) {
+    if (!mImages[i]->mSuccess)  continue;
+    sourceMB += (LReal)mImages[i]->mSourceMemoryKB / 1024.0;
+    cachedMB += (LReal)mImages[i]->mCachedMemoryKB / 1024.0;
+  }
+
+  CHAR buffer[256];
+  sprintf(buffer,
+          "LuxC4D texture cache: %d image(s) need %.1f MB instead of %.1f MB (%.1f MB saved)",
+          (int)mImages.size(), cachedMB, sourceMB, sourceMB-cachedMB);
+  GePrint(buffer);
+}
+
+
+/// Processes every stride-th image starting with image "first".
+///
+/// @param[in]  first
+///   The index of the first image to process.
+/// @param[in]  stride
+///   The index distance between two images to process.
+/// @param[in]  thread
+///   The thread we are running in, which is used for checking if we should
+///   stop. Can be NULL.
+void LuxTextureCache::processImageRange(SizeT       first,
+                                        SizeT       stride,
+                                        BaseThread* thread)
+{
+  for (SizeT i=first; i<mImages.size(); i+=stride) {
+    if (thread && thread->TestBreak())  break;
+    mImages[i]->mSuccess = processImage(*mImages[i]);
+  }
+}
+
+
+/// Creates the cached copy of a single image. If the stamp of an existing copy
+/// matches the source file, nothing will be done. If the image is larger than
+/// its target resolution, it will be downscaled. Otherwise it will be copied.
+/// Environment maps are downscaled to the target width in float precision.
+///
+/// @param[in]  image
+///   The image entry to process.
+/// @return
+///   TRUE if the cached copy exists afterwards, FALSE otherwise.
+Bool LuxTextureCache::processImage(Image& image)
+{
+  // shaders are baked and not loaded
+  if (image.mShader)  return bakeShader(image);
+
+  // if size and modification time of the source file are the same as last
+  // time, the cached copy is up to date and we don't have to read the source
+  LONG     targetRes = image.mTargetResolution;
+  Filename stamp(stampPath(image.mCachedPath));
+  Bool     cachedExists = GeFExist(image.mCachedPath);
+  ULONG    sourceStamp = fileStamp(image.mSourcePath, targetRes);
+  if (cachedExists && sourceStamp && checkStamp(stamp, 0, sourceStamp, image)) {
+    return TRUE;
+  }
+
+  // hash source file and processing settings
+  ULONG hash;
+  if (!hashFile(image.mSourcePath, hash))  return FALSE;
+  hash = hashBytes(&targetRes, sizeof(targetRes), hash);
+
+  // if only the file stamp has changed (e.g. because the file was touched),
+  // update the stamp of the cached copy
+  if (cachedExists && checkStamp(stamp, hash, 0, image)) {
+    writeStamp(stamp, hash, sourceStamp, image);
+    return TRUE;
+  }
+
+  // load source image
+  AutoAlloc<BaseBitmap> bitmap;
+  Bool scaled = FALSE;
+  if (bitmap && (bitmap->Init(image.mSourcePath) == IMAGERESULT_OK)) {
+
+    // environment maps are scaled in float precision, all other images keep
+    // their bit depth and alpha channel
+    LONG width  = bitmap->GetBw();
+    LONG height = bitmap->GetBh();
+    image.mSourceMemoryKB = imageMemoryKB(width, height, bitmap->GetBt());
+    image.mCachedMemoryKB = image.mSourceMemoryKB;
+    if (image.mEnvironment) {
+      scaled = scaleEnvironmentMap(*bitmap, image);
+    } else if ((width > targetRes) || (height > targetRes)) {
+      scaled = scaleImage(*bitmap, image);
+    }
+  }
+
+  // if we haven't written a downscaled version, copy the original
+  if (!scaled) {
+    ULONG copyHash;
+    if (!copyFile(image.mSourcePath, image.mCachedPath, copyHash))  return FALSE;
+  }
+
+  // store stamp - if that fails we will just process the image again next time
+  writeStamp(stamp, hash, sourceStamp, image);
+  return TRUE;
+}
+
+
+/// Downscales an image to its target resolution, keeping its aspect ratio.
+/// Images with 8 bit per channel and without alpha channel are scaled with
+/// ScaleIt(). All others keep their bit depth and alpha channel, which needs
+/// the bicubic scaler of R12 and later - older versions copy them unscaled
+/// and log that, as they are then larger than their share of the memory
+/// budget.
+///
+/// @param[in]  bitmap
+///   The loaded source image.
+/// @param[in]  image
+///   The image entry of the image.
+/// @return
+///   TRUE if the downscaled copy was written, FALSE if it failed (the source
+///   should be copied then).
+Bool LuxTextureCache::scaleImage(BaseBitmap& bitmap,
+                                 Image&      image)
+{
+  // determine new size, keeping the aspect ratio
+  LONG width     = bitmap.GetBw();
+  LONG height    = bitmap.GetBh();
+  LONG targetRes = image.mTargetResolution;
+  LONG newWidth, newHeight;
+  if (width >= height) {
+    newWidth  = targetRes;
+    newHeight = (LONG)((LReal)height * targetRes / width + 0.5);
+  } else {
+    newHeight = targetRes;
+    newWidth  = (LONG)((LReal)width * targetRes / height + 0.5);
+  }
+  if (newWidth < 1)   newWidth = 1;
+  if (newHeight < 1)  newHeight = 1;
+
+  // 8 bit images without alpha channel are scaled into a 24 bit bitmap
+  LONG                  depth = bitmap.GetBt();
+  Bool                  hasAlpha = (bitmap.GetChannelCount() > 0);
+  AutoAlloc<BaseBitmap> scaledBitmap;
+  if (!scaledBitmap)  return FALSE;
+  if ((depth <= 24) && !hasAlpha) {
+    if (scaledBitmap->Init(newWidth, newHeight, 24) != IMAGERESULT_OK)  return FALSE;
+    bitmap.ScaleIt(scaledBitmap, 256, TRUE, FALSE);
+    if (scaledBitmap->Save(image.mCachedPath, image.mFilterID, 0, SAVEBIT_0) != IMAGERESULT_OK) {
+      return FALSE;
+    }
+    image.mCachedMemoryKB = imageMemoryKB(newWidth, newHeight, 24);
+    return TRUE;
+  }
+
+#if _C4D_VERSION>=120
+  // all other images are scaled bicubic into a bitmap with the same number of
+  // bits per channel, the alpha channel separately into its own channel
+  LONG    scaledDepth = 24;
+  SAVEBIT saveFlags = SAVEBIT_0;
+  if (depth > 48) {
+    scaledDepth = 96;
+    saveFlags   = SAVEBIT_32BITCHANNELS;
+  } else if (depth > 32) {
+    scaledDepth = 48;
+    saveFlags   = SAVEBIT_16BITCHANNELS;
+  }
+  if (scaledBitmap->Init(newWidth, newHeight, scaledDepth) != IMAGERESULT_OK) {
+    return FALSE;
+  }
+  bitmap.ScaleBicubic(scaledBitmap, 0, 0, width-1, height-1, 0, 0, newWidth-1, newHeight-1);
+  LONG scaledBits = scaledDepth;
+  if (hasAlpha) {
+    BaseBitmap* alpha = bitmap.GetInternalChannel();
+    BaseBitmap* scaledAlpha = scaledBitmap->AddChannel(TRUE, FALSE);
+    if (!alpha || !scaledAlpha)  return FALSE;
+    alpha->ScaleBicubic(scaledAlpha, 0, 0, width-1, height-1, 0, 0, newWidth-1, newHeight-1);
+    saveFlags   = saveFlags | SAVEBIT_ALPHA;
+    scaledBits += scaledDepth / 3;
+  }
+  if (scaledBitmap->Save(image.mCachedPath, image.mFilterID, 0, saveFlags) != IMAGERESULT_OK) {
+    return FALSE;
+  }
+  image.mCachedMemoryKB = imageMemoryKB(newWidth, newHeight, scaledBits);
+  return TRUE;
+#else
+  GePrint("LuxC4D texture cache: '" + image.mSourcePath.GetString() +
+          "' has an alpha channel or more than 8 bit per channel and can't be scaled, so it's copied with its full resolution");
+  return FALSE;
+#endif
+}
+
+
+/// Downscales an environment map to its target width, keeping its aspect ratio
+/// and its float precision. Float bitmaps can only be scaled with the bicubic
+/// scaler of R12 and later, older versions will always copy the source file.
+///
+/// @param[in]  bitmap
+///   The loaded source image.
+/// @param[in]  image
+///   The image entry of the environment map.
+/// @return
+///   TRUE if the downscaled copy was written, FALSE if it wasn't necessary or
+///   failed (the source should be copied then).
+Bool LuxTextureCache::scaleEnvironmentMap(BaseBitmap& bitmap,
+                                          Image&      image)
+{
+#if _C4D_VERSION>=120
+  LONG width  = bitmap.GetBw();
+  LONG height = bitmap.GetBh();
+  if (width <= image.mTargetResolution)  return FALSE;
+
+  // determine new size
+  LONG newWidth  = image.mTargetResolution;
+  LONG newHeight = (LONG)((LReal)height * newWidth / width + 0.5);
+  if (newHeight < 1)  newHeight = 1;
+
+  // scale into a float bitmap and save it in the format of the source
+  AutoAlloc<BaseBitmap> scaledBitmap;
+  if (!scaledBitmap ||
+      (scaledBitmap->Init(newWidth, newHeight, 96) != IMAGERESULT_OK))
+  {
+    return FALSE;
+  }
+  bitmap.ScaleBicubic(scaledBitmap, 0, 0, width-1, height-1, 0, 0, newWidth-1, newHeight-1);
+  if (scaledBitmap->Save(image.mCachedPath, image.mFilterID, 0, SAVEBIT_32BITCHANNELS) != IMAGERESULT_OK) {
+    return FALSE;
+  }
+  image.mCachedMemoryKB = imageMemoryKB(newWidth, newHeight, 96);
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+
+/// Bakes a shader into a square image of its target resolution, by sampling
+/// it at the centre of every pixel in UV space. If the stamp of an existing
+/// image matches the dirty checksum that was recorded for the shader in the
+/// original document, nothing will be baked.
+///
+/// @param[in]  image
+///   The image entry of the shader.
+/// @return
+///   TRUE if the baked image exists afterwards, FALSE otherwise.
+Bool LuxTextureCache::bakeShader(Image& image)
+{
+  if (!image.mShaderReady)  return FALSE;
+  BaseShader& shader = *image.mShader;
+  LONG resolution = image.mTargetResolution;
+  image.mSourceMemoryKB = imageMemoryKB(resolution, resolution, 24);
+  image.mCachedMemoryKB = image.mSourceMemoryKB;
+
+  // the recorded dirty checksum (which includes the session token) tells us
+  // if the shader has changed - without one, we always bake
+  ULONG dirty = 0;
+  if (image.mShaderDirty) {
+    dirty = hashBytes(&resolution, sizeof(resolution), image.mShaderDirty);
+    dirty = hashBytes(&image.mShaderTime, sizeof(image.mShaderTime), dirty);
+  }
+  Filename stamp(stampPath(image.mCachedPath));
+  if (dirty && GeFExist(image.mCachedPath) && checkShaderStamp(stamp, dirty)) {
+    return TRUE;
+  }
+
+  // bake shader
+  AutoAlloc<BaseBitmap> bitmap;
+  if (!bitmap || (bitmap->Init(resolution, resolution, 24) != IMAGERESULT_OK)) {
+    return FALSE;
+  }
+  Real invResolution = 1.0 / resolution;
+  for (LONG y=0; y<resolution; ++y) {
+    for (LONG x=0; x<resolution; ++x) {
+      Vector color = sampleShader(shader,
+                                  ((Real)x + 0.5) * invResolution,
+                                  ((Real)y + 0.5) * invResolution,
+                                  image.mShaderTime);
+      bitmap->SetPixel(x, y,
+                       (LONG)(FCut(color.x, 0.0, 1.0) * 255.0 + 0.5),
+                       (LONG)(FCut(color.y, 0.0, 1.0) * 255.0 + 0.5),
+                       (LONG)(FCut(color.z, 0.0, 1.0) * 255.0 + 0.5));
+    }
+  }
+  if (bitmap->Save(image.mCachedPath, image.mFilterID, 0, SAVEBIT_0) != IMAGERESULT_OK) {
+    return FALSE;
+  }
+
+  // store stamp - if that fails we will just bake the shader again next time
+  writeShaderStamp(stamp, dirty);
+  return TRUE;
+}
+
+
+/// Copies a file bytewise and calculates the hash of its content on the way.
+///
+/// @param[in]  sourcePath
+///   The file to copy.
+/// @param[in]  targetPath
+///   The path of the copy. An existing file will be overwritten.
+/// @param[out]  hash
+///   Receives the hash of the file content.
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool LuxTextureCache::copyFile(const Filename& sourcePath,
+                               const Filename& targetPath,
+                               ULONG&          hash)
+{
+  AutoAlloc<BaseFile> source;
+  AutoAlloc<BaseFile> target;
+  if (!source || !target ||
+      !source->Open(sourcePath, FILEOPEN_READ, FILEDIALOG_NONE) ||
+      !target->Open(targetPath, FILEOPEN_WRITE, FILEDIALOG_NONE))
+  {
+    return FALSE;
+  }
+
+  CHAR  buffer[16384];
+  VLONG bytesRead;
+  hash = 2166136261U;
+  while ((bytesRead = source->ReadBytes(buffer, sizeof(buffer), TRUE)) > 0) {
+    hash = hashBytes(buffer, bytesRead, hash);
+    if (!target->WriteBytes(buffer, bytesRead))  return FALSE;
+  }
+  return TRUE;
+}
+
+
+/// Calculates the hash of the content of a file.
+///
+/// @param[in]  path
+///   The file to hash.
+/// @param[out]  hash
+///   Receives the hash.
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool LuxTextureCache::hashFile(const Filename& path,
+                               ULONG&          hash)
+{
+  AutoAlloc<BaseFile> file;
+  if (!file || !file->Open(path, FILEOPEN_READ, FILEDIALOG_NONE))  return FALSE;
+
+  CHAR  buffer[16384];
+  VLONG bytesRead;
+  hash = 2166136261U;
+  while ((bytesRead = file->ReadBytes(buffer, sizeof(buffer), TRUE)) > 0) {
+    hash = hashBytes(buffer, bytesRead, hash);
+  }
+  return TRUE;
+}
+
+
+/// Calculates a checksum of the size and modification time of a file and the
+/// target resolution of its cached copy, which is much cheaper than hashing
+/// its content.
+///
+/// @param[in]  path
+///   The file to stamp.
+/// @param[in]  targetResolution
+///   The target resolution of the cached copy.
+/// @return
+///   The checksum or 0, if size or modification time couldn't be determined.
+ULONG LuxTextureCache::fileStamp(const Filename& path,
+                                 LONG            targetResolution)
+{
+  AutoAlloc<BaseFile> file;
+  LocalFileTime       time;
+  if (!file ||
+      !file->Open(path, FILEOPEN_READ, FILEDIALOG_NONE) ||
+      !GeGetFileTime(path, FILETIME_MODIFIED, &time))
+  {
+    return 0;
+  }
+  VLONG length = file->GetLength();
+  ULONG stamp = hashBytes(&length, sizeof(length), 2166136261U);
+  stamp = hashBytes(&time, sizeof(time), stamp);
+  stamp = hashBytes(&targetResolution, sizeof(targetResolution), stamp);
+  return stamp ? stamp : 1;
+}
+
+
+/// Returns TRUE if the stamp file exists and contains the specified file
+/// stamp or, if that is 0, the specified hash. In that case the memory usage
+/// stored in the stamp is copied into the image.
+Bool LuxTextureCache::checkStamp(const Filename& stampPath,
+                                 ULONG           hash,
+                                 ULONG           fileStamp,
+                                 Image&          image)
+{
+  AutoAlloc<BaseFile> file;
+  ULONG               storedHash, sourceMemoryKB, cachedMemoryKB, storedFileStamp;
+  if (!file ||
+      !file->Open(stampPath, FILEOPEN_READ, FILEDIALOG_NONE) ||
+      !file->ReadULong(&storedHash) ||
+      !file->ReadULong(&sourceMemoryKB) ||
+      !file->ReadULong(&cachedMemoryKB))
+  {
+    return FALSE;
+  }
+  if (fileStamp) {
+    // stamps of older versions have no file stamp
+    if (!file->ReadULong(&storedFileStamp) || (storedFileStamp != fileStamp)) {
+      return FALSE;
+    }
+  } else if (storedHash != hash) {
+    return FALSE;
+  }
+  image.mSourceMemoryKB = sourceMemoryKB;
+  image.mCachedMemoryKB = cachedMemoryKB;
+  return TRUE;
+}
+
+
+/// Writes the hash, the memory usage of the image and the file stamp of the
+/// source file into a stamp file.
+Bool LuxTextureCache::writeStamp(const Filename& stampPath,
+                                 ULONG           hash,
+                                 ULONG           fileStamp,
+                                 const Image&    image)
+{
+  AutoAlloc<BaseFile> file;
+  return (file &&
+          file->Open(stampPath, FILEOPEN_WRITE, FILEDIALOG_NONE) &&
+          file->WriteULong(hash) &&
+          file->WriteULong(image.mSourceMemoryKB) &&
+          file->WriteULong(image.mCachedMemoryKB) &&
+          file->WriteULong(fileStamp));
+}
+
+
+/// Returns TRUE if the stamp file of a baked shader exists and contains the
+/// specified dirty checksum. A value of 0 is never matched.
+Bool LuxTextureCache::checkShaderStamp(const Filename& stampPath,
+                                       ULONG           dirty)
+{
+  AutoAlloc<BaseFile> file;
+  ULONG               storedDirty;
+  if (!dirty ||
+      !file ||
+      !file->Open(stampPath, FILEOPEN_READ, FILEDIALOG_NONE) ||
+      !file->ReadULong(&storedDirty))
+  {
+    return FALSE;
+  }
+  return (storedDirty == dirty);
+}
+
+
+/// Writes the dirty checksum of a baked shader into a stamp file.
+Bool LuxTextureCache::writeShaderStamp(const Filename& stampPath,
+                                       ULONG           dirty)
+{
+  AutoAlloc<BaseFile> file;
+  return (file &&
+          file->Open(stampPath, FILEOPEN_WRITE, FILEDIALOG_NONE) &&
+          file->WriteULong(dirty));
+}
+
+
+/// Returns the path of the stamp file, that belongs to a cached image.
+Filename LuxTextureCache::stampPath(const Filename& cachedPath)
+{
+  return Filename(cachedPath.GetString() + ".stamp");
+}
+
+
+/// Returns the ID of the bitmap filter that can be used to write an image
+/// with the suffix of the passed path or 0 if it's not supported.
+LONG LuxTextureCache::filterFromSuffix(const Filename& path)
+{
+  if (path.CheckSuffix("png"))  return FILTER_PNG;
+  if (path.CheckSuffix("jpg") || path.CheckSuffix("jpeg"))  return FILTER_JPG;
+  if (path.CheckSuffix("tif") || path.CheckSuffix("tiff"))  return FILTER_TIF;
+  if (path.CheckSuffix("tga"))  return FILTER_TGA;
+  if (path.CheckSuffix("bmp"))  return FILTER_BMP;
+  return 0;
+}
+
+
+/// Returns the ID of the bitmap filter that can be used to write an environment
+/// map with the suffix of the passed path or 0 if it's not supported.
+LONG LuxTextureCache::environmentFilterFromSuffix(const Filename& path)
+{
+  if (path.CheckSuffix("hdr"))  return FILTER_HDR;
+  if (path.CheckSuffix("exr"))  return FILTER_EXR;
+  return 0;
+}
+
+
+/// Updates a 32-bit FNV-1a hash with a block of bytes.
+///
+/// @param[in]  data
+///   Pointer to the bytes.
+/// @param[in]  size
+///   The number of bytes.
+/// @param[in]  hash
+///   The current hash value (2166136261 for a new hash).
+/// @return
+///   The updated hash value.
+ULONG LuxTextureCache::hashBytes(const void* data,
+                                 SizeT       size,
+                                 ULONG       hash)
+{
+  const UCHAR* bytes = (const UCHAR*)data;
+  for (SizeT i=0; i<size; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+
+/// Returns the memory in KB, an uncompressed image of the specified size
+/// needs.
+ULONG LuxTextureCache::imageMemoryKB(LONG width,
+                                     LONG height,
+                                     LONG bitsPerPixel)
+{
+  return (ULONG)((LReal)width * height * bitsPerPixel / 8.0 / 1024.0 + 0.5);
+}
+
+
+/// Returns a path that describes the position of a shader in the shader tree
+/// of its owner, e.g. "Material/0/2". It doesn't change as long as the
+/// material isn't restructured or renamed.
+String LuxTextureCache::shaderPath(BaseShader& shader)
+{
+  String path;
+  for (BaseShader* node=&shader; node; node=node->GetUp()) {
+    LONG index = 0;
+    for (BaseShader* pred=node->GetPred(); pred; pred=pred->GetPred()) {
+      ++index;
+    }
+    path = "/" + LongToString(index) + path;
+  }
+  BaseList2D* owner = shader.GetMain();
+  if (owner)  path = owner->GetName() + path;
+  return path;
+}
+
+
+/// Updates a checksum with the data dirty counts of a shader and all its
+/// child shaders.
+ULONG LuxTextureCache::shaderDirtyChecksum(BaseShader& shader,
+                                           ULONG       checksum)
+{
+  ULONG dirty = shader.GetDirty(DIRTYFLAGS_DATA);
+  checksum = hashBytes(&dirty, sizeof(dirty), checksum);
+  for (BaseShader* child=shader.GetDown(); child; child=child->GetNext()) {
+    checksum = shaderDirtyChecksum(*child, checksum);
+  }
+  return checksum;
+}
+
+
+/// Samples an initialised shader at a UV coordinate.
+Vector LuxTextureCache::sampleShader(BaseShader& shader,
+                                     Real        u,
+                                     Real        v,
+                                     Real        time)
+{
+  ChannelData channelData;
+  channelData.p       = Vector(u, v, 0.0);
+  channelData.n       = Vector(0.0, 0.0, 1.0);
+  channelData.d       = Vector(0.0, 0.0, 0.0);
+  channelData.t       = time;
+  channelData.texflag = 0;
+  channelData.vd      = 0;
+  channelData.off     = 0.0;
+  channelData.scale   = 0.0;
+  return shader.Sample(&channelData);
+}
+
+
+
+/*****************************************************************************
+ * Implementation of class LuxTextureCache::Worker.
+ *****************************************************************************/
+
+/// Constructs an idle worker.
+LuxTextureCache::Worker::Worker(void)
+: mCache(0),
+  mFirst(0),
+  mStride(1)
+{}
+
+
+/// Thread main function, which processes the images assigned to this worker.
+void LuxTextureCache::Worker::Main(void)
+{
+  if (mCache)  mCache->processImageRange(mFirst, mStride, Get());
+}
+
+
+/// Returns the name of the worker thread.
+const CHAR* LuxTextureCache::Worker::GetThreadName(void)
+{
+  return "LuxC4D texture cache worker";
+}
@@ -0,0 +1,295 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __LUXTEXTURECACHE_H__
+#define __LUXTEXTURECACHE_H__  1
+
+
+
+#include <c4d.h>
+
+#include "common.h"
+#include "dynarray1d.h"
+#include "hashmap.h"
+#include "rbtreemap.h"
+
+
+
+/***************************************************************************//*!
+ This class implements an export-time texture cache. Every image that is
+ referenced by the exported scene gets registered via addImage(), which
+ immediately returns the path of the processed copy inside the cache directory.
+ The actual work is done later in processImages(), which distributes all
+ registered images over a number of worker threads.
+
+ Every call of addImage() is also recorded in a usage log. The exporter can
+ then pass the resolution an object needs on screen for a range of that log
+ via requestResolution(). Each image gets the smallest power of two covering
+ the largest requested resolution (capped by the maximum resolution), which is
+ then reduced further until the estimated memory of all images fits into the
+ memory budget.
+
+ Images that are larger than their target resolution get downscaled, keeping
+ their bit depth and alpha channel, all other images are copied unchanged. For
+ each processed image we store a small stamp file next to it, which contains a
+ hash of the source file and the settings used for processing it, and the size
+ and modification time of the source file. If size and modification time
+ still match, the image is skipped without reading the source file. Otherwise
+ the source file is hashed and the image is only processed again, if the hash
+ doesn't match.
+
+ Environment maps are registered separately via addEnvironmentMap(). They are
+ kept in their float format, their width is capped by the maximum environment
+ resolution and they don't take part in the memory budget.
+
+ Shaders that LuxRender can't evaluate itself (i.e. everything except the
+ bitmap shader) can be registered via addShader(). They are sampled in UV space
+ and baked into PNG images, which are then treated like any other cached image,
+ except that their resolution is capped by the shader bake resolution. Their
+ stamp stores the dirty checksum of the shader tree, so unchanged shaders are
+ not baked again during a session. The export converts a copy of the document,
+ whose dirty counts don't follow the edits of the original. So the checksums
+ are taken from the original document via recordShaderChecksums() before the
+ copy is made, and they include a session token, as dirty counts don't survive
+ a restart. Shaders without a recorded checksum are always baked.
+
+ A cache can also take its images from another cache via setSourceCache(),
+ which is used by the frames of an animation that are exported after the first
+ frame. Such a cache doesn't register or process any images, but returns the
+ cached paths of the images the source cache has processed successfully. All
+ other images are exported unprocessed and other shaders aren't baked. Shaders
+ are found by their shader path, unless the path is ambiguous.
+*//****************************************************************************/
+class LuxTextureCache
+{
+public:
+
+  LuxTextureCache(void);
+  ~LuxTextureCache(void);
+
+  Bool init(const Filename& cacheDirectory,
+            LONG            maxResolution,
+            LONG            memoryBudget=0,
+            LONG            maxEnvironmentResolution=0,
+            LONG            shaderResolution=0);
+  void erase(void);
+
+  inline Bool isEnabled(void) const;
+  inline void setSourceCache(const LuxTextureCache* sourceCache);
+  inline Bool bakesShaders(void) const;
+  inline SizeT imageCount(void) const;
+
+  Bool addImage(const Filename& imagePath,
+                Filename&       cachedPath);
+  Bool addEnvironmentMap(const Filename& imagePath,
+                         Filename&       cachedPath);
+  Bool addShader(BaseShader& shader,
+                 Filename&   cachedPath);
+  void recordShaderChecksums(BaseDocument& document,
+                             ULONG         sessionToken);
+
+  inline SizeT usageLogSize(void) const;
+  Bool repeatUsage(SizeT begin,
+                   SizeT end);
+  void requestResolution(SizeT begin,
+                         SizeT end,
+                         LONG  resolution);
+
+  Bool processImages(void);
+
+
+private:
+
+  /// Helper structure which stores all information about a single cached
+  /// image.
+  struct Image {
+    Filename    mSourcePath;
+    Filename    mCachedPath;
+    LONG        mFilterID;
+    LONG        mMaxResolution;
+    LONG        mRequestedResolution;
+    LONG        mTargetResolution;
+    ULONG       mSourceMemoryKB;
+    ULONG       mCachedMemoryKB;
+    BaseShader* mShader;
+    ULONG       mShaderDirty;
+    Real        mShaderTime;
+    Bool        mShaderReady;
+    Bool        mEnvironment;
+    Bool        mSuccess;
+  };
+
+  /// Worker thread that processes every mStride-th image, starting with
+  /// image mFirst. As every worker has its own set of images no locking is
+  /// needed.
+  class Worker : public C4DThread
+  {
+  public:
+
+    LuxTextureCache* mCache;
+    SizeT            mFirst;
+    SizeT            mStride;
+
+    Worker(void);
+
+    virtual void Main(void);
+    virtual const CHAR* GetThreadName(void);
+  };
+
+  friend class Worker;
+
+
+  typedef DynArray1D<Image*>                 ImagesT;
+  typedef RBTreeMap<String, SizeT, NodePool> ImageIndicesT;
+  typedef DynArray1D<SizeT>                  UsageLogT;
+  typedef HashMap<String, ULONG>             ShaderChecksumsT;
+
+
+  /// The smallest target resolution we reduce images to, when trying to
+  /// fit them into the memory budget.
+  static const LONG cMinResolution = 64;
+
+
+  Filename               mCacheDirectory;
+  const LuxTextureCache* mSourceCache;
+  LONG                   mMaxResolution;
+  LONG                   mMemoryBudget;
+  LONG                   mMaxEnvironmentResolution;
+  LONG                   mShaderResolution;
+  ImagesT                mImages;
+  ImageIndicesT          mImageIndices;
+  UsageLogT              mUsageLog;
+  ShaderChecksumsT       mShaderChecksums;
+
+  Bool registerImage(const Filename& imagePath,
+                     Bool            environment,
+                     Filename&       cachedPath);
+  Bool storeImage(Image*        image,
+                  const String& key,
+                  Bool          logUsage);
+  Bool findProcessedImage(const String& key,
+                          Filename&     cachedPath) const;
+  void determineTargetResolutions(void);
+  void recordShaderTree(BaseShader& shader,
+                        ULONG       sessionToken);
+  void initShaders(void);
+  void freeShaders(void);
+  void reportMemoryUsage(void);
+
+  void processImageRange(SizeT       first,
+                         SizeT       stride,
+                         BaseThread* thread);
+  Bool processImage(Image& image);
+  Bool scaleImage(BaseBitmap& bitmap,
+                  Image&      image);
+  Bool scaleEnvironmentMap(BaseBitmap& bitmap,
+                           Image&      image);
+  Bool bakeShader(Image& image);
+  Bool copyFile(const Filename& sourcePath,
+                const Filename& targetPath,
+                ULONG&          hash);
+  Bool hashFile(const Filename& path,
+                ULONG&          hash);
+  ULONG fileStamp(const Filename& path,
+                  LONG            targetResolution);
+  Bool checkStamp(const Filename& stampPath,
+                  ULONG           hash,
+                  ULONG           fileStamp,
+                  Image&          image);
+  Bool writeStamp(const Filename& stampPath,
+                  ULONG           hash,
+                  ULONG           fileStamp,
+                  const Image&    image);
+  Bool checkShaderStamp(const Filename& stampPath,
+                        ULONG           dirty);
+  Bool writeShaderStamp(const Filename& stampPath,
+                        ULONG           dirty);
+  Filename stampPath(const Filename& cachedPath);
+
+  static LONG filterFromSuffix(const Filename& path);
+  static LONG environmentFilterFromSuffix(const Filename& path);
+  static ULONG hashBytes(const void* data,
+                         SizeT       size,
+                         ULONG       hash);
+  static ULONG imageMemoryKB(LONG width,
+                             LONG height,
+                             LONG bitsPerPixel);
+  static String shaderPath(BaseShader& shader);
+  static ULONG shaderDirtyChecksum(BaseShader& shader,
+                                   ULONG       checksum);
+  static Vector sampleShader(BaseShader& shader,
+                             Real        u,
+                             Real        v,
+                             Real        time);
+};
+
+
+
+/*****************************************************************************
+ * Inlined functions of LuxTextureCache
+ *****************************************************************************/
+
+/// Returns TRUE if the cache was initialised, i.e. images will be processed.
+inline Bool LuxTextureCache::isEnabled(void) const
+{
+  return (mMaxResolution > 0);
+}
+
+
+/// Sets the cache the images are taken from instead of processing them, or
+/// NULL to process the images in this cache. The source cache must have
+/// processed its images already and must not change while it's used. The
+/// setting is not changed by init() or erase().
+inline void LuxTextureCache::setSourceCache(const LuxTextureCache* sourceCache)
+{
+  mSourceCache = sourceCache;
+}
+
+
+/// Returns TRUE if non-bitmap shaders will be baked into images.
+inline Bool LuxTextureCache::bakesShaders(void) const
+{
+  return (isEnabled() && (mShaderResolution > 0));
+}
+
+
+/// Returns the number of images that have been registered so far.
+inline SizeT LuxTextureCache::imageCount(void) const
+{
+  return mImages.size();
+}
+
+
+/// Returns the current number of entries in the usage log. Together with the
+/// size after some images were added, it defines the log range of these
+/// images.
+inline SizeT LuxTextureCache::usageLogSize(void) const
+{
+  return mUsageLog.size();
+}
+
+
+
+#endif  // #ifndef __LUXTEXTURECACHE_H__
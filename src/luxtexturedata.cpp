@@ -25,6 +25,70 @@
 
 #include "filepath.h"
 #include "luxtexturedata.h"
+#include "utilities.h"
+
+
+
+/*****************************************************************************
+ * Helper functions.
+ *****************************************************************************/
+
+/// Returns TRUE if a texture is constant and all its components have the
+/// specified value (within some error margin).
+static inline Bool isConstantValue(LuxTextureData& texture, LuxFloat value)
+{
+  if (!texture.isConstant())  return FALSE;
+  if (texture.mType == LUX_FLOAT_TEXTURE) {
+    return fabs(texture.constantFloat() - value) < 0.00001;
+  }
+  const LuxColor& color(texture.constantColor());
+  return (fabs(color.c[0] - value) < 0.00001) &&
+         (fabs(color.c[1] - value) < 0.00001) &&
+         (fabs(color.c[2] - value) < 0.00001);
+}
+
+
+/// Creates a constant texture with the value of another constant texture.
+static LuxTextureDataH constantCopy(LuxTextureData& texture)
+{
+  LuxConstantTextureData* constant = gNew LuxConstantTextureData(texture.mType);
+  if (!constant)  return LuxTextureDataH();
+  if (texture.mType == LUX_FLOAT_TEXTURE) {
+    constant->mFloat = texture.constantFloat();
+  } else {
+    constant->mColor = texture.constantColor();
+  }
+  return LuxTextureDataH(constant);
+}
+
+
+/// Creates a constant texture with the product of two constant textures.
+static LuxTextureDataH constantProduct(LuxTextureData& texture1,
+                                       LuxTextureData& texture2)
+{
+  LuxConstantTextureData* constant = gNew LuxConstantTextureData(texture1.mType);
+  if (!constant)  return LuxTextureDataH();
+  if (texture1.mType == LUX_FLOAT_TEXTURE) {
+    constant->mFloat = texture1.constantFloat() * texture2.constantFloat();
+  } else {
+    constant->mColor = texture1.constantColor() ^ texture2.constantColor();
+  }
+  return LuxTextureDataH(constant);
+}
+
+
+/// Creates a scale texture of two textures.
+static LuxTextureDataH newScale(LuxTextureType         type,
+                                const LuxTextureDataH& texture1,
+                                const LuxTextureDataH& texture2)
+{
+  if (!texture1 || !texture2)  return LuxTextureDataH();
+  LuxScaleTextureData* scale = gNew LuxScaleTextureData(type);
+  if (!scale)  return LuxTextureDataH();
+  scale->mTexture1 = texture1;
+  scale->mTexture2 = texture2;
+  return LuxTextureDataH(scale);
+}
 
 
 
@@ -38,17 +102,64 @@ Bool LuxTextureData::isConstant() const
 }
 
 
+// the dummy constants are defined at file scope, so they are initialised before
+// any converter thread can access them
+static const LuxFloat sDummyFloat(0.0);
+static const LuxColor sDummyColor(0.0);
+
+
 const LuxFloat& LuxTextureData::constantFloat()
 {
-  static const LuxFloat cDummy(0.0);
-  return cDummy;
+  return sDummyFloat;
 }
 
 
 const LuxColor& LuxTextureData::constantColor()
 {
-  static const LuxColor cDummy(0.0);
-  return cDummy;
+  return sDummyColor;
+}
+
+
+/// Simplifies the texture graph below this texture and returns the texture
+/// that should be used instead of this one. The returned texture must produce
+/// the same values as this one.
+///
+/// @return
+///   The replacement texture or an empty handle, if this texture can't be
+///   simplified.
+LuxTextureDataH LuxTextureData::simplified()
+{
+  return LuxTextureDataH();
+}
+
+
+/// Returns a texture that produces the values of this texture multiplied by a
+/// constant factor without needing an additional scale texture (e.g. by
+/// folding the factor into a constant or a texture parameter).
+///
+/// @param[in]  factor
+///   The constant texture to multiply with. It has the same type as this
+///   texture.
+/// @return
+///   The new texture or an empty handle, if the factor can't be absorbed.
+LuxTextureDataH LuxTextureData::scaledBy(LuxTextureData& factor)
+{
+  return LuxTextureDataH();
+}
+
+
+/// Simplifies a texture graph: Nested scales get collapsed, scales by 1 and
+/// mixes with amount 0 or 1 are removed and constant factors are folded into
+/// other textures where possible. The handle is replaced by the simplified
+/// texture.
+///
+/// @param[in/out]  texture
+///   The handle of the root texture of the graph. Can be empty.
+void LuxTextureData::simplify(LuxTextureDataH& texture)
+{
+  if (!texture)  return;
+  LuxTextureDataH replacement = texture->simplified();
+  if (replacement)  texture = replacement;
 }
 
 
@@ -150,6 +261,53 @@ const LuxColor& LuxScaleTextureData::constantColor()
 }
 
 
+LuxTextureDataH LuxScaleTextureData::simplified()
+{
+  GeAssert(mTexture1);
+  GeAssert(mTexture2);
+
+  simplify(mTexture1);
+  simplify(mTexture2);
+
+  // leave invalid graphs alone, they will be reported in sendToAPI()
+  if ((mTexture1->mType != mType) || (mTexture2->mType != mType)) {
+    return LuxTextureDataH();
+  }
+
+  // fold constants, drop factors of 1 and replace scales by 0 by a constant
+  if (isConstant())  return constantProduct(*mTexture1, *mTexture2);
+  if (isConstantValue(*mTexture1, 1.0))  return mTexture2;
+  if (isConstantValue(*mTexture2, 1.0))  return mTexture1;
+  if (isConstantValue(*mTexture1, 0.0))  return mTexture1;
+  if (isConstantValue(*mTexture2, 0.0))  return mTexture2;
+
+  // try to push a constant factor into the other texture, which collapses
+  // nested scales
+  if (mTexture1->isConstant())  return mTexture2->scaledBy(*mTexture1);
+  if (mTexture2->isConstant())  return mTexture1->scaledBy(*mTexture2);
+  return LuxTextureDataH();
+}
+
+
+LuxTextureDataH LuxScaleTextureData::scaledBy(LuxTextureData& factor)
+{
+  GeAssert(mTexture1);
+  GeAssert(mTexture2);
+
+  if (mTexture1->isConstant()) {
+    return newScale(mType, constantProduct(*mTexture1, factor), mTexture2);
+  }
+  if (mTexture2->isConstant()) {
+    return newScale(mType, mTexture1, constantProduct(*mTexture2, factor));
+  }
+  LuxTextureDataH scaled = mTexture1->scaledBy(factor);
+  if (scaled)  return newScale(mType, scaled, mTexture2);
+  scaled = mTexture2->scaledBy(factor);
+  if (scaled)  return newScale(mType, mTexture1, scaled);
+  return LuxTextureDataH();
+}
+
+
 Bool LuxScaleTextureData::sendToAPI(LuxAPI&          receiver,
                                     const LuxString& name)
 {
@@ -174,7 +332,7 @@ Bool LuxScaleTextureData::sendToAPI(LuxAPI&          receiver,
   }
 
   // setup parameters
-  LuxParamSet paramSet(2);
+  LuxParamSetN<2> paramSet;
   LuxString texture1Name = name + ".tex1";
   LuxString texture2Name = name + ".tex2";
   if (!mTexture1->sendToAPIAndAddToParamSet(receiver, paramSet, "tex1", texture1Name) ||
@@ -230,6 +388,52 @@ const LuxColor& LuxMixTextureData::constantColor()
 }
 
 
+LuxTextureDataH LuxMixTextureData::simplified()
+{
+  GeAssert(mTexture1);
+  GeAssert(mTexture2);
+
+  simplify(mTexture1);
+  simplify(mTexture2);
+
+  // leave invalid graphs alone, they will be reported in sendToAPI()
+  if ((mTexture1->mType != mType) || (mTexture2->mType != mType)) {
+    return LuxTextureDataH();
+  }
+
+  // fold constants and drop mixes that return only one of the textures
+  if (isConstant())  return constantCopy(*this);
+  if (mAmount < 0.00001)  return mTexture1;
+  if (mAmount > 0.99999)  return mTexture2;
+  if (mTexture1 == mTexture2)  return mTexture1;
+  return LuxTextureDataH();
+}
+
+
+LuxTextureDataH LuxMixTextureData::scaledBy(LuxTextureData& factor)
+{
+  GeAssert(mTexture1);
+  GeAssert(mTexture2);
+
+  // we can only absorb the factor, if both textures can absorb it
+  LuxTextureDataH scaled1 = mTexture1->isConstant() ?
+                            constantProduct(*mTexture1, factor) :
+                            mTexture1->scaledBy(factor);
+  if (!scaled1)  return LuxTextureDataH();
+  LuxTextureDataH scaled2 = mTexture2->isConstant() ?
+                            constantProduct(*mTexture2, factor) :
+                            mTexture2->scaledBy(factor);
+  if (!scaled2)  return LuxTextureDataH();
+
+  LuxMixTextureData* mix = gNew LuxMixTextureData(mType);
+  if (!mix)  return LuxTextureDataH();
+  mix->mTexture1 = scaled1;
+  mix->mTexture2 = scaled2;
+  mix->mAmount   = mAmount;
+  return LuxTextureDataH(mix);
+}
+
+
 Bool LuxMixTextureData::sendToAPI(LuxAPI&          receiver,
                                   const LuxString& name)
 {
@@ -243,7 +447,7 @@ Bool LuxMixTextureData::sendToAPI(LuxAPI&          receiver,
   }
 
   // setup parameters
-  LuxParamSet paramSet(3);
+  LuxParamSetN<3> paramSet;
   LuxString texture1Name = name + ".tex1";
   LuxString texture2Name = name + ".tex2";
   if (!mTexture1->sendToAPIAndAddToParamSet(receiver, paramSet, "tex1", texture1Name) ||
@@ -307,10 +511,16 @@ const LuxColor& LuxConstantTextureData::constantColor()
 }
 
 
+LuxTextureDataH LuxConstantTextureData::scaledBy(LuxTextureData& factor)
+{
+  return constantProduct(*this, factor);
+}
+
+
 Bool LuxConstantTextureData::sendToAPI(LuxAPI&          receiver,
                                        const LuxString& name)
 {
-  LuxParamSet paramSet(1);
+  LuxParamSetN<1> paramSet;
 
   // setup parameters
   if (mType == LUX_FLOAT_TEXTURE) {
@@ -335,6 +545,14 @@ LuxUVMaskTextureData::LuxUVMaskTextureData(LuxTextureType type)
 {}
 
 
+LuxTextureDataH LuxUVMaskTextureData::simplified()
+{
+  simplify(mInnerTex);
+  simplify(mOuterTex);
+  return LuxTextureDataH();
+}
+
+
 Bool LuxUVMaskTextureData::sendToAPI(LuxAPI&          receiver,
                                      const LuxString& name)
 {
@@ -348,7 +566,7 @@ Bool LuxUVMaskTextureData::sendToAPI(LuxAPI&          receiver,
   }
 
   // export child textures
-  LuxParamSet paramSet(2 + LuxTextureMapping::maxParamCount());
+  LuxParamSetN<8> paramSet(2 + LuxTextureMapping::maxParamCount());
   LuxString innerTexName = name + ".inner";
   LuxString outerTexName = name + ".outer";
   if (!mInnerTex->sendToAPIAndAddToParamSet(receiver, paramSet, "innertex", innerTexName) ||
@@ -369,7 +587,9 @@ Bool LuxUVMaskTextureData::sendToAPI(LuxAPI&          receiver,
 
 LuxImageMapData::LuxImageMapData(LuxTextureType type)
 : LuxTextureData(type),
-  mGamma(1.0)
+  mGamma(1.0),
+  mGain(1.0),
+  mShader(0)
 {}
 
 
@@ -383,12 +603,97 @@ LuxImageMapData::LuxImageMapData(LuxTextureType     type,
   mImagePath(imagePath),
   mChannel(channel),
   mGamma(gamma),
-  mWrapType(wrapType)
+  mWrapType(wrapType),
+  mGain(1.0),
+  mShader(0)
 {
   mMapping = mapping;
 }
 
 
+/// Creates an imagemap texture from a shader. Bitmap shaders reference their
+/// image directly, all other shaders are baked into an image by the texture
+/// cache of the receiver during export.
+///
+/// @param[in]  shader
+///   The shader to convert.
+/// @param[in]  bakeShaders
+///   TRUE if non-bitmap shaders should be baked. If FALSE, only bitmap shaders
+///   are converted.
+/// @param[in]  type
+///   The texture type (float or colour).
+/// @param[in]  mapping
+///   The texture mapping.
+/// @param[in]  gamma  (default == 1.0)
+///   The gamma that shall be applied to the texture.
+/// @param[in]  channel  (default == IMAGE_CHANNEL_NONE)
+///   The image channel that should be used for float textures.
+/// @param[in]  wrapType  (default == WRAP_TYPE_NONE)
+///   The wrap type of the texture.
+/// @return
+///   The new texture or an empty handle, if the shader is not supported or
+///   we ran out of memory.
+LuxImageMapDataH LuxImageMapData::fromShader(BaseList2D&        shader,
+                                             Bool               bakeShaders,
+                                             LuxTextureType     type,
+                                             LuxTextureMappingH mapping,
+                                             LuxFloat           gamma,
+                                             Channel            channel,
+                                             WrapType           wrapType)
+{
+  // bitmap shader -> use its image
+  if (shader.GetType() == Xbitmap) {
+    BaseDocument* document = shader.GetDocument();
+    if (!document) { return LuxImageMapDataH(); }
+    Filename bitmapPath = getParameterFilename(shader, BITMAPSHADER_FILENAME);
+    Filename fullBitmapPath;
+    GenerateTexturePath(document->GetDocumentPath(),
+                        bitmapPath,
+                        Filename(),
+                        &fullBitmapPath);
+    return gNew LuxImageMapData(type, mapping, fullBitmapPath, gamma, channel, wrapType);
+  }
+
+  // any other shader -> bake it, if allowed (baked images have no alpha
+  // channel, i.e. we use the colour instead, like C4D does)
+  if (!bakeShaders || !shader.IsInstanceOf(Xbase)) { return LuxImageMapDataH(); }
+  if (channel == IMAGE_CHANNEL_ALPHA) { channel = IMAGE_CHANNEL_NONE; }
+  LuxImageMapDataH imageMap = gNew LuxImageMapData(type, mapping, Filename(), gamma, channel, wrapType);
+  if (imageMap) { imageMap->mShader = (BaseShader*)&shader; }
+  return imageMap;
+}
+
+
+LuxTextureDataH LuxImageMapData::scaledBy(LuxTextureData& factor)
+{
+  // the factor goes into the gain parameter, i.e. colour factors can only be
+  // absorbed if they are grey
+  LuxFloat gain;
+  if (mType == LUX_FLOAT_TEXTURE) {
+    gain = factor.constantFloat();
+  } else {
+    const LuxColor& color(factor.constantColor());
+    if ((fabs(color.c[0] - color.c[1]) > 0.00001) ||
+        (fabs(color.c[0] - color.c[2]) > 0.00001))
+    {
+      return LuxTextureDataH();
+    }
+    gain = color.c[0];
+  }
+
+  LuxImageMapData* imageMap = gNew LuxImageMapData(mType,
+                                                   mMapping,
+                                                   mImagePath,
+                                                   mGamma,
+                                                   mChannel,
+                                                   mWrapType);
+  if (!imageMap)  return LuxTextureDataH();
+  imageMap->mGain   = mGain * gain;
+  imageMap->mShader = mShader;
+  return LuxTextureDataH(imageMap);
+}
+
+
 Bool LuxImageMapData::sendToAPI(LuxAPI&          receiver,
                                 const LuxString& name)
 {
@@ -410,10 +715,23 @@ Bool LuxImageMapData::sendToAPI(LuxAPI&          receiver,
     "clamp"
   };
 
-  LuxParamSet paramSet(4 + LuxTextureMapping::maxParamCount());
+  LuxParamSetN<12> paramSet(5 + LuxTextureMapping::maxParamCount());
+
+  // if the receiver has a texture cache, reference the processed copy of the
+  // image instead of the original - shaders can only be exported as baked
+  // images of the cache
+  Filename imagePath(mImagePath);
+  LuxTextureCache* textureCache = receiver.textureCache();
+  if (mShader) {
+    if (!textureCache || !textureCache->addShader(*mShader, imagePath)) {
+      ERRLOG_RETURN_VALUE(FALSE, "LuxImageMapData::sendToAPI(): could not bake shader");
+    }
+  } else if (textureCache) {
+    textureCache->addImage(mImagePath, imagePath);
+  }
 
   // convert and clean up image path
-  FilePath processedPath(mImagePath);
+  FilePath processedPath(imagePath);
   receiver.processFilePath(processedPath);
   LuxString processedPathStr(processedPath.getLuxString());
   paramSet.addParam(LUX_STRING, "filename", &processedPathStr);
@@ -423,7 +741,7 @@ Bool LuxImageMapData::sendToAPI(LuxAPI&          receiver,
   if ((mChannel > IMAGE_CHANNEL_NONE) && (mChannel < IMAGE_CHANNEL_COUNT)) {
     // load bitmap and check if it has an alpha channel
     // TODO: cache results
-    if (mChannel == IMAGE_CHANNEL_ALPHA) {
+    if ((mChannel == IMAGE_CHANNEL_ALPHA) && !mShader) {
       BaseBitmap* bitmap = BaseBitmap::Alloc();
       bitmap->Init(mImagePath);
       if (!bitmap->GetChannelCount()) {
@@ -444,6 +762,11 @@ Bool LuxImageMapData::sendToAPI(LuxAPI&          receiver,
     paramSet.addParam(LUX_FLOAT, "gamma", &mGamma);
   }
 
+  // if a constant factor was folded into the image map, export it as gain
+  if (fabsf(mGain-1.0) > 0.00001) {
+    paramSet.addParam(LUX_FLOAT, "gain", &mGain);
+  }
+
   // if we want wrapping mode "black", add it as additional parameter
   LuxString wrap;
   if (mWrapType != WRAP_TYPE_NONE) {
@@ -49,9 +49,10 @@ enum LuxTextureType {
 
 
 /***************************************************************************//*!
- Base class of a texture parameter container implementation.
+ Base class of a texture parameter container implementation. The reference
+ counter of LuxTextureDataH is embedded in the object.
 *//****************************************************************************/
-class LuxTextureData
+class LuxTextureData : public RefCounted
 {
 public:
 
@@ -66,6 +67,10 @@ public:
   virtual const LuxFloat& constantFloat();
   virtual const LuxColor& constantColor();
 
+  virtual AutoRef<LuxTextureData> simplified();
+  virtual AutoRef<LuxTextureData> scaledBy(LuxTextureData& factor);
+  static void simplify(AutoRef<LuxTextureData>& texture);
+
   virtual Bool sendToAPI(LuxAPI&          receiver,
                          const LuxString& name) =0;
   Bool sendToAPIAndAddToParamSet(LuxAPI&                receiver,
@@ -108,6 +113,9 @@ public:
   virtual const LuxFloat& constantFloat();
   virtual const LuxColor& constantColor();
 
+  virtual LuxTextureDataH simplified();
+  virtual LuxTextureDataH scaledBy(LuxTextureData& factor);
+
   virtual Bool sendToAPI(LuxAPI&          receiver,
                          const LuxString& name);
 
@@ -139,6 +147,9 @@ public:
   virtual const LuxFloat& constantFloat();
   virtual const LuxColor& constantColor();
 
+  virtual LuxTextureDataH simplified();
+  virtual LuxTextureDataH scaledBy(LuxTextureData& factor);
+
   virtual Bool sendToAPI(LuxAPI&          receiver,
                          const LuxString& name);
 
@@ -172,6 +183,8 @@ public:
   virtual const LuxFloat& constantFloat();
   virtual const LuxColor& constantColor();
 
+  virtual LuxTextureDataH scaledBy(LuxTextureData& factor);
+
   virtual Bool sendToAPI(LuxAPI&          receiver,
                          const LuxString& name);
 };
@@ -192,6 +205,8 @@ public:
 
   LuxUVMaskTextureData(LuxTextureType type);
 
+  virtual LuxTextureDataH simplified();
+
   virtual Bool sendToAPI(LuxAPI&          receiver,
                          const LuxString& name);
 };
@@ -226,10 +241,12 @@ public:
     WRAP_TYPE_COUNT
   };
 
-  Filename  mImagePath;
-  Channel   mChannel;
-  LuxFloat  mGamma;
-  WrapType  mWrapType;
+  Filename    mImagePath;
+  Channel     mChannel;
+  LuxFloat    mGamma;
+  WrapType    mWrapType;
+  LuxFloat    mGain;
+  BaseShader* mShader;
 
 
   LuxImageMapData(LuxTextureType type);
@@ -240,6 +257,16 @@ public:
                   Channel            channel = IMAGE_CHANNEL_NONE,
                   WrapType           wrapBlack = WRAP_TYPE_NONE);
 
+  static AutoRef<LuxImageMapData> fromShader(BaseList2D&        shader,
+                                             Bool               bakeShaders,
+                                             LuxTextureType     type,
+                                             LuxTextureMappingH mapping,
+                                             LuxFloat           gamma = 1.0,
+                                             Channel            channel = IMAGE_CHANNEL_NONE,
+                                             WrapType           wrapType = WRAP_TYPE_NONE);
+
+  virtual LuxTextureDataH scaledBy(LuxTextureData& factor);
+
   virtual Bool sendToAPI(LuxAPI&          receiver,
                          const LuxString& name);
 };
@@ -35,12 +35,15 @@
 
 
 /***************************************************************************//*!
- Base class of a texture mapping implementation.
+ Base class of a texture mapping implementation. The reference counter of
+ LuxTextureMappingH is embedded in the object.
 *//****************************************************************************/
-class LuxTextureMapping
+class LuxTextureMapping : public RefCounted
 {
 public:
 
+  virtual ~LuxTextureMapping() {}
+
   /// Returns the maximum number of mapping parameters a texture mapping might
   /// need.
   inline static ULONG maxParamCount();
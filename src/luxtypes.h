@@ -30,6 +30,7 @@
 
 #include <string>
 
+#include "arraytraits.h"
 #include "common.h"
 
 
@@ -445,4 +446,15 @@ struct LuxColor
 
 
 
+// The default constructors of these types don't initialise anything, i.e.
+// arrays of them can be allocated uninitialised and copied with memcpy(). The
+// geometry types are aligned for the SIMD kernels.
+DECLARE_ALIGNED_ARRAY_TYPE(LuxVector2D)
+DECLARE_ALIGNED_ARRAY_TYPE(LuxVector)
+DECLARE_ALIGNED_ARRAY_TYPE(LuxPoint)
+DECLARE_ALIGNED_ARRAY_TYPE(LuxNormal)
+DECLARE_TRIVIAL_ARRAY_TYPE(LuxColor)
+
+
+
 #endif  // #ifndef __LUXTYPES_H__
@@ -0,0 +1,117 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include "memoryarena.h"
+#include "utilities.h"
+
+
+
+/*****************************************************************************
+ * Implementation of public member functions of class MemoryArena.
+ *****************************************************************************/
+
+/// Constructs an empty arena. No memory is allocated until the first
+/// allocation.
+MemoryArena::MemoryArena(void)
+: mBlocks(0),
+  mNext(0),
+  mEnd(0),
+  mNextBlockSize(cMinBlockSize),
+  mAllocatedSize(0)
+{}
+
+
+/// Destroys the arena and gives back all its memory.
+MemoryArena::~MemoryArena(void)
+{
+  release();
+}
+
+
+/// Gives back all blocks of the arena to the memory manager. All memory
+/// allocated from the arena becomes invalid.
+void MemoryArena::release(void)
+{
+  while (mBlocks) {
+    void* block = mBlocks;
+    mBlocks = mBlocks->mPrevious;
+    GeFree(block);
+  }
+  mNext          = 0;
+  mEnd           = 0;
+  mNextBlockSize = cMinBlockSize;
+  mAllocatedSize = 0;
+}
+
+
+
+/*****************************************************************************
+ * Implementation of private member functions of class MemoryArena.
+ *****************************************************************************/
+
+/// Allocates a new block and takes the requested memory from it. This is only
+/// called if the current block has not enough space left.
+///
+/// @param[in]  size
+///   The number of bytes to allocate (already rounded up to cAlignment).
+/// @return
+///   Pointer to the memory or NULL if we ran out of memory.
+void* MemoryArena::allocateFromNewBlock(SizeT size)
+{
+  // large allocations get their own block, which is put behind the current
+  // block, so the rest of the current block can still be used
+  if (size > cMaxBlockSize / 4) {
+    CHAR* memory = (CHAR*)GeAllocNC(size + cAlignment);
+    if (!memory) {
+      ERRLOG_RETURN_VALUE(0, "MemoryArena::allocateFromNewBlock(): could not allocate " + LLongToString(size) + " bytes");
+    }
+    Block* block = (Block*)memory;
+    if (mBlocks) {
+      block->mPrevious = mBlocks->mPrevious;
+      mBlocks->mPrevious = block;
+    } else {
+      block->mPrevious = 0;
+      mBlocks = block;
+    }
+    mAllocatedSize += size + cAlignment;
+    return memory + cAlignment;
+  }
+
+  // otherwise allocate the next block in the growing sequence
+  SizeT blockSize = mNextBlockSize;
+  while (blockSize < size + cAlignment)  blockSize *= 2;
+  CHAR* memory = (CHAR*)GeAllocNC(blockSize);
+  if (!memory) {
+    ERRLOG_RETURN_VALUE(0, "MemoryArena::allocateFromNewBlock(): could not allocate block of " + LLongToString(blockSize) + " bytes");
+  }
+  Block* block = (Block*)memory;
+  block->mPrevious = mBlocks;
+  mBlocks = block;
+  mNext = memory + cAlignment + size;
+  mEnd  = memory + blockSize;
+  mAllocatedSize += blockSize;
+  if (mNextBlockSize < cMaxBlockSize)  mNextBlockSize *= 2;
+  return memory + cAlignment;
+}
@@ -0,0 +1,149 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __MEMORYARENA_H__
+#define __MEMORYARENA_H__  1
+
+
+
+#include <cstddef>
+
+#include <c4d.h>
+
+
+
+/***************************************************************************//*!
+ This class implements a monotonic memory arena: memory is handed out by
+ bumping a pointer through larger blocks, the single allocations are never
+ freed and all blocks are given back in one step by release(). It's meant for
+ the many small objects that live only during one export.
+
+ The first block has a size of cMinBlockSize bytes, every following block is
+ twice as large until cMaxBlockSize is reached. Allocations, which don't fit
+ into a block of that size, get their own block. The sizes of all allocations
+ are rounded up to cAlignment bytes, i.e. they are aligned like the blocks we
+ get from the C4D memory manager (up to cAlignment).
+
+ Objects are constructed in the arena via placement new:
+   HierarchyData* data = new (arena) HierarchyData();
+ Their destructors are not called by release(), i.e. the owner has to destroy
+ objects that have a non-trivial destructor, before the arena is released.
+*//****************************************************************************/
+class MemoryArena
+{
+public:
+
+  /// The alignment of all allocations.
+  static const SizeT cAlignment = 16;
+
+
+  MemoryArena(void);
+  ~MemoryArena(void);
+
+  inline void* allocate(SizeT size);
+  void release(void);
+
+  inline SizeT allocatedSize(void) const;
+
+
+private:
+
+  /// Header of a memory block. The memory handed out starts cAlignment bytes
+  /// after the beginning of the block.
+  struct Block {
+    Block* mPrevious;
+  };
+
+
+  /// The size of the first block.
+  static const SizeT cMinBlockSize = 16 * 1024;
+  /// The maximum size of blocks that are shared by several allocations.
+  static const SizeT cMaxBlockSize = 1024 * 1024;
+
+
+  Block* mBlocks;
+  CHAR*  mNext;
+  CHAR*  mEnd;
+  SizeT  mNextBlockSize;
+  SizeT  mAllocatedSize;
+
+
+  // We don't allow copying of MemoryArenas.
+  MemoryArena(const MemoryArena& other);
+  MemoryArena& operator=(const MemoryArena& other);
+
+  void* allocateFromNewBlock(SizeT size);
+};
+
+
+
+/*****************************************************************************
+ * Inlined functions of MemoryArena
+ *****************************************************************************/
+
+/// Allocates uninitialised memory from the arena.
+///
+/// @param[in]  size
+///   The number of bytes to allocate.
+/// @return
+///   Pointer to the memory or NULL if we ran out of memory.
+inline void* MemoryArena::allocate(SizeT size)
+{
+  size = (size + cAlignment - 1) & ~(cAlignment - 1);
+  if ((SizeT)(mEnd - mNext) < size)  return allocateFromNewBlock(size);
+  void* memory = mNext;
+  mNext += size;
+  return memory;
+}
+
+
+/// Returns the number of bytes of all blocks that are currently allocated by
+/// the arena.
+inline SizeT MemoryArena::allocatedSize(void) const
+{
+  return mAllocatedSize;
+}
+
+
+
+/*****************************************************************************
+ * Placement new for MemoryArena
+ *****************************************************************************/
+
+/// Allocates an object in a MemoryArena. As it doesn't throw, the constructor
+/// is not called and NULL is returned, if the allocation failed.
+inline void* operator new(size_t size, MemoryArena& arena) throw()
+{
+  return arena.allocate((SizeT)size);
+}
+
+/// Only called if a constructor throws during placement new into an arena.
+/// There is nothing to do, as the memory is released with the arena.
+inline void operator delete(void*, MemoryArena&) throw()
+{}
+
+
+
+#endif  // #ifndef __MEMORYARENA_H__
@@ -0,0 +1,108 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include <cstdio>
+
+#include "nameallocator.h"
+#include "utilities.h"
+
+
+
+/*****************************************************************************
+ * Implementation of public member functions of class NameAllocator.
+ *****************************************************************************/
+
+/// Constructs an empty allocator.
+NameAllocator::NameAllocator(void)
+{}
+
+
+/// Forgets all names, that were allocated or reserved so far.
+void NameAllocator::erase(void)
+{
+  mNames.erase();
+  mNextSuffixes.erase();
+}
+
+
+/// Reserves a name, i.e. it won't be returned by allocate(). Reserving a name
+/// twice is allowed.
+///
+/// @param[in]  name
+///   The name to reserve.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+Bool NameAllocator::reserve(const LuxString& name)
+{
+  if (!mNames.add(name)) {
+    ERRLOG_RETURN_VALUE(FALSE, "NameAllocator::reserve(): not enough memory to store name");
+  }
+  return TRUE;
+}
+
+
+/// Returns a unique identifier for a C4D name. The C4D string is converted
+/// only once - see allocate(const LuxString&,LuxString&).
+Bool NameAllocator::allocate(const String& name,
+                             LuxString&    uniqueName)
+{
+  LuxString luxName;
+  convert2LuxString(name, luxName);
+  return allocate(luxName, uniqueName);
+}
+
+
+/// Returns a unique identifier for a name, i.e. the name itself, if it wasn't
+/// used yet, otherwise the name plus the next free number.
+///
+/// @param[in]  name
+///   The name from which the identifier gets derived.
+/// @param[out]  uniqueName
+///   Receives the identifier.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+Bool NameAllocator::allocate(const LuxString& name,
+                             LuxString&       uniqueName)
+{
+  // if the name is still free, use it directly
+  if (!mNames.get(name)) {
+    uniqueName = name;
+    return reserve(uniqueName);
+  }
+
+  // otherwise append the next number, which isn't taken (numbering starts at
+  // 2, as the plain name is the first one)
+  ULONG* nextSuffix = mNextSuffixes.get(name);
+  ULONG  suffix = nextSuffix ? *nextSuffix : 2;
+  CHAR   buffer[16];
+  do {
+    sprintf(buffer, " %u", (unsigned int)suffix++);
+    uniqueName = name + buffer;
+  } while (mNames.get(uniqueName));
+  if (!mNextSuffixes.add(name, suffix)) {
+    ERRLOG_RETURN_VALUE(FALSE, "NameAllocator::allocate(): not enough memory to store name");
+  }
+  return reserve(uniqueName);
+}
@@ -0,0 +1,81 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __NAMEALLOCATOR_H__
+#define __NAMEALLOCATOR_H__  1
+
+
+
+#include <c4d.h>
+
+#include "hashmap.h"
+#include "hashset.h"
+#include "luxtypes.h"
+
+
+
+/***************************************************************************//*!
+ This class hands out unique identifiers, which are derived from (not
+ necessarily unique) names. The first request of a name returns the name
+ itself, the following requests append " 2", " 3", ... to it. Generated names
+ are reserved, too, i.e. they never collide with a later name that happens to
+ look like a generated one.
+
+ For every base name we remember the next suffix to try, so allocating a
+ name takes amortized constant time, even if thousands of names are equal.
+ The identifiers only depend on the order of the requests, i.e. exporting the
+ same scene twice results in the same identifiers.
+*//****************************************************************************/
+class NameAllocator
+{
+public:
+
+  NameAllocator(void);
+
+  void erase(void);
+
+  Bool reserve(const LuxString& name);
+  Bool allocate(const String& name,
+                LuxString&    uniqueName);
+  Bool allocate(const LuxString& name,
+                LuxString&       uniqueName);
+
+
+private:
+
+  typedef HashSet<LuxString>        NamesT;
+  typedef HashMap<LuxString, ULONG> SuffixesT;
+
+  NamesT    mNames;
+  SuffixesT mNextSuffixes;
+
+  // At the moment, we don't allow copying of NameAllocators.
+  NameAllocator(const NameAllocator& other);
+  NameAllocator& operator=(const NameAllocator& other);
+};
+
+
+
+#endif  // #ifndef __NAMEALLOCATOR_H__
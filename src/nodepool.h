@@ -0,0 +1,131 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __NODEPOOL_H__
+#define __NODEPOOL_H__  1
+
+
+
+#include <c4d.h>
+
+
+
+/***************************************************************************//*!
+ This is the default node allocator of the node based containers (DList,
+ RBTreeMap and RBTreeSet): every node gets its own memory block from the C4D
+ memory manager, i.e. nodes can be moved freely between containers.
+
+ A node allocator hands out uninitialised memory for a single node of type
+ NodeT. The container constructs the node with placement new and destroys it
+ before it passes it back to deallocate(). release() gets called after all
+ nodes of a container were deallocated. cCanTransferNodes tells the
+ containers, if a node allocated by one instance may be deallocated by
+ another one.
+*//****************************************************************************/
+template <class NodeT>
+class NodeHeapAllocator
+{
+public:
+
+  enum { cCanTransferNodes = 1 };
+
+  inline void* allocate(void);
+  inline void  deallocate(NodeT* node);
+  inline void  release(void);
+};
+
+
+
+/***************************************************************************//*!
+ This node allocator carves the nodes out of slabs, i.e. larger memory blocks
+ of which each holds many nodes. The first slab has room for cMinSlabNodes
+ nodes and every following slab is twice as large as the previous one until
+ cMaxSlabNodes is reached. Deallocated nodes are put into a free list and get
+ reused by the next allocation. release() gives back all slabs at once.
+
+ Compared to NodeHeapAllocator we need far less calls of the memory manager,
+ the nodes of a container lie close to each other, which helps lookups, and
+ destroying a large container doesn't free thousands of small blocks.
+
+ The nodes belong to the pool of the container that allocated them, i.e. they
+ can't be moved to another container (cCanTransferNodes == 0). The nodes are
+ aligned like other memory blocks of C4D, which rules out node types that
+ need a larger alignment.
+*//****************************************************************************/
+template <class NodeT>
+class NodePool
+{
+public:
+
+  enum { cCanTransferNodes = 0 };
+
+
+  NodePool(void);
+  ~NodePool(void);
+
+  void*       allocate(void);
+  inline void deallocate(NodeT* node);
+  void        release(void);
+
+
+private:
+
+  /// A single node slot of a slab. The first slot of every slab stores the
+  /// link to the previously allocated slab, unused slots are linked into the
+  /// free list.
+  union Slot
+  {
+    Slot* mNext;
+    LReal mAlignment;
+    CHAR  mNode[sizeof(NodeT)];
+  };
+
+
+  /// The number of nodes of the first slab.
+  static const VULONG cMinSlabNodes = 8;
+  /// The maximum number of nodes of a slab.
+  static const VULONG cMaxSlabNodes = 1024;
+
+
+  Slot*  mSlabs;
+  Slot*  mFreeSlots;
+  Slot*  mNextSlot;
+  Slot*  mSlabEnd;
+  VULONG mNextSlabNodes;
+
+
+  // We don't allow copying of NodePools, as the nodes belong to their container.
+  NodePool(const NodePool& other);
+  NodePool& operator=(const NodePool& other);
+
+  Bool allocateSlab(void);
+};
+
+
+#include "nodepool_impl.h"
+
+
+
+#endif  // #ifndef __NODEPOOL_H__
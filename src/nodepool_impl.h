@@ -0,0 +1,157 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __NODEPOOL_IMPL_H__
+#define __NODEPOOL_IMPL_H__ 1
+
+
+
+/*******************************************************************************
+ * Implementation of public member functions of template class NodeHeapAllocator.
+ *******************************************************************************/
+
+/// Allocates the (uninitialised) memory of a single node.
+///
+/// @return
+///   Pointer to the node memory or NULL if we ran out of memory.
+template <class NodeT>
+inline void* NodeHeapAllocator<NodeT>::allocate(void)
+{
+  return GeAllocNC(sizeof(NodeT));
+}
+
+
+/// Deallocates the memory of a node, which has already been destroyed.
+template <class NodeT>
+inline void NodeHeapAllocator<NodeT>::deallocate(NodeT* node)
+{
+  void* memory = node;
+  GeFree(memory);
+}
+
+
+/// Does nothing, as every node was deallocated already.
+template <class NodeT>
+inline void NodeHeapAllocator<NodeT>::release(void)
+{}
+
+
+
+/*******************************************************************************
+ * Implementation of public member functions of template class NodePool.
+ *******************************************************************************/
+
+/// Constructs an empty pool. The first slab is allocated with the first node.
+template <class NodeT>
+NodePool<NodeT>::NodePool(void)
+: mSlabs(0),
+  mFreeSlots(0),
+  mNextSlot(0),
+  mSlabEnd(0),
+  mNextSlabNodes(cMinSlabNodes)
+{}
+
+
+/// Destroys the pool and deallocates all its slabs.
+template <class NodeT>
+NodePool<NodeT>::~NodePool(void)
+{
+  release();
+}
+
+
+/// Allocates the (uninitialised) memory of a single node. Nodes that were
+/// deallocated before are reused first.
+///
+/// @return
+///   Pointer to the node memory or NULL if we ran out of memory.
+template <class NodeT>
+void* NodePool<NodeT>::allocate(void)
+{
+  Slot* slot = mFreeSlots;
+  if (slot) {
+    mFreeSlots = slot->mNext;
+    return slot;
+  }
+  if ((mNextSlot == mSlabEnd) && !allocateSlab())  return 0;
+  return mNextSlot++;
+}
+
+
+/// Puts the memory of a destroyed node back into the free list of the pool.
+///
+/// @param[in]  node
+///   The node, which must have been allocated by this pool.
+template <class NodeT>
+inline void NodePool<NodeT>::deallocate(NodeT* node)
+{
+  Slot* slot = (Slot*)node;
+  slot->mNext = mFreeSlots;
+  mFreeSlots = slot;
+}
+
+
+/// Deallocates all slabs. All nodes must have been destroyed before.
+template <class NodeT>
+void NodePool<NodeT>::release(void)
+{
+  while (mSlabs) {
+    void* slab = mSlabs;
+    mSlabs = mSlabs->mNext;
+    GeFree(slab);
+  }
+  mFreeSlots     = 0;
+  mNextSlot      = 0;
+  mSlabEnd       = 0;
+  mNextSlabNodes = cMinSlabNodes;
+}
+
+
+
+/*******************************************************************************
+ * Implementation of private member functions of template class NodePool.
+ *******************************************************************************/
+
+/// Allocates a new slab, from which the following nodes are taken. This is
+/// only called if the current slab is full.
+///
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+template <class NodeT>
+Bool NodePool<NodeT>::allocateSlab(void)
+{
+  Slot* slab = (Slot*)GeAllocNC((mNextSlabNodes + 1) * sizeof(Slot));
+  if (!slab)  return FALSE;
+  slab->mNext = mSlabs;
+  mSlabs    = slab;
+  mNextSlot = slab + 1;
+  mSlabEnd  = mNextSlot + mNextSlabNodes;
+  if (mNextSlabNodes < cMaxSlabNodes)  mNextSlabNodes *= 2;
+  return TRUE;
+}
+
+
+
+#endif  // #ifndef __NODEPOOL_IMPL_H__
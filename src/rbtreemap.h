@@ -28,6 +28,12 @@
 
 
 
+#include <new>
+
+#include "nodepool.h"
+
+
+
 /***************************************************************************//*!
  This class implments a map, based on the very cool "simplified"
  left-leaning red-black tree of Robert Sedgewick:
@@ -39,9 +45,12 @@
  The template type has to support the following functions:
   - Copy constructor  T::T(const T&)
   - Copy operator     T::operator=(const T&)
+
+ The nodes are allocated by ALLOCATOR<Node>, which is NodeHeapAllocator by
+ default. Maps that get many entries should use NodePool instead.
 *//****************************************************************************/
 
-template <class K, class T>
+template <class K, class T, template <class> class ALLOCATOR=NodeHeapAllocator>
 class RBTreeMap
 {
 public:
@@ -117,6 +126,8 @@ private:
   SizeT mSize;
   Node* mNewNode;
 
+  ALLOCATOR<Node> mAllocator;
+
 
   // At the moment, we don't allow copying of RBTreeMaps.
   RBTreeMap(const RBTreeMap& other) {}
@@ -130,7 +141,7 @@ private:
                const KeyT&   key,
                const ValueT& value);
 
-  static void deleteRecursive(Node* node);
+  void deleteRecursive(Node* node);
 };
 
 
@@ -33,15 +33,15 @@
  *******************************************************************************/
 
 /// Constructs a new (empty) red-black tree.
-template <class K, class T>
-RBTreeMap<K,T>::RBTreeMap(void)
+template <class K, class T, template <class> class ALLOCATOR>
+RBTreeMap<K,T,ALLOCATOR>::RBTreeMap(void)
 : mRoot(0), mSize(0)
 {}
 
 
 /// Destroys a red-black tree and deallocates its resources.
-template <class K, class T>
-RBTreeMap<K,T>::~RBTreeMap(void)
+template <class K, class T, template <class> class ALLOCATOR>
+RBTreeMap<K,T,ALLOCATOR>::~RBTreeMap(void)
 {
   erase();
 }
@@ -49,18 +49,19 @@ RBTreeMap<K,T>::~RBTreeMap(void)
 
 /// Deallocates all resources of a red-black tree. The tree will be empty
 /// afterwards.
-template <class K, class T>
-void RBTreeMap<K,T>::erase(void)
+template <class K, class T, template <class> class ALLOCATOR>
+void RBTreeMap<K,T,ALLOCATOR>::erase(void)
 {
-  RBTreeMap<K,T>::deleteRecursive(mRoot);
+  deleteRecursive(mRoot);
+  mAllocator.release();
   mRoot = 0;
   mSize = 0;
 }
 
 
 /// Returns the number of entries of red-black tree.
-template <class K, class T>
-inline typename RBTreeMap<K,T>::SizeT RBTreeMap<K,T>::size(void) const
+template <class K, class T, template <class> class ALLOCATOR>
+inline typename RBTreeMap<K,T,ALLOCATOR>::SizeT RBTreeMap<K,T,ALLOCATOR>::size(void) const
 {
   return mSize;
 }
@@ -75,9 +76,9 @@ inline typename RBTreeMap<K,T>::SizeT RBTreeMap<K,T>::size(void) const
 ///   The value to add.
 /// @return
 ///   NULL if we ran out of memory, otherwise the pointer to the stored value.
-template <class K, class T>
-typename RBTreeMap<K,T>::ValueT* RBTreeMap<K,T>::add(const KeyT& key,
-                                                     const ValueT& value)
+template <class K, class T, template <class> class ALLOCATOR>
+typename RBTreeMap<K,T,ALLOCATOR>::ValueT* RBTreeMap<K,T,ALLOCATOR>::add(const KeyT& key,
+                                                                         const ValueT& value)
 {
   mNewNode = 0;
   mRoot = insert(mRoot, key, value);
@@ -92,8 +93,8 @@ typename RBTreeMap<K,T>::ValueT* RBTreeMap<K,T>::add(const KeyT& key,
 ///   The key for which the value will be looked up.
 /// @return
 ///   Pointer to the found value, or NULL if there is no matching value.
-template <class K, class T>
-const typename RBTreeMap<K,T>::ValueT* RBTreeMap<K,T>::get(const KeyT& key) const
+template <class K, class T, template <class> class ALLOCATOR>
+const typename RBTreeMap<K,T,ALLOCATOR>::ValueT* RBTreeMap<K,T,ALLOCATOR>::get(const KeyT& key) const
 {
   const Node* node = mRoot;
   while (node) {
@@ -115,8 +116,8 @@ const typename RBTreeMap<K,T>::ValueT* RBTreeMap<K,T>::get(const KeyT& key) cons
 ///   The key for which the value will be looked up.
 /// @return
 ///   Pointer to the found value, or NULL if there is no matching value.
-template <class K, class T>
-typename RBTreeMap<K,T>::ValueT* RBTreeMap<K,T>::get(const KeyT& key)
+template <class K, class T, template <class> class ALLOCATOR>
+typename RBTreeMap<K,T,ALLOCATOR>::ValueT* RBTreeMap<K,T,ALLOCATOR>::get(const KeyT& key)
 {
   Node* node = mRoot;
   while (node) {
@@ -142,8 +143,8 @@ typename RBTreeMap<K,T>::ValueT* RBTreeMap<K,T>::get(const KeyT& key)
 ///   Pointer to the root node of the sub-tree (must not be NULL).
 /// @return
 ///   Pointer to the new root node of the rotated sub-tree.
-template <class K, class T>
-inline typename RBTreeMap<K,T>::Node* RBTreeMap<K,T>::rotateLeft(Node* node)
+template <class K, class T, template <class> class ALLOCATOR>
+inline typename RBTreeMap<K,T,ALLOCATOR>::Node* RBTreeMap<K,T,ALLOCATOR>::rotateLeft(Node* node)
 {
   Node* child   = node->mRight;
   node->mRight  = child->mLeft;
@@ -160,8 +161,8 @@ inline typename RBTreeMap<K,T>::Node* RBTreeMap<K,T>::rotateLeft(Node* node)
 ///   Pointer to the root node of the sub-tree (must not be NULL).
 /// @return
 ///   Pointer to the new root node of the rotated sub-tree.
-template <class K, class T>
-inline typename RBTreeMap<K,T>::Node* RBTreeMap<K,T>::rotateRight(Node* node)
+template <class K, class T, template <class> class ALLOCATOR>
+inline typename RBTreeMap<K,T,ALLOCATOR>::Node* RBTreeMap<K,T,ALLOCATOR>::rotateRight(Node* node)
 {
   Node* child   = node->mLeft;
   node->mLeft   = child->mRight;
@@ -180,8 +181,8 @@ inline typename RBTreeMap<K,T>::Node* RBTreeMap<K,T>::rotateRight(Node* node)
 ///
 /// @param[in]  node
 ///   Pointer to the parent node (must nit be NULL).
-template <class K, class T>
-inline void RBTreeMap<K,T>::colorFlip(Node* node)
+template <class K, class T, template <class> class ALLOCATOR>
+inline void RBTreeMap<K,T,ALLOCATOR>::colorFlip(Node* node)
 {
   node->mIsRed         ^= 1;
   node->mLeft->mIsRed  ^= 1;
@@ -205,14 +206,15 @@ inline void RBTreeMap<K,T>::colorFlip(Node* node)
 /// @return
 ///   Pointer to the new root node of the sub-tree or NULL, if the allocation
 ///   of a new tree node failed.
-template <class K, class T>
-typename RBTreeMap<K,T>::Node* RBTreeMap<K,T>::insert(Node*         node,
-                                                      const KeyT&   key,
-                                                      const ValueT& value)
+template <class K, class T, template <class> class ALLOCATOR>
+typename RBTreeMap<K,T,ALLOCATOR>::Node* RBTreeMap<K,T,ALLOCATOR>::insert(Node*         node,
+                                                                          const KeyT&   key,
+                                                                          const ValueT& value)
 {
   // if we have found a leave, add new node to it and return
   if (!node) {
-    mNewNode = gNew Node(key, value);
+    void* memory = mAllocator.allocate();
+    mNewNode = memory ? new (memory) Node(key, value) : 0;
     return mNewNode;
   }
 
@@ -247,17 +249,19 @@ typename RBTreeMap<K,T>::Node* RBTreeMap<K,T>::insert(Node*         node,
 }
 
 
-/// Deletes recursively all nodes of a sub-tree.
+/// Destroys recursively all nodes of a sub-tree and passes them back to the
+/// node allocator.
 ///
 /// @param[in]  node
 ///   Pointer to the root node of the sub-tree (can be NULL).
-template <class K, class T>
-void RBTreeMap<K,T>::deleteRecursive(Node* node)
+template <class K, class T, template <class> class ALLOCATOR>
+void RBTreeMap<K,T,ALLOCATOR>::deleteRecursive(Node* node)
 {
   if (!node)  return;
   deleteRecursive(node->mLeft);
   deleteRecursive(node->mRight);
-  gDelete(node);
+  node->~Node();
+  mAllocator.deallocate(node);
 }
 
 
@@ -28,6 +28,12 @@
 
 
 
+#include <new>
+
+#include "nodepool.h"
+
+
+
 /***************************************************************************//*!
  This class implments a set, based on the very cool "simplified"
  left-leaning red-black tree of Robert Sedgewick:
@@ -37,9 +43,12 @@
   - Copy constructor  T::T(const T&)
   - Copy operator     T::operator=(const T&)
   - Less operator     bool T::operator<(const T&)
+
+ The nodes are allocated by ALLOCATOR<Node>, which is NodeHeapAllocator by
+ default. Sets that get many entries should use NodePool instead.
 *//****************************************************************************/
 
-template <class T>
+template <class T, template <class> class ALLOCATOR=NodeHeapAllocator>
 class RBTreeSet
 {
 public:
@@ -109,6 +118,8 @@ private:
   SizeT mSize;
   Node* mNewNode;
 
+  ALLOCATOR<Node> mAllocator;
+
 
   RBTreeSet(const RBTreeSet& other) {}
   RBTreeSet& operator==(const RBTreeSet& other)  {}
@@ -120,7 +131,7 @@ private:
   Node* insert(Node* node,
                const ValueT& value);
 
-  static void deleteRecursive(Node* node);
+  void deleteRecursive(Node* node);
 };
 
 
@@ -33,15 +33,15 @@
  *******************************************************************************/
 
 /// Constructs a new (empty) red-black tree.
-template <class T>
-RBTreeSet<T>::RBTreeSet(void)
+template <class T, template <class> class ALLOCATOR>
+RBTreeSet<T,ALLOCATOR>::RBTreeSet(void)
 : mRoot(0), mSize(0)
 {}
 
 
 /// Destroys a red-black tree and deallocates its resources.
-template <class T>
-RBTreeSet<T>::~RBTreeSet(void)
+template <class T, template <class> class ALLOCATOR>
+RBTreeSet<T,ALLOCATOR>::~RBTreeSet(void)
 {
   erase();
 }
@@ -49,18 +49,19 @@ RBTreeSet<T>::~RBTreeSet(void)
 
 /// Deallocates all resources of a red-black tree. The tree will be empty
 /// afterwards.
-template <class T>
-void RBTreeSet<T>::erase(void)
+template <class T, template <class> class ALLOCATOR>
+void RBTreeSet<T,ALLOCATOR>::erase(void)
 {
-  RBTreeSet<T>::deleteRecursive(mRoot);
+  deleteRecursive(mRoot);
+  mAllocator.release();
   mRoot = 0;
   mSize = 0;
 }
 
 
 /// Returns the number of entries of red-black tree.
-template <class T>
-inline typename RBTreeSet<T>::SizeT RBTreeSet<T>::size(void) const
+template <class T, template <class> class ALLOCATOR>
+inline typename RBTreeSet<T,ALLOCATOR>::SizeT RBTreeSet<T,ALLOCATOR>::size(void) const
 {
   return mSize;
 }
@@ -73,8 +74,8 @@ inline typename RBTreeSet<T>::SizeT RBTreeSet<T>::size(void) const
 ///   The value to add to the red-black tree.
 /// @return
 ///   NULL if we ran out of memory, otherwise the pointer to the stored entry.
-template <class T>
-const typename RBTreeSet<T>::ValueT* RBTreeSet<T>::add(const ValueT& value)
+template <class T, template <class> class ALLOCATOR>
+const typename RBTreeSet<T,ALLOCATOR>::ValueT* RBTreeSet<T,ALLOCATOR>::add(const ValueT& value)
 {
   mNewNode = 0;
   mRoot = insert(mRoot, value);
@@ -90,8 +91,8 @@ const typename RBTreeSet<T>::ValueT* RBTreeSet<T>::add(const ValueT& value)
 ///   The value that defines the rang of the value to retrieve.
 /// @return
 ///   Pointer to the found value, or NULL if there is no matching value.
-template <class T>
-const typename RBTreeSet<T>::ValueT* RBTreeSet<T>::get(const ValueT& value) const
+template <class T, template <class> class ALLOCATOR>
+const typename RBTreeSet<T,ALLOCATOR>::ValueT* RBTreeSet<T,ALLOCATOR>::get(const ValueT& value) const
 {
   const Node* node = mRoot;
   while (node) {
@@ -118,8 +119,8 @@ const typename RBTreeSet<T>::ValueT* RBTreeSet<T>::get(const ValueT& value) cons
 ///   Pointer to the root node of the sub-tree (must not be NULL).
 /// @return
 ///   Pointer to the new root node of the rotated sub-tree.
-template <class T>
-inline typename RBTreeSet<T>::Node* RBTreeSet<T>::rotateLeft(Node* node)
+template <class T, template <class> class ALLOCATOR>
+inline typename RBTreeSet<T,ALLOCATOR>::Node* RBTreeSet<T,ALLOCATOR>::rotateLeft(Node* node)
 {
   Node* child   = node->mRight;
   node->mRight  = child->mLeft;
@@ -136,8 +137,8 @@ inline typename RBTreeSet<T>::Node* RBTreeSet<T>::rotateLeft(Node* node)
 ///   Pointer to the root node of the sub-tree (must not be NULL).
 /// @return
 ///   Pointer to the new root node of the rotated sub-tree.
-template <class T>
-inline typename RBTreeSet<T>::Node* RBTreeSet<T>::rotateRight(Node* node)
+template <class T, template <class> class ALLOCATOR>
+inline typename RBTreeSet<T,ALLOCATOR>::Node* RBTreeSet<T,ALLOCATOR>::rotateRight(Node* node)
 {
   Node* child   = node->mLeft;
   node->mLeft   = child->mRight;
@@ -156,8 +157,8 @@ inline typename RBTreeSet<T>::Node* RBTreeSet<T>::rotateRight(Node* node)
 ///
 /// @param[in]  node
 ///   Pointer to the parent node (must nit be NULL).
-template <class T>
-inline void RBTreeSet<T>::colorFlip(Node* node)
+template <class T, template <class> class ALLOCATOR>
+inline void RBTreeSet<T,ALLOCATOR>::colorFlip(Node* node)
 {
   node->mIsRed         ^= 1;
   node->mLeft->mIsRed  ^= 1;
@@ -179,13 +180,14 @@ inline void RBTreeSet<T>::colorFlip(Node* node)
 /// @return
 ///   Pointer to the new root node of the sub-tree or NULL, if the allocation
 ///   of a new tree node failed.
-template <class T>
-typename RBTreeSet<T>::Node* RBTreeSet<T>::insert(Node*         node,
-                                                  const ValueT& value)
+template <class T, template <class> class ALLOCATOR>
+typename RBTreeSet<T,ALLOCATOR>::Node* RBTreeSet<T,ALLOCATOR>::insert(Node*         node,
+                                                                      const ValueT& value)
 {
   // if we have found a leave, add new node to it and return
   if (!node) {
-    mNewNode = gNew Node(value);
+    void* memory = mAllocator.allocate();
+    mNewNode = memory ? new (memory) Node(value) : 0;
     return mNewNode;
   }
 
@@ -218,17 +220,19 @@ typename RBTreeSet<T>::Node* RBTreeSet<T>::insert(Node*         node,
 }
 
 
-/// Deletes recursively all nodes of a sub-tree.
+/// Destroys recursively all nodes of a sub-tree and passes them back to the
+/// node allocator.
 ///
 /// @param[in]  node
 ///   Pointer to the root node of the sub-tree (can be NULL).
-template <class T>
-void RBTreeSet<T>::deleteRecursive(Node* node)
+template <class T, template <class> class ALLOCATOR>
+void RBTreeSet<T,ALLOCATOR>::deleteRecursive(Node* node)
 {
   if (!node)  return;
   deleteRecursive(node->mLeft);
   deleteRecursive(node->mRight);
-  gDelete(node);
+  node->~Node();
+  mAllocator.deallocate(node);
 }
 
 
@@ -0,0 +1,93 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include "symboltable.h"
+#include "utilities.h"
+
+
+
+/*****************************************************************************
+ * Implementation of public member functions of class SymbolTable.
+ *****************************************************************************/
+
+/// Constructs an empty symbol table.
+SymbolTable::SymbolTable(void)
+{}
+
+
+/// Forgets all symbols. All symbols handed out so far become invalid.
+void SymbolTable::erase(void)
+{
+  mC4DSymbols.erase();
+  mSymbols.erase();
+  mStrings.erase();
+}
+
+
+/// Returns the symbol of a string. If the string wasn't interned yet, a copy
+/// of it is stored in the table.
+///
+/// @param[in]  name
+///   The string to intern.
+/// @return
+///   The symbol of the string or NULL if we ran out of memory.
+LuxSymbol SymbolTable::intern(const LuxString& name)
+{
+  // if the string is already known, return its symbol
+  const LuxSymbol* symbol = mSymbols.get(&name);
+  if (symbol) {
+    return *symbol;
+  }
+
+  // otherwise store a copy of the string and register it
+  if (!mStrings.pushBack(name)) {
+    ERRLOG_RETURN_VALUE(0, "SymbolTable::intern(): not enough memory to store string");
+  }
+  LuxSymbol newSymbol = &mStrings.back();
+  if (!mSymbols.add(newSymbol)) {
+    mStrings.removeBack();
+    ERRLOG_RETURN_VALUE(0, "SymbolTable::intern(): not enough memory to store symbol");
+  }
+  return newSymbol;
+}
+
+
+/// Returns the symbol of a C4D string. The string is converted only the first
+/// time it's passed in - see intern(const LuxString&).
+LuxSymbol SymbolTable::intern(const String& name)
+{
+  LuxSymbol* symbol = mC4DSymbols.get(name);
+  if (symbol) {
+    return *symbol;
+  }
+
+  LuxString luxName;
+  convert2LuxString(name, luxName);
+  LuxSymbol newSymbol = intern(luxName);
+  if (newSymbol && !mC4DSymbols.add(name, newSymbol)) {
+    ERRLOG_RETURN_VALUE(0, "SymbolTable::intern(): not enough memory to store C4D string");
+  }
+  return newSymbol;
+}
@@ -0,0 +1,106 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __SYMBOLTABLE_H__
+#define __SYMBOLTABLE_H__  1
+
+
+
+#include <c4d.h>
+
+#include "dlist.h"
+#include "hashmap.h"
+#include "hashset.h"
+#include "luxtypes.h"
+
+
+
+/// An interned string, i.e. a pointer to the single copy of a string in a
+/// SymbolTable. Two symbols of the same table are equal, if and only if their
+/// pointers are equal. The pointer can be passed directly as value of a
+/// LUX_STRING or LUX_TEXTURE parameter.
+typedef const LuxString* LuxSymbol;
+
+
+
+/***************************************************************************//*!
+ This class stores each distinct string only once and hands out a LuxSymbol
+ for it. Symbols stay valid until erase() is called or the table is destroyed,
+ so they can be copied around, compared and hashed like plain pointers.
+
+ C4D strings are converted only once - the symbol of a C4D string is
+ remembered, so interning the same C4D name again is a single hash lookup.
+*//****************************************************************************/
+class SymbolTable
+{
+public:
+
+  SymbolTable(void);
+
+  void erase(void);
+
+  inline SizeT size(void) const  { return mStrings.size(); }
+
+  LuxSymbol intern(const LuxString& name);
+  LuxSymbol intern(const String& name);
+
+
+private:
+
+  /// Hashes and compares symbols by the strings they point to, which allows
+  /// us to look up a string before it's interned.
+  struct ContentHashTraits {
+    static inline ULONG hash(LuxSymbol key)
+    {
+      return HashTraits<LuxString>::hash(*key);
+    }
+
+    static inline Bool equal(LuxSymbol key1, LuxSymbol key2)
+    {
+      return (*key1 == *key2);
+    }
+  };
+
+  /// The container type for storing the strings (the nodes never move).
+  typedef DList<LuxString, NodePool>              StringsT;
+  /// The lookup set of all symbols.
+  typedef HashSet<LuxSymbol, ContentHashTraits>   SymbolsT;
+  /// The lookup map from C4D strings to their symbols.
+  typedef HashMap<String, LuxSymbol>              C4DSymbolsT;
+
+
+  StringsT    mStrings;
+  SymbolsT    mSymbols;
+  C4DSymbolsT mC4DSymbols;
+
+
+  // At the moment, we don't allow copying of SymbolTables.
+  SymbolTable(const SymbolTable& other);
+  SymbolTable& operator=(const SymbolTable& other);
+};
+
+
+
+#endif  // #ifndef __SYMBOLTABLE_H__
@@ -25,6 +25,8 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 #include "common.h"
 #include "dlist.h"
@@ -44,7 +46,91 @@ const CHAR* gPathDelimiterStr = "/";
 
 
 
-/// Works like printf, but writes the string to the debug console.
+/// The current level of the debug log - see LogLevel. Messages below this
+/// level are skipped by the LOG_...() macros.
+LONG gLogLevel = LOGLEVEL_INFO;
+
+/// The file the debug log is copied to or NULL, if there is no log file.
+static BaseFile* sLogFile = 0;
+
+/// Serialises the writes into the log file, as the frames of an animation are
+/// exported by several threads.
+static Semaphore* sLogLock = 0;
+
+
+
+/// Writes a line into the debug console and into the log file, if one is set.
+static void writeLog(const CHAR* text)
+{
+  C4DOS.Ge->GeDebugOut("%s", text);
+  if (sLogFile && sLogLock) {
+    sLogLock->Lock();
+    sLogFile->WriteBytes((void*)text, (VLONG)strlen(text));
+    sLogFile->WriteBytes((void*)"\n", 1);
+    sLogLock->UnLock();
+  }
+}
+
+
+/// Initialises the debug log. The log level and log file can be set via the
+/// environment variables LUXC4D_LOG_LEVEL (0 = trace ... 4 = none) and
+/// LUXC4D_LOG_FILE, which is useful for diagnosing exports on a render farm.
+///
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool initLogging(void)
+{
+  sLogLock = Semaphore::Alloc();
+  if (!sLogLock) {
+    ERRLOG_RETURN_VALUE(FALSE, "initLogging(): could not allocate log lock");
+  }
+  const char* level = getenv("LUXC4D_LOG_LEVEL");
+  if (level && *level) {
+    gLogLevel = (LONG)atoi(level);
+  }
+  const char* logFile = getenv("LUXC4D_LOG_FILE");
+  if (logFile && *logFile) {
+    return setLogFile(Filename(String(logFile)));
+  }
+  return TRUE;
+}
+
+
+/// Closes the log file and frees the resources allocated by initLogging().
+void freeLogging(void)
+{
+  setLogFile(Filename());
+  Semaphore::Free(sLogLock);
+}
+
+
+/// Sets the file into which all messages of the debug log are copied. The file
+/// gets overwritten. This must not be called while an export is running.
+///
+/// @param[in]  logFile
+///   The path of the log file or an empty path to close the current log file.
+/// @return
+///   TRUE if successful, FALSE otherwise.
+Bool setLogFile(const Filename& logFile)
+{
+  if (sLogFile) {
+    sLogFile->Close();
+    BaseFile::Free(sLogFile);
+  }
+  if (!logFile.Content())  return TRUE;
+
+  sLogFile = BaseFile::Alloc();
+  if (!sLogFile || !sLogFile->Open(logFile, FILEOPEN_WRITE, FILEDIALOG_NONE)) {
+    BaseFile::Free(sLogFile);
+    ERRLOG_RETURN_VALUE(FALSE, "setLogFile(): could not open log file '" + logFile.GetString() + "'");
+  }
+  return TRUE;
+}
+
+
+/// Works like printf, but writes the string to the debug console and the log
+/// file. Messages longer than 2047 characters get truncated. Use it via the
+/// LOG_...() macros, which skip disabled levels.
 void debugLog(const CHAR* format, ...)
 {
   static const SizeT cBufferSize = 2048;
@@ -52,13 +138,19 @@ void debugLog(const CHAR* format, ...)
 
   va_list args;
 	va_start(args, format);
-  vsprintf(charBuffer, format, args);
-	C4DOS.Ge->GeDebugOut("%s", charBuffer);
+#if defined(_MSC_VER) && (_MSC_VER < 1900)
+  _vsnprintf(charBuffer, cBufferSize, format, args);
+#else
+  vsnprintf(charBuffer, cBufferSize, format, args);
+#endif
 	va_end(args);
+  charBuffer[cBufferSize-1] = '\0';
+  writeLog(charBuffer);
 }
 
 
-/// Writes a string to the debug console.
+/// Writes a string to the debug console and the log file. Use it via the
+/// LOG_...() macros, which skip disabled levels.
 void debugLog(const String& msg)
 {
   static const SizeT cBufferSize = 2048;
@@ -66,7 +158,7 @@ void debugLog(const String& msg)
 
   msg.GetCString(charBuffer, cBufferSize);
   charBuffer[cBufferSize-1] = '\0';
-	C4DOS.Ge->GeDebugOut("%s", charBuffer);
+  writeLog(charBuffer);
 }
 
 
@@ -57,6 +57,50 @@
 
 
 
+/*****************************************************************************
+ * Leveled debug logging
+ *****************************************************************************/
+
+/// The levels of the debug log. A message is only written, if its level is not
+/// below the minimum level of the build (LUXC4D_MIN_LOG_LEVEL) and not below
+/// the current log level (gLogLevel).
+enum LogLevel
+{
+  LOGLEVEL_TRACE = 0,
+  LOGLEVEL_DEBUG,
+  LOGLEVEL_INFO,
+  LOGLEVEL_WARNING,
+  LOGLEVEL_NONE
+};
+
+/// The minimum level of messages that get compiled in. Messages below it are
+/// removed by the compiler, e.g. define it as LOGLEVEL_INFO for release builds.
+#ifndef LUXC4D_MIN_LOG_LEVEL
+#define LUXC4D_MIN_LOG_LEVEL  LOGLEVEL_TRACE
+#endif
+
+/// Evaluates to TRUE if messages of the specified level are written.
+#define LOG_ENABLED(level)                                                    \
+  (((level) >= LUXC4D_MIN_LOG_LEVEL) && ((level) >= gLogLevel))
+
+/// Writes a message into the debug log, if its level is enabled. The
+/// arguments are passed on to debugLog(), but are not evaluated at all if the
+/// level is disabled, i.e. string concatenations are free then. It expands to
+/// a single statement, so it can be used in an unbraced if-else.
+#define LOG_MESSAGE(level,...)                                                \
+  do { if (LOG_ENABLED(level)) debugLog(__VA_ARGS__); } while (0)
+
+/// Writes a message of level LOGLEVEL_TRACE - see LOG_MESSAGE().
+#define LOG_TRACE(...)    LOG_MESSAGE(LOGLEVEL_TRACE, __VA_ARGS__)
+/// Writes a message of level LOGLEVEL_DEBUG - see LOG_MESSAGE().
+#define LOG_DEBUG(...)    LOG_MESSAGE(LOGLEVEL_DEBUG, __VA_ARGS__)
+/// Writes a message of level LOGLEVEL_INFO - see LOG_MESSAGE().
+#define LOG_INFO(...)     LOG_MESSAGE(LOGLEVEL_INFO, __VA_ARGS__)
+/// Writes a message of level LOGLEVEL_WARNING - see LOG_MESSAGE().
+#define LOG_WARNING(...)  LOG_MESSAGE(LOGLEVEL_WARNING, __VA_ARGS__)
+
+
+
 /*****************************************************************************
  * Common types
  *****************************************************************************/
@@ -72,12 +116,20 @@ typedef VULONG  SizeT;
 extern const CHAR  gPathDelimiter;
 extern const CHAR* gPathDelimiterStr;
 
+extern LONG gLogLevel;
+
 
 
 /*****************************************************************************
  * Functions
  *****************************************************************************/
 
+Bool initLogging(void);
+
+void freeLogging(void);
+
+Bool setLogFile(const Filename& logFile);
+
 void debugLog(const CHAR* format, ...);
 
 void debugLog(const String& msg);
@@ -0,0 +1,78 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#include "utilities.h"
+#include "vectorstreams.h"
+
+
+
+/*****************************************************************************
+ * Implementation of public member functions of class VectorStreams.
+ *****************************************************************************/
+
+/// Constructs empty streams.
+VectorStreams::VectorStreams(void)
+: mSize(0), mPaddedSize(0)
+{}
+
+
+/// Deallocates the current streams and allocates new ones for SIZE vectors.
+/// The stream entries are not initialised, except the padding, which is set
+/// to 0.
+///
+/// @param[in]  size
+///   The number of vectors to store.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+Bool VectorStreams::init(SizeT size)
+{
+  erase();
+  if (size <= 0)  return TRUE;
+
+  SizeT paddedSize = (size + cStreamPadding - 1) / cStreamPadding * cStreamPadding;
+  if (!mStreams.init(3*paddedSize)) {
+    ERRLOG_RETURN_VALUE(FALSE, "VectorStreams::init(): not enough memory to allocate streams");
+  }
+  mSize       = size;
+  mPaddedSize = paddedSize;
+
+  // clear padding of all streams
+  LuxFloat* streams = mStreams.arrayAddress();
+  for (SizeT stream=0; stream<3; ++stream) {
+    for (SizeT c=size; c<paddedSize; ++c) {
+      streams[stream*paddedSize + c] = 0.0f;
+    }
+  }
+  return TRUE;
+}
+
+
+/// Deallocates the streams.
+void VectorStreams::erase(void)
+{
+  mStreams.erase();
+  mSize       = 0;
+  mPaddedSize = 0;
+}
@@ -0,0 +1,204 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __VECTORSTREAMS_H__
+#define __VECTORSTREAMS_H__  1
+
+
+
+#include <c4d.h>
+
+#include "fixarray1d.h"
+#include "luxtypes.h"
+
+
+
+/***************************************************************************//*!
+ This class stores 3D vectors as structure of arrays, i.e. as three separate
+ streams of X, Y and Z components. It allows writing geometry kernels against
+ plain float arrays, which is what SIMD code needs, while the rest of the
+ exporter keeps using arrays of LuxPoint, LuxNormal or LuxVector.
+
+ All streams are stored in one memory block. Each stream starts at an address
+ aligned to LUXC4D_SIMD_ALIGNMENT bytes and is padded to a multiple of
+ paddedSize() entries, so kernels can always process complete SIMD registers.
+ The padding entries are set to 0 by init() (and thus by load()).
+
+ The vector type used by load() and store() has to have the float members x, y
+ and z.
+*//****************************************************************************/
+class VectorStreams
+{
+public:
+
+  /// The number of floats that fit into one SIMD alignment unit. Stream sizes
+  /// are a multiple of it.
+  static const SizeT cStreamPadding = LUXC4D_SIMD_ALIGNMENT / sizeof(LuxFloat);
+
+
+  VectorStreams(void);
+
+  Bool init(SizeT size);
+  void erase(void);
+
+  inline SizeT size(void) const;
+  inline SizeT paddedSize(void) const;
+
+  inline const LuxFloat* x(void) const;
+  inline LuxFloat*       x(void);
+  inline const LuxFloat* y(void) const;
+  inline LuxFloat*       y(void);
+  inline const LuxFloat* z(void) const;
+  inline LuxFloat*       z(void);
+
+  template <class VectorT>
+  Bool load(const VectorT* vectors,
+            SizeT          size);
+  template <class VectorT>
+  void store(VectorT* vectors) const;
+
+
+private:
+
+  typedef FixArray1D<LuxFloat, LUXC4D_SIMD_ALIGNMENT> StreamsT;
+
+  StreamsT mStreams;
+  SizeT    mSize;
+  SizeT    mPaddedSize;
+
+  // At the moment, we don't allow copying of VectorStreams.
+  VectorStreams(const VectorStreams& other);
+  VectorStreams& operator=(const VectorStreams& other);
+};
+
+
+
+/*****************************************************************************
+ * Inlined functions of VectorStreams
+ *****************************************************************************/
+
+/// Returns the number of vectors stored in the streams.
+inline SizeT VectorStreams::size(void) const
+{
+  return mSize;
+}
+
+
+/// Returns the number of entries per stream including the padding, which is
+/// a multiple of cStreamPadding.
+inline SizeT VectorStreams::paddedSize(void) const
+{
+  return mPaddedSize;
+}
+
+
+/// Returns a constant pointer to the aligned stream of X components.
+inline const LuxFloat* VectorStreams::x(void) const
+{
+  return mStreams.arrayAddress();
+}
+
+
+/// Returns a pointer to the aligned stream of X components.
+inline LuxFloat* VectorStreams::x(void)
+{
+  return mStreams.arrayAddress();
+}
+
+
+/// Returns a constant pointer to the aligned stream of Y components.
+inline const LuxFloat* VectorStreams::y(void) const
+{
+  return mStreams.arrayAddress() + mPaddedSize;
+}
+
+
+/// Returns a pointer to the aligned stream of Y components.
+inline LuxFloat* VectorStreams::y(void)
+{
+  return mStreams.arrayAddress() + mPaddedSize;
+}
+
+
+/// Returns a constant pointer to the aligned stream of Z components.
+inline const LuxFloat* VectorStreams::z(void) const
+{
+  return mStreams.arrayAddress() + 2*mPaddedSize;
+}
+
+
+/// Returns a pointer to the aligned stream of Z components.
+inline LuxFloat* VectorStreams::z(void)
+{
+  return mStreams.arrayAddress() + 2*mPaddedSize;
+}
+
+
+/// (Re-)initialises the streams and splits an array of vectors into them.
+///
+/// @param[in]  vectors
+///   The array of vectors to load (can be NULL if size is 0).
+/// @param[in]  size
+///   The number of vectors in the array.
+/// @return
+///   TRUE if successful, FALSE if we ran out of memory.
+template <class VectorT>
+Bool VectorStreams::load(const VectorT* vectors,
+                         SizeT          size)
+{
+  if (!init(size))  return FALSE;
+  LuxFloat* xs = x();
+  LuxFloat* ys = y();
+  LuxFloat* zs = z();
+  for (SizeT c=0; c<size; ++c) {
+    xs[c] = vectors[c].x;
+    ys[c] = vectors[c].y;
+    zs[c] = vectors[c].z;
+  }
+  return TRUE;
+}
+
+
+/// Merges the streams back into an array of vectors.
+///
+/// @param[out]  vectors
+///   The array where the vectors will be stored. It must have at least size()
+///   entries.
+template <class VectorT>
+void VectorStreams::store(VectorT* vectors) const
+{
+  const LuxFloat* xs = x();
+  const LuxFloat* ys = y();
+  const LuxFloat* zs = z();
+  for (SizeT c=0; c<mSize; ++c) {
+    vectors[c].x = xs[c];
+    vectors[c].y = ys[c];
+    vectors[c].z = zs[c];
+  }
+}
+
+
+
+#endif  // #ifndef __VECTORSTREAMS_H__
@@ -0,0 +1,348 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+/*****************************************************************************
+ * Test and benchmark of GeometryKernels. The test runs every kernel with all
+ * instruction sets the CPU supports and checks that the results are
+ * bit-identical to the scalar kernels, for sizes 0 to 69, aligned and
+ * unaligned arrays, zero vectors, NaNs, infinities and values near the
+ * threshold of equalPolygonNormals(). Guard values behind every output array
+ * detect writes past its end. With the argument "--benchmark", it also
+ * measures every kernel with 1M entries.
+ *****************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <vector>
+
+#include "geometrykernels.h"
+
+
+
+/// The number of failed checks.
+static int sFailures = 0;
+
+
+/// Records a failed check, if the condition is false.
+#define CHECK(condition, kernel, size)                                        \
+  { if (!(condition)) {                                                       \
+      printf("%s:%d: %s (%s, size %u) failed: %s\n", __FILE__, __LINE__,      \
+             kernel, GeometryKernels::instructionSetName(                     \
+                       GeometryKernels::instructionSet()),                    \
+             (unsigned int)(size), #condition);                               \
+      ++sFailures;                                                            \
+  } }
+
+
+/// The largest tested size and the number of guard values behind the arrays.
+static const unsigned int cMaxSize = 69;
+static const unsigned int cGuardSize = 16;
+static const float        cGuard = -12345.0f;
+static const int          cIntGuard = -12345;
+
+
+/// Returns the next value of a xorshift random number generator.
+static inline unsigned int nextRandom(unsigned int& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+
+/// Returns a random float in [-2, 2].
+static inline float randomFloat(unsigned int& state)
+{
+  return (float)(nextRandom(state) % 40001) / 10000.0f - 2.0f;
+}
+
+
+/// Creates count vectors with 3 floats each, of which some are zero vectors,
+/// contain NaN or infinity, or are very short.
+static void createVectors(unsigned int count,
+                          unsigned int seed,
+                          float*       vectors)
+{
+  unsigned int state = seed;
+  for (unsigned int i=0; i<count*3; ++i)  vectors[i] = randomFloat(state);
+  for (unsigned int i=0; i<count; ++i) {
+    float* vector = vectors + i*3;
+    switch (i % 13) {
+      case 3:  vector[0] = vector[1] = vector[2] = 0.0f;  break;
+      case 5:  vector[1] = std::numeric_limits<float>::quiet_NaN();  break;
+      case 8:  vector[2] = std::numeric_limits<float>::infinity();  break;
+      case 11: vector[0] = 1.0e-20f;  vector[1] = vector[2] = 0.0f;  break;
+    }
+  }
+}
+
+
+/// Runs scalePoints() with unaligned and aligned output for all sizes and
+/// stores the results (including the guard values) in results.
+static void runScalePoints(std::vector<float>& results)
+{
+  const unsigned int pointCount = 50;
+  std::vector<double> points(pointCount * 3);
+  unsigned int        state = 1234567;
+  for (unsigned int i=0; i<points.size(); ++i)  points[i] = randomFloat(state) * 1000.0;
+  points[7] = std::numeric_limits<double>::quiet_NaN();
+  points[20] = -std::numeric_limits<double>::infinity();
+  points[31] = 1.0e300;
+  std::vector<GeometryKernels::IndexT> indices(cMaxSize);
+  for (unsigned int i=0; i<cMaxSize; ++i)  indices[i] = nextRandom(state) % pointCount;
+
+  results.clear();
+  std::vector<float> buffer(cMaxSize*3 + cGuardSize + 4);
+  for (unsigned int offset=0; offset<2; ++offset) {
+    for (unsigned int size=0; size<=cMaxSize; ++size) {
+      float* result = &buffer[offset];
+      std::fill(buffer.begin(), buffer.end(), cGuard);
+      GeometryKernels::scalePoints(&points[0], &indices[0], size, 0.01, result);
+      for (unsigned int i=0; i<cGuardSize; ++i) {
+        CHECK(result[size*3 + i] == cGuard, "scalePoints", size);
+      }
+      results.insert(results.end(), result, result + size*3 + cGuardSize);
+    }
+  }
+}
+
+
+/// Runs normalizeNormals() with 16 byte aligned and unaligned arrays for all
+/// sizes and stores the results (including the guard values) in results.
+static void runNormalizeNormals(std::vector<float>& results)
+{
+  results.clear();
+  std::vector<float> buffer(cMaxSize*3 + cGuardSize + 8);
+  float* aligned = &buffer[0];
+  while (((size_t)aligned & 15) != 0)  ++aligned;
+  for (unsigned int offset=0; offset<4; ++offset) {
+    for (unsigned int size=0; size<=cMaxSize; ++size) {
+      float* normals = aligned + offset;
+      std::fill(buffer.begin(), buffer.end(), cGuard);
+      createVectors(size, 7654321 + size, normals);
+      GeometryKernels::normalizeNormals(normals, size);
+      for (unsigned int i=0; i<cGuardSize; ++i) {
+        CHECK(normals[size*3 + i] == cGuard, "normalizeNormals", size);
+      }
+      results.insert(results.end(), normals, normals + size*3 + cGuardSize);
+    }
+  }
+}
+
+
+/// Runs equalPolygonNormals() for all sizes with flat polygons, polygons of
+/// which one normal differs by a distance around the threshold, and polygons
+/// containing NaN, and stores the results in results.
+static void runEqualPolygonNormals(std::vector<float>& results)
+{
+  const double       maxDistanceSquared = 1.0e-4;
+  const float        distances[] = { 0.0f, 0.0099f, 0.01f, 0.0101f, 0.5f };
+  const unsigned int distanceCount = sizeof(distances) / sizeof(distances[0]);
+
+  results.clear();
+  std::vector<float> normals(cMaxSize*12);
+  for (unsigned int size=0; size<=cMaxSize; ++size) {
+    for (unsigned int variant=0; variant<distanceCount+1; ++variant) {
+      // flat polygons
+      unsigned int state = 5555 + size;
+      for (unsigned int poly=0; poly<size; ++poly) {
+        float x = randomFloat(state), y = randomFloat(state), z = randomFloat(state);
+        for (unsigned int corner=0; corner<4; ++corner) {
+          normals[poly*12 + corner*3]     = x;
+          normals[poly*12 + corner*3 + 1] = y;
+          normals[poly*12 + corner*3 + 2] = z;
+        }
+      }
+      // modify one normal of the last polygon (the one that is handled by
+      // the scalar remainder loop of the SIMD kernels) and of a polygon in
+      // the middle
+      for (unsigned int p=0; p<2 && size; ++p) {
+        unsigned int poly = p ? size-1 : size/2;
+        unsigned int corner = 1 + (size + p) % 3;
+        float* normal = &normals[poly*12 + corner*3];
+        if (variant < distanceCount) {
+          normal[(size + p) % 3] += distances[variant];
+        } else {
+          normal[(size + p) % 3] = std::numeric_limits<float>::quiet_NaN();
+        }
+      }
+      bool equal = GeometryKernels::equalPolygonNormals(size ? &normals[0] : 0, size,
+                                                        maxDistanceSquared);
+      results.push_back(equal ? 1.0f : 0.0f);
+    }
+  }
+}
+
+
+/// Runs triangulate() with triangles and quads mixed in different patterns
+/// for all sizes and stores the results (including the guard values) in
+/// results.
+static void runTriangulate(std::vector<float>& results)
+{
+  results.clear();
+  std::vector<int> polygons(cMaxSize*4);
+  std::vector<int> triangles(cMaxSize*6 + cGuardSize);
+  for (unsigned int pattern=0; pattern<4; ++pattern) {
+    unsigned int state = 99 + pattern;
+    for (unsigned int size=0; size<=cMaxSize; ++size) {
+      for (unsigned int poly=0; poly<size; ++poly) {
+        for (unsigned int corner=0; corner<4; ++corner) {
+          polygons[poly*4 + corner] = (int)(nextRandom(state) % 1000);
+        }
+        bool triangle = (pattern == 0) ? false :
+                        (pattern == 1) ? true :
+                        (pattern == 2) ? (poly % 2 == 0) :
+                                         (nextRandom(state) % 3 == 0);
+        if (triangle)  polygons[poly*4 + 3] = polygons[poly*4 + 2];
+      }
+      // the output array has the 6 entries per polygon the documentation
+      // demands; only the first count entries have to be identical
+      unsigned int maxIndices = 0;
+      for (unsigned int poly=0; poly<size; ++poly) {
+        maxIndices += (polygons[poly*4 + 2] == polygons[poly*4 + 3]) ? 3 : 6;
+      }
+      std::fill(triangles.begin(), triangles.end(), cIntGuard);
+      GeometryKernels::IndexT count =
+          GeometryKernels::triangulate(size ? &polygons[0] : 0, size, &triangles[0]);
+      CHECK(count == maxIndices, "triangulate", size);
+      for (unsigned int i=0; i<cGuardSize; ++i) {
+        CHECK(triangles[size*6 + i] == cIntGuard, "triangulate", size);
+      }
+      results.push_back((float)count);
+      for (unsigned int i=0; i<count; ++i)  results.push_back((float)triangles[i]);
+    }
+  }
+}
+
+
+/// Returns true if two result arrays are bit-identical.
+static bool identical(const std::vector<float>& a,
+                      const std::vector<float>& b)
+{
+  return (a.size() == b.size()) &&
+         (a.empty() || (memcmp(&a[0], &b[0], a.size() * sizeof(float)) == 0));
+}
+
+
+/// Returns the processor time in milliseconds.
+static double milliseconds(void)
+{
+  return (double)clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+
+/// Measures every kernel of the current instruction set with count entries
+/// and prints the times in milliseconds.
+static void benchmark(unsigned int count)
+{
+  std::vector<double>                  points(count * 3);
+  std::vector<GeometryKernels::IndexT> indices(count);
+  std::vector<float>                   result(count * 3);
+  std::vector<float>                   normals(count * 3 + 4);
+  std::vector<float>                   polygonNormals(count * 12, 0.5f);
+  std::vector<int>                     polygons(count * 4);
+  std::vector<int>                     triangles(count * 6);
+  unsigned int                         state = 42;
+  for (unsigned int i=0; i<count*3; ++i)  points[i] = randomFloat(state) * 100.0;
+  for (unsigned int i=0; i<count; ++i)  indices[i] = nextRandom(state) % count;
+  for (unsigned int i=0; i<count*4; ++i)  polygons[i] = (int)(nextRandom(state) % count);
+  for (unsigned int i=0; i<count; i+=3)  polygons[i*4 + 3] = polygons[i*4 + 2];
+  float* alignedNormals = &normals[0];
+  while (((size_t)alignedNormals & 15) != 0)  ++alignedNormals;
+  createVectors(count, 17, alignedNormals);
+
+  const int repeats = 10;
+  double times[4] = { 0.0, 0.0, 0.0, 0.0 };
+  bool   equal = true;
+  for (int r=0; r<repeats; ++r) {
+    double start = milliseconds();
+    GeometryKernels::scalePoints(&points[0], &indices[0], count, 0.01, &result[0]);
+    double scaled = milliseconds();
+    GeometryKernels::normalizeNormals(alignedNormals, count);
+    double normalized = milliseconds();
+    equal &= GeometryKernels::equalPolygonNormals(&polygonNormals[0], count, 1.0e-4);
+    double checked = milliseconds();
+    GeometryKernels::triangulate(&polygons[0], count, &triangles[0]);
+    double triangulated = milliseconds();
+    times[0] += scaled - start;
+    times[1] += normalized - scaled;
+    times[2] += checked - normalized;
+    times[3] += triangulated - checked;
+  }
+  printf("  %-6s scale %6.2f  normalize %6.2f  flat check %6.2f  triangulate %6.2f%s\n",
+         GeometryKernels::instructionSetName(GeometryKernels::instructionSet()),
+         times[0] / repeats, times[1] / repeats, times[2] / repeats, times[3] / repeats,
+         equal ? "" : " (unexpected result)");
+}
+
+
+int main(int argc, char* argv[])
+{
+  // reference results of the scalar kernels
+  GeometryKernels::init(GeometryKernels::INSTRUCTIONS_SCALAR);
+  std::vector<float> scale, normalize, flat, triangulate;
+  runScalePoints(scale);
+  runNormalizeNormals(normalize);
+  runEqualPolygonNormals(flat);
+  runTriangulate(triangulate);
+
+  // compare the SIMD kernels against them
+  for (int set=GeometryKernels::INSTRUCTIONS_SSE2; set<=GeometryKernels::INSTRUCTIONS_AVX2; ++set) {
+    if (GeometryKernels::init((GeometryKernels::InstructionSet)set) != set) {
+      printf("%s is not supported by this CPU or build -> skipped\n",
+             GeometryKernels::instructionSetName((GeometryKernels::InstructionSet)set));
+      continue;
+    }
+    std::vector<float> results;
+    runScalePoints(results);
+    CHECK(identical(results, scale), "scalePoints", cMaxSize);
+    runNormalizeNormals(results);
+    CHECK(identical(results, normalize), "normalizeNormals", cMaxSize);
+    runEqualPolygonNormals(results);
+    CHECK(identical(results, flat), "equalPolygonNormals", cMaxSize);
+    runTriangulate(results);
+    CHECK(identical(results, triangulate), "triangulate", cMaxSize);
+  }
+
+  if ((argc > 1) && (strcmp(argv[1], "--benchmark") == 0)) {
+    printf("milliseconds for 1M entries:\n");
+    for (int set=GeometryKernels::INSTRUCTIONS_SCALAR; set<=GeometryKernels::INSTRUCTIONS_AVX2; ++set) {
+      if (GeometryKernels::init((GeometryKernels::InstructionSet)set) == set) {
+        benchmark(1000000);
+      }
+    }
+  }
+
+  if (sFailures) {
+    printf("%d checks failed\n", sFailures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
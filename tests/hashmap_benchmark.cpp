@@ -0,0 +1,187 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+/*****************************************************************************
+ * Benchmark of HashMap/HashSet against RBTreeMap/RBTreeSet with 10^3 to 10^6
+ * entries, using the key types the converter uses: object pointers and
+ * LuxStrings. For every size it measures adding all keys, looking up all keys,
+ * looking up keys that are not stored and adding all keys again (which only
+ * overwrites). Before that, it checks that both containers find the same
+ * entries and that overwriting an entry doesn't grow the hash table.
+ *****************************************************************************/
+
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+#include "hashmap.h"
+#include "hashset.h"
+#include "rbtreemap.h"
+#include "rbtreeset.h"
+
+
+
+/// Returns the processor time in seconds.
+static double seconds(void)
+{
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+
+/// Creates count unique pointer keys, which are spaced like the addresses of
+/// heap objects and shuffled, and count unique LuxString keys, which look like
+/// object names.
+static void createKeys(SizeT                   count,
+                       std::vector<void*>&     pointers,
+                       std::vector<LuxString>& strings)
+{
+  pointers.resize(count);
+  strings.resize(count);
+  VULONG random = 88172645463325252ULL;
+  CHAR   name[64];
+  for (SizeT i=0; i<count; ++i) {
+    random ^= random << 13;
+    random ^= random >> 7;
+    random ^= random << 17;
+    pointers[i] = (void*)(VULONG)(0x10000000ULL + i * 48);
+    SizeT other = (SizeT)(random % (i + 1));
+    void* swap = pointers[i];
+    pointers[i] = pointers[other];
+    pointers[other] = swap;
+    sprintf(name, "Object %u.%u", (unsigned int)(random % 97), (unsigned int)i);
+    strings[i] = name;
+  }
+}
+
+
+/// Measures a map type with the specified keys and prints the nanoseconds
+/// per operation. The keys in [count/2, count) are not added to the map and
+/// are used for the failing lookups.
+template <class MapT, class KeyT>
+static SizeT benchmarkMap(const char*              name,
+                          const std::vector<KeyT>& keys)
+{
+  SizeT  count = keys.size() / 2;
+  SizeT  found = 0;
+  MapT   map;
+  double start = seconds();
+  for (SizeT i=0; i<count; ++i)  map.add(keys[i], (LONG)i);
+  double added = seconds();
+  for (SizeT i=0; i<count; ++i)  found += (map.get(keys[i]) != 0);
+  double hits = seconds();
+  for (SizeT i=count; i<keys.size(); ++i)  found += (map.get(keys[i]) != 0);
+  double misses = seconds();
+  for (SizeT i=0; i<count; ++i)  map.add(keys[i], (LONG)(i + 1));
+  double overwritten = seconds();
+
+  double scale = 1.0e9 / (double)count;
+  printf("  %-22s %8.1f %8.1f %8.1f %8.1f\n", name,
+         (added - start) * scale, (hits - added) * scale,
+         (misses - hits) * scale, (overwritten - misses) * scale);
+  return found;
+}
+
+
+/// Measures a set type with the specified keys - see benchmarkMap().
+template <class SetT, class KeyT>
+static SizeT benchmarkSet(const char*              name,
+                          const std::vector<KeyT>& keys)
+{
+  SizeT  count = keys.size() / 2;
+  SizeT  found = 0;
+  SetT   set;
+  double start = seconds();
+  for (SizeT i=0; i<count; ++i)  set.add(keys[i]);
+  double added = seconds();
+  for (SizeT i=0; i<count; ++i)  found += (set.get(keys[i]) != 0);
+  double hits = seconds();
+  for (SizeT i=count; i<keys.size(); ++i)  found += (set.get(keys[i]) != 0);
+  double misses = seconds();
+  for (SizeT i=0; i<count; ++i)  set.add(keys[i]);
+  double overwritten = seconds();
+
+  double scale = 1.0e9 / (double)count;
+  printf("  %-22s %8.1f %8.1f %8.1f %8.1f\n", name,
+         (added - start) * scale, (hits - added) * scale,
+         (misses - hits) * scale, (overwritten - misses) * scale);
+  return found;
+}
+
+
+/// Checks that overwriting an entry of a full table doesn't rehash it, i.e.
+/// the pointers to the stored values stay valid.
+static Bool checkOverwrite(void)
+{
+  HashMap<LuxString, LONG> map;
+  HashSet<LuxString>       set;
+  CHAR                     name[16];
+  for (LONG i=0; i<12; ++i) {
+    sprintf(name, "key %d", (int)i);
+    map.add(name, i);
+    set.add(name);
+  }
+  const LONG*      value = map.get("key 0");
+  const LuxString* key = set.get("key 0");
+  return (value && key &&
+          (map.add("key 0", 100) == value) && (*value == 100) &&
+          (set.add("key 0") == key) &&
+          (map.size() == 12) && (set.size() == 12));
+}
+
+
+int main(void)
+{
+  if (!checkOverwrite()) {
+    printf("FAILED: overwriting an entry of a full hash table moved it\n");
+    return 1;
+  }
+
+  printf("nanoseconds per operation:   add      hit     miss  overwrite\n");
+  Bool success = TRUE;
+  for (SizeT count=1000; count<=1000000; count*=10) {
+    std::vector<void*>     pointers;
+    std::vector<LuxString> strings;
+    createKeys(count * 2, pointers, strings);
+
+    printf("%u entries\n", (unsigned int)count);
+    SizeT found[8];
+    found[0] = benchmarkMap<HashMap<void*, LONG> >("HashMap<void*>", pointers);
+    found[1] = benchmarkMap<RBTreeMap<void*, LONG, NodePool> >("RBTreeMap<void*>", pointers);
+    found[2] = benchmarkMap<HashMap<LuxString, LONG> >("HashMap<LuxString>", strings);
+    found[3] = benchmarkMap<RBTreeMap<LuxString, LONG, NodePool> >("RBTreeMap<LuxString>", strings);
+    found[4] = benchmarkSet<HashSet<void*> >("HashSet<void*>", pointers);
+    found[5] = benchmarkSet<RBTreeSet<void*, NodePool> >("RBTreeSet<void*>", pointers);
+    found[6] = benchmarkSet<HashSet<LuxString> >("HashSet<LuxString>", strings);
+    found[7] = benchmarkSet<RBTreeSet<LuxString, NodePool> >("RBTreeSet<LuxString>", strings);
+    for (LONG i=0; i<8; ++i) {
+      if (found[i] != count) {
+        printf("FAILED: container %d found %u of %u entries\n",
+               (int)i, (unsigned int)found[i], (unsigned int)count);
+        success = FALSE;
+      }
+    }
+  }
+  return success ? 0 : 1;
+}
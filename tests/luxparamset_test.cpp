@@ -0,0 +1,165 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+/*****************************************************************************
+ * Test of LuxParamSet and LuxParamSetN: parameters of small sets are stored in
+ * the object itself, larger sets overflow to the heap, the capacity is
+ * enforced, and add() appends the parameters of another set and returns TRUE.
+ *****************************************************************************/
+
+#include <cstdio>
+
+#include "luxparamset.h"
+
+
+
+/// The number of failed checks.
+static LONG sFailures = 0;
+
+
+/// Records a failed check, if the condition is FALSE.
+#define CHECK(condition)                                                      \
+  { if (!(condition)) {                                                       \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);    \
+      ++sFailures;                                                            \
+  } }
+
+
+/// Returns TRUE if the parameter arrays of a set lie within the object, i.e.
+/// the set didn't allocate them on the heap.
+template <class SetT>
+static Bool isInline(const SetT& set)
+{
+  const CHAR* begin = (const CHAR*)&set;
+  const CHAR* end = begin + sizeof(SetT);
+  const CHAR* types = (const CHAR*)set.paramTypes();
+  const CHAR* sizes = (const CHAR*)set.paramArraySizes();
+  return (types >= begin) && (types < end) && (sizes >= begin) && (sizes < end);
+}
+
+
+/// Fills a set with count float parameters, which all point to value.
+static Bool fill(LuxParamSet& set,
+                 LONG         count,
+                 LuxFloat&    value)
+{
+  static const CHAR* cNames[] = { "a", "b", "c", "d", "e", "f", "g", "h" };
+  for (LONG i=0; i<count; ++i) {
+    if (!set.addParam(LUX_FLOAT, cNames[i % 8], &value, (ULONG)(i + 1)))  return FALSE;
+  }
+  return TRUE;
+}
+
+
+/// Sets with up to N parameters use the inline arrays.
+static void testInlineStorage(void)
+{
+  LuxFloat        value = 1.0f;
+  LuxParamSetN<4> set;
+  CHECK(isInline(set));
+  CHECK(set.paramNumber() == 0);
+  CHECK(fill(set, 4, value));
+  CHECK(set.paramNumber() == 4);
+  CHECK(set.paramTypes()[3] == LUX_FLOAT);
+  CHECK(set.paramValues()[3] == &value);
+  CHECK(set.paramArraySizes()[3] == 4);
+  CHECK(!set.addParam(LUX_FLOAT, "e", &value));
+  CHECK(set.paramNumber() == 4);
+
+  // invalid parameters are rejected
+  LuxParamSetN<2> other;
+  CHECK(!other.addParam(LUX_FLOAT, 0, &value));
+  CHECK(!other.addParam(LUX_FLOAT, "a", 0));
+  CHECK(!other.addParam(LUX_FLOAT, "a", &value, 0));
+  CHECK(other.paramNumber() == 0);
+}
+
+
+/// Sets that need more than N parameters allocate their arrays on the heap.
+static void testHeapOverflow(void)
+{
+  LuxFloat        value = 2.0f;
+  LuxParamSetN<2> set(6);
+  CHECK(!isInline(set));
+  CHECK(fill(set, 6, value));
+  CHECK(set.paramNumber() == 6);
+  CHECK(set.paramArraySizes()[5] == 6);
+  CHECK(!set.addParam(LUX_FLOAT, "g", &value));
+
+  // plain LuxParamSets always use the heap
+  LuxParamSet heapSet(3);
+  CHECK(fill(heapSet, 3, value));
+  CHECK(!heapSet.addParam(LUX_FLOAT, "d", &value));
+  CHECK(heapSet.paramNumber() == 3);
+
+  // clear() keeps the storage
+  const LuxParamType* types = set.paramTypes();
+  set.clear();
+  CHECK(set.paramNumber() == 0);
+  CHECK(set.paramTypes() == types);
+  CHECK(fill(set, 6, value));
+}
+
+
+/// add() appends all parameters of another set, if they fit.
+static void testAdd(void)
+{
+  LuxFloat        value1 = 1.0f;
+  LuxFloat        value2 = 2.0f;
+  LuxParamSetN<3> first;
+  LuxParamSetN<8> second(3);
+  LuxParamSetN<5> target;
+  CHECK(fill(first, 3, value1));
+  CHECK(fill(second, 2, value2));
+
+  CHECK(target.add(first) == TRUE);
+  CHECK(target.add(second) == TRUE);
+  CHECK(target.paramNumber() == 5);
+  CHECK(target.paramValues()[2] == &value1);
+  CHECK(target.paramValues()[3] == &value2);
+  CHECK(target.paramArraySizes()[4] == 2);
+
+  // a set that doesn't fit is rejected completely
+  CHECK(!target.add(first));
+  CHECK(target.paramNumber() == 5);
+
+  // adding an empty set succeeds
+  LuxParamSet empty(1);
+  CHECK(target.add(empty) == TRUE);
+}
+
+
+int main(void)
+{
+  testInlineStorage();
+  testHeapOverflow();
+  testAdd();
+  if (sFailures) {
+    printf("%d checks failed\n", (int)sFailures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
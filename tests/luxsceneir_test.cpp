@@ -0,0 +1,245 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+/*****************************************************************************
+ * Test of LuxSceneIR, filled like LuxAPIConverter does it: the polygons of a
+ * cube and a triangle are split by GeometryKernels::triangulate() and stored
+ * as meshes, which are placed by instances. The test checks the triangle
+ * indices with every available instruction set and that every mesh, material
+ * and instance returns exactly the data it was given. Neither file depends on
+ * the C4D SDK.
+ *****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+
+#include "geometrykernels.h"
+#include "luxsceneir.h"
+
+
+
+/// The number of failed checks.
+static int sFailures = 0;
+
+
+/// Records a failed check, if the condition is false.
+#define CHECK(condition)                                                      \
+  { if (!(condition)) {                                                       \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);    \
+      ++sFailures;                                                            \
+  } }
+
+
+/// The corners of a unit cube.
+static const float cCubePoints[8*3] = {
+  0.0f, 0.0f, 0.0f,   1.0f, 0.0f, 0.0f,   1.0f, 1.0f, 0.0f,   0.0f, 1.0f, 0.0f,
+  0.0f, 0.0f, 1.0f,   1.0f, 0.0f, 1.0f,   1.0f, 1.0f, 1.0f,   0.0f, 1.0f, 1.0f
+};
+
+/// The 6 quads of the cube in the layout of C4D's CPolygon.
+static const int cCubePolygons[6*4] = {
+  0, 1, 2, 3,   4, 7, 6, 5,   0, 4, 5, 1,   1, 5, 6, 2,   2, 6, 7, 3,   3, 7, 4, 0
+};
+
+/// A single triangle (third and fourth index are equal) and a quad.
+static const int cMixedPolygons[2*4] = {
+  0, 1, 2, 2,   0, 2, 3, 4
+};
+
+
+/// Returns true if two float arrays are equal.
+static bool equal(const float* a,
+                  const float* b,
+                  unsigned int count)
+{
+  return a && b && (memcmp(a, b, count * sizeof(float)) == 0);
+}
+
+
+/// triangulate() splits quads into 2 triangles and keeps triangles, with the
+/// index order Lux expects.
+static void testTriangulate(void)
+{
+  int triangles[6*6];
+  CHECK(GeometryKernels::triangulate(cCubePolygons, 6, triangles) == 36);
+  static const int cFirstQuad[6] = { 0, 2, 1,   0, 3, 2 };
+  CHECK(memcmp(triangles, cFirstQuad, sizeof(cFirstQuad)) == 0);
+  for (int i=0; i<36; ++i) {
+    CHECK((triangles[i] >= 0) && (triangles[i] < 8));
+  }
+
+  int mixed[2*6];
+  static const int cMixed[9] = { 0, 2, 1,   0, 3, 2,   0, 4, 3 };
+  CHECK(GeometryKernels::triangulate(cMixedPolygons, 2, mixed) == 9);
+  CHECK(memcmp(mixed, cMixed, sizeof(cMixed)) == 0);
+  CHECK(GeometryKernels::triangulate(cMixedPolygons, 0, mixed) == 0);
+}
+
+
+/// Meshes keep their data and offsets, also if only some of them have
+/// normals or UVs.
+static void testMeshes(LuxSceneIR& ir)
+{
+  int triangles[6*6];
+  LuxSceneIR::IndexT triangleCount = GeometryKernels::triangulate(cCubePolygons, 6, triangles);
+
+  // mesh 0: cube with triangles and normals
+  float normals[8*3];
+  for (int i=0; i<8*3; ++i)  normals[i] = cCubePoints[i] - 0.5f;
+  LuxSceneIR::IndexT cube = ir.addMesh(cCubePoints, 8, triangles, triangleCount,
+                                       0, 0, normals, 0);
+  // mesh 1: cube with quads only, without normals and UVs
+  LuxSceneIR::IndexT quadCube = ir.addMesh(cCubePoints, 8, 0, 0,
+                                           cCubePolygons, 6*4, 0, 0);
+  // mesh 2: triangle fan with normals and UVs
+  float uvs[5*2] = { 0.0f, 0.0f,   1.0f, 0.0f,   1.0f, 1.0f,   0.0f, 1.0f,   0.5f, 0.5f };
+  int   fan[3*6];
+  LuxSceneIR::IndexT fanCount = GeometryKernels::triangulate(cMixedPolygons, 2, fan);
+  LuxSceneIR::IndexT fanMesh = ir.addMesh(cCubePoints, 5, fan, fanCount, 0, 0,
+                                          normals, uvs);
+
+  CHECK(cube == 0);
+  CHECK(quadCube == 1);
+  CHECK(fanMesh == 2);
+  CHECK(ir.meshCount() == 3);
+
+  CHECK(ir.meshPointCount(cube) == 8);
+  CHECK(equal(ir.meshPoints(cube), cCubePoints, 8*3));
+  CHECK(equal(ir.meshNormals(cube), normals, 8*3));
+  CHECK(ir.meshUVs(cube) == 0);
+  CHECK(ir.meshTriangleIndexCount(cube) == 36);
+  CHECK(ir.meshTriangles(cube) && (memcmp(ir.meshTriangles(cube), triangles, 36 * sizeof(int)) == 0));
+  CHECK(ir.meshQuadIndexCount(cube) == 0);
+  CHECK(ir.meshQuads(cube) == 0);
+
+  CHECK(ir.meshPointCount(quadCube) == 8);
+  CHECK(equal(ir.meshPoints(quadCube), cCubePoints, 8*3));
+  CHECK(ir.meshNormals(quadCube) == 0);
+  CHECK(ir.meshTriangleIndexCount(quadCube) == 0);
+  CHECK(ir.meshTriangles(quadCube) == 0);
+  CHECK(ir.meshQuadIndexCount(quadCube) == 24);
+  CHECK(ir.meshQuads(quadCube) && (memcmp(ir.meshQuads(quadCube), cCubePolygons, sizeof(cCubePolygons)) == 0));
+
+  // the indices stay relative to the mesh, even though its data is stored
+  // behind the data of the other meshes
+  CHECK(ir.meshPointCount(fanMesh) == 5);
+  CHECK(equal(ir.meshPoints(fanMesh), cCubePoints, 5*3));
+  CHECK(equal(ir.meshNormals(fanMesh), normals, 5*3));
+  CHECK(equal(ir.meshUVs(fanMesh), uvs, 5*2));
+  CHECK(ir.meshTriangleIndexCount(fanMesh) == 9);
+  CHECK(ir.meshTriangles(fanMesh) && (memcmp(ir.meshTriangles(fanMesh), fan, 9 * sizeof(int)) == 0));
+}
+
+
+/// Materials are deduplicated by their key and instances keep their data.
+static void testInstances(LuxSceneIR& ir)
+{
+  int   materialObjects[2];
+  float matrix[16];
+  for (int i=0; i<16; ++i)  matrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+  matrix[12] = 3.0f;
+
+  LuxSceneIR::IndexT transform = ir.addTransform(matrix);
+  LuxSceneIR::IndexT material0 = ir.addMaterial(&materialObjects[0]);
+  LuxSceneIR::IndexT material1 = ir.addMaterial(&materialObjects[1]);
+  LuxSceneIR::IndexT noMaterial = ir.addMaterial(0);
+  CHECK(transform == 0);
+  CHECK(ir.transformCount() == 1);
+  CHECK(equal(ir.transform(transform), matrix, 16));
+  CHECK((material0 == 0) && (material1 == 1) && (noMaterial == 2));
+  CHECK(ir.addMaterial(&materialObjects[0]) == material0);
+  CHECK(ir.addMaterial(0) == noMaterial);
+  CHECK(ir.materialCount() == 3);
+  CHECK(ir.materialKey(material1) == &materialObjects[1]);
+
+  LuxSceneIR::IndexT shape = ir.addInstance("cube", 0, transform, material0,
+                                            LuxSceneIR::cInvalidIndex,
+                                            LuxSceneIR::INSTANCE_SHAPE, 256);
+  LuxSceneIR::IndexT portal = ir.addInstance("portal", LuxSceneIR::cInvalidIndex,
+                                             transform, noMaterial, 1,
+                                             LuxSceneIR::INSTANCE_PORTAL |
+                                             LuxSceneIR::INSTANCE_PORTAL_FLIP, 0);
+  CHECK((shape == 0) && (portal == 1));
+  CHECK(ir.instanceCount() == 2);
+  CHECK(ir.instanceName(shape) == "cube");
+  CHECK(ir.instanceMesh(shape) == 0);
+  CHECK(ir.instanceTransform(shape) == transform);
+  CHECK(ir.instanceMaterial(shape) == material0);
+  CHECK(ir.instancePortalMesh(shape) == LuxSceneIR::cInvalidIndex);
+  CHECK(ir.instanceFlags(shape) == LuxSceneIR::INSTANCE_SHAPE);
+  CHECK(ir.instanceTextureResolution(shape) == 256);
+  CHECK(ir.instanceShard(shape).empty());
+  CHECK(ir.instanceChecksum(shape) == 0);
+  CHECK(ir.instanceDirtyChecksum(shape) == 0);
+  CHECK(ir.instanceSource(shape) == LuxSceneIR::cInvalidIndex);
+  CHECK(ir.instanceMesh(portal) == LuxSceneIR::cInvalidIndex);
+  CHECK(ir.instancePortalMesh(portal) == 1);
+
+  // cached instances get their meshes and shard later
+  ir.setInstanceShard(shape, "0123456789abcdef", 0x12345678U, 0x9abcdef0U, 7);
+  ir.setInstanceMeshes(shape, 2, 1, LuxSceneIR::INSTANCE_SHAPE | LuxSceneIR::INSTANCE_PORTAL);
+  CHECK(ir.instanceShard(shape) == "0123456789abcdef");
+  CHECK(ir.instanceChecksum(shape) == 0x12345678U);
+  CHECK(ir.instanceDirtyChecksum(shape) == 0x9abcdef0U);
+  CHECK(ir.instanceSource(shape) == 7);
+  CHECK(ir.instanceMesh(shape) == 2);
+  CHECK(ir.instancePortalMesh(shape) == 1);
+  CHECK(ir.instanceFlags(shape) == (LuxSceneIR::INSTANCE_SHAPE | LuxSceneIR::INSTANCE_PORTAL));
+  CHECK(ir.instanceShard(portal).empty());
+}
+
+
+int main(void)
+{
+  for (int set=GeometryKernels::INSTRUCTIONS_SCALAR; set<=GeometryKernels::INSTRUCTIONS_AVX2; ++set) {
+    GeometryKernels::InstructionSet used = GeometryKernels::init((GeometryKernels::InstructionSet)set);
+    if (used == set)  testTriangulate();
+  }
+
+  LuxSceneIR ir;
+  CHECK(ir.meshCount() == 0);
+  CHECK(ir.instanceCount() == 0);
+  CHECK(ir.meshDataSize() == 0);
+  testMeshes(ir);
+  // points of all meshes, normals padded up to the last mesh with normals,
+  // UVs of the fan mesh and the padding in front of them, triangles and quads
+  CHECK(ir.meshDataSize() == (21*3 + 21*3 + 21*2) * sizeof(float) +
+                             (36 + 9 + 24) * sizeof(int));
+  testInstances(ir);
+
+  // clear() removes everything, so the IR can be filled again
+  ir.clear();
+  CHECK((ir.meshCount() == 0) && (ir.transformCount() == 0) &&
+        (ir.materialCount() == 0) && (ir.instanceCount() == 0) &&
+        (ir.meshDataSize() == 0));
+  testMeshes(ir);
+
+  if (sFailures) {
+    printf("%d checks failed\n", sFailures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,159 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+/*****************************************************************************
+ * Benchmark of the node allocators NodeHeapAllocator and NodePool, used by
+ * DList and RBTreeMap with 10^3 to 10^6 entries. For every size it measures
+ * filling the container, traversing it (DList) or looking up all keys
+ * (RBTreeMap), removing every second entry and refilling it (which reuses the
+ * freed nodes) and destroying the container. Both allocators have to produce
+ * the same results.
+ *****************************************************************************/
+
+#include <cstdio>
+#include <ctime>
+
+#include "dlist.h"
+#include "rbtreemap.h"
+
+
+
+/// Returns the processor time in seconds.
+static double seconds(void)
+{
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+
+/// Returns the next value of a xorshift random number generator.
+static inline ULONG nextRandom(ULONG& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+
+/// Prints one result line with the nanoseconds per entry of each phase.
+static void printTimes(const char* name,
+                       SizeT       count,
+                       double      times[5])
+{
+  double scale = 1.0e9 / (double)count;
+  printf("  %-30s %8.1f %8.1f %8.1f %8.1f\n", name,
+         (times[1] - times[0]) * scale, (times[2] - times[1]) * scale,
+         (times[3] - times[2]) * scale, (times[4] - times[3]) * scale);
+}
+
+
+/// Measures a DList with the specified allocator and returns a checksum of
+/// the traversed values.
+template <template <class> class ALLOCATOR>
+static VULONG benchmarkList(const char* name,
+                            SizeT       count)
+{
+  typedef DList<LONG, ALLOCATOR> ListT;
+
+  VULONG checksum = 0;
+  double times[5];
+  ListT* list = new ListT;
+  times[0] = seconds();
+  for (SizeT i=0; i<count; ++i)  list->pushBack((LONG)i);
+  times[1] = seconds();
+  for (typename ListT::ConstIteratorT it=((const ListT*)list)->begin(); it.isValid(); ++it) {
+    checksum = checksum * 31 + *it;
+  }
+  times[2] = seconds();
+  typename ListT::IteratorT it = list->begin();
+  while (it.isValid()) {
+    typename ListT::IteratorT next = it;
+    ++next;
+    list->remove(it);
+    it = next;
+    if (it.isValid())  ++it;
+  }
+  for (SizeT i=0; i<count/2; ++i)  list->pushFront((LONG)i);
+  times[3] = seconds();
+  checksum += list->size();
+  delete list;
+  times[4] = seconds();
+
+  printTimes(name, count, times);
+  return checksum;
+}
+
+
+/// Measures an RBTreeMap with the specified allocator and returns a checksum
+/// of the looked up values.
+template <template <class> class ALLOCATOR>
+static VULONG benchmarkMap(const char* name,
+                           SizeT       count)
+{
+  typedef RBTreeMap<ULONG, LONG, ALLOCATOR> MapT;
+
+  VULONG checksum = 0;
+  double times[5];
+  MapT*  map = new MapT;
+  ULONG  random = 2463534242U;
+  times[0] = seconds();
+  for (SizeT i=0; i<count; ++i)  map->add(nextRandom(random), (LONG)i);
+  times[1] = seconds();
+  random = 2463534242U;
+  for (SizeT i=0; i<count; ++i) {
+    const LONG* value = map->get(nextRandom(random));
+    checksum = checksum * 31 + (value ? *value : -1);
+  }
+  times[2] = seconds();
+  // RBTreeMap can't remove single entries, so we rebuild it instead
+  map->erase();
+  for (SizeT i=0; i<count; ++i)  map->add(nextRandom(random), (LONG)i);
+  times[3] = seconds();
+  checksum += map->size();
+  delete map;
+  times[4] = seconds();
+
+  printTimes(name, count, times);
+  return checksum;
+}
+
+
+int main(void)
+{
+  Bool success = TRUE;
+  printf("nanoseconds per entry:             fill   traverse  refill  destroy\n");
+  for (SizeT count=1000; count<=1000000; count*=10) {
+    printf("%u entries\n", (unsigned int)count);
+    VULONG heapList = benchmarkList<NodeHeapAllocator>("DList<NodeHeapAllocator>", count);
+    VULONG poolList = benchmarkList<NodePool>("DList<NodePool>", count);
+    VULONG heapMap = benchmarkMap<NodeHeapAllocator>("RBTreeMap<NodeHeapAllocator>", count);
+    VULONG poolMap = benchmarkMap<NodePool>("RBTreeMap<NodePool>", count);
+    if ((heapList != poolList) || (heapMap != poolMap)) {
+      printf("FAILED: the allocators produced different results\n");
+      success = FALSE;
+    }
+  }
+  return success ? 0 : 1;
+}
@@ -0,0 +1,254 @@
+/************************************************************************
+ * LuxC4D - CINEMA 4D plug-in for export to LuxRender                   *
+ * (http://www.luxrender.net)                                           *
+ *                                                                      *
+ * Author:                                                              *
+ * Marcus Spranger (abstrax)                                            *
+ *                                                                      *
+ ************************************************************************
+ *                                                                      *
+ * This file is part of LuxC4D.                                         *
+ *                                                                      *
+ * LuxC4D is free software: you can redistribute it and/or modify       *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation, either version 3 of the License, or    *
+ * (at your option) any later version.                                  *
+ *                                                                      *
+ * LuxC4D is distributed in the hope that it will be useful,            *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+ * GNU General Public License for more details.                         *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with LuxC4D.  If not, see <http://www.gnu.org/licenses/>.      *
+ ************************************************************************/
+
+#ifndef __C4D_H__
+#define __C4D_H__  1
+
+
+
+/*****************************************************************************
+ * Minimal stand-in for the CINEMA 4D SDK header "c4d.h", which only declares
+ * what the SDK independent parts of the plugin (containers, parameter sets,
+ * scene IR) need, so that they can be tested without the SDK. Everything
+ * else is declared, but not defined.
+ *****************************************************************************/
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <string>
+
+
+#define _C4D_VERSION  120
+
+
+typedef char               CHAR;
+typedef unsigned char      UCHAR;
+typedef short              SWORD;
+typedef unsigned short     UWORD;
+typedef int                LONG;
+typedef unsigned int       ULONG;
+typedef long long          LLONG;
+typedef unsigned long long LULONG;
+typedef long long          VLONG;
+typedef unsigned long long VULONG;
+typedef float              SReal;
+typedef double             LReal;
+typedef double             Real;
+typedef int                Bool;
+
+#define TRUE   1
+#define FALSE  0
+
+#define MINLONGl  (-2147483647-1)
+#define MAXLONGl  2147483647
+
+
+struct SVector;
+
+struct LVector
+{
+  LReal x, y, z;
+
+  LVector(void) : x(0.0), y(0.0), z(0.0) {}
+  LVector(LReal ix, LReal iy, LReal iz) : x(ix), y(iy), z(iz) {}
+  inline SVector ToSV(void) const;
+};
+
+struct SVector
+{
+  SReal x, y, z;
+
+  SVector(void) : x(0.0f), y(0.0f), z(0.0f) {}
+  SVector(SReal ix, SReal iy, SReal iz) : x(ix), y(iy), z(iz) {}
+  LVector ToLV(void) const { return LVector(x, y, z); }
+};
+
+inline SVector LVector::ToSV(void) const
+{
+  return SVector((SReal)x, (SReal)y, (SReal)z);
+}
+
+typedef LVector Vector;
+
+
+struct SMatrix;
+
+struct LMatrix
+{
+  LVector off, v1, v2, v3;
+
+  LMatrix(void) : v1(1.0, 0.0, 0.0), v2(0.0, 1.0, 0.0), v3(0.0, 0.0, 1.0) {}
+  inline SMatrix ToSM(void) const;
+};
+
+struct SMatrix
+{
+  SVector off, v1, v2, v3;
+
+  SMatrix(void) : v1(1.0f, 0.0f, 0.0f), v2(0.0f, 1.0f, 0.0f), v3(0.0f, 0.0f, 1.0f) {}
+  LMatrix ToLM(void) const
+  {
+    LMatrix m;
+    m.off = off.ToLV();  m.v1 = v1.ToLV();  m.v2 = v2.ToLV();  m.v3 = v3.ToLV();
+    return m;
+  }
+};
+
+inline SMatrix LMatrix::ToSM(void) const
+{
+  SMatrix m;
+  m.off = off.ToSV();  m.v1 = v1.ToSV();  m.v2 = v2.ToSV();  m.v3 = v3.ToSV();
+  return m;
+}
+
+typedef LMatrix Matrix;
+
+
+struct CPolygon
+{
+  LONG a, b, c, d;
+};
+
+
+class String
+{
+public:
+
+  String(void) {}
+  String(const CHAR* str) : mStr(str) {}
+  String(const std::string& str) : mStr(str) {}
+
+  LONG GetLength(void) const { return (LONG)mStr.size(); }
+  UWORD operator[](LONG pos) const { return (UWORD)(UCHAR)mStr[pos]; }
+  Bool operator==(const String& other) const { return mStr == other.mStr; }
+  Bool operator!=(const String& other) const { return mStr != other.mStr; }
+  String operator+(const String& other) const { return String(mStr + other.mStr); }
+  const std::string& str(void) const { return mStr; }
+
+private:
+
+  std::string mStr;
+};
+
+inline String operator+(const CHAR* str1, const String& str2)
+{
+  return String(str1) + str2;
+}
+
+inline String LongToString(LONG value)
+{
+  CHAR buffer[16];
+  sprintf(buffer, "%d", (int)value);
+  return String(buffer);
+}
+
+inline String LLongToString(LLONG value)
+{
+  CHAR buffer[32];
+  sprintf(buffer, "%lld", value);
+  return String(buffer);
+}
+
+
+enum FILESELECTTYPE
+{
+  FILESELECTTYPE_ANYTHING = 0
+};
+
+enum FILESELECT
+{
+  FILESELECT_LOAD = 0
+};
+
+
+class Filename
+{
+public:
+
+  Filename(void) {}
+  Filename(const String& path) : mPath(path) {}
+
+  const String& GetString(void) const { return mPath; }
+  Bool FileSelect(FILESELECTTYPE type, FILESELECT flags, const String& title);
+
+private:
+
+  String mPath;
+};
+
+
+class C4DAtom;
+class GeListNode;
+class BaseList2D;
+class BaseTag;
+class BaseObject;
+class BaseContainer;
+class Description;
+class AtomArray;
+
+class PointObject
+{
+public:
+
+  const Vector* GetPointR(void) const { return 0; }
+};
+
+class PolygonObject : public PointObject
+{
+public:
+
+  const CPolygon* GetPolygonR(void) const { return 0; }
+};
+
+
+inline void GePrint(const String& msg)
+{
+  fprintf(stderr, "%s\n", msg.str().c_str());
+}
+
+inline LONG GeGetTimer(void)
+{
+  return (LONG)(clock() * 1000 / CLOCKS_PER_SEC);
+}
+
+#define GeAssert(condition)  assert(condition)
+
+#define GeAlloc(size)    calloc(1, (size))
+#define GeAllocNC(size)  malloc(size)
+#define GeFree(ptr)      { free(ptr);  (ptr) = 0; }
+
+#define gNew             new (std::nothrow)
+#define gDelete(ptr)     { delete (ptr);  (ptr) = 0; }
+#define bNew             new (std::nothrow)
+#define bDelete(ptr)     { delete[] (ptr);  (ptr) = 0; }
+
+
+
+#endif  // #ifndef __C4D_H__